@@ -192,6 +192,7 @@ static gboolean _on_module_activated (ModuleWidget *pModuleWidget, G_GNUC_UNUSED
 ModuleWidget *cairo_dock_module_widget_new (GldiModule *pModule, GldiModuleInstance *pInstance, GtkWidget *pMainWindow)
 {
 	g_return_val_if_fail (pModule != NULL, NULL);
+	gldi_module_load_interface (pModule);  // the custom widgets may be used without an instance.
 	
 	GldiModuleInstance *pModuleInstance = (pInstance ? pInstance : pModule->pInstancesList != NULL ? pModule->pInstancesList->data : NULL);  // can be NULL if the module is not yet activated.
 	ModuleWidget *pModuleWidget = g_new0 (ModuleWidget, 1);
@@ -66,6 +66,8 @@
 #include "cairo-dock-themes-manager.h"
 #include "cairo-dock-dialog-factory.h"
 #include "cairo-dock-keyfile-utilities.h"
+#include "cairo-dock-theme-snapshot.h"  // gldi_theme_snapshot_enable
+#include "cairo-dock-trace.h"  // gldi_trace_start
 #include "cairo-dock-config.h"
 #include "cairo-dock-file-manager.h"
 #include "cairo-dock-log.h"
@@ -369,8 +371,10 @@ int main (int argc, char** argv)
 	//\___________________ get app's options.
 	gboolean bSafeMode = FALSE, bMaintenance = FALSE, bNoSticky = FALSE, bCappuccino = FALSE, bPrintVersion = FALSE,
 	bTesting = FALSE, bForceOpenGL = FALSE, bToggleIndirectRendering = FALSE, bKeepAbove = FALSE, bForceColors = FALSE,
-	bAskBackend = FALSE, bTransparencyWorkaround = FALSE, bAllowMultiInstance = FALSE, bNoDBusName = FALSE;
-	gchar *cEnvironment = NULL, *cUserDefinedDataDir = NULL, *cVerbosity = 0, *cUserDefinedModuleDir = NULL, *cExcludeModule = NULL, *cThemeServerAdress = NULL;
+	bAskBackend = FALSE, bTransparencyWorkaround = FALSE, bAllowMultiInstance = FALSE, bNoDBusName = FALSE, bProfileNotifications = FALSE,
+	bThemeSnapshot = FALSE;
+	gchar *cEnvironment = NULL, *cUserDefinedDataDir = NULL, *cVerbosity = 0, *cUserDefinedModuleDir = NULL, *cExcludeModule = NULL, *cThemeServerAdress = NULL,
+	*cTraceFile = NULL;
 	int iDelay = 0;
 	GOptionEntry pOptionsTable[] =
 	{
@@ -483,6 +487,15 @@ int main (int argc, char** argv)
 		{"force-gio-launch", 0, G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
 			&g_bGioLaunch,
 			_("For debugging purposes only. Rely on GIO to launch apps instead of our own implementation (implies --disable-systemd)."), NULL},
+		{"profile-notifications", 0, G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
+			&bProfileNotifications,
+			_("For debugging purposes only. Measure the time spent in each notification callback, and print a report on exit."), NULL},
+		{"theme-snapshot", 0, G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
+			&bThemeSnapshot,
+			_("Keep a snapshot of the conf files of the current theme, to load it faster at the next startup."), NULL},
+		{"trace-startup", 0, G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_FILENAME,
+			&cTraceFile,
+			_("For debugging purposes only. Record the time spent in each step of the startup, and write it into this file in the trace-event JSON format."), "FILE"},
 		{NULL, 0, 0, 0,
 			NULL,
 			NULL, NULL}
@@ -536,6 +549,18 @@ int main (int argc, char** argv)
 	if (bForceColors)
 		cd_log_force_use_color ();
 	
+	if (bProfileNotifications)
+		gldi_object_enable_notifications_profile (TRUE);
+	
+	if (bThemeSnapshot)
+		gldi_theme_snapshot_enable (TRUE);
+	
+	if (cTraceFile != NULL)
+	{
+		gldi_trace_start (cTraceFile);
+		g_free (cTraceFile);
+	}
+	
 	CairoDockDesktopEnv iDesktopEnv = CAIRO_DOCK_UNKNOWN_ENV;
 	if (cEnvironment != NULL)
 	{
@@ -603,7 +628,9 @@ int main (int argc, char** argv)
 	
 	//\___________________ initialize libgldi.
 	GldiRenderingMethod iRendering = (bForceOpenGL ? GLDI_OPENGL : g_bForceCairo ? GLDI_CAIRO : GLDI_DEFAULT);
+	gint64 iStartTime = gldi_trace_begin ();
 	gldi_init (iRendering);
+	gldi_trace_end ("startup", "gldi_init", NULL, iStartTime);
 	
 	//\___________________ set custom user options.
 	if (bKeepAbove)
@@ -1049,6 +1076,13 @@ int main (int argc, char** argv)
 	signal (SIGABRT, NULL);
 	signal (SIGTERM, NULL);
 	signal (SIGHUP, NULL);
+	
+	if (bProfileNotifications)  // print it before the modules are unloaded, so that callbacks can still be resolved.
+	{
+		gchar *cReport = gldi_object_get_notifications_profile (0);
+		g_print ("\n ============================ notifications profile ============================\n%s", cReport);
+		g_free (cReport);
+	}
 
 	gldi_free_all ();
 
@@ -138,6 +138,225 @@ gfloat cairo_dock_calculate_magnitude (gint iMagnitudeIndex)  // merci a Robrob
 }
 
 
+  ///////////////////////
+ /// FRAME SCHEDULER ///
+///////////////////////
+
+/* All animated containers share a single frame scheduler: on each tick, every container whose animation step is due runs its animation loop, so that all docks, desklets and dialogs are updated together instead of each waking the main loop on its own schedule.
+ * The tick is driven by the frame clock of one of the animated windows (synchronized with the display refresh), and falls back to a timer when no such window is available or its clock stalls (unmapped window, compositor not sending frame callbacks).
+ * When nothing moves anymore, everything is stopped.
+ */
+
+#define CD_FRAME_CLOCK_WATCHDOG 250  // ms without a tick before we fall back to the timer
+
+typedef struct {
+	GldiContainer *pContainer;
+	gint64 iNextStepTime;  // us
+	gboolean bRemoved;
+	} CairoDockFrameSubscriber;
+
+static GPtrArray *s_pFrameSubscribers = NULL;
+static GSList *s_pRemovedSubscribers = NULL;  // removed while ticking, freed at the end of the tick
+static gboolean s_bTicking = FALSE;
+static guint s_iLastSubscriptionId = 0;
+// frame clock driver
+static GdkFrameClock *s_pFrameClock = NULL;
+static GldiContainer *s_pFrameClockContainer = NULL;
+static gulong s_iSidFrameClockUpdate = 0;
+static gint64 s_iLastFrameClockTick = 0;
+static guint s_iSidFrameClockWatchdog = 0;
+// timer driver
+static guint s_iSidFrameTimer = 0;
+static gint s_iFrameTimerInterval = 0;
+
+static void _update_frame_scheduler (void);
+
+static gint _get_min_delta_t (void)
+{
+	gint iMinDeltaT = G_MAXINT;
+	guint i;
+	for (i = 0; i < s_pFrameSubscribers->len; i ++)
+	{
+		CairoDockFrameSubscriber *pSubscriber = g_ptr_array_index (s_pFrameSubscribers, i);
+		iMinDeltaT = MIN (iMinDeltaT, MAX (1, cairo_dock_get_animation_delta_t (pSubscriber->pContainer)));
+	}
+	return iMinDeltaT;
+}
+
+static void _remove_subscriber (guint i)
+{
+	CairoDockFrameSubscriber *pSubscriber = g_ptr_array_index (s_pFrameSubscribers, i);
+	g_ptr_array_remove_index (s_pFrameSubscribers, i);
+	if (pSubscriber->pContainer == s_pFrameClockContainer)
+		s_pFrameClockContainer = NULL;  // the driver will be replaced in _update_frame_scheduler
+	if (s_bTicking)
+	{
+		pSubscriber->bRemoved = TRUE;
+		s_pRemovedSubscribers = g_slist_prepend (s_pRemovedSubscribers, pSubscriber);
+	}
+	else
+		g_free (pSubscriber);
+}
+
+static gint _find_subscriber (GldiContainer *pContainer)
+{
+	guint i;
+	for (i = 0; i < s_pFrameSubscribers->len; i ++)
+	{
+		CairoDockFrameSubscriber *pSubscriber = g_ptr_array_index (s_pFrameSubscribers, i);
+		if (pSubscriber->pContainer == pContainer)
+			return i;
+	}
+	return -1;
+}
+
+static void _frame_tick (gint64 iNow, gint64 iTolerance)
+{
+	// take a snapshot, since any animation loop can start or stop other animations (or destroy other containers).
+	guint n = s_pFrameSubscribers->len;
+	CairoDockFrameSubscriber **pSnapshot = g_newa (CairoDockFrameSubscriber*, n);
+	memcpy (pSnapshot, s_pFrameSubscribers->pdata, n * sizeof (gpointer));
+	
+	s_bTicking = TRUE;
+	guint i;
+	for (i = 0; i < n; i ++)
+	{
+		CairoDockFrameSubscriber *pSubscriber = pSnapshot[i];
+		if (pSubscriber->bRemoved || iNow + iTolerance < pSubscriber->iNextStepTime)
+			continue;
+		
+		// schedule the next step; keep the average pace of the container, unless we're too late.
+		GldiContainer *pContainer = pSubscriber->pContainer;
+		gint64 iDeltaT = MAX (1, cairo_dock_get_animation_delta_t (pContainer)) * 1000;
+		pSubscriber->iNextStepTime += iDeltaT;
+		if (pSubscriber->iNextStepTime < iNow)
+			pSubscriber->iNextStepTime = iNow + iDeltaT;
+		
+		gboolean bContinue = pContainer->iface.animation_loop (pContainer);
+		if (! bContinue && ! pSubscriber->bRemoved)  // the animation is over (if the container has been destroyed, it's already unsubscribed).
+		{
+			pContainer->iSidGLAnimation = 0;
+			gint j = _find_subscriber (pContainer);
+			if (j >= 0)
+				_remove_subscriber (j);
+		}
+	}
+	s_bTicking = FALSE;
+	
+	g_slist_free_full (s_pRemovedSubscribers, g_free);
+	s_pRemovedSubscribers = NULL;
+	_update_frame_scheduler ();
+}
+
+static void _on_frame_clock_update (GdkFrameClock *pFrameClock, G_GNUC_UNUSED gpointer data)
+{
+	gint64 iRefreshInterval = 0;
+	s_iLastFrameClockTick = gdk_frame_clock_get_frame_time (pFrameClock);
+	gdk_frame_clock_get_refresh_info (pFrameClock, s_iLastFrameClockTick, &iRefreshInterval, NULL);
+	_frame_tick (s_iLastFrameClockTick, iRefreshInterval / 2);  // run a step if it's due before the middle of the next frame.
+}
+
+static gboolean _on_frame_timer (G_GNUC_UNUSED gpointer data)
+{
+	_frame_tick (g_get_monotonic_time (), 1000);
+	return TRUE;  // _update_frame_scheduler removes us when needed.
+}
+
+static void _stop_frame_clock (void)
+{
+	if (s_pFrameClock != NULL)
+	{
+		g_signal_handler_disconnect (s_pFrameClock, s_iSidFrameClockUpdate);
+		gdk_frame_clock_end_updating (s_pFrameClock);
+		g_object_unref (s_pFrameClock);
+		s_pFrameClock = NULL;
+		s_iSidFrameClockUpdate = 0;
+	}
+	s_pFrameClockContainer = NULL;
+	if (s_iSidFrameClockWatchdog != 0)
+	{
+		g_source_remove (s_iSidFrameClockWatchdog);
+		s_iSidFrameClockWatchdog = 0;
+	}
+}
+
+static void _stop_frame_timer (void)
+{
+	if (s_iSidFrameTimer != 0)
+	{
+		g_source_remove (s_iSidFrameTimer);
+		s_iSidFrameTimer = 0;
+		s_iFrameTimerInterval = 0;
+	}
+}
+
+static void _start_frame_timer (void)
+{
+	gint iInterval = _get_min_delta_t ();
+	if (s_iSidFrameTimer != 0 && s_iFrameTimerInterval == iInterval)
+		return;
+	_stop_frame_timer ();
+	s_iFrameTimerInterval = iInterval;
+	s_iSidFrameTimer = g_timeout_add (iInterval, _on_frame_timer, NULL);
+}
+
+static gboolean _check_frame_clock (G_GNUC_UNUSED gpointer data)
+{
+	if (g_get_monotonic_time () - s_iLastFrameClockTick > CD_FRAME_CLOCK_WATCHDOG * 1000)  // the clock doesn't tick anymore, use the timer.
+	{
+		cd_debug ("frame clock stalled, falling back to the timer");
+		s_iSidFrameClockWatchdog = 0;
+		_stop_frame_clock ();
+		_start_frame_timer ();
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static gboolean _start_frame_clock (void)
+{
+	guint i;
+	for (i = 0; i < s_pFrameSubscribers->len; i ++)
+	{
+		CairoDockFrameSubscriber *pSubscriber = g_ptr_array_index (s_pFrameSubscribers, i);
+		GtkWidget *pWidget = pSubscriber->pContainer->pWidget;
+		if (pWidget == NULL || ! gtk_widget_get_mapped (pWidget))
+			continue;
+		GdkFrameClock *pFrameClock = gtk_widget_get_frame_clock (pWidget);
+		if (pFrameClock == NULL)
+			continue;
+		
+		s_pFrameClock = g_object_ref (pFrameClock);
+		s_pFrameClockContainer = pSubscriber->pContainer;
+		s_iSidFrameClockUpdate = g_signal_connect (pFrameClock, "update", G_CALLBACK (_on_frame_clock_update), NULL);
+		gdk_frame_clock_begin_updating (pFrameClock);
+		s_iLastFrameClockTick = g_get_monotonic_time ();
+		s_iSidFrameClockWatchdog = g_timeout_add (CD_FRAME_CLOCK_WATCHDOG, _check_frame_clock, NULL);
+		return TRUE;
+	}
+	return FALSE;
+}
+
+static void _update_frame_scheduler (void)
+{
+	if (s_bTicking)  // will be done at the end of the tick
+		return;
+	if (s_pFrameSubscribers->len == 0)  // nothing moves, sleep.
+	{
+		_stop_frame_clock ();
+		_stop_frame_timer ();
+		return;
+	}
+	if (s_pFrameClockContainer == NULL)  // no driver yet, or it's not animated anymore.
+	{
+		_stop_frame_clock ();
+		if (s_iSidFrameTimer == 0 && _start_frame_clock ())
+			return;
+	}
+	if (s_pFrameClock == NULL)
+		_start_frame_timer ();
+}
+
 void cairo_dock_launch_animation (GldiContainer *pContainer)
 {
 	if (pContainer->iSidGLAnimation == 0 && pContainer->iface.animation_loop != NULL)
@@ -145,7 +364,30 @@ void cairo_dock_launch_animation (GldiContainer *pContainer)
 		int iAnimationDeltaT = cairo_dock_get_animation_delta_t (pContainer);
 		pContainer->bKeepSlowAnimation = TRUE;
 		
-		pContainer->iSidGLAnimation = g_timeout_add (iAnimationDeltaT, (GSourceFunc)pContainer->iface.animation_loop, pContainer);
+		if (s_pFrameSubscribers == NULL)
+			s_pFrameSubscribers = g_ptr_array_new ();
+		CairoDockFrameSubscriber *pSubscriber = g_new0 (CairoDockFrameSubscriber, 1);
+		pSubscriber->pContainer = pContainer;
+		pSubscriber->iNextStepTime = g_get_monotonic_time () + MAX (1, iAnimationDeltaT) * 1000;
+		g_ptr_array_add (s_pFrameSubscribers, pSubscriber);
+		
+		if (++ s_iLastSubscriptionId == 0)  // 0 means "not animated"
+			s_iLastSubscriptionId = 1;
+		pContainer->iSidGLAnimation = s_iLastSubscriptionId;
+		_update_frame_scheduler ();
+	}
+}
+
+void cairo_dock_stop_animation (GldiContainer *pContainer)
+{
+	if (pContainer->iSidGLAnimation == 0)
+		return;
+	pContainer->iSidGLAnimation = 0;
+	gint i = _find_subscriber (pContainer);
+	if (i >= 0)
+	{
+		_remove_subscriber (i);
+		_update_frame_scheduler ();
 	}
 }
 
@@ -112,11 +112,16 @@ void cairo_dock_pop_down (CairoDock *pDock);
 
 gfloat cairo_dock_calculate_magnitude (gint iMagnitudeIndex);
 
-/** Launch the animation of a Container.
+/** Launch the animation of a Container. Its animation loop will be called every iAnimationDeltaT ms, in sync with the other animated containers and with the display refresh, until it returns FALSE.
 *@param pContainer the container to animate.
 */
 void cairo_dock_launch_animation (GldiContainer *pContainer);
 
+/** Stop the animation of a Container, if it was running. Animation loops don't need it, they just return FALSE.
+*@param pContainer the container.
+*/
+void cairo_dock_stop_animation (GldiContainer *pContainer);
+
 void cairo_dock_start_shrinking (CairoDock *pDock);
 
 void cairo_dock_start_growing (CairoDock *pDock);
@@ -212,7 +212,7 @@ CD_APPLET_POST_LOAD_PROTO \
 * \ref CD_APPLET_DEFINE2_BEGIN and \ref CD_APPLET_DEFINE2_END instead.
 */
 #define CD_APPLET_DEFINITION2(cName, iFlags, iAppletCategory, cDescription, cAuthor) \
-CD_APPLET_DEFINE2_BEGIN (cName, iFlags, iAppletCategory, cDescription, cAuthor) \
+CD_APPLET_DEFINE2_BEGIN (cName, (iFlags) | CAIRO_DOCK_MODULE_DEFERRED_LOADING, iAppletCategory, cDescription, cAuthor) \
 CD_APPLET_DEFINE_COMMON_APPLET_INTERFACE \
 CD_APPLET_DEFINE2_END
 
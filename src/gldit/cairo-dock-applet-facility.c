@@ -43,6 +43,7 @@
 #include "cairo-dock-backends-manager.h"
 #include "cairo-dock-dock-facility.h"
 #include "cairo-dock-dock-priv.h"
+#include "cairo-dock-dock-geometry-priv.h"  // gldi_dock_invalidate_geometry
 #include "cairo-dock-icon-facility.h"
 #include "cairo-dock-applet-facility.h"
 
@@ -444,6 +445,7 @@ void cairo_dock_remove_all_icons_from_applet (GldiModuleInstance *pInstance)
 			cd_debug (" destroy sub-dock icons");
 			GList *icons = pIcon->pSubDock->icons;
 			pIcon->pSubDock->icons = NULL;
+			gldi_dock_invalidate_geometry (pIcon->pSubDock);
 			GList *ic;
 			Icon *icon;
 			for (ic = icons; ic != NULL; ic = ic->next)
@@ -58,7 +58,7 @@ static void _gldi_appli_icon_demands_attention (Icon *icon, CairoDock *pDock, gb
 		{
 			pDialog = gldi_dialog_show_temporary (pHiddenIcon->cName, icon, CAIRO_CONTAINER (pDock), 1000*myTaskbarParam.iDialogDuration); // mieux vaut montrer pas d'icone dans le dialogue que de montrer une icone qui n'a pas de rapport avec l'appli demandant l'attention.
 			g_return_if_fail (pDialog != NULL);
-			gldi_dialog_set_icon_surface (pDialog, pHiddenIcon->image.pSurface, pDialog->iIconSize);
+			gldi_dialog_set_icon_surface (pDialog, cairo_dock_image_buffer_get_surface (&pHiddenIcon->image), pDialog->iIconSize);
 		}
 		if (pDialog && bForceDemand)
 		{
@@ -498,7 +498,7 @@ const CairoDockImageBuffer *gldi_appli_icon_get_image_buffer (Icon *pIcon)
 	static CairoDockImageBuffer image;
 	
 	// if the given icon is not loaded
-	if (pIcon->image.pSurface == NULL)
+	if (cairo_dock_image_buffer_get_surface (&pIcon->image) == NULL)
 	{
 		// try to get the image from the class
 		const CairoDockImageBuffer *pImageBuffer = cairo_dock_get_class_image_buffer (pIcon->cClass);
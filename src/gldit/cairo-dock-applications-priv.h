@@ -78,6 +78,7 @@ struct _CairoTaskbarParam {
 	CairoTaskbarPlacement iIconPlacement;
 	gchar *cRelativeIconName;
 	gboolean bSeparateApplis;
+	gint iIconUpdateDelay;  // ms
 	} ;
 
 // signals
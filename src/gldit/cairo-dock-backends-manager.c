@@ -31,6 +31,7 @@
 #include "cairo-dock-dock-manager.h"
 #include "cairo-dock-container-priv.h"
 #include "cairo-dock-config.h"
+#include "cairo-dock-dock-geometry-priv.h"  // gldi_dock_invalidate_geometry
 #include "cairo-dock-backends-manager.h"
 
 // public (manager, config, data)
@@ -256,6 +257,7 @@ void cairo_dock_set_renderer (CairoDock *pDock, const gchar *cRendererName)
 		pDock->pRendererData = NULL;
 	}
 	pDock->pRenderer = cairo_dock_get_renderer (cRendererName, (pDock->iRefCount == 0));
+	gldi_dock_invalidate_geometry (pDock);  // forget which icon the previous view found pointed
 	
 	pDock->fMagnitudeMax = 1.;
 	pDock->container.bUseReflect = pDock->pRenderer->bUseReflect;
@@ -266,8 +268,7 @@ void cairo_dock_set_renderer (CairoDock *pDock, const gchar *cRendererName)
 		pDock->container.iAnimationDeltaT = 30;  // le main dock est cree avant meme qu'on ait recupere la valeur en conf. Lorsqu'une vue lui sera attribuee, la bonne valeur sera renseignee, en attendant on met un truc non nul.
 	if (iAnimationDeltaT != pDock->container.iAnimationDeltaT && pDock->container.iSidGLAnimation != 0)
 	{
-		g_source_remove (pDock->container.iSidGLAnimation);
-		pDock->container.iSidGLAnimation = 0;
+		cairo_dock_stop_animation (CAIRO_CONTAINER (pDock));
 		cairo_dock_launch_animation (CAIRO_CONTAINER (pDock));
 	}
 	if (pDock->cRendererName != cRendererName)  // NULL ecrase le nom de l'ancienne vue.
@@ -54,9 +54,7 @@ static void _load_image (Icon *icon)
 			{
 				Icon *pOneIcon = (Icon *) (g_list_last ((GList*)pApplis)->data);  // on prend le dernier car les applis sont inserees a l'envers, et on veut avoir celle qui etait deja present dans le dock (pour 2 raisons : continuite, et la nouvelle (en 1ere position) n'est pas forcement deja dans un dock, ce qui fausse le ratio).
 				cd_debug ("  load from %s (%dx%d)", pOneIcon->cName, iWidth, iHeight);
-				pSurface = cairo_dock_duplicate_surface (pOneIcon->image.pSurface,
-					pOneIcon->image.iWidth,
-					pOneIcon->image.iHeight,
+				pSurface = cairo_dock_image_buffer_copy_scale (&pOneIcon->image,
 					iWidth,
 					iHeight);  /// could make a gldi_image_buffer_load_from_buffer (&pOneIcon->image, iWidth, iHeight) and duplicate the texture only...
 			}
@@ -1535,9 +1535,7 @@ cairo_surface_t *cairo_dock_create_surface_from_class (const gchar *cClass, int
 				if (pInhibitorIcon->pSubDock == NULL || myIndicatorsParam.bUseClassIndic)  // in the case where a launcher has more than one instance of its class and which represents the stack, we doesn't take the icon.
 				{
 					cd_debug ("%s will give its surface", pInhibitorIcon->cName);
-					return cairo_dock_duplicate_surface (pInhibitorIcon->image.pSurface,
-						pInhibitorIcon->image.iWidth,
-						pInhibitorIcon->image.iHeight,
+					return cairo_dock_image_buffer_copy_scale (&pInhibitorIcon->image,
 						iWidth,
 						iHeight);
 				}
@@ -2441,7 +2439,7 @@ const CairoDockImageBuffer *cairo_dock_get_class_image_buffer (const gchar *cCla
 	for (ic = pClassAppli->pIconsOfClass; ic != NULL; ic = ic->next)
 	{
 		pIcon = ic->data;
-		if (CAIRO_DOCK_ICON_TYPE_IS_LAUNCHER (pIcon) && pIcon->image.pSurface)  // avoid applets
+		if (CAIRO_DOCK_ICON_TYPE_IS_LAUNCHER (pIcon) && cairo_dock_image_buffer_get_surface (&pIcon->image))  // avoid applets
 		{
 			memcpy (&image, &pIcon->image, sizeof (CairoDockImageBuffer));
 			return &image;
@@ -2450,7 +2448,7 @@ const CairoDockImageBuffer *cairo_dock_get_class_image_buffer (const gchar *cCla
 	for (ic = pClassAppli->pAppliOfClass; ic != NULL; ic = ic->next)
 	{
 		pIcon = ic->data;
-		if (pIcon->image.pSurface)
+		if (cairo_dock_image_buffer_get_surface (&pIcon->image))
 		{
 			memcpy (&image, &pIcon->image, sizeof (CairoDockImageBuffer));
 			return &image;
@@ -2530,75 +2528,10 @@ static GDesktopAppInfo *_search_desktop_file (const gchar *cDesktopFile, gboolea
 		return app; // can be NULL
 	}
 	
-	// handle potential partial matches and special cases
-	
-	/* #0: special casing for apps with known problems */
-	
-	/* #0.1: Gnome Terminal, required at least on Ubuntu 22.04 and 24.04
-	 * (should be fixed in newer versions, see e.g. here: https://gitlab.gnome.org/GNOME/gnome-terminal/-/issues/8033)
-	 */
-	if (!strcmp (cDesktopFile, "gnome-terminal-server"))
-	{
-		const char *tmpkey = "org.gnome.terminal";
-		app = gldi_desktop_file_db_lookup (tmpkey, TRUE); // we want exact match for org.gnome.terminal.desktop
-		if (app)
-		{
-			g_free (tmp_to_free); // can be NULL
-			return g_object_ref (app);
-		}
-	}
-	/* #0.2: gted -> org.gnome.TextEditor.desktop, required at least on Ubuntu 24.04.
-	 * Note: issue only exists in X11 where WM_CLASS is the program name for most GTK4 apps,
-	 * as opposed to Wayland where the "application-id" is used; see details here:
-	 * https://gitlab.gnome.org/GNOME/gtk/-/work_items/8296
-	 * In this case, normally, WM_CLASS would be "gnome-text-editor", which is correctly
-	 * matched based on the Exec= key in the .desktop file. However, on Ubuntu 24.04, "gted"
-	 * exists as a symlink and if it is used to launch the app, WM_CLASS will also be set to
-	 * "gted" that is not possible to match with normal methods.
-	 */
-	if (!strcmp (cDesktopFile, "gted"))
-	{
-		const char *tmpkey = "org.gnome.texteditor";
-		app = gldi_desktop_file_db_lookup (tmpkey, TRUE); // we want exact match
-		if (app)
-		{
-			g_free (tmp_to_free); // can be NULL
-			return g_object_ref (app);
-		}
-	}
-	
-	GString *sID = g_string_new (NULL);
-	
-	/* #1: add common prefices
-	 * e.g. org.gnome.Evince.desktop, but app-id is only evince on Ubuntu 22.04 and 24.04
-	 * More generally, this can happen with GTK+3 apps that have only "partially" migrated
-	 * to using the "new" (reverse DNS style) .desktop format.
-	 * See e.g.
-	 * https://gitlab.gnome.org/GNOME/gtk/-/issues/2822
-	 * https://gitlab.gnome.org/GNOME/gtk/-/issues/2034
-	 * https://honk.sigxcpu.org/con/GTK__and_the_application_id.html
-	 * https://docs.gtk.org/gtk4/migrating-3to4.html#set-a-proper-application-id
-	 */
-	const char *prefices[] = {"org.gnome.", "org.kde.", "org.freedesktop.", NULL};
-	int j;
-	
-	for (j = 0; prefices[j]; j++)
-	{
-		g_string_printf (sID, "%s%s", prefices[j], cDesktopFile);
-		app = gldi_desktop_file_db_lookup (sID->str, TRUE); // we want exact match for the file name
-		if (app) break;
-	}
-	
-	if (!app)
-	{
-		// #2: snap "namespaced" names -- these could be anything, we just handle the "common" case where
-		// simply the app-id is duplicated (e.g. "firefox_firefox.desktop" as on Ubuntu 22.04 and 24.04)
-		g_string_printf (sID, "%s_%s", cDesktopFile, cDesktopFile);
-		app = gldi_desktop_file_db_lookup (sID->str, TRUE); // we want exact match for the file name
-	}
+	// handle potential partial matches and special cases: they are indexed by the DB (see gldi_desktop_file_db_lookup_variant ())
+	app = gldi_desktop_file_db_lookup_variant (cDesktopFile);
 	
 	g_free (tmp_to_free); // can be null
-	g_string_free(sID, TRUE);
 	if (app) g_object_ref (app);
 	return app;
 }
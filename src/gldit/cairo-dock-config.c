@@ -53,6 +53,8 @@ static char DES_crypt_key[64] =
 #include "cairo-dock-file-manager.h"  // cairo_dock_get_file_size
 #include "cairo-dock-user-icon-manager.h"  // gldi_user_icons_new_from_directory
 #include "cairo-dock-core.h"  // gldi_free_all
+#include "cairo-dock-theme-snapshot.h"  // gldi_theme_snapshot_begin
+#include "cairo-dock-trace.h"
 #include "cairo-dock-config.h"
 
 gboolean g_bEasterEggs = FALSE;
@@ -452,36 +454,62 @@ void cairo_dock_load_current_theme (void)
 {
 	cd_message ("%s ()", __func__);
 	s_bLoading = TRUE;
+	gint64 iThemeStartTime = gldi_trace_begin ();
+	gint64 iStartTime;
 	
 	//\___________________ Free everything.
+	iStartTime = gldi_trace_begin ();
 	gldi_free_all ();  // do nothing if there is nothing to unload.
-		
+	gldi_trace_end ("theme", "free all", NULL, iStartTime);
+	
+	//\___________________ Read the conf files from the snapshot of the theme, if enabled.
+	gldi_theme_snapshot_begin ();
+	
 	//\___________________ Get all managers config.
+	iStartTime = gldi_trace_begin ();
 	gldi_managers_get_config (g_cConfFile, GLDI_VERSION);  /// en fait, CAIRO_DOCK_VERSION ...
+	gldi_trace_end ("theme", "get managers config", NULL, iStartTime);
 	
 	//\___________________ Load config for auto-loaded modules (these represent core modules,
 	//  including dock-rendering, whose config is needed in the next step).
+	iStartTime = gldi_trace_begin ();
 	gldi_modules_load_auto_config ();
+	gldi_trace_end ("theme", "get auto-loaded modules config", NULL, iStartTime);
 	
 	//\___________________ Create the primary container (needed to have a cairo/opengl context).
+	iStartTime = gldi_trace_begin ();
 	CairoDock *pMainDock = gldi_dock_new (CAIRO_DOCK_MAIN_DOCK_NAME);
+	gldi_trace_end ("theme", "create main dock", NULL, iStartTime);
 	
 	//\___________________ Load all managers data.
+	iStartTime = gldi_trace_begin ();
 	gldi_managers_load ();
+	gldi_trace_end ("theme", "load managers", NULL, iStartTime);
+	iStartTime = gldi_trace_begin ();
 	gldi_modules_activate_all (TRUE); // TRUE -> only load auto-loaded modules before loading anything (views, etc)
+	gldi_trace_end ("theme", "activate auto-loaded modules", NULL, iStartTime);
 	
 	//\___________________ Now load the user icons (launchers, etc).
+	iStartTime = gldi_trace_begin ();
 	gldi_user_icons_new_from_directory (g_cCurrentLaunchersPath);
+	gldi_trace_end ("theme", "gldi_user_icons_new_from_directory", NULL, iStartTime);
 	
 	cairo_dock_hide_show_launchers_on_other_desktops ();
 	
 	//\___________________ Load the applets.
+	iStartTime = gldi_trace_begin ();
 	gldi_modules_activate_all (FALSE); // FALSE -> load everything
+	gldi_trace_end ("theme", "activate modules", NULL, iStartTime);
 	
 	//\___________________ Start the applications manager (will load the icons if the option is enabled).
+	iStartTime = gldi_trace_begin ();
 	cairo_dock_start_applications_manager (pMainDock);
+	gldi_trace_end ("theme", "start applications manager", NULL, iStartTime);
+	
+	gldi_theme_snapshot_end ();  // rewrites the snapshot if some conf files have changed.
 	
 	s_bLoading = FALSE;
+	gldi_trace_end ("theme", "cairo_dock_load_current_theme", NULL, iThemeStartTime);
 }
 
 
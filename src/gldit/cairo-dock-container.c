@@ -37,6 +37,7 @@
 #include "cairo-dock-animations.h"  // cairo_dock_animation_will_be_visible
 #include "cairo-dock-desktop-manager.h"  // gldi_desktop_get_width
 #include "cairo-dock-menu.h"  // gldi_menu_new
+#include "cairo-dock-dock-hud.h"  // gldi_dock_hud_count_redraw
 #include "cdwindow.h"
 #define _MANAGER_DEF_
 #include "cairo-dock-container-priv.h"
@@ -212,7 +213,11 @@ static inline void _redraw_container_area (GldiContainer *pContainer, GdkRectang
 		pArea->width = pContainer->iHeight - pArea->x;
 	
 	if (pArea->width > 0 && pArea->height > 0)
+	{
 		gdk_window_invalidate_rect (gldi_container_get_gdk_window (pContainer), pArea, FALSE);
+		gldi_gl_container_add_damage (pContainer, pArea);
+		gldi_dock_hud_count_redraw (pContainer);
+	}
 }
 
 void cairo_dock_redraw_container_area (GldiContainer *pContainer, GdkRectangle *pArea)
@@ -878,11 +883,7 @@ static void reset_object (GldiObject *obj)
 	pContainer->pWidget = NULL;
 	
 	// stop the animation loop
-	if (pContainer->iSidGLAnimation != 0)
-	{
-		g_source_remove (pContainer->iSidGLAnimation);
-		pContainer->iSidGLAnimation = 0;
-	}
+	cairo_dock_stop_animation (pContainer);
 	
 	if (g_pPrimaryContainer == pContainer)
 		g_pPrimaryContainer = NULL;
@@ -168,6 +168,7 @@ struct _GldiContainer {
 	/// a wl_egl_window (needed on Wayland + EGL)
 	void *eglwindow;
 	
+	/// reserved[0] is used by the core to keep the OpenGL damage of the container (see gldi_gl_container_get_damage).
 	gpointer reserved[2];
 };
 
@@ -58,6 +58,7 @@
 #include "cairo-dock-icon-container.h"
 #include "cairo-dock-utils.h"  // cairo_dock_get_version_from_string
 #include "cairo-dock-file-manager.h"
+#include "cairo-dock-draw-opengl.h"  // cairo_dock_set_core_icon_renderers
 #include "cairo-dock-overlay.h"
 #include "cairo-dock-log.h"
 #include "cairo-dock-opengl-priv.h"
@@ -121,6 +122,7 @@ void gldi_init (GldiRenderingMethod iRendering)
 	_gldi_register_core_managers ();
 	
 	gldi_managers_init ();
+	cairo_dock_set_core_icon_renderers ();  // now that the managers have registered their callbacks
 	
 	// register internal backends.
 	cairo_dock_register_built_in_data_renderers ();
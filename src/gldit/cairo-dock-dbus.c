@@ -21,6 +21,14 @@
 #include <glib.h>
 
 #include "cairo-dock-log.h"
+#include "cairo-dock-object.h"  // notifications profile
+#include "cairo-dock-dock-hud.h"  // gldi_docks_show_hud
+#include "cairo-dock-image-cache.h"  // cairo_dock_image_cache_get_report
+#include "cairo-dock-image-buffer.h"  // cairo_dock_get_image_memory_report
+#include "cairo-dock-icon-manager.h"  // cairo_dock_get_icon_path_cache_report
+#include "cairo-dock-config.h"  // cairo_dock_load_current_theme
+#include "cairo-dock-trace.h"  // gldi_trace_start
+#include "cairo-dock-X-manager.h"  // gldi_X_manager_get_events_report
 #include "cairo-dock-dbus-priv.h"
 
 
@@ -44,9 +52,152 @@ const gchar *cairo_dock_dbus_get_owned_name (void)
 	return s_bNameOwned ? s_cBusName : NULL;
 }
 
+  /////////////
+ /// DEBUG ///
+/////////////
+
+// Diagnostic methods of the core, exported on their own path so that they don't clash with the interface of the DBus applet.
+static const gchar *s_cDebugObjectPath = "/org/cairodock/CairoDock/Debug";
+static const gchar s_cDebugInterfaceXml[] =
+	"<node>"
+	"  <interface name='org.cairodock.CairoDock.Debug'>"
+	"    <method name='EnableNotificationsProfile'>"
+	"      <arg type='b' name='enable' direction='in'/>"
+	"    </method>"
+	"    <method name='ResetNotificationsProfile'/>"
+	"    <method name='GetNotificationsProfile'>"
+	"      <arg type='u' name='max_lines' direction='in'/>"
+	"      <arg type='s' name='report' direction='out'/>"
+	"    </method>"
+	"    <method name='ShowDocksHud'>"
+	"      <arg type='b' name='show' direction='in'/>"
+	"    </method>"
+	"    <method name='GetImageCacheStats'>"
+	"      <arg type='s' name='report' direction='out'/>"
+	"    </method>"
+	"    <method name='GetMemoryReport'>"
+	"      <arg type='s' name='report' direction='out'/>"
+	"    </method>"
+	"    <method name='GetIconPathCacheStats'>"
+	"      <arg type='s' name='report' direction='out'/>"
+	"    </method>"
+	"    <method name='TraceThemeReload'>"
+	"      <arg type='s' name='file' direction='in'/>"
+	"    </method>"
+	"    <method name='GetXEventsStats'>"
+	"      <arg type='s' name='report' direction='out'/>"
+	"    </method>"
+	"  </interface>"
+	"</node>";
+
+static gboolean _reload_theme_idle (G_GNUC_UNUSED gpointer data)
+{
+	cairo_dock_load_current_theme ();
+	return FALSE;
+}
+
+static void _on_debug_method_call (G_GNUC_UNUSED GDBusConnection *pConn,
+	G_GNUC_UNUSED const gchar *cSender,
+	G_GNUC_UNUSED const gchar *cObjectPath,
+	G_GNUC_UNUSED const gchar *cInterfaceName,
+	const gchar *cMethodName,
+	GVariant *pParameters,
+	GDBusMethodInvocation *pInvocation,
+	G_GNUC_UNUSED gpointer data)
+{
+	if (strcmp (cMethodName, "EnableNotificationsProfile") == 0)
+	{
+		gboolean bEnable;
+		g_variant_get (pParameters, "(b)", &bEnable);
+		gldi_object_enable_notifications_profile (bEnable);
+		g_dbus_method_invocation_return_value (pInvocation, NULL);
+	}
+	else if (strcmp (cMethodName, "ResetNotificationsProfile") == 0)
+	{
+		gldi_object_reset_notifications_profile ();
+		g_dbus_method_invocation_return_value (pInvocation, NULL);
+	}
+	else if (strcmp (cMethodName, "GetNotificationsProfile") == 0)
+	{
+		guint iMaxLines;
+		g_variant_get (pParameters, "(u)", &iMaxLines);
+		gchar *cReport = gldi_object_get_notifications_profile (iMaxLines);
+		g_dbus_method_invocation_return_value (pInvocation, g_variant_new ("(s)", cReport));
+		g_free (cReport);
+	}
+	else if (strcmp (cMethodName, "ShowDocksHud") == 0)
+	{
+		gboolean bShow;
+		g_variant_get (pParameters, "(b)", &bShow);
+		gldi_docks_show_hud (bShow);
+		g_dbus_method_invocation_return_value (pInvocation, NULL);
+	}
+	else if (strcmp (cMethodName, "GetImageCacheStats") == 0)
+	{
+		gchar *cReport = cairo_dock_image_cache_get_report ();
+		g_dbus_method_invocation_return_value (pInvocation, g_variant_new ("(s)", cReport));
+		g_free (cReport);
+	}
+	else if (strcmp (cMethodName, "GetMemoryReport") == 0)
+	{
+		gchar *cReport = cairo_dock_get_image_memory_report ();
+		g_dbus_method_invocation_return_value (pInvocation, g_variant_new ("(s)", cReport));
+		g_free (cReport);
+	}
+	else if (strcmp (cMethodName, "GetIconPathCacheStats") == 0)
+	{
+		gchar *cReport = cairo_dock_get_icon_path_cache_report ();
+		g_dbus_method_invocation_return_value (pInvocation, g_variant_new ("(s)", cReport));
+		g_free (cReport);
+	}
+	else if (strcmp (cMethodName, "TraceThemeReload") == 0)
+	{
+		const gchar *cFilePath;
+		g_variant_get (pParameters, "(&s)", &cFilePath);
+		if (! gldi_trace_start (cFilePath))
+		{
+			g_dbus_method_invocation_return_error (pInvocation, G_DBUS_ERROR, G_DBUS_ERROR_FAILED, "A trace is already being recorded");
+			return;
+		}
+		g_idle_add (_reload_theme_idle, NULL);  // reload once the call has returned; the trace is written shortly after the first frame.
+		g_dbus_method_invocation_return_value (pInvocation, NULL);
+	}
+	else if (strcmp (cMethodName, "GetXEventsStats") == 0)
+	{
+		gchar *cReport = gldi_X_manager_get_events_report ();
+		g_dbus_method_invocation_return_value (pInvocation, g_variant_new ("(s)", cReport));
+		g_free (cReport);
+	}
+	else
+		g_dbus_method_invocation_return_error (pInvocation, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD, "Unknown method '%s'", cMethodName);
+}
+
+static const GDBusInterfaceVTable s_debugVTable = {_on_debug_method_call, NULL, NULL, {0}};
+
+static void _register_debug_interface (GDBusConnection *pConn)
+{
+	GError *erreur = NULL;
+	GDBusNodeInfo *pNodeInfo = g_dbus_node_info_new_for_xml (s_cDebugInterfaceXml, &erreur);
+	if (pNodeInfo == NULL)
+	{
+		cd_warning ("invalid debug interface: %s", erreur->message);
+		g_error_free (erreur);
+		return;
+	}
+	g_dbus_connection_register_object (pConn, s_cDebugObjectPath, pNodeInfo->interfaces[0], &s_debugVTable, NULL, NULL, &erreur);
+	if (erreur != NULL)
+	{
+		cd_warning ("couldn't export the debug interface: %s", erreur->message);
+		g_error_free (erreur);
+	}
+	g_dbus_node_info_unref (pNodeInfo);
+}
+
+
 static void _on_bus_acquired (GDBusConnection *pConn, G_GNUC_UNUSED const gchar* cName, G_GNUC_UNUSED gpointer ptr)
 {
 	s_pMainConnection = pConn;
+	_register_debug_interface (pConn);
 }
 
 
@@ -19,6 +19,7 @@
 
 
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <string.h>
 #include <gio/gio.h>
 #include <gmodule.h>
@@ -26,40 +27,355 @@
 #include "cairo-dock-class-manager-priv.h" // cairo_dock_guess_class
 #include "cairo-dock-log.h" // cd_error
 
-static GAppInfoMonitor *monitor = NULL;
+extern gchar *g_cCairoDockDataDir;
 
-typedef struct _desktop_db {
-	// hash tables store GDesktopAppInfo
-	GHashTable *class_table; // main table mapping desktop file IDs (without the extension)
-	GHashTable *alt_class_table; // alternative mapping based on the StartupWMClass (if exists)
-} desktop_db;
+/* The DB is an index of the classes of all the installed apps, mapped to the path of their .desktop file.
+ * It is saved on the disk, along with the mtimes of the applications directories, so that it can be used
+ * as soon as the dock starts; it is only rebuilt from scratch if these directories have changed meanwhile.
+ * While the dock runs, each .desktop file that changes is updated on its own. */
 
-static desktop_db *db_current = NULL; // current database (used for lookups)
-static desktop_db *db_pending = NULL; // pending database (created by our worker thread)
+#define INDEX_FILE ".desktop-file-index"
+#define INDEX_MAGIC "CDDFIDX" // 7 chars + '\0'
+#define INDEX_VERSION 2 // to be increased each time the format changes
+#define UPDATE_DELAY 1 // s, to group the changes of several files
+#define SAVE_DELAY 10 // s
 
-static GMutex mutex; // mutex for accessing db_pending
-static GCond cond; // condition to signal that db_pending has been updated (only used if db_current == NULL)
+// on-disk format: header, directories, entries, alternative entries, strings; offsets are from the start of the file.
+// The records are read in place from the mapped file, so each table has to start on a multiple of 8 (for the mtimes of the directories).
+typedef struct {
+	gchar magic[8];
+	guint32 version; // also rejects an index written on a machine of another endianness
+	guint32 n_dirs;
+	guint32 n_entries;
+	guint32 n_alt_entries;
+} index_header;
+
+typedef struct {
+	guint32 path; // applications directory (or one of its sub-directories)
+	guint32 padding;
+	gint64 mtime; // 0 if it doesn't exist
+} index_dir;
+
+typedef struct {
+	guint32 key; // class, lower case (entries are sorted by key)
+	guint32 path; // .desktop file
+} index_entry;
+
+G_STATIC_ASSERT (sizeof (index_header) % 8 == 0);
+G_STATIC_ASSERT (sizeof (index_dir) == 16 && G_STRUCT_OFFSET (index_dir, mtime) == 8);
+G_STATIC_ASSERT (sizeof (index_entry) == 8);
+
+typedef struct _desktop_index {
+	GBytes *bytes;
+	const gchar *data;
+	gsize size;
+	const index_header *header;
+	const index_dir *dirs;
+	const index_entry *entries; // main table: desktop file IDs (without the extension)
+	const index_entry *alt_entries; // alternative table: StartupWMClass or command (if different)
+} desktop_index;
+
+typedef struct {
+	gchar *path;
+	gint64 mtime;
+} dir_info;
+
+static desktop_index *index_current = NULL; // current index (used for lookups)
+static desktop_index *index_pending = NULL; // pending index (created by our worker thread)
+static GHashTable *overlay = NULL; // changes since index_current was built: class -> path, or "" if removed
+static GHashTable *alt_overlay = NULL; // same for the alternative table
+static GHashTable *apps = NULL; // path -> GDesktopAppInfo, created when first looked up
+static GHashTable *variants = NULL; // other spellings of the desktop file IDs -> path, built on the first heuristic lookup
+
+static GPtrArray *monitors = NULL; // GFileMonitor on each applications directory
+static GHashTable *changed_files = NULL; // paths relative to an applications directory, to update
+static guint sid_update = 0;
+static guint sid_save = 0;
+
+static GMutex mutex; // mutex for accessing index_pending
+static GCond cond; // condition to signal that index_pending has been updated (only used if index_current == NULL)
 static GThread *thread = NULL; // our worker thread
 
-static gboolean update_pending = FALSE; // update of apps is already pending
+static gboolean update_pending = FALSE; // full update of apps is already pending
 static gboolean more_work = FALSE; // more work to do for the worker thread (apps on the system have changed)
 static gboolean thread_running = FALSE; // worker thread is running (doing work updating the app DB; set to TRUE in _start_thread())
 static gboolean error = FALSE; // set if the worker cannot retrieve apps
 
-static void _desktop_db_free (desktop_db *db)
+static void _on_dir_changed (GFileMonitor *monitor, GFile *file, GFile *other, GFileMonitorEvent event, gpointer data);
+static void _invalidate_variants (void);
+
+
+  ///////////////////
+ /// DIRECTORIES ///
+///////////////////
+
+// the applications directories, by order of priority
+static gchar **_get_app_dirs (void)
+{
+	const gchar * const *sys_dirs = g_get_system_data_dirs ();
+	guint n = g_strv_length ((gchar**)sys_dirs);
+	gchar **dirs = g_new0 (gchar*, n + 2);
+	dirs[0] = g_build_filename (g_get_user_data_dir (), "applications", NULL);
+	guint i;
+	for (i = 0; i < n; i ++)
+		dirs[i+1] = g_build_filename (sys_dirs[i], "applications", NULL);
+	return dirs;
+}
+
+static void _dir_info_free (dir_info *d)
 {
-	if (db)
+	g_free (d->path);
+	g_free (d);
+}
+
+static void _collect_dir (GPtrArray *dirs, const gchar *path)
+{
+	GStatBuf st;
+	dir_info *d = g_new0 (dir_info, 1);
+	d->path = g_strdup (path);
+	d->mtime = (g_stat (path, &st) == 0 ? (gint64)st.st_mtime : 0);
+	g_ptr_array_add (dirs, d);
+	if (d->mtime == 0)
+		return;
+	
+	GDir *dir = g_dir_open (path, 0, NULL);
+	if (!dir) return;
+	const gchar *name;
+	while ((name = g_dir_read_name (dir)) != NULL)
 	{
-		if (db->alt_class_table) g_hash_table_unref(db->alt_class_table);
-		if (db->class_table) g_hash_table_unref(db->class_table);
-		g_free (db);
+		if (g_str_has_suffix (name, ".desktop")) continue; // most of the entries, no need to stat them
+		gchar *sub = g_build_filename (path, name, NULL);
+		if (g_file_test (sub, G_FILE_TEST_IS_DIR) && ! g_file_test (sub, G_FILE_TEST_IS_SYMLINK))
+			_collect_dir (dirs, sub);
+		g_free (sub);
 	}
+	g_dir_close (dir);
 }
 
+// all the directories that contain .desktop files, with their current mtime
+static GPtrArray *_collect_dirs (void)
+{
+	GPtrArray *dirs = g_ptr_array_new_with_free_func ((GDestroyNotify)_dir_info_free);
+	gchar **roots = _get_app_dirs ();
+	int i;
+	for (i = 0; roots[i] != NULL; i ++)
+		_collect_dir (dirs, roots[i]);
+	g_strfreev (roots);
+	return dirs;
+}
+
+static void _watch_dirs (void)
+{
+	if (monitors) g_ptr_array_free (monitors, TRUE);
+	monitors = g_ptr_array_new_with_free_func (g_object_unref);
+	GPtrArray *dirs = _collect_dirs ();
+	guint i;
+	for (i = 0; i < dirs->len; i ++)
+	{
+		dir_info *d = g_ptr_array_index (dirs, i);
+		GFile *file = g_file_new_for_path (d->path);
+		GFileMonitor *monitor = g_file_monitor_directory (file, G_FILE_MONITOR_NONE, NULL, NULL);  // works also if it doesn't exist yet
+		if (monitor)
+		{
+			g_signal_connect (monitor, "changed", G_CALLBACK (_on_dir_changed), NULL);
+			g_ptr_array_add (monitors, monitor);
+		}
+		g_object_unref (file);
+	}
+	g_ptr_array_free (dirs, TRUE);
+}
+
+
+  /////////////
+ /// INDEX ///
+/////////////
+
+static void _index_free (desktop_index *index)
+{
+	if (index)
+	{
+		g_bytes_unref (index->bytes);
+		g_free (index);
+	}
+}
+
+static gboolean _index_string_is_valid (desktop_index *index, guint32 offset)
+{
+	return (offset < index->size && memchr (index->data + offset, '\0', index->size - offset) != NULL);
+}
+
+// takes ownership of 'bytes'
+static desktop_index *_index_new (GBytes *bytes)
+{
+	desktop_index *index = g_new0 (desktop_index, 1);
+	index->bytes = bytes;
+	index->data = g_bytes_get_data (bytes, &index->size);
+	const index_header *h = (const index_header*)index->data;
+	if (((guintptr)index->data & 7) != 0  // the records are read in place; mapped files and allocated buffers are always aligned enough
+	|| index->size < sizeof (index_header)
+	|| memcmp (h->magic, INDEX_MAGIC, sizeof (h->magic)) != 0
+	|| h->version != INDEX_VERSION
+	|| sizeof (index_header) + (guint64)h->n_dirs * sizeof (index_dir) + ((guint64)h->n_entries + h->n_alt_entries) * sizeof (index_entry) > index->size)
+		goto invalid;
+	index->header = h;
+	index->dirs = (const index_dir*)(index->data + sizeof (index_header));
+	index->entries = (const index_entry*)(index->dirs + h->n_dirs);
+	index->alt_entries = index->entries + h->n_entries;
+	
+	guint i;
+	for (i = 0; i < h->n_dirs; i ++)
+		if (! _index_string_is_valid (index, index->dirs[i].path)) goto invalid;
+	for (i = 0; i < h->n_entries + h->n_alt_entries; i ++)
+		if (! _index_string_is_valid (index, index->entries[i].key) || ! _index_string_is_valid (index, index->entries[i].path)) goto invalid;
+	return index;
+	
+invalid:
+	cd_warning ("the index of the desktop files is invalid, it will be rebuilt");
+	_index_free (index);
+	return NULL;
+}
+
+static gchar *_get_index_path (void)
+{
+	return g_strdup_printf ("%s/%s", g_cCairoDockDataDir, INDEX_FILE);
+}
+
+static desktop_index *_index_load (void)
+{
+	gchar *path = _get_index_path ();
+	GMappedFile *map = g_mapped_file_new (path, FALSE, NULL);
+	g_free (path);
+	if (!map) return NULL;
+	GBytes *bytes = g_mapped_file_get_bytes (map);
+	g_mapped_file_unref (map);  // the bytes keep it mapped
+	return _index_new (bytes);
+}
+
+// TRUE if no applications directory has changed since the index was built
+static gboolean _index_is_up_to_date (desktop_index *index)
+{
+	GPtrArray *dirs = _collect_dirs ();
+	gboolean ok = (dirs->len == index->header->n_dirs);
+	guint i;
+	for (i = 0; ok && i < dirs->len; i ++)
+	{
+		dir_info *d = g_ptr_array_index (dirs, i);
+		ok = (strcmp (d->path, index->data + index->dirs[i].path) == 0 && d->mtime == index->dirs[i].mtime);
+	}
+	g_ptr_array_free (dirs, TRUE);
+	return ok;
+}
+
+static const gchar *_index_search (desktop_index *index, const index_entry *entries, guint n, const char *key)
+{
+	guint lo = 0, hi = n;
+	while (lo < hi)
+	{
+		guint mid = (lo + hi) / 2;
+		int cmp = strcmp (key, index->data + entries[mid].key);
+		if (cmp == 0) return index->data + entries[mid].path;
+		if (cmp < 0) hi = mid;
+		else lo = mid + 1;
+	}
+	return NULL;
+}
+
+// path of the .desktop file of a class, taking into account the changes since the index was built
+static const gchar *_lookup_path (const char *key, gboolean alt)
+{
+	const gchar *path = g_hash_table_lookup (alt ? alt_overlay : overlay, key);
+	if (path) return (*path != '\0' ? path : NULL);
+	if (!index_current) return NULL;
+	return alt ?
+		_index_search (index_current, index_current->alt_entries, index_current->header->n_alt_entries, key) :
+		_index_search (index_current, index_current->entries, index_current->header->n_entries, key);
+}
+
+static int _compare_keys (gconstpointer a, gconstpointer b)
+{
+	return strcmp (*(const gchar**)a, *(const gchar**)b);
+}
+
+static void _append_table (GByteArray *blob, GArray *records, GHashTable *table)
+{
+	GPtrArray *keys = g_ptr_array_sized_new (g_hash_table_size (table));
+	GHashTableIter iter;
+	gpointer key, value;
+	g_hash_table_iter_init (&iter, table);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+		g_ptr_array_add (keys, key);
+	g_ptr_array_sort (keys, _compare_keys);
+	
+	guint i;
+	for (i = 0; i < keys->len; i ++)
+	{
+		const gchar *k = g_ptr_array_index (keys, i);
+		const gchar *p = g_hash_table_lookup (table, k);
+		index_entry e;
+		e.key = blob->len;
+		g_byte_array_append (blob, (const guint8*)k, strlen (k) + 1);
+		e.path = blob->len;
+		g_byte_array_append (blob, (const guint8*)p, strlen (p) + 1);
+		g_array_append_val (records, e);
+	}
+	g_ptr_array_free (keys, TRUE);
+}
+
+// serializes the 2 tables (class -> path) and the directories, and writes the result on the disk.
+static GBytes *_index_write (GPtrArray *dirs, GHashTable *table, GHashTable *alt_table)
+{
+	guint n_entries = g_hash_table_size (table), n_alt_entries = g_hash_table_size (alt_table);
+	gsize strings_start = sizeof (index_header) + dirs->len * sizeof (index_dir) + (n_entries + n_alt_entries) * sizeof (index_entry);
+	GByteArray *blob = g_byte_array_new ();
+	g_byte_array_set_size (blob, strings_start); // the records are copied at the end, once the offsets of the strings are known.
+	
+	index_dir *dir_records = g_new0 (index_dir, dirs->len);
+	guint i;
+	for (i = 0; i < dirs->len; i ++)
+	{
+		dir_info *d = g_ptr_array_index (dirs, i);
+		dir_records[i].path = blob->len;
+		dir_records[i].mtime = d->mtime;
+		g_byte_array_append (blob, (const guint8*)d->path, strlen (d->path) + 1);
+	}
+	GArray *records = g_array_sized_new (FALSE, FALSE, sizeof (index_entry), n_entries + n_alt_entries);
+	_append_table (blob, records, table);
+	_append_table (blob, records, alt_table);
+	
+	index_header h;
+	memset (&h, 0, sizeof (h));
+	memcpy (h.magic, INDEX_MAGIC, sizeof (h.magic));
+	h.version = INDEX_VERSION;
+	h.n_dirs = dirs->len;
+	h.n_entries = n_entries;
+	h.n_alt_entries = n_alt_entries;
+	memcpy (blob->data, &h, sizeof (h));
+	memcpy (blob->data + sizeof (h), dir_records, dirs->len * sizeof (index_dir));
+	memcpy (blob->data + sizeof (h) + dirs->len * sizeof (index_dir), records->data, records->len * sizeof (index_entry));
+	g_free (dir_records);
+	g_array_free (records, TRUE);
+	
+	gchar *path = _get_index_path ();
+	GError *erreur = NULL;
+	if (! g_file_set_contents (path, (const gchar*)blob->data, blob->len, &erreur))
+	{
+		cd_warning ("couldn't write the index of the desktop files: %s", erreur->message);
+		g_error_free (erreur);
+	}
+	g_free (path);
+	return g_byte_array_free_to_bytes (blob);
+}
+
+
+  ////////////////////
+ /// FULL REBUILD ///
+////////////////////
+
 static void _process_app (gpointer data, gpointer user_data)
 {
 	if (!data) return;
-	desktop_db *db = (desktop_db*)user_data;
+	GHashTable **tables = (GHashTable**)user_data;
+	GHashTable *class_table = tables[0], *alt_class_table = tables[1];
 	GAppInfo *app = (GAppInfo*)data;
 	const char *id = g_app_info_get_id (app);
 	if (!id) return;
@@ -81,15 +397,14 @@ static void _process_app (gpointer data, gpointer user_data)
 	else id_lower = g_ascii_strdown (id, -1);
 	
 	// check if this ID exists (desktop file names should be unique, so there is no use adding in that case)
-	if (g_hash_table_contains (db->class_table, id_lower))
+	if (g_hash_table_contains (class_table, id_lower))
 	{
 		g_free (id_lower);
 		return;
 	}
 	
 	// add the app ID to the (main) hash table
-	g_object_ref (desktop_app);
-	g_hash_table_insert (db->class_table, id_lower, desktop_app);
+	g_hash_table_insert (class_table, id_lower, g_strdup (fn));
 	
 	// process commandline and / or wm class (note: this will always return lower case as well)
 	char *alt_id = cairo_dock_guess_class (cmdline, wmclass);
@@ -101,40 +416,41 @@ static void _process_app (gpointer data, gpointer user_data)
 	}
 	
 	// only add the alternate ID if it does not exist yet
-	if (g_hash_table_contains (db->class_table, alt_id) || g_hash_table_contains(db->alt_class_table, alt_id))
+	if (g_hash_table_contains (class_table, alt_id) || g_hash_table_contains(alt_class_table, alt_id))
 	{
 		g_free (alt_id);
 		return;
 	}
-	g_object_ref (desktop_app);
-	g_hash_table_insert (db->alt_class_table, alt_id, desktop_app);
+	g_hash_table_insert (alt_class_table, alt_id, g_strdup (fn));
 }
 
 static gpointer _thread_func (G_GNUC_UNUSED gpointer ptr)
 {
 	while (1)
 	{
-		desktop_db *db = NULL;
+		desktop_index *index = NULL;
+		GPtrArray *dirs = _collect_dirs (); // before the scan, so that a change during the scan will be noticed next time.
 		GList *list = g_app_info_get_all ();
 		
 		if (list)
 		{
-			db = g_malloc (sizeof(desktop_db));
-			db->class_table = g_hash_table_new_full (g_str_hash, g_str_equal,
-				g_free, g_object_unref);
-			db->alt_class_table = g_hash_table_new_full (g_str_hash, g_str_equal,
-				g_free, g_object_unref);
-			g_list_foreach (list, _process_app, db);
-			// note: apps added to the hash table were ref'd in _process_app ()
+			GHashTable *tables[2];
+			tables[0] = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+			tables[1] = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+			g_list_foreach (list, _process_app, tables);
 			g_list_free_full (list, g_object_unref);
+			index = _index_new (_index_write (dirs, tables[0], tables[1]));
+			g_hash_table_unref (tables[0]);
+			g_hash_table_unref (tables[1]);
 		}
+		g_ptr_array_free (dirs, TRUE);
 		
 		gboolean exit = TRUE;
 		g_mutex_lock (&mutex);
-		if (db)
+		if (index)
 		{
-			_desktop_db_free (db_pending);
-			db_pending = db;
+			_index_free (index_pending);
+			index_pending = index;
 			if (more_work) exit = FALSE;
 		}
 		else error = TRUE;
@@ -164,29 +480,364 @@ static gboolean _start_thread (G_GNUC_UNUSED gpointer ptr)
 	return FALSE; // needed to remove timeout
 }
 
-static void _on_apps_changed(G_GNUC_UNUSED GAppInfoMonitor* pMonitor, G_GNUC_UNUSED void* dummy) {
+static void _trigger_full_update (void)
+{
 	if(update_pending) return;
 	update_pending = TRUE;
-	g_timeout_add_seconds (5, _start_thread, NULL);
+	g_timeout_add_seconds (UPDATE_DELAY, _start_thread, NULL);
+}
+
+// swap in the index built by the worker, if any; wait for it if there is no index at all.
+static gboolean _get_current_index (void)
+{
+	if (index_current && ! g_atomic_pointer_get (&index_pending))
+		return TRUE;
+	g_mutex_lock (&mutex);
+	if (!index_pending)
+	{
+		// in this case index_current == NULL, we have to wait for the thread (which should be running)
+		if (!thread_running)
+		{
+			g_mutex_unlock (&mutex);
+			cd_error ("no worker thread!\n");
+			return FALSE;
+		}
+		
+		while (!(index_pending || error))
+			g_cond_wait (&cond, &mutex);
+		
+		if (error)
+		{
+			g_mutex_unlock (&mutex);
+			cd_error ("cannot get app database!\n");
+			return FALSE;
+		}
+	}
+	
+	// here index_pending is valid, we have to swap with index_current; it was built from the disk after the changes we know.
+	_index_free (index_current);
+	index_current = index_pending;
+	index_pending = NULL;
+	g_mutex_unlock (&mutex);
+	g_hash_table_remove_all (overlay);
+	g_hash_table_remove_all (alt_overlay);
+	g_hash_table_remove_all (apps);
+	_invalidate_variants ();
+	return TRUE;
+}
+
+
+  ///////////////////////////
+ /// INCREMENTAL UPDATES ///
+///////////////////////////
+
+static void _add_table (GHashTable *table, desktop_index *index, const index_entry *entries, guint n, GHashTable *changes)
+{
+	guint i;
+	if (index)
+		for (i = 0; i < n; i ++)
+			g_hash_table_insert (table, (gpointer)(index->data + entries[i].key), (gpointer)(index->data + entries[i].path));
+	GHashTableIter iter;
+	gpointer key, value;
+	g_hash_table_iter_init (&iter, changes);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		if (*(gchar*)value == '\0') g_hash_table_remove (table, key);
+		else g_hash_table_insert (table, key, value);
+	}
+}
+
+static gboolean _save_index (G_GNUC_UNUSED gpointer data)
+{
+	sid_save = 0;
+	if (thread_running || g_atomic_pointer_get (&index_pending)) // a new index is coming anyway
+		return FALSE;
+	GHashTable *table = g_hash_table_new (g_str_hash, g_str_equal); // points to the strings of the index and of the overlays
+	GHashTable *alt_table = g_hash_table_new (g_str_hash, g_str_equal);
+	_add_table (table, index_current, index_current ? index_current->entries : NULL, index_current ? index_current->header->n_entries : 0, overlay);
+	_add_table (alt_table, index_current, index_current ? index_current->alt_entries : NULL, index_current ? index_current->header->n_alt_entries : 0, alt_overlay);
+	GPtrArray *dirs = _collect_dirs ();
+	desktop_index *index = _index_new (_index_write (dirs, table, alt_table));
+	g_ptr_array_free (dirs, TRUE);
+	g_hash_table_unref (table);
+	g_hash_table_unref (alt_table);
+	if (index)
+	{
+		_index_free (index_current);
+		index_current = index;
+		g_hash_table_remove_all (overlay);
+		g_hash_table_remove_all (alt_overlay);
+	}
+	return FALSE;
+}
+
+static gchar *_get_key (const gchar *id)
+{
+	const char *tmp = g_str_has_suffix (id, ".desktop") ? id + strlen (id) - 8 : NULL;
+	return tmp ? g_ascii_strdown (id, tmp - id) : g_ascii_strdown (id, -1);
 }
 
+// the file at 'rel_path' in one of the applications directories has changed: update its entries.
+static void _update_file (const gchar *rel_path, gchar **roots)
+{
+	gchar *id = g_strdelimit (g_strdup (rel_path), "/", '-'); // desktop file ID, as in GIO
+	gchar *key = _get_key (id);
+	g_free (id);
+	_invalidate_variants ();
+	
+	// forget the entries of the file that provided this ID until now.
+	const gchar *prev = _lookup_path (key, FALSE);
+	if (prev)
+	{
+		gchar *prev_path = g_strdup (prev);
+		g_hash_table_remove (apps, prev_path);
+		g_hash_table_insert (overlay, g_strdup (key), g_strdup (""));
+		// alternative classes pointing to this file
+		guint i;
+		if (index_current)
+			for (i = 0; i < index_current->header->n_alt_entries; i ++)
+				if (strcmp (index_current->data + index_current->alt_entries[i].path, prev_path) == 0)
+					g_hash_table_insert (alt_overlay, g_strdup (index_current->data + index_current->alt_entries[i].key), g_strdup (""));
+		GHashTableIter iter;
+		gpointer k, v;
+		g_hash_table_iter_init (&iter, alt_overlay);
+		while (g_hash_table_iter_next (&iter, &k, &v))
+			if (strcmp (v, prev_path) == 0) g_hash_table_iter_replace (&iter, g_strdup (""));
+		g_free (prev_path);
+	}
+	
+	// the file that provides this ID now, if any: the first directory that has it wins, as in GIO; if this file is hidden or invalid, it masks the ones of the next directories.
+	GDesktopAppInfo *app = NULL;
+	gboolean bFound = FALSE;
+	int i;
+	for (i = 0; roots[i] != NULL && ! bFound; i ++)
+	{
+		gchar *path = g_build_filename (roots[i], rel_path, NULL);
+		if (g_file_test (path, G_FILE_TEST_EXISTS))
+		{
+			bFound = TRUE;
+			app = g_desktop_app_info_new_from_filename (path); // NULL if hidden or invalid
+		}
+		g_free (path);
+	}
+	if (app)
+	{
+		const char *fn = g_desktop_app_info_get_filename (app);
+		g_hash_table_insert (overlay, g_strdup (key), g_strdup (fn));
+		char *alt_id = cairo_dock_guess_class (g_app_info_get_commandline (G_APP_INFO (app)), g_desktop_app_info_get_startup_wm_class (app));
+		if (alt_id && strcmp (alt_id, key) != 0 && !_lookup_path (alt_id, FALSE) && !_lookup_path (alt_id, TRUE))
+			g_hash_table_insert (alt_overlay, alt_id, g_strdup (fn));
+		else g_free (alt_id);
+		g_hash_table_insert (apps, g_strdup (fn), app);
+	}
+	g_free (key);
+}
+
+static gboolean _update_changed_files (G_GNUC_UNUSED gpointer data)
+{
+	sid_update = 0;
+	gchar **roots = _get_app_dirs ();
+	GHashTableIter iter;
+	gpointer rel_path;
+	g_hash_table_iter_init (&iter, changed_files);
+	while (g_hash_table_iter_next (&iter, &rel_path, NULL))
+		_update_file (rel_path, roots);
+	g_hash_table_remove_all (changed_files);
+	g_strfreev (roots);
+	
+	if (sid_save == 0)
+		sid_save = g_timeout_add_seconds (SAVE_DELAY, _save_index, NULL);
+	return FALSE;
+}
+
+static void _on_dir_changed (G_GNUC_UNUSED GFileMonitor *monitor, GFile *file, G_GNUC_UNUSED GFile *other, GFileMonitorEvent event, G_GNUC_UNUSED gpointer data)
+{
+	if (event != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT && event != G_FILE_MONITOR_EVENT_CREATED && event != G_FILE_MONITOR_EVENT_DELETED)
+		return;
+	gchar *path = g_file_get_path (file);
+	if (!path) return;
+	
+	if (! g_str_has_suffix (path, ".desktop"))
+	{
+		// a sub-directory may have been added or removed; rebuild everything and watch it.
+		if (event != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT && (event == G_FILE_MONITOR_EVENT_DELETED || g_file_test (path, G_FILE_TEST_IS_DIR)))
+		{
+			_trigger_full_update ();
+			_watch_dirs ();
+		}
+		g_free (path);
+		return;
+	}
+	if (thread_running)  // the scan may have read the file before it changed.
+	{
+		g_mutex_lock (&mutex);
+		if (thread_running) more_work = TRUE;
+		g_mutex_unlock (&mutex);
+	}
+	
+	// find its path relative to its applications directory
+	gchar **roots = _get_app_dirs ();
+	int i;
+	for (i = 0; roots[i] != NULL; i ++)
+	{
+		gsize n = strlen (roots[i]);
+		if (strncmp (path, roots[i], n) == 0 && path[n] == '/')
+		{
+			g_hash_table_add (changed_files, g_strdup (path + n + 1));
+			break;
+		}
+	}
+	g_strfreev (roots);
+	g_free (path);
+	if (sid_update == 0)
+		sid_update = g_timeout_add_seconds (UPDATE_DELAY, _update_changed_files, NULL);
+}
+
+
+  ////////////////
+ /// VARIANTS ///
+////////////////
+
+/* Some apps report a class that is only part of their desktop file ID, so we also index these IDs by
+ * the spellings that are known to differ; they are tried in the order of this enum.
+ * #1: common prefices
+ * e.g. org.gnome.Evince.desktop, but app-id is only evince on Ubuntu 22.04 and 24.04
+ * More generally, this can happen with GTK+3 apps that have only "partially" migrated
+ * to using the "new" (reverse DNS style) .desktop format.
+ * See e.g.
+ * https://gitlab.gnome.org/GNOME/gtk/-/issues/2822
+ * https://gitlab.gnome.org/GNOME/gtk/-/issues/2034
+ * https://honk.sigxcpu.org/con/GTK__and_the_application_id.html
+ * https://docs.gtk.org/gtk4/migrating-3to4.html#set-a-proper-application-id
+ * #2: snap "namespaced" names -- these could be anything, we just handle the "common" case where
+ * simply the app-id is duplicated (e.g. "firefox_firefox.desktop" as on Ubuntu 22.04 and 24.04) */
+typedef enum {
+	VARIANT_GNOME = 0,
+	VARIANT_KDE,
+	VARIANT_FREEDESKTOP,
+	VARIANT_SNAP,
+	NB_VARIANTS
+} variant_type;
+
+static const char *s_prefices[] = {"org.gnome.", "org.kde.", "org.freedesktop."};
+
+/* Apps with known problems, that take precedence over the variants.
+ * gnome-terminal-server: Gnome Terminal, required at least on Ubuntu 22.04 and 24.04
+ * (should be fixed in newer versions, see e.g. here: https://gitlab.gnome.org/GNOME/gnome-terminal/-/issues/8033)
+ * gted -> org.gnome.TextEditor.desktop, required at least on Ubuntu 24.04.
+ * Note: issue only exists in X11 where WM_CLASS is the program name for most GTK4 apps,
+ * as opposed to Wayland where the "application-id" is used; see details here:
+ * https://gitlab.gnome.org/GNOME/gtk/-/work_items/8296
+ * In this case, normally, WM_CLASS would be "gnome-text-editor", which is correctly
+ * matched based on the Exec= key in the .desktop file. However, on Ubuntu 24.04, "gted"
+ * exists as a symlink and if it is used to launch the app, WM_CLASS will also be set to
+ * "gted" that is not possible to match with normal methods. */
+static const char *s_special_cases[][2] = {
+	{"gnome-terminal-server", "org.gnome.terminal"},
+	{"gted", "org.gnome.texteditor"},
+	{NULL, NULL}
+};
+
+static void _invalidate_variants (void)
+{
+	if (variants)
+	{
+		g_hash_table_unref (variants);
+		variants = NULL;
+	}
+}
+
+// the shorter spelling of 'key' of the given type, or NULL if it has none.
+static gchar *_get_variant (const gchar *key, variant_type type)
+{
+	if (type == VARIANT_SNAP)
+	{
+		gsize len = strlen (key), n = len / 2;
+		if (len % 2 == 1 && key[n] == '_' && strncmp (key, key + n + 1, n) == 0)
+			return g_strndup (key, n);
+		return NULL;
+	}
+	return (g_str_has_prefix (key, s_prefices[type]) && key[strlen (s_prefices[type])] != '\0' ?
+		g_strdup (key + strlen (s_prefices[type])) :
+		NULL);
+}
+
+static void _add_variant (const gchar *key, const gchar *path, variant_type type)
+{
+	gchar *variant = _get_variant (key, type);
+	if (variant && ! g_hash_table_contains (variants, variant))
+		g_hash_table_insert (variants, variant, g_strdup (path));
+	else g_free (variant);
+}
+
+static void _build_variants (void)
+{
+	variants = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	
+	int i;
+	for (i = 0; s_special_cases[i][0] != NULL; i ++)
+	{
+		const gchar *path = _lookup_path (s_special_cases[i][1], FALSE);
+		if (path) g_hash_table_insert (variants, g_strdup (s_special_cases[i][0]), g_strdup (path));
+	}
+	
+	// one pass per type, so that the first type wins when several IDs give the same variant.
+	variant_type type;
+	for (type = 0; type < NB_VARIANTS; type ++)
+	{
+		guint j;
+		if (index_current)
+			for (j = 0; j < index_current->header->n_entries; j ++)
+			{
+				const gchar *key = index_current->data + index_current->entries[j].key;
+				if (! g_hash_table_contains (overlay, key))
+					_add_variant (key, index_current->data + index_current->entries[j].path, type);
+			}
+		GHashTableIter iter;
+		gpointer key, path;
+		g_hash_table_iter_init (&iter, overlay);
+		while (g_hash_table_iter_next (&iter, &key, &path))
+			if (*(gchar*)path != '\0')
+				_add_variant (key, path, type);
+	}
+}
+
+
+  ///////////
+ /// API ///
+///////////
 
 void gldi_desktop_file_db_init ()
 {
-	update_pending = TRUE;
-	_start_thread (NULL);
-	monitor = g_app_info_monitor_get();
-	g_signal_connect (monitor, "changed", G_CALLBACK(_on_apps_changed), NULL);
+	overlay = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	alt_overlay = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	apps = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+	changed_files = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	
+	// use the index saved last time right away; if some apps have been installed or removed since, rebuild it in the background.
+	index_current = _index_load ();
+	if (!index_current || !_index_is_up_to_date (index_current))
+	{
+		cd_debug ("the index of the desktop files must be rebuilt");
+		update_pending = TRUE;
+		_start_thread (NULL);
+	}
+	_watch_dirs ();
 }
 
 void gldi_desktop_file_db_stop (void)
 {
-	if (monitor)
+	if (monitors)
 	{
-		g_object_unref (monitor);
-		monitor = NULL;
+		g_ptr_array_free (monitors, TRUE);
+		monitors = NULL;
 	}
 	update_pending = FALSE;
+	if (sid_update != 0)
+	{
+		g_source_remove (sid_update);
+		sid_update = 0;
+	}
 	
 	g_mutex_lock (&mutex);
 	more_work = FALSE;
@@ -197,52 +848,58 @@ void gldi_desktop_file_db_stop (void)
 		g_thread_join (thread);
 		thread = NULL;
 	}
-	_desktop_db_free (db_current);
-	_desktop_db_free (db_pending);
-	db_current = NULL;
-	db_pending = NULL;
+	if (changed_files != NULL && g_hash_table_size (changed_files) != 0)  // the saved index has the current mtimes of the directories, so it must include all their changes.
+		_update_changed_files (NULL);
+	if (sid_save != 0)  // keep the changes for the next time.
+	{
+		g_source_remove (sid_save);
+		_save_index (NULL);
+	}
+	_index_free (index_current);
+	_index_free (index_pending);
+	index_current = NULL;
+	index_pending = NULL;
+	if (overlay) g_hash_table_unref (overlay);
+	if (alt_overlay) g_hash_table_unref (alt_overlay);
+	if (apps) g_hash_table_unref (apps);
+	if (changed_files) g_hash_table_unref (changed_files);
+	overlay = alt_overlay = apps = changed_files = NULL;
+	_invalidate_variants ();
 	error = FALSE;
 }
 
-GDesktopAppInfo *gldi_desktop_file_db_lookup (const char *class, gboolean bOnlyDesktopID)
+static GDesktopAppInfo *_get_app (const gchar *path)
 {
-	if (!db_current || g_atomic_pointer_get (&db_pending))
+	GDesktopAppInfo *app = g_hash_table_lookup (apps, path);
+	if (!app)
 	{
-		// update db_current
-		g_mutex_lock (&mutex);
-		if (!db_pending)
-		{
-			// in this case db_current == NULL, we have to wait for the thread (which should be running)
-			if (!thread_running)
-			{
-				g_mutex_unlock (&mutex);
-				cd_error ("no worker thread!\n");
-				return NULL;
-			}
-			
-			while (!(db_pending || error))
-				g_cond_wait (&cond, &mutex);
-			
-			if (error)
-			{
-				g_mutex_unlock (&mutex);
-				cd_error ("cannot get app database!\n");
-				return NULL;
-			}
-		}
-		
-		// here db_pending is valid, we have to swap with db_current
-		_desktop_db_free (db_current);
-		db_current = db_pending;
-		db_pending = NULL;
-		g_mutex_unlock (&mutex);
+		app = g_desktop_app_info_new_from_filename (path);
+		if (!app) return NULL; // removed since (we'll be notified)
+		g_hash_table_insert (apps, g_strdup (path), app);
 	}
+	return app;
+}
+
+GDesktopAppInfo *gldi_desktop_file_db_lookup (const char *class, gboolean bOnlyDesktopID)
+{
+	if (! _get_current_index ())
+		return NULL;
 	
-	void *tmp = g_hash_table_lookup (db_current->class_table, class);
-	if (!tmp && !bOnlyDesktopID) tmp = g_hash_table_lookup (db_current->alt_class_table, class);
+	const gchar *path = _lookup_path (class, FALSE);
+	if (!path && !bOnlyDesktopID) path = _lookup_path (class, TRUE);
+	if (!path) return NULL;
 	
-	return (GDesktopAppInfo*)tmp;
+	return _get_app (path);
 }
 
-
-
+GDesktopAppInfo *gldi_desktop_file_db_lookup_variant (const char *class)
+{
+	if (! _get_current_index ())
+		return NULL;
+	
+	if (!variants) _build_variants ();
+	const gchar *path = g_hash_table_lookup (variants, class);
+	if (!path) return NULL;
+	
+	return _get_app (path);
+}
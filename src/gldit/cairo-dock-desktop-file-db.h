@@ -33,8 +33,8 @@ G_BEGIN_DECLS
 
 
 /**
- * Start the desktop file DB manager. This will run a background thread to populate the DB with all apps
- * installed on the system. */
+ * Start the desktop file DB manager. The index saved during the last session is used right away; if the
+ * applications directories have changed since, a background thread rebuilds it with all apps installed on the system. */
 void gldi_desktop_file_db_init (void);
 
 /**
@@ -42,8 +42,8 @@ void gldi_desktop_file_db_init (void);
 void gldi_desktop_file_db_stop (void);
 
 /**
- * Try to look up an installed app. This function can block the first time it's called if the DB has not been
- * fully populated yet.
+ * Try to look up an installed app. This function can only block if no index has ever been saved and the DB
+ * has not been fully populated yet.
  * @param class Desktop file ID, class or app-id of an app to look up (matching is based on the basename of
  * 	its .desktop file, and the content of the StartupWMClass and Exec keys in it).
  * @param bOnlyDesktopID if TRUE, only the .desktop file name is used for matching (can be useful if looking
@@ -53,6 +53,16 @@ void gldi_desktop_file_db_stop (void);
 */
 GDesktopAppInfo *gldi_desktop_file_db_lookup (const char *class, gboolean bOnlyDesktopID);
 
+/**
+ * Try to look up an installed app whose .desktop file name is a known variant of the given class, for apps that
+ * don't report their full desktop file ID (e.g. "evince" for org.gnome.Evince.desktop, or "firefox" for
+ * firefox_firefox.desktop). The variants are indexed once, so this is a single lookup.
+ * @param class class or app-id of an app to look up, in lower case.
+ * @return GDesktopAppInfo corresponding to the app if found. The return value is owned by the DB, the
+ *  caller should call g_object_ref () on it if it wants to keep it.
+*/
+GDesktopAppInfo *gldi_desktop_file_db_lookup_variant (const char *class);
+
 G_END_DECLS
 
 #endif
@@ -371,12 +371,9 @@ static cairo_surface_t *_cairo_dock_create_dialog_icon_surface (const gchar *cIm
 	cairo_surface_t *pIconBuffer = NULL;
 	if (strcmp (cImageFilePath, "same icon") == 0)
 	{
-		if (pIcon && pIcon->image.pSurface)
+		if (pIcon && (pIcon->image.pSurface || pIcon->image.iTexture))
 		{
-			int iWidth, iHeight;
-			cairo_dock_get_icon_extent (pIcon, &iWidth, &iHeight);
-			pIconBuffer = cairo_dock_duplicate_surface (pIcon->image.pSurface,
-				iWidth, iHeight,
+			pIconBuffer = cairo_dock_image_buffer_copy_scale (&pIcon->image,
 				iDesiredSize, iDesiredSize);
 		}
 		else if (pIcon && pIcon->cFileName)
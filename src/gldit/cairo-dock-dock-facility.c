@@ -41,6 +41,8 @@
 extern CairoDockGLConfig g_openglConfig;
 #include "cairo-dock-dock-facility.h"
 #include "cairo-dock-dock-priv.h"
+#include "cairo-dock-dock-hud.h"
+#include "cairo-dock-dock-geometry-priv.h"
 
 extern gboolean g_bUseOpenGL;  // for cairo_dock_make_preview()
 
@@ -292,7 +294,10 @@ static void cairo_dock_manage_mouse_position (CairoDock *pDock)
 }
 Icon *cairo_dock_calculate_dock_icons (CairoDock *pDock)
 {
+	gint64 iStartTime = gldi_dock_hud_begin ();
+	gldi_dock_get_geometry (pDock)->iPointed = GLDI_DOCK_GEOMETRY_UNKNOWN_INDEX;  // let the view tell which icon is pointed, if it uses the linear wave.
 	Icon *pPointedIcon = pDock->pRenderer->calculate_icons (pDock);
+	gldi_dock_hud_end (pDock, GLDI_DOCK_HUD_LAYOUT, iStartTime);
 	cairo_dock_manage_mouse_position (pDock);
 	return pPointedIcon;
 	/**if (pDock->iMousePositionType == CAIRO_DOCK_MOUSE_INSIDE)
@@ -526,6 +531,119 @@ void cairo_dock_calculate_icons_positions_at_rest_linear (CairoDock *pDock)
 
 		x_cumulated += icon->fWidth + myIconsParam.iIconGap;
 	}
+	gldi_dock_geometry_update_at_rest (pDock);
+}
+
+static Icon *_calculate_wave_with_position (Icon **pIcons, guint iNbIcons, gboolean bSortedAtRest, int x_abs, gdouble fMagnitude, double fFlatDockWidth, int iWidth, int iHeight, double fAlign, double fFoldingFactor, gboolean bDirectionUp, gint *iPointedIndex);
+
+// Phase of an icon in the wave (pi/2 next to the cursor); it's not clamped, and it doesn't decrease with the middle of the icon.
+static inline double _get_wave_phase (double fXAtRest, double fWidth, int x_abs)
+{
+	float fXMiddle = GLDI_DOCK_GEOMETRY_X_MIDDLE (fXAtRest, fWidth);
+	return (fXMiddle - x_abs) / myIconsParam.iSinusoidWidth * G_PI + G_PI / 2;
+}
+
+// Get the icons inside the sinusoid, [*iFirst;*iLast[: the phase of the icons before is <= 0, and >= pi for the ones after.
+// The phases can only be bisected if the icons are sorted at rest; otherwise the whole range is returned, and the phases are clamped icon by icon.
+static void _get_wave_window (Icon **pIcons, guint iNbIcons, gboolean bSortedAtRest, int x_abs, guint *iFirst, guint *iLast)
+{
+	if (! bSortedAtRest || myIconsParam.iSinusoidWidth <= 0)
+	{
+		*iFirst = 0;
+		*iLast = iNbIcons;
+		return;
+	}
+	guint a = 0, b = iNbIcons, m;
+	while (a < b)  // first icon whose phase is > 0
+	{
+		m = (a + b) / 2;
+		if (_get_wave_phase (pIcons[m]->fXAtRest, pIcons[m]->fWidth, x_abs) > 0)
+			b = m;
+		else
+			a = m + 1;
+	}
+	*iFirst = a;
+	b = iNbIcons;
+	while (a < b)  // first icon whose phase is >= pi
+	{
+		m = (a + b) / 2;
+		if (_get_wave_phase (pIcons[m]->fXAtRest, pIcons[m]->fWidth, x_abs) >= G_PI)
+			b = m;
+		else
+			a = m + 1;
+	}
+	*iLast = a;
+}
+
+// Same as the wave of a dock without size nor folding (as used to compute the max width): there is no constraint nor insertion offset, so only the positions at rest and the widths are needed, and only fX and fScale are computed, in the geometry arrays.
+static void _simulate_wave_with_position (GldiDockGeometry *pGeometry, int x_abs, gdouble fMagnitude, double fFlatDockWidth, double fAlign)
+{
+	const int iWidth = 0;
+	const double fFoldingFactor = 0.;
+	guint iNbIcons = pGeometry->iNbIcons, i;
+	const gdouble *fXAtRest = pGeometry->fXAtRest, *fWidth = pGeometry->fWidth;
+	gdouble *fX = pGeometry->fX, *fScale = pGeometry->fScale;
+	
+	//\_______________ Outside of the sinusoid, the phase is saturated, so all the icons there get the same scale; only the icons inside need a sine.
+	double fWaveAmplitude = fMagnitude * myIconsParam.fAmplitude;
+	double fScaleBefore = 1 + fWaveAmplitude * sin (0.);
+	double fScaleAfter = 1 + fWaveAmplitude * sin (G_PI);
+	double fPhase;
+	guint iFirst, iLast;
+	_get_wave_window (pGeometry->pIcons, iNbIcons, pGeometry->bSortedAtRest, x_abs, &iFirst, &iLast);
+	for (i = 0; i < iFirst; i ++)
+		fScale[i] = fScaleBefore;
+	for (i = iFirst; i < iLast; i ++)
+	{
+		fPhase = _get_wave_phase (fXAtRest[i], fWidth[i], x_abs);
+		if (fPhase <= 0)
+			fScale[i] = fScaleBefore;
+		else if (fPhase >= G_PI)
+			fScale[i] = fScaleAfter;
+		else
+			fScale[i] = 1 + fWaveAmplitude * sin (fPhase);
+	}
+	for (i = iLast; i < iNbIcons; i ++)
+		fScale[i] = fScaleAfter;
+	
+	//\_______________ The positions depend on each other, so all the icons are placed.
+	float x_cumulated = 0;
+	gint iPointed = (x_abs < 0 ? 0 : -1);
+	for (i = 0; i < iNbIcons; i ++)
+	{
+		x_cumulated = fXAtRest[i];
+		
+		if (iPointed >= 0)
+		{
+			if (i == 0)
+				fX[i] = x_cumulated - 1. * (fFlatDockWidth - iWidth) / 2;
+			else
+				fX[i] = fX[i-1] + (fWidth[i-1] + myIconsParam.iIconGap) * fScale[i-1];
+			fX[i] = fAlign * iWidth + (fX[i] - fAlign * iWidth) * (1. - fFoldingFactor);
+		}
+		
+		if (iPointed < 0
+		    && x_cumulated + fWidth[i] + .5*myIconsParam.iIconGap >= x_abs
+		    && x_cumulated - .5*myIconsParam.iIconGap <= x_abs)
+		{
+			iPointed = i;
+			fX[i] = x_cumulated - (fFlatDockWidth - iWidth) / 2 + (1 - fScale[i]) * (x_abs - x_cumulated + .5*myIconsParam.iIconGap);
+			fX[i] = fAlign * iWidth + (fX[i] - fAlign * iWidth) * (1. - fFoldingFactor);
+		}
+	}
+	
+	if (iPointed < 0)  // We are at the right of icons.
+	{
+		iPointed = iNbIcons - 1;
+		fX[iPointed] = x_cumulated - (fFlatDockWidth - iWidth) / 2 + (1 - fScale[iPointed]) * (fWidth[iPointed] + .5*myIconsParam.iIconGap);
+		fX[iPointed] = fAlign * iWidth + (fX[iPointed] - fAlign * iWidth) * (1 - fFoldingFactor);
+	}
+	
+	for (i = iPointed; i > 0; i --)
+	{
+		fX[i-1] = fX[i] - (fWidth[i-1] + myIconsParam.iIconGap) * fScale[i-1];
+		fX[i-1] = fAlign * iWidth + (fX[i-1] - fAlign * iWidth) * (1. - fFoldingFactor);
+	}
 }
 
 double cairo_dock_calculate_max_dock_width (CairoDock *pDock, double fFlatDockWidth, double fWidthConstraintFactor, double fExtraWidth)
@@ -535,68 +653,74 @@ double cairo_dock_calculate_max_dock_width (CairoDock *pDock, double fFlatDockWi
 	GList *pIconList = pDock->icons;
 	if (pIconList == NULL)
 		return 2 * myDocksParam.iDockRadius + myDocksParam.iDockLineWidth + 2 * myDocksParam.iFrameMargin;
-
-	// We reset extreme positions of the icons.
-	GList* ic;
+	
+	GldiDockGeometry *pGeometry = gldi_dock_get_geometry (pDock);
+	guint iNbIcons = pGeometry->iNbIcons, i, j;
+	Icon **pIcons = pGeometry->pIcons;
+	gdouble *fX = pGeometry->fX, *fScale = pGeometry->fScale, *fWidth = pGeometry->fWidth, *fXMin = pGeometry->fXMin, *fXMax = pGeometry->fXMax;
+	
+	// We take the current geometry of the icons, and reset their extreme positions.
+	gldi_dock_geometry_update_at_rest (pDock);
 	Icon *icon;
-	for (ic = pIconList; ic != NULL; ic = ic->next)
+	for (i = 0; i < iNbIcons; i ++)
 	{
-		icon = ic->data;
-		icon->fXMax = -1e4;
-		icon->fXMin = 1e4;
+		fXMax[i] = -1e4;
+		fXMin[i] = 1e4;
 	}
 
 	/* We simulate the move of the cursor in all the width of the dock and we
 	 * get the maximum width and the balance position for each icon.
+	 * This is quadratic in the number of icons, so it is done on the geometry arrays only.
 	 */
-	GList *ic2;
-	for (ic = pIconList; ic != NULL; ic = ic->next)
+	for (i = 0; i < iNbIcons; i ++)
 	{
-		icon = ic->data;
-
-		cairo_dock_calculate_wave_with_position_linear (pIconList, icon->fXAtRest, pDock->fMagnitudeMax, fFlatDockWidth, 0, 0, 0.5, 0, pDock->container.bDirectionUp);
+		_simulate_wave_with_position (pGeometry, pGeometry->fXAtRest[i], pDock->fMagnitudeMax, fFlatDockWidth, 0.5);
 		
-		for (ic2 = pIconList; ic2 != NULL; ic2 = ic2->next)
+		for (j = 0; j < iNbIcons; j ++)
 		{
-			icon = ic2->data;
-
-			if (icon->fX + icon->fWidth * icon->fScale > icon->fXMax)
-				icon->fXMax = icon->fX + icon->fWidth * icon->fScale;
-			if (icon->fX < icon->fXMin)
-				icon->fXMin = icon->fX;
+			if (fX[j] + fWidth[j] * fScale[j] > fXMax[j])
+				fXMax[j] = fX[j] + fWidth[j] * fScale[j];
+			if (fX[j] < fXMin[j])
+				fXMin[j] = fX[j];
 		}
 	}
-	cairo_dock_calculate_wave_with_position_linear (pIconList, fFlatDockWidth - 1, pDock->fMagnitudeMax, fFlatDockWidth, 0, 0, pDock->fAlign, 0, pDock->container.bDirectionUp);  // last calculation at the extreme right of the dock.
-	for (ic = pIconList; ic != NULL; ic = ic->next)
+	gint iPointed;
+	_calculate_wave_with_position (pIcons, iNbIcons, pGeometry->bSortedAtRest, fFlatDockWidth - 1, pDock->fMagnitudeMax, fFlatDockWidth, 0, 0, pDock->fAlign, 0, pDock->container.bDirectionUp, &iPointed);  // last calculation at the extreme right of the dock.
+	for (i = 0; i < iNbIcons; i ++)
 	{
-		icon = ic->data;
+		icon = pIcons[i];
 
-		if (icon->fX + icon->fWidth * icon->fScale > icon->fXMax)
-			icon->fXMax = icon->fX + icon->fWidth * icon->fScale;
-		if (icon->fX < icon->fXMin)
-			icon->fXMin = icon->fX;
+		if (icon->fX + icon->fWidth * icon->fScale > fXMax[i])
+			fXMax[i] = icon->fX + icon->fWidth * icon->fScale;
+		if (icon->fX < fXMin[i])
+			fXMin[i] = icon->fX;
 	}
 
-	fMaxDockWidth = (icon->fXMax - ((Icon *) pIconList->data)->fXMin) * fWidthConstraintFactor + fExtraWidth;
+	fMaxDockWidth = (fXMax[iNbIcons-1] - fXMin[0]) * fWidthConstraintFactor + fExtraWidth;
 	fMaxDockWidth = ceil (fMaxDockWidth) + 1;
 
-	for (ic = pIconList; ic != NULL; ic = ic->next)
+	for (i = 0; i < iNbIcons; i ++)
 	{
-		icon = ic->data;
-		icon->fXMin += fMaxDockWidth / 2;
-		icon->fXMax += fMaxDockWidth / 2;
+		icon = pIcons[i];
+		icon->fXMin = fXMin[i] += fMaxDockWidth / 2;
+		icon->fXMax = fXMax[i] += fMaxDockWidth / 2;
 		//g_print ("%s : [%d;%d]\n", icon->cName, (int) icon->fXMin, (int) icon->fXMax);
-		icon->fX = icon->fXAtRest;
-		icon->fScale = 1;
+		icon->fX = fX[i] = icon->fXAtRest;
+		icon->fScale = fScale[i] = 1;
 	}
+	pGeometry->iPointed = GLDI_DOCK_GEOMETRY_UNKNOWN_INDEX;  // the last calculation may have marked an icon as pointed
 
 	return fMaxDockWidth;
 }
 
-Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_abs, gdouble fMagnitude, double fFlatDockWidth, int iWidth, int iHeight, double fAlign, double fFoldingFactor, gboolean bDirectionUp)
+static GPtrArray *s_pLayoutIcons = NULL;  // scratch array of the icons being laid out, kept between 2 calls to avoid re-allocating it on each motion event.
+
+// iPointed is set to the index of the pointed icon, -1 if none.
+static Icon *_calculate_wave_with_position (Icon **pIcons, guint iNbIcons, gboolean bSortedAtRest, int x_abs, gdouble fMagnitude, double fFlatDockWidth, int iWidth, int iHeight, double fAlign, double fFoldingFactor, gboolean bDirectionUp, gint *iPointedIndex)
 {
 	//g_print (">>>>>%s (%d/%.2f, %dx%d, %.2f, %.2f)\n", __func__, x_abs, fFlatDockWidth, iWidth, iHeight, fAlign, fFoldingFactor);
-	if (pIconList == NULL)
+	*iPointedIndex = -1;
+	if (iNbIcons == 0)
 		return NULL;
 	if (x_abs < 0 && iWidth > 0)
 		// to avoid too quick resize when leaving from the edges.
@@ -606,32 +730,55 @@ Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_a
 		///x_abs = fFlatDockWidth+1;
 		x_abs = (int) fFlatDockWidth;
 	
-	
-	float x_cumulated = 0, fXMiddle, fDeltaExtremum;
-	GList* ic, *pointed_ic;
+	guint i;
+	//\_______________ We compute the phase of the icons (pi/2 next to the cursor), and deduct the sinusoidal amplitude next to them (their scale).
+	// Outside of the sinusoid, the phase is saturated, so all the icons there get the same scale; only the icons inside need to be computed.
+	double fWaveAmplitude = fMagnitude * myIconsParam.fAmplitude;
+	double fScaleBefore = 1 + fWaveAmplitude * sin (0.);
+	double fScaleAfter = 1 + fWaveAmplitude * sin (G_PI);
+	guint iFirst, iLast;
 	Icon *icon, *prev_icon;
-	double fScale = 0.;
-	double offset = 0.;
-	pointed_ic = (x_abs < 0 ? pIconList : NULL);
-	for (ic = pIconList; ic != NULL; ic = ic->next)
+	_get_wave_window (pIcons, iNbIcons, bSortedAtRest, x_abs, &iFirst, &iLast);
+	for (i = 0; i < iFirst; i ++)
 	{
-		icon = ic->data;
-		x_cumulated = icon->fXAtRest;
-		fXMiddle = icon->fXAtRest + icon->fWidth / 2;
-
-		//\_______________ We compute its phase (pi/2 next to the cursor).
-		icon->fPhase = (fXMiddle - x_abs) / myIconsParam.iSinusoidWidth * G_PI + G_PI / 2;
-		if (icon->fPhase < 0)
+		icon = pIcons[i];
+		icon->fPhase = 0;
+		icon->fScale = fScaleBefore;
+	}
+	for (i = iFirst; i < iLast; i ++)
+	{
+		icon = pIcons[i];
+		icon->fPhase = _get_wave_phase (icon->fXAtRest, icon->fWidth, x_abs);
+		if (icon->fPhase <= 0)
 		{
 			icon->fPhase = 0;
+			icon->fScale = fScaleBefore;
 		}
-		else if (icon->fPhase > G_PI)
+		else if (icon->fPhase >= G_PI)
 		{
 			icon->fPhase = G_PI;
+			icon->fScale = fScaleAfter;
 		}
+		else
+			icon->fScale = 1 + fWaveAmplitude * sin (icon->fPhase);
+	}
+	for (i = iLast; i < iNbIcons; i ++)
+	{
+		icon = pIcons[i];
+		icon->fPhase = G_PI;
+		icon->fScale = fScaleAfter;
+	}
+	
+	//\_______________ The positions depend on each other (and on the constraints of each icon), so all the icons are placed.
+	float x_cumulated = 0, fXMiddle, fDeltaExtremum;
+	double fScale = 0.;
+	double offset = 0.;
+	gint iPointed = (x_abs < 0 ? 0 : -1);
+	for (i = 0; i < iNbIcons; i ++)
+	{
+		icon = pIcons[i];
+		x_cumulated = icon->fXAtRest;
 		
-		//\_______________ We deduct the sinusoidal amplitude next to the icon (its scale)
-		icon->fScale = 1 + fMagnitude * myIconsParam.fAmplitude * sin (icon->fPhase);
 		if (iWidth > 0 && icon->fInsertRemoveFactor != 0)
 		{
 			fScale = icon->fScale;
@@ -649,16 +796,16 @@ Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_a
 		/* If we already have defined a pointed icon, we can move the current
 		 * icon compared to the previous one
 		 */
-		if (pointed_ic != NULL)
+		if (iPointed >= 0)
 		{
-			if (ic == pIconList)  // can happen if we are outside from the left of the dock.
+			if (i == 0)  // can happen if we are outside from the left of the dock.
 			{
 				icon->fX = x_cumulated - 1. * (fFlatDockWidth - iWidth) / 2;
 				//g_print ("  outside from the left : icon->fX = %.2f (%.2f)\n", icon->fX, x_cumulated);
 			}
 			else
 			{
-				prev_icon = (ic->prev != NULL ? ic->prev->data : cairo_dock_get_last_icon (pIconList));
+				prev_icon = pIcons[i-1];
 				icon->fX = prev_icon->fX + (prev_icon->fWidth + myIconsParam.iIconGap) * prev_icon->fScale;
 
 				if (icon->fX + icon->fWidth * icon->fScale > icon->fXMax - myIconsParam.fAmplitude * fMagnitude * (icon->fWidth + 1.5*myIconsParam.iIconGap) / 8 && iWidth != 0)
@@ -674,11 +821,11 @@ Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_a
 		}
 		
 		//\_______________ We check if we have a pointer on this icon.
-		if (pointed_ic == NULL
+		if (iPointed < 0
 		    && x_cumulated + icon->fWidth + .5*myIconsParam.iIconGap >= x_abs
 		    && x_cumulated - .5*myIconsParam.iIconGap <= x_abs) // we found the pointed icon.
 		{
-			pointed_ic = ic;
+			iPointed = i;
 			///icon->bPointed = TRUE;
 			icon->bPointed = (x_abs != (int) fFlatDockWidth && x_abs != 0);
 			icon->fX = x_cumulated - (fFlatDockWidth - iWidth) / 2 + (1 - icon->fScale) * (x_abs - x_cumulated + .5*myIconsParam.iIconGap);
@@ -690,30 +837,30 @@ Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_a
 		
 		if (iWidth > 0 && icon->fInsertRemoveFactor != 0)
 		{
-			if (pointed_ic != ic)  // bPointed can be false for the last icon on the right.
-				offset += (icon->fWidth * (fScale - icon->fScale)) * (pointed_ic == NULL ? 1 : -1);
+			if (iPointed != (gint)i)  // bPointed can be false for the last icon on the right.
+				offset += (icon->fWidth * (fScale - icon->fScale)) * (iPointed < 0 ? 1 : -1);
 			else
-				offset += (2*(fXMiddle - x_abs) * (fScale - icon->fScale)) * (pointed_ic == NULL ? 1 : -1);
+			{
+				fXMiddle = GLDI_DOCK_GEOMETRY_X_MIDDLE (icon->fXAtRest, icon->fWidth);
+				offset += (2*(fXMiddle - x_abs) * (fScale - icon->fScale)) * (iPointed < 0 ? 1 : -1);
+			}
 		}
 	}
 	
 	//\_______________ We place icons before pointed icon beside this one
-	if (pointed_ic == NULL)  // We are at the right of icons.
+	if (iPointed < 0)  // We are at the right of icons.
 	{
-		pointed_ic = g_list_last (pIconList);
-		icon = pointed_ic->data;
+		iPointed = iNbIcons - 1;
+		icon = pIcons[iPointed];
 		icon->fX = x_cumulated - (fFlatDockWidth - iWidth) / 2 + (1 - icon->fScale) * (icon->fWidth + .5*myIconsParam.iIconGap);
 		icon->fX = fAlign * iWidth + (icon->fX - fAlign * iWidth) * (1 - fFoldingFactor);
 		//g_print ("  outside on the right: icon->fX = %.2f (%.2f)\n", icon->fX, x_cumulated);
 	}
 	
-	ic = pointed_ic;
-	while (ic != pIconList)
+	for (i = iPointed; i > 0; i --)
 	{
-		icon = ic->data;
-		
-		ic = ic->prev;  // since ic != pIconList, ic->prev is not NULL
-		prev_icon = ic->data;
+		icon = pIcons[i];
+		prev_icon = pIcons[i-1];
 		
 		prev_icon->fX = icon->fX - (prev_icon->fWidth + myIconsParam.iIconGap) * prev_icon->fScale;
 		//g_print ("fX <- %.2f; fXMin : %.2f\n", prev_icon->fX, prev_icon->fXMin);
@@ -733,20 +880,42 @@ Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_a
 	if (offset != 0)
 	{
 		offset /= 2;
-		//g_print ("offset : %.2f (pointed:%s)\n", offset, pointed_ic?((Icon*)pointed_ic->data)->cName:"none");
-		for (ic = pIconList; ic != NULL; ic = ic->next)
-		{
-			icon = ic->data;
-			//if (ic == pIconList)
-			//	cd_debug ("fX : %.2f - %.2f", icon->fX, offset);
-			icon->fX -= offset;
-		}
+		//g_print ("offset : %.2f (pointed:%d)\n", offset, iPointed);
+		for (i = 0; i < iNbIcons; i ++)
+			pIcons[i]->fX -= offset;
 	}
 	
-	icon = pointed_ic->data;
+	icon = pIcons[iPointed];
+	*iPointedIndex = (icon->bPointed ? iPointed : -1);
 	return (icon->bPointed ? icon : NULL);
 }
 
+Icon * cairo_dock_calculate_wave_with_position_linear (GList *pIconList, int x_abs, gdouble fMagnitude, double fFlatDockWidth, int iWidth, int iHeight, double fAlign, double fFoldingFactor, gboolean bDirectionUp)
+{
+	if (pIconList == NULL)
+		return NULL;
+	
+	//\_______________ The icons of a dock are already gathered in a contiguous array, so that we can walk them back and forth by index.
+	// The caller may have placed the icons at rest by itself, so we can't rely on them being sorted.
+	Icon *pFirstIcon = pIconList->data;
+	if (CAIRO_DOCK_IS_DOCK (pFirstIcon->pContainer) && CAIRO_DOCK (pFirstIcon->pContainer)->icons == pIconList)
+	{
+		GldiDockGeometry *pGeometry = gldi_dock_get_geometry (CAIRO_DOCK (pFirstIcon->pContainer));
+		return _calculate_wave_with_position (pGeometry->pIcons, pGeometry->iNbIcons, FALSE, x_abs, fMagnitude, fFlatDockWidth, iWidth, iHeight, fAlign, fFoldingFactor, bDirectionUp, &pGeometry->iPointed);
+	}
+	
+	//\_______________ Otherwise we gather them in a scratch array.
+	if (s_pLayoutIcons == NULL)
+		s_pLayoutIcons = g_ptr_array_new ();
+	g_ptr_array_set_size (s_pLayoutIcons, 0);
+	GList* ic;
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+		g_ptr_array_add (s_pLayoutIcons, ic->data);
+	
+	gint iPointed;
+	return _calculate_wave_with_position ((Icon **) s_pLayoutIcons->pdata, s_pLayoutIcons->len, FALSE, x_abs, fMagnitude, fFlatDockWidth, iWidth, iHeight, fAlign, fFoldingFactor, bDirectionUp, &iPointed);
+}
+
 Icon *cairo_dock_apply_wave_effect_linear (CairoDock *pDock)
 {
 	//\_______________ We compute the cursor's position in the container of the flat dock
@@ -758,7 +927,8 @@ Icon *cairo_dock_apply_wave_effect_linear (CairoDock *pDock)
 
 	//\_______________ We compute all parameters for the icons.
 	double fMagnitude = cairo_dock_calculate_magnitude (pDock->iMagnitudeIndex);  // * pDock->fMagnitudeMax
-	Icon *pPointedIcon = cairo_dock_calculate_wave_with_position_linear (pDock->icons, x_abs, fMagnitude, pDock->fFlatDockWidth, pDock->container.iWidth, pDock->container.iHeight, pDock->fAlign, pDock->fFoldingFactor, pDock->container.bDirectionUp);  // iMaxDockWidth
+	GldiDockGeometry *pGeometry = gldi_dock_get_geometry (pDock);
+	Icon *pPointedIcon = _calculate_wave_with_position (pGeometry->pIcons, pGeometry->iNbIcons, pGeometry->bSortedAtRest, x_abs, fMagnitude, pDock->fFlatDockWidth, pDock->container.iWidth, pDock->container.iHeight, pDock->fAlign, pDock->fFoldingFactor, pDock->container.bDirectionUp, &pGeometry->iPointed);  // iMaxDockWidth
 	return pPointedIcon;
 }
 
@@ -55,6 +55,9 @@
 #include "cairo-dock-dock-manager.h"
 #include "cairo-dock-dialog-priv.h" //gldi_dialogs_refresh_all, gldi_dialogs_replace_all
 #include "cairo-dock-dock-priv.h" // also includes dock-factory
+#include "cairo-dock-dock-hud.h"
+#include "cairo-dock-trace.h"  // gldi_trace_frame_drawn
+#include "cairo-dock-dock-geometry-priv.h"  // gldi_dock_invalidate_geometry
 
 // dependencies
 extern CairoDockHidingEffect *g_pHidingBackend;
@@ -122,6 +125,8 @@ void _dock_size_update_opengl (CairoDock *pDock)
 
 static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoContext, CairoDock *pDock)
 {
+	gint64 iStartTime = gldi_dock_hud_begin ();
+	gint64 iTraceStartTime = gldi_trace_begin ();
 	gboolean bIsLoading = cairo_dock_is_loading ();
 	
 	if (g_bUseOpenGL && pDock->pRenderer->render_opengl != NULL)  // OpenGL rendering
@@ -141,7 +146,8 @@ static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoCon
 			_dock_size_update_opengl (pDock);
 		}
 		
-		if (! gldi_gl_container_begin_draw_full (CAIRO_CONTAINER (pDock), area.x + area.y != 0 ? &area : NULL, TRUE))
+		gldi_dock_hud_add_damage (pDock);
+		if (! gldi_gl_container_begin_draw_full (CAIRO_CONTAINER (pDock), &area, TRUE))  // only repaint the damaged area, the rest of the dock is clipped.
 			return FALSE;
 		
 		if (bIsLoading)
@@ -156,6 +162,7 @@ static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoCon
 		{
 			gldi_object_notify (pDock, NOTIFICATION_RENDER, pDock, NULL);
 		}
+		gldi_dock_hud_draw (pDock, NULL);
 		
 		gldi_gl_container_end_draw (CAIRO_CONTAINER (pDock));
 	}
@@ -175,6 +182,7 @@ static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoCon
 		{
 			gldi_object_notify (pDock, NOTIFICATION_RENDER, pDock, pCairoContext);
 		}
+		gldi_dock_hud_draw (pDock, pCairoContext);
 	}
 	
 	if (!bIsLoading && pDock->bWMIconsNeedUpdate)
@@ -183,6 +191,9 @@ static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoCon
 		pDock->bWMIconsNeedUpdate = FALSE;
 	}
 	
+	gldi_dock_hud_end (pDock, GLDI_DOCK_HUD_FRAME, iStartTime);
+	if (iTraceStartTime != 0 && ! bIsLoading)
+		gldi_trace_frame_drawn (iTraceStartTime);
 	return FALSE;
 }
 
@@ -724,7 +735,7 @@ static gboolean _on_leave_notify2 (G_GNUC_UNUSED GtkWidget* pWidget, GdkEventCro
 				GdkDragContext *context = gtk_drag_begin_with_coordinates (pDock->container.pWidget,
 					targets, GDK_ACTION_COPY, 1, (GdkEvent*)pEvent, -1, -1);
 				gtk_target_list_unref (targets);
-				gtk_drag_set_icon_surface (context, s_pIconClicked->image.pSurface);
+				gtk_drag_set_icon_surface (context, cairo_dock_image_buffer_get_surface (&s_pIconClicked->image));
 			}
 			// "old" method: use a flying container (only works reliably on X11)
 			else s_pFlyingContainer = gldi_flying_container_new (s_pIconClicked, pOriginDock);
@@ -1894,7 +1905,9 @@ static gboolean _cairo_dock_hide (CairoDock *pDock)
 					bVisibleIconsPresent = TRUE;
 			}
 			
+			gint64 iStartTime = gldi_dock_hud_begin ();
 			pDock->pRenderer->calculate_icons (pDock);
+			gldi_dock_hud_end (pDock, GLDI_DOCK_HUD_LAYOUT, iStartTime);
 			
 			gldi_dialogs_replace_all ();
 			
@@ -2046,6 +2059,7 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 	}
 	//g_print (" => %d, %d\n", pDock->bIsShrinkingDown, pDock->bIsGrowingUp);
 	
+	gint64 iStartTime = gldi_dock_hud_begin ();
 	double fDockMagnitude = cairo_dock_calculate_magnitude (pDock->iMagnitudeIndex);
 	gboolean bIconIsAnimating;
 	gboolean bNoMoreDemandingAttention = FALSE;
@@ -2116,6 +2130,7 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 		gldi_object_notify (pDock, NOTIFICATION_UPDATE_SLOW, pDock, &pContainer->bKeepSlowAnimation);
 	}
 	gldi_object_notify (pDock, NOTIFICATION_UPDATE, pDock, &bContinue);
+	gldi_dock_hud_end (pDock, GLDI_DOCK_HUD_UPDATE, iStartTime);
 	
 	if (! bContinue && ! pContainer->bKeepSlowAnimation)
 	{
@@ -2246,6 +2261,7 @@ static void _detach_icon (GldiContainer *pContainer, Icon *icon)
 	//\___________________ On l'enleve de la liste.
 	pDock->icons = g_list_delete_link (pDock->icons, ic);
 	ic = NULL;
+	gldi_dock_invalidate_geometry (pDock);
 	pDock->fFlatDockWidth -= icon->fWidth + myIconsParam.iIconGap;
 	
 	//\___________________ On enleve le separateur si c'est la derniere icone de son type.
@@ -2318,6 +2334,20 @@ static void _detach_icon (GldiContainer *pContainer, Icon *icon)
 	icon->cParentDockName = NULL;
 }
 
+static void _set_inserted_icon_size (CairoDock *pDock, Icon *icon)
+{
+	int wi = icon->image.iWidth, hi = icon->image.iHeight;
+	cairo_dock_set_icon_size_in_dock (pDock, icon);
+	
+	if (wi != cairo_dock_icon_get_allocated_width (icon) || hi != cairo_dock_icon_get_allocated_height (icon)  // if size has changed, reload the buffers
+	|| (! icon->image.pSurface && ! icon->image.iTexture))  // might happen, for instance if the icon is a launcher pinned on a desktop and was detached before being loaded.
+		cairo_dock_trigger_load_icon_buffers (icon);
+	
+	pDock->fFlatDockWidth += myIconsParam.iIconGap + icon->fWidth;
+	if (! CAIRO_DOCK_ICON_TYPE_IS_SEPARATOR (icon))
+		pDock->iMaxIconHeight = MAX (pDock->iMaxIconHeight, icon->fHeight);
+}
+
 static void _insert_icon (GldiContainer *pContainer, Icon *icon, gboolean bAnimateIcon)
 {
 	CairoDock *pDock = CAIRO_DOCK (pContainer);
@@ -2351,18 +2381,10 @@ static void _insert_icon (GldiContainer *pContainer, Icon *icon, gboolean bAnima
 	pDock->icons = g_list_insert_sorted (pDock->icons,
 		icon,
 		(GCompareFunc)cairo_dock_compare_icons_order);
+	gldi_dock_invalidate_geometry (pDock);
 	
 	//\______________ set the icon size, now that it's inside a container.
-	int wi = icon->image.iWidth, hi = icon->image.iHeight;
-	cairo_dock_set_icon_size_in_dock (pDock, icon);
-	
-	if (wi != cairo_dock_icon_get_allocated_width (icon) || hi != cairo_dock_icon_get_allocated_height (icon)  // if size has changed, reload the buffers
-	|| (! icon->image.pSurface && ! icon->image.iTexture))  // might happen, for instance if the icon is a launcher pinned on a desktop and was detached before being loaded.
-		cairo_dock_trigger_load_icon_buffers (icon);
-	
-	pDock->fFlatDockWidth += myIconsParam.iIconGap + icon->fWidth;
-	if (! CAIRO_DOCK_ICON_TYPE_IS_SEPARATOR (icon))
-		pDock->iMaxIconHeight = MAX (pDock->iMaxIconHeight, icon->fHeight);
+	_set_inserted_icon_size (pDock, icon);
 	
 	//\______________ insert a separator if needed.
 	if (bSeparatorNeeded)
@@ -2431,6 +2453,93 @@ static void _insert_icon (GldiContainer *pContainer, Icon *icon, gboolean bAnima
 	gldi_object_notify (pDock, NOTIFICATION_INSERT_ICON, icon, pDock);  /// TODO: make it a Container notification...
 }
 
+void gldi_dock_insert_icons (CairoDock *pDock, GList *pIcons)
+{
+	//\______________ icons that need more than a sorted insertion are inserted one by one.
+	GPtrArray *pNewIcons = g_ptr_array_new ();
+	GList *ic;
+	Icon *icon;
+	for (ic = pIcons; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		if (cairo_dock_get_icon_container (icon) != NULL)
+		{
+			cd_warning ("This icon (%s) is already inside a container !", icon->cName);
+			continue;
+		}
+		if (icon->fOrder == CAIRO_DOCK_LAST_ORDER || CAIRO_DOCK_ICON_TYPE_IS_APPLI (icon))
+		{
+			gldi_icon_insert_in_container (icon, CAIRO_CONTAINER (pDock), ! CAIRO_DOCK_ANIMATE_ICON);
+			continue;
+		}
+		g_ptr_array_add (pNewIcons, icon);
+	}
+	if (pNewIcons->len == 0)
+	{
+		g_ptr_array_free (pNewIcons, TRUE);
+		return;
+	}
+	cd_debug ("insert %d icons in %s", pNewIcons->len, gldi_dock_get_name (pDock));
+	
+	//\______________ merge them into the list at once, instead of a sorted insertion for each of them.
+	GList *pList = NULL;
+	GHashTable *pNewIconsSet = g_hash_table_new (NULL, NULL);
+	guint i;
+	for (i = 0; i < pNewIcons->len; i ++)
+	{
+		icon = g_ptr_array_index (pNewIcons, i);
+		g_hash_table_add (pNewIconsSet, icon);
+		cairo_dock_set_icon_container (icon, pDock);
+		if (icon->cParentDockName == NULL)
+			icon->cParentDockName = g_strdup (gldi_dock_get_name (pDock));
+		pList = g_list_prepend (pList, icon);
+	}
+	pDock->icons = g_list_sort (g_list_concat (pDock->icons, pList), (GCompareFunc)cairo_dock_compare_icons_order);
+	gldi_dock_invalidate_geometry (pDock);
+	
+	//\______________ set the icons size, now that they're inside a container.
+	for (i = 0; i < pNewIcons->len; i ++)
+	{
+		icon = g_ptr_array_index (pNewIcons, i);
+		_set_inserted_icon_size (pDock, icon);
+		icon->fInsertRemoveFactor = 0.;
+	}
+	
+	//\______________ insert a separator between 2 groups, where one of the new icons starts or ends a group (the same as inserting them one by one).
+	Icon *pNextIcon, *pSeparatorIcon;
+	for (ic = pDock->icons; ic != NULL && ic->next != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		pNextIcon = ic->next->data;
+		if (! CAIRO_DOCK_ICON_TYPE_IS_SEPARATOR (icon) && ! CAIRO_DOCK_ICON_TYPE_IS_SEPARATOR (pNextIcon)
+		&& icon->iGroup != pNextIcon->iGroup
+		&& (g_hash_table_contains (pNewIconsSet, icon) || g_hash_table_contains (pNewIconsSet, pNextIcon)))
+		{
+			pSeparatorIcon = gldi_auto_separator_icon_new (icon, pNextIcon);
+			gldi_icon_insert_in_container (pSeparatorIcon, CAIRO_CONTAINER(pDock), ! CAIRO_DOCK_ANIMATE_ICON);  // it goes right after 'icon', so the loop skips it.
+		}
+	}
+	g_hash_table_destroy (pNewIconsSet);
+	
+	//\______________ the layout is computed once for all the icons.
+	cairo_dock_trigger_update_dock_size (pDock);
+	
+	if (pDock->iRefCount != 0)  // on prevoit le redessin de l'icone pointant sur le sous-dock.
+	{
+		cairo_dock_trigger_redraw_subdock_content (pDock);
+	}
+	
+	//\______________ Notify everybody.
+	for (i = 0; i < pNewIcons->len; i ++)
+	{
+		icon = g_ptr_array_index (pNewIcons, i);
+		if (icon->pSubDock != NULL)
+			gldi_subdock_synchronize_orientation (icon->pSubDock, pDock, FALSE);
+		gldi_object_notify (pDock, NOTIFICATION_INSERT_ICON, icon, pDock);
+	}
+	g_ptr_array_free (pNewIcons, TRUE);
+}
+
 void gldi_dock_attach_applet (CairoDock *pDock, GldiModuleInstance *pInstance)
 {
 	pDock->applets = g_list_prepend (pDock->applets, pInstance); // note: we don't care about order
@@ -2615,6 +2724,7 @@ void cairo_dock_remove_icons_from_dock (CairoDock *pDock, CairoDock *pReceivingD
 	g_return_if_fail (pReceivingDock != NULL);
 	GList *pIconsList = pDock->icons;
 	pDock->icons = NULL;
+	gldi_dock_invalidate_geometry (pDock);
 	Icon *icon;
 	GList *ic;
 	for (ic = pIconsList; ic != NULL; ic = ic->next)
@@ -0,0 +1,101 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_DOCK_GEOMETRY_PRIV__
+#define  __CAIRO_DOCK_DOCK_GEOMETRY_PRIV__
+
+#include <glib.h>
+#include "cairo-dock-struct.h"
+
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-dock-geometry-priv.h This class keeps a contiguous copy of the icons of a dock and of their geometry, alongside the list of icons.
+* The per-frame loops (layout, rendering) walk these arrays by index instead of following the list and dereferencing each Icon, which are big and scattered in memory.
+*
+* The arrays are rebuilt lazily when the icons have been inserted, removed or reordered: every place that modifies the list of icons of a dock has to call \ref gldi_dock_invalidate_geometry. The Icon fields remain the reference: the layout keeps writing them, since they are used everywhere else.
+* It's internal to the core: the geometry is kept aside of the CairoDock structure, so that its layout can change without breaking the API of the plug-ins.
+*/
+
+typedef struct _GldiDockGeometry GldiDockGeometry;
+
+/// Contiguous geometry of the icons of a dock, in the order of the list (structure of arrays).
+struct _GldiDockGeometry {
+	/// number of icons.
+	guint iNbIcons;
+	/// allocated length of the arrays.
+	guint iSize;
+	/// the icons.
+	Icon **pIcons;
+	/// position of the icons at rest.
+	gdouble *fXAtRest;
+	/// width of the icons.
+	gdouble *fWidth;
+	/// position of the icons, used by the layout.
+	gdouble *fX;
+	/// scale of the icons, used by the layout.
+	gdouble *fScale;
+	/// extremal positions of the icons with the wave, used by the layout.
+	gdouble *fXMin;
+	gdouble *fXMax;
+	/// TRUE if the middles of the icons at rest are in increasing order, which lets the wave look for the icons inside the sinusoid by bisection. Updated when the arrays are built and when the positions at rest are computed.
+	gboolean bSortedAtRest;
+	/// index of the icon pointed by the last layout, -1 if none, or GLDI_DOCK_GEOMETRY_UNKNOWN_INDEX if the layout didn't tell.
+	gint iPointed;
+	/// incremented each time the icons of the dock change.
+	guint iStamp;
+	/// value of iStamp when the arrays were built.
+	guint iBuiltStamp;
+};
+
+#define GLDI_DOCK_GEOMETRY_UNKNOWN_INDEX -2
+
+/// Middle of an icon at rest, in single precision, as the wave uses it.
+#define GLDI_DOCK_GEOMETRY_X_MIDDLE(fXAtRest, fWidth) ((float) ((fXAtRest) + (fWidth) / 2))
+
+/** Get the geometry of a dock, rebuilding it if the icons have changed since the last call to \ref gldi_dock_invalidate_geometry. The arrays are valid until the icons of the dock change.
+*@param pDock the dock
+*@return the geometry, never NULL.
+*/
+GldiDockGeometry *gldi_dock_get_geometry (CairoDock *pDock);
+
+/** Tell that the icons of a dock have been inserted, removed or reordered. The geometry will be rebuilt the next time it's needed.
+*@param pDock the dock
+*/
+void gldi_dock_invalidate_geometry (CairoDock *pDock);
+
+/** Free the geometry of a dock.
+*@param pDock the dock
+*/
+void gldi_dock_free_geometry (CairoDock *pDock);
+
+/** Take the positions at rest and the widths of the icons of a dock, once they have been computed.
+*@param pDock the dock
+*/
+void gldi_dock_geometry_update_at_rest (CairoDock *pDock);
+
+/** Get the index of the first icon to draw, so that the pointed icon is drawn last (above its neighbours). Same as \ref cairo_dock_get_first_drawn_element_linear, but doesn't need to walk the icons when the layout told which icon is pointed.
+*@param pDock the dock
+*@return the index of the first icon to draw, or -1 if the dock is empty.
+*/
+gint gldi_dock_geometry_get_first_drawn_index (CairoDock *pDock);
+
+G_END_DECLS
+#endif
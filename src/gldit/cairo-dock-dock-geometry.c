@@ -0,0 +1,159 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+
+#include "cairo-dock-icon-factory.h"
+#include "cairo-dock-dock-factory.h"
+#include "cairo-dock-dock-geometry-priv.h"
+
+static GHashTable *s_pDockGeometries = NULL;  // dock -> geometry
+
+static void _resize_geometry (GldiDockGeometry *pGeometry, guint iNbIcons)
+{
+	if (iNbIcons <= pGeometry->iSize)
+		return;
+	guint iSize = MAX (16, pGeometry->iSize);
+	while (iSize < iNbIcons)
+		iSize *= 2;
+	pGeometry->pIcons   = g_renew (Icon*, pGeometry->pIcons, iSize);
+	pGeometry->fXAtRest = g_renew (gdouble, pGeometry->fXAtRest, iSize);
+	pGeometry->fWidth   = g_renew (gdouble, pGeometry->fWidth, iSize);
+	pGeometry->fX       = g_renew (gdouble, pGeometry->fX, iSize);
+	pGeometry->fScale   = g_renew (gdouble, pGeometry->fScale, iSize);
+	pGeometry->fXMin    = g_renew (gdouble, pGeometry->fXMin, iSize);
+	pGeometry->fXMax    = g_renew (gdouble, pGeometry->fXMax, iSize);
+	pGeometry->iSize = iSize;
+}
+
+static void _update_at_rest (GldiDockGeometry *pGeometry)
+{
+	gboolean bSorted = TRUE;
+	float fXMiddle, fPrevXMiddle = 0;
+	Icon *icon;
+	guint i;
+	for (i = 0; i < pGeometry->iNbIcons; i ++)
+	{
+		icon = pGeometry->pIcons[i];
+		pGeometry->fXAtRest[i] = icon->fXAtRest;
+		pGeometry->fWidth[i]   = icon->fWidth;
+		fXMiddle = GLDI_DOCK_GEOMETRY_X_MIDDLE (icon->fXAtRest, icon->fWidth);
+		if (i != 0 && fXMiddle < fPrevXMiddle)  // the icons have been wrapped around the dock, or are being resized
+			bSorted = FALSE;
+		fPrevXMiddle = fXMiddle;
+	}
+	pGeometry->bSortedAtRest = bSorted;
+}
+
+static void _rebuild_geometry (CairoDock *pDock, GldiDockGeometry *pGeometry)
+{
+	_resize_geometry (pGeometry, g_list_length (pDock->icons));
+	
+	Icon *icon;
+	GList *ic;
+	guint i = 0;
+	for (ic = pDock->icons; ic != NULL; ic = ic->next, i ++)
+	{
+		icon = ic->data;
+		pGeometry->pIcons[i]   = icon;
+		pGeometry->fX[i]       = icon->fX;
+		pGeometry->fScale[i]   = icon->fScale;
+		pGeometry->fXMin[i]    = icon->fXMin;
+		pGeometry->fXMax[i]    = icon->fXMax;
+	}
+	pGeometry->iNbIcons = i;
+	pGeometry->iPointed = GLDI_DOCK_GEOMETRY_UNKNOWN_INDEX;
+	pGeometry->iBuiltStamp = pGeometry->iStamp;
+	_update_at_rest (pGeometry);
+}
+
+static void _free_geometry (GldiDockGeometry *pGeometry)
+{
+	g_free (pGeometry->pIcons);
+	g_free (pGeometry->fXAtRest);
+	g_free (pGeometry->fWidth);
+	g_free (pGeometry->fX);
+	g_free (pGeometry->fScale);
+	g_free (pGeometry->fXMin);
+	g_free (pGeometry->fXMax);
+	g_free (pGeometry);
+}
+
+GldiDockGeometry *gldi_dock_get_geometry (CairoDock *pDock)
+{
+	if (s_pDockGeometries == NULL)
+		s_pDockGeometries = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)_free_geometry);
+	GldiDockGeometry *pGeometry = g_hash_table_lookup (s_pDockGeometries, pDock);
+	if (pGeometry == NULL)
+	{
+		pGeometry = g_new0 (GldiDockGeometry, 1);
+		pGeometry->iStamp = 1;  // not built yet
+		g_hash_table_insert (s_pDockGeometries, pDock, pGeometry);
+	}
+	if (pGeometry->iBuiltStamp != pGeometry->iStamp)
+		_rebuild_geometry (pDock, pGeometry);
+	return pGeometry;
+}
+
+void gldi_dock_invalidate_geometry (CairoDock *pDock)
+{
+	GldiDockGeometry *pGeometry = (s_pDockGeometries ? g_hash_table_lookup (s_pDockGeometries, pDock) : NULL);
+	if (pGeometry != NULL)  // else it will be built the first time it's needed
+		pGeometry->iStamp ++;
+}
+
+void gldi_dock_free_geometry (CairoDock *pDock)
+{
+	if (s_pDockGeometries != NULL)
+		g_hash_table_remove (s_pDockGeometries, pDock);
+}
+
+void gldi_dock_geometry_update_at_rest (CairoDock *pDock)
+{
+	GldiDockGeometry *pGeometry = gldi_dock_get_geometry (pDock);
+	_update_at_rest (pGeometry);
+}
+
+gint gldi_dock_geometry_get_first_drawn_index (CairoDock *pDock)
+{
+	GldiDockGeometry *pGeometry = gldi_dock_get_geometry (pDock);
+	if (pGeometry->iNbIcons == 0)
+		return -1;
+	
+	gint iPointed = pGeometry->iPointed;
+	if (iPointed >= 0 && ! pGeometry->pIcons[iPointed]->bPointed)  // not pointed anymore since the layout.
+		iPointed = GLDI_DOCK_GEOMETRY_UNKNOWN_INDEX;
+	if (iPointed == GLDI_DOCK_GEOMETRY_UNKNOWN_INDEX)  // the view has its own layout, look for the pointed icon.
+	{
+		guint i;
+		iPointed = -1;
+		for (i = 0; i < pGeometry->iNbIcons; i ++)
+		{
+			if (pGeometry->pIcons[i]->bPointed)
+			{
+				iPointed = i;
+				break;
+			}
+		}
+	}
+	
+	if (iPointed < 0 || (guint)iPointed + 1 == pGeometry->iNbIcons)  // last icon or no pointed icon.
+		return 0;
+	return iPointed + 1;
+}
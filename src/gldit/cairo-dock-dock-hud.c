@@ -0,0 +1,271 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <cairo.h>
+#include <gtk/gtk.h>
+#include <GL/gl.h>
+
+#include "cairo-dock-dock-factory.h"
+#include "cairo-dock-dock-manager.h"  // myDockObjectMgr
+#include "cairo-dock-container.h"
+#include "cairo-dock-draw-opengl.h"  // cairo_dock_create_texture_from_surface
+#include "cairo-dock-opengl.h"  // gldi_gl_container_set_ortho_view
+#include "cairo-dock-opengl-priv.h"  // gldi_gl_container_make_current
+#include "cairo-dock-log.h"
+#include "cairo-dock-dock-hud.h"
+
+#define CD_HUD_PERIOD 1000000  // us
+#define CD_HUD_FONT_SIZE 11
+#define CD_HUD_MARGIN 4
+
+gboolean g_bShowDockHud = FALSE;
+static GHashTable *s_pDockHuds = NULL;  // dock -> CairoDockHud
+
+typedef struct {
+	gint64 iPeriodStart;
+	guint iNbFrames;
+	guint iNbSteps;  // number of animation steps
+	guint iNbRedraws;
+	guint iNbPartialFrames;  // OpenGL frames that only repainted the damaged area
+	gint64 iTotalTime[GLDI_DOCK_HUD_NB_COUNTERS];
+	gint64 iMaxFrameTime;
+	gchar *cText;  // measures of the last period
+	GLuint iTexture;  // cText, when drawing with OpenGL
+	gint iTextureWidth, iTextureHeight;
+	} CairoDockHud;
+
+static void _free_hud (CairoDockHud *pHud)
+{
+	g_free (pHud->cText);
+	g_free (pHud);  // the texture is deleted while the GL context is current, see _delete_hud_texture
+}
+
+static void _delete_hud_texture (CairoDock *pDock, CairoDockHud *pHud, G_GNUC_UNUSED gpointer data)
+{
+	if (pHud->iTexture != 0 && gldi_gl_container_make_current (CAIRO_CONTAINER (pDock)))
+		_cairo_dock_delete_texture (pHud->iTexture);
+	pHud->iTexture = 0;
+}
+
+static gboolean _on_dock_destroyed (G_GNUC_UNUSED gpointer data, CairoDock *pDock)
+{
+	CairoDockHud *pHud = (s_pDockHuds ? g_hash_table_lookup (s_pDockHuds, pDock) : NULL);
+	if (pHud)
+	{
+		_delete_hud_texture (pDock, pHud, NULL);  // the dock is not reset yet, so its GL context is still there
+		g_hash_table_remove (s_pDockHuds, pDock);
+	}
+	return GLDI_NOTIFICATION_LET_PASS;
+}
+
+static CairoDockHud *_get_hud (CairoDock *pDock)
+{
+	if (s_pDockHuds == NULL)
+	{
+		s_pDockHuds = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify)_free_hud);
+		gldi_object_register_notification (&myDockObjectMgr,
+			NOTIFICATION_DESTROY,
+			(GldiNotificationFunc) _on_dock_destroyed,
+			GLDI_RUN_AFTER, NULL);
+	}
+	CairoDockHud *pHud = g_hash_table_lookup (s_pDockHuds, pDock);
+	if (pHud == NULL)
+	{
+		pHud = g_new0 (CairoDockHud, 1);
+		pHud->iPeriodStart = g_get_monotonic_time ();
+		g_hash_table_insert (s_pDockHuds, pDock, pHud);
+	}
+	return pHud;
+}
+
+static void _publish_measures (CairoDock *pDock, CairoDockHud *pHud, gint64 iNow)
+{
+	double fPeriod = (iNow - pHud->iPeriodStart) / 1e6;
+	guint n = MAX (1, pHud->iNbFrames);
+	g_free (pHud->cText);
+	pHud->cText = g_strdup_printf ("frame  %.2f ms (max %.2f) %.0f fps\n"
+		"layout %.2f ms/frame\n"
+		"render %.2f ms/frame\n"
+		"update %.2f ms/step, %.0f steps/s\n"
+		"redraw requests %.0f/s\n"
+		"partial frames %.0f%%",
+		pHud->iTotalTime[GLDI_DOCK_HUD_FRAME] / 1e3 / n, pHud->iMaxFrameTime / 1e3, pHud->iNbFrames / fPeriod,
+		pHud->iTotalTime[GLDI_DOCK_HUD_LAYOUT] / 1e3 / n,
+		pHud->iTotalTime[GLDI_DOCK_HUD_RENDER] / 1e3 / n,
+		pHud->iTotalTime[GLDI_DOCK_HUD_UPDATE] / 1e3 / MAX (1, pHud->iNbSteps), pHud->iNbSteps / fPeriod,
+		pHud->iNbRedraws / fPeriod,
+		100. * pHud->iNbPartialFrames / n);
+	_delete_hud_texture (pDock, pHud, NULL);  // will be re-created on next draw
+	
+	pHud->iPeriodStart = iNow;
+	pHud->iNbFrames = pHud->iNbSteps = pHud->iNbRedraws = pHud->iNbPartialFrames = 0;
+	pHud->iMaxFrameTime = 0;
+	memset (pHud->iTotalTime, 0, sizeof (pHud->iTotalTime));
+}
+
+void gldi_dock_hud_end (CairoDock *pDock, GldiDockHudCounter iCounter, gint64 iStartTime)
+{
+	if (iStartTime == 0 || ! g_bShowDockHud)
+		return;
+	gint64 iNow = g_get_monotonic_time ();
+	CairoDockHud *pHud = _get_hud (pDock);
+	gint64 iDuration = iNow - iStartTime;
+	pHud->iTotalTime[iCounter] += iDuration;
+	switch (iCounter)
+	{
+		case GLDI_DOCK_HUD_FRAME:
+		{
+			pHud->iNbFrames ++;
+			GldiGLDamage *pDamage = gldi_gl_container_get_damage (CAIRO_CONTAINER (pDock));
+			if (pDamage != NULL && pDamage->history[0].width != 0)  // the frame that has just been presented was partial
+				pHud->iNbPartialFrames ++;
+			if (iDuration > pHud->iMaxFrameTime)
+				pHud->iMaxFrameTime = iDuration;
+			if (iNow - pHud->iPeriodStart >= CD_HUD_PERIOD)
+				_publish_measures (pDock, pHud, iNow);
+		}
+		break;
+		case GLDI_DOCK_HUD_UPDATE:
+			pHud->iNbSteps ++;
+		break;
+		default:
+		break;
+	}
+}
+
+void gldi_dock_hud_count_redraw (GldiContainer *pContainer)
+{
+	if (! g_bShowDockHud || ! CAIRO_DOCK_IS_DOCK (pContainer))
+		return;
+	_get_hud (CAIRO_DOCK (pContainer))->iNbRedraws ++;
+}
+
+static cairo_surface_t *_create_text_surface (const gchar *cText, int *iWidth, int *iHeight)
+{
+	gchar **cLines = g_strsplit (cText, "\n", -1);
+	int i, w = 0, n = g_strv_length (cLines);
+	
+	// measure the text
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 1, 1);
+	cairo_t *ctx = cairo_create (pSurface);
+	cairo_select_font_face (ctx, "monospace", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+	cairo_set_font_size (ctx, CD_HUD_FONT_SIZE);
+	cairo_text_extents_t extents;
+	for (i = 0; i < n; i ++)
+	{
+		cairo_text_extents (ctx, cLines[i], &extents);
+		w = MAX (w, extents.x_advance);
+	}
+	cairo_destroy (ctx);
+	cairo_surface_destroy (pSurface);
+	
+	// draw it on a dark background
+	*iWidth = w + 2 * CD_HUD_MARGIN;
+	*iHeight = n * (CD_HUD_FONT_SIZE + 2) + 2 * CD_HUD_MARGIN;
+	pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, *iWidth, *iHeight);
+	ctx = cairo_create (pSurface);
+	cairo_set_source_rgba (ctx, 0., 0., 0., .7);
+	cairo_paint (ctx);
+	cairo_select_font_face (ctx, "monospace", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+	cairo_set_font_size (ctx, CD_HUD_FONT_SIZE);
+	cairo_set_source_rgb (ctx, 0.3, 1., 0.3);
+	for (i = 0; i < n; i ++)
+	{
+		cairo_move_to (ctx, CD_HUD_MARGIN, CD_HUD_MARGIN + (i + 1) * (CD_HUD_FONT_SIZE + 2) - 2);
+		cairo_show_text (ctx, cLines[i]);
+	}
+	cairo_destroy (ctx);
+	g_strfreev (cLines);
+	return pSurface;
+}
+
+void gldi_dock_hud_add_damage (CairoDock *pDock)
+{
+	if (! g_bShowDockHud)
+		return;
+	CairoDockHud *pHud = _get_hud (pDock);
+	if (pHud->iTexture != 0)  // unchanged since the last frame: it's simply redrawn inside the damaged area.
+		return;
+	// new measures (once per period): their size is not known yet, repaint the whole dock.
+	GldiContainer *pContainer = CAIRO_CONTAINER (pDock);
+	GdkRectangle area = {0, 0,
+		(pContainer->bIsHorizontal ? pContainer->iWidth : pContainer->iHeight),
+		(pContainer->bIsHorizontal ? pContainer->iHeight : pContainer->iWidth)};
+	gldi_gl_container_add_damage (pContainer, &area);
+}
+
+void gldi_dock_hud_draw (CairoDock *pDock, cairo_t *pCairoContext)
+{
+	if (! g_bShowDockHud)
+		return;
+	CairoDockHud *pHud = _get_hud (pDock);
+	const gchar *cText = (pHud->cText ? pHud->cText : "measuring...");
+	
+	if (pCairoContext != NULL)
+	{
+		int w, h;
+		cairo_surface_t *pSurface = _create_text_surface (cText, &w, &h);
+		cairo_save (pCairoContext);
+		cairo_identity_matrix (pCairoContext);
+		cairo_reset_clip (pCairoContext);
+		cairo_set_source_surface (pCairoContext, pSurface, 0., 0.);
+		cairo_paint (pCairoContext);
+		cairo_restore (pCairoContext);
+		cairo_surface_destroy (pSurface);
+	}
+	else
+	{
+		if (pHud->iTexture == 0)
+		{
+			cairo_surface_t *pSurface = _create_text_surface (cText, &pHud->iTextureWidth, &pHud->iTextureHeight);
+			pHud->iTexture = cairo_dock_create_texture_from_surface (pSurface);
+			cairo_surface_destroy (pSurface);
+		}
+		GldiContainer *pContainer = CAIRO_CONTAINER (pDock);
+		int iWindowHeight = (pContainer->bIsHorizontal ? pContainer->iHeight : pContainer->iWidth);
+		gint iScale = gdk_window_get_scale_factor (gldi_container_get_gdk_window (pContainer));
+		
+		gldi_gl_container_set_ortho_view (pContainer);
+		glMatrixMode (GL_MODELVIEW);
+		glPushMatrix ();
+		glLoadIdentity ();
+		glTranslatef (pHud->iTextureWidth / 2., iWindowHeight * iScale - pHud->iTextureHeight / 2., 0.);  // top-left corner
+		_cairo_dock_enable_texture ();
+		_cairo_dock_set_blend_alpha ();
+		_cairo_dock_set_alpha (1.);
+		_cairo_dock_apply_texture_at_size (pHud->iTexture, pHud->iTextureWidth, pHud->iTextureHeight);
+		_cairo_dock_disable_texture ();
+		glPopMatrix ();
+	}
+}
+
+void gldi_docks_show_hud (gboolean bShow)
+{
+	if (bShow == g_bShowDockHud)
+		return;
+	g_bShowDockHud = bShow;
+	cd_message ("%s the docks HUD", bShow ? "showing" : "hiding");
+	if (! bShow && s_pDockHuds != NULL)
+	{
+		g_hash_table_foreach (s_pDockHuds, (GHFunc)_delete_hud_texture, NULL);
+		g_hash_table_remove_all (s_pDockHuds);
+	}
+	gldi_docks_redraw_all_root ();
+}
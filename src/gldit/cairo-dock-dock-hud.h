@@ -0,0 +1,84 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_DOCK_HUD__
+#define  __CAIRO_DOCK_DOCK_HUD__
+
+#include <glib.h>
+#include <cairo.h>
+#include "cairo-dock-struct.h"
+
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-dock-hud.h This class draws a small debug overlay on each dock, showing how much time is spent to compute and draw it.
+* Measures are accumulated over 1 second, and the overlay is updated each second.
+*/
+
+/// Measures displayed by the HUD.
+typedef enum {
+	/// time spent to draw a frame (whole expose)
+	GLDI_DOCK_HUD_FRAME = 0,
+	/// time spent in the renderer's calculate_icons
+	GLDI_DOCK_HUD_LAYOUT,
+	/// time spent in the renderer's render/render_opengl
+	GLDI_DOCK_HUD_RENDER,
+	/// time spent in the NOTIFICATION_UPDATE* handlers, per animation step
+	GLDI_DOCK_HUD_UPDATE,
+	GLDI_DOCK_HUD_NB_COUNTERS
+	} GldiDockHudCounter;
+
+/// TRUE if the HUD is displayed.
+extern gboolean g_bShowDockHud;
+
+/** Start a measure. Returns 0 when the HUD is hidden, so that measuring costs nothing.
+*/
+#define gldi_dock_hud_begin(...) (G_UNLIKELY (g_bShowDockHud) ? g_get_monotonic_time () : 0)
+
+/** End a measure started with \ref gldi_dock_hud_begin and account it to a dock.
+*@param pDock the dock
+*@param iCounter what has been measured
+*@param iStartTime value returned by \ref gldi_dock_hud_begin
+*/
+void gldi_dock_hud_end (CairoDock *pDock, GldiDockHudCounter iCounter, gint64 iStartTime);
+
+/** Count a redraw request on a container (only docks are accounted).
+*@param pContainer the container
+*/
+void gldi_dock_hud_count_redraw (GldiContainer *pContainer);
+
+/** Add the HUD to the damage of a dock drawn with OpenGL when its measures have changed, so that they are repainted even if no icon is damaged.
+*@param pDock the dock
+*/
+void gldi_dock_hud_add_damage (CairoDock *pDock);
+
+/** Draw the HUD on a dock, at the end of its rendering.
+*@param pDock the dock
+*@param pCairoContext the drawing context, or NULL when drawing with OpenGL
+*/
+void gldi_dock_hud_draw (CairoDock *pDock, cairo_t *pCairoContext);
+
+/** Show or hide the HUD on all docks.
+*@param bShow TRUE to show it
+*/
+void gldi_docks_show_hud (gboolean bShow);
+
+G_END_DECLS
+#endif
@@ -56,6 +56,8 @@
 #include "cairo-dock-dock-facility.h"
 #include "cairo-dock-dock-manager.h"
 #include "cairo-dock-dock-priv.h" // also includes dock-factory
+#include "cairo-dock-dock-hud.h"
+#include "cairo-dock-dock-geometry-priv.h"  // gldi_dock_free_geometry
 #include "cairo-dock-dialog-manager.h" // myDialogObjectMgr
 #include "cairo-dock-windows-manager.h"
 
@@ -1184,7 +1186,9 @@ static gboolean _render_dock_notification (G_GNUC_UNUSED gpointer pUserData, Cai
 		
 		/// TODO: see if it's ok to not use the optimized rendering any more...
 		/// if not, we can probably get the clip on the cairo context
+		gint64 iStartTime = gldi_dock_hud_begin ();
 		pDock->pRenderer->render (pCairoContext, pDock);
+		gldi_dock_hud_end (pDock, GLDI_DOCK_HUD_RENDER, iStartTime);
 		
 		if (pDock->fHideOffset != 0 && g_pHidingBackend != NULL && g_pHidingBackend->post_render)
 			g_pHidingBackend->post_render (pDock, pDock->fHideOffset, pCairoContext);
@@ -1200,7 +1204,9 @@ static gboolean _render_dock_notification (G_GNUC_UNUSED gpointer pUserData, Cai
 		if (pDock->iFadeCounter != 0 && g_pKeepingBelowBackend != NULL && g_pKeepingBelowBackend->pre_render_opengl)
 			g_pKeepingBelowBackend->pre_render_opengl (pDock, (double) pDock->iFadeCounter / myBackendsParam.iHideNbSteps);
 		
+		gint64 iStartTime = gldi_dock_hud_begin ();
 		pDock->pRenderer->render_opengl (pDock);
+		gldi_dock_hud_end (pDock, GLDI_DOCK_HUD_RENDER, iStartTime);
 		
 		if (pDock->fHideOffset != 0 && g_pHidingBackend != NULL && g_pHidingBackend->post_render_opengl)
 			g_pHidingBackend->post_render_opengl (pDock, pDock->fHideOffset);
@@ -2040,6 +2046,7 @@ static void reset_object (GldiObject *obj)
 		glDeleteFramebuffersEXT (1, &pDock->iFboId);
 	if (pDock->iRedirectedTexture != 0)
 		_cairo_dock_delete_texture (pDock->iRedirectedTexture);
+	gldi_dock_free_geometry (pDock);
 	g_free (pDock->cDockName);
 }
 
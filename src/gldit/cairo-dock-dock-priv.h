@@ -92,6 +92,12 @@ void cairo_dock_set_icon_size_in_dock (CairoDock *pDock, Icon *icon);
 
 void cairo_dock_create_redirect_texture_for_dock (CairoDock *pDock);
 
+/** Insert several icons in a dock at once, without animation. It is the same as inserting each icon with \ref gldi_icon_insert_in_container, except that the list of icons is merged and the layout is updated only once, which is much faster for a lot of icons (like when loading the launchers).
+*@param pDock a dock.
+*@param pIcons a list of icons that are not inside a container yet; the list is not modified.
+*/
+void gldi_dock_insert_icons (CairoDock *pDock, GList *pIcons);
+
 /** Attach an applet to a dock. This will prevent the dock from being
 *  deleted even if the applet detaches its icon. Should be used for
 *  all applets that have this dock set as their parent container.
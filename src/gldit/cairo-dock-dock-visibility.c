@@ -26,6 +26,7 @@
 #include "cairo-dock-desktop-manager.h"
 #include "cairo-dock-dock-manager.h"
 #include "cairo-dock-dock-priv.h"
+#include "cairo-dock-window-overlaps-priv.h"
 #include "cairo-dock-dock-visibility.h"
 
 
@@ -35,9 +36,8 @@
 
 static GldiDockVisibilityBackend s_backend = {0};
 
-static inline gboolean _window_overlaps_area (const GldiWindowActor *actor, const GtkAllocation *pArea);
-static inline gboolean _window_overlaps_dock (const GldiWindowActor *actor, const CairoDock *pDock);
-static inline gboolean _dock_has_overlapping_window (GtkAllocation *pArea);
+static void _update_window_overlaps (GldiWindowActor *actor, gboolean bDestroyed);
+static void _invalidate_overlaps (void);
 
 
 static void _get_dock_geometry (const CairoDock *pDock, GtkAllocation *pArea)
@@ -95,7 +95,7 @@ static void _get_dock_geometry (const CairoDock *pDock, GtkAllocation *pArea)
 	}
 }
 
-static void _show_if_no_overlapping_window (CairoDock *pDock, G_GNUC_UNUSED gpointer data)
+static void _hide_if_any_overlap_or_show (CairoDock *pDock, G_GNUC_UNUSED gpointer data)
 {
 	if (pDock->iVisibility != CAIRO_DOCK_VISI_AUTO_HIDE_ON_OVERLAP_ANY)
 		return ;
@@ -106,44 +106,13 @@ static void _show_if_no_overlapping_window (CairoDock *pDock, G_GNUC_UNUSED gpoi
 			cairo_dock_deactivate_temporary_auto_hide (pDock);
 		}
 	}
-}
-
-static void _hide_if_overlap (CairoDock *pDock, GldiWindowActor *pAppli)
-{
-	if (pDock->iVisibility != CAIRO_DOCK_VISI_AUTO_HIDE_ON_OVERLAP_ANY)
-		return ;
-	if (! cairo_dock_is_temporary_hidden (pDock))
-	{
-		if (gldi_window_is_on_current_desktop (pAppli) && _window_overlaps_dock (pAppli, pDock))
-		{
-			cairo_dock_activate_temporary_auto_hide (pDock);
-		}
-	}
-}
-
-static void _hide_if_overlap_or_show_if_no_overlapping_window (CairoDock *pDock, GldiWindowActor *pAppli)
-{
-	if (pDock->iVisibility != CAIRO_DOCK_VISI_AUTO_HIDE_ON_OVERLAP_ANY)
-		return ;
-	GtkAllocation area;
-	_get_dock_geometry (pDock, &area);
-	if (_window_overlaps_area (pAppli, &area))  // cette fenetre peut provoquer l'auto-hide.
+	else
 	{
-		if (! cairo_dock_is_temporary_hidden (pDock))
+		if (gldi_dock_has_overlapping_window (pDock))
 		{
 			cairo_dock_activate_temporary_auto_hide (pDock);
 		}
 	}
-	else  // ne gene pas/plus.
-	{
-		if (cairo_dock_is_temporary_hidden (pDock))
-		{
-			if (!_dock_has_overlapping_window (&area))
-			{
-				cairo_dock_deactivate_temporary_auto_hide (pDock);
-			}
-		}
-	}
 }
 
 static void _hide_show_if_on_our_way (CairoDock *pDock, GldiWindowActor *pCurrentAppli)
@@ -162,7 +131,7 @@ static void _hide_show_if_on_our_way (CairoDock *pDock, GldiWindowActor *pCurren
 		GtkAllocation area;
 		_get_dock_geometry (pDock, &area);
 		
-		if (gldi_window_is_on_current_desktop (pCurrentAppli) && _window_overlaps_area (pCurrentAppli, &area))
+		if (gldi_window_is_on_current_desktop (pCurrentAppli) && gldi_window_intersects_area (pCurrentAppli, &area))
 			bShow = FALSE;
 		else
 		{
@@ -170,7 +139,7 @@ static void _hide_show_if_on_our_way (CairoDock *pDock, GldiWindowActor *pCurren
 				gldi_window_get_transient_for (pCurrentAppli) : NULL;
 		
 			if (pParentAppli && gldi_window_is_on_current_desktop (pParentAppli) &&
-				_window_overlaps_area (pParentAppli, &area))
+				gldi_window_intersects_area (pParentAppli, &area))
 			{
 				bShow = FALSE;
 			}
@@ -186,27 +155,6 @@ static void _hide_show_if_on_our_way (CairoDock *pDock, GldiWindowActor *pCurren
 		cairo_dock_activate_temporary_auto_hide (pDock);
 }
 
-static void _hide_if_any_overlap_or_show (CairoDock *pDock, G_GNUC_UNUSED gpointer data)
-{
-	if (pDock->iVisibility != CAIRO_DOCK_VISI_AUTO_HIDE_ON_OVERLAP_ANY)
-		return ;
-	if (cairo_dock_is_temporary_hidden (pDock))
-	{
-		if (!gldi_dock_has_overlapping_window (pDock))
-		{
-			cairo_dock_deactivate_temporary_auto_hide (pDock);
-		}
-	}
-	else
-	{
-		if (gldi_dock_has_overlapping_window (pDock))
-		{
-			cairo_dock_activate_temporary_auto_hide (pDock);
-		}
-	}
-}
-
-
   ///////////////
  // Callbacks //
 ///////////////
@@ -215,7 +163,8 @@ static gboolean _on_window_created (G_GNUC_UNUSED gpointer data, GldiWindowActor
 {
 	// docks visibility on overlap any
 	/// see how to handle modal dialogs ...
-	gldi_docks_foreach_root ((GFunc)_hide_if_overlap, actor);
+	_update_window_overlaps (actor, FALSE);
+	gldi_docks_foreach_root ((GFunc)_hide_if_any_overlap_or_show, NULL);
 	
 	return GLDI_NOTIFICATION_LET_PASS;
 }
@@ -223,9 +172,10 @@ static gboolean _on_window_created (G_GNUC_UNUSED gpointer data, GldiWindowActor
 static gboolean _on_window_destroyed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
 	// docks visibility on overlap any
-	gboolean bIsHidden = actor->bIsHidden;  // the window is already destroyed, but the actor is still valid (it represents the last state of the window); temporarily make it hidden so that it doesn't overlap the dock (that's a bit tricky, we could also add an "except-this-window" parameter to 'gldi_dock_has_overlapping_window()')
+	gboolean bIsHidden = actor->bIsHidden;  // the window is already destroyed, but the actor is still valid (it represents the last state of the window); temporarily make it hidden so that it's not counted again if a dock has to recompute its overlapping windows
 	actor->bIsHidden = TRUE;
-	gldi_docks_foreach_root ((GFunc)_show_if_no_overlapping_window, NULL);
+	_update_window_overlaps (actor, TRUE);
+	gldi_docks_foreach_root ((GFunc)_hide_if_any_overlap_or_show, NULL);
 	actor->bIsHidden = bIsHidden;
 	
 	return GLDI_NOTIFICATION_LET_PASS;
@@ -234,14 +184,8 @@ static gboolean _on_window_destroyed (G_GNUC_UNUSED gpointer data, GldiWindowAct
 static gboolean _on_window_size_position_changed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
 	// docks visibility on overlap any
-	if (! gldi_window_is_on_current_desktop (actor))  // not on this desktop/viewport any more
-	{
-		gldi_docks_foreach_root ((GFunc)_show_if_no_overlapping_window, NULL);
-	}
-	else  // elle est sur le viewport courant.
-	{
-		gldi_docks_foreach_root ((GFunc)_hide_if_overlap_or_show_if_no_overlapping_window, actor);
-	}
+	_update_window_overlaps (actor, FALSE);
+	gldi_docks_foreach_root ((GFunc)_hide_if_any_overlap_or_show, NULL);
 	
 	// docks visibility on overlap active
 	if (actor == gldi_windows_get_active())  // c'est la fenetre courante qui a change de bureau.
@@ -266,10 +210,8 @@ static gboolean _on_window_state_changed (G_GNUC_UNUSED gpointer data, GldiWindo
 	// docks visibility on overlap any
 	if (bHiddenChanged)
 	{
-		if (!actor->bIsHidden)  // la fenetre reapparait.
-			gldi_docks_foreach_root ((GFunc)_hide_if_overlap, actor);
-		else  // la fenetre se cache.
-			gldi_docks_foreach_root ((GFunc)_show_if_no_overlapping_window, NULL);
+		_update_window_overlaps (actor, FALSE);
+		gldi_docks_foreach_root ((GFunc)_hide_if_any_overlap_or_show, NULL);
 	}
 	
 	return GLDI_NOTIFICATION_LET_PASS;
@@ -284,14 +226,8 @@ static gboolean _on_window_desktop_changed (G_GNUC_UNUSED gpointer data, GldiWin
 	}
 	
 	// docks visibility on overlap any
-	if (gldi_window_is_on_current_desktop (actor))  // petite optimisation : si l'appli arrive sur le bureau courant, on peut se contenter de ne verifier qu'elle.
-	{
-		gldi_docks_foreach_root ((GFunc)_hide_if_overlap, actor);
-	}
-	else  // la fenetre n'est plus sur le bureau courant.
-	{
-		gldi_docks_foreach_root ((GFunc)_show_if_no_overlapping_window, NULL);
-	}
+	_update_window_overlaps (actor, FALSE);
+	gldi_docks_foreach_root ((GFunc)_hide_if_any_overlap_or_show, NULL);
 	
 	return GLDI_NOTIFICATION_LET_PASS;
 }
@@ -303,11 +239,19 @@ static gboolean _on_desktop_changed (G_GNUC_UNUSED gpointer data)
 	gldi_docks_foreach_root ((GFunc)_hide_show_if_on_our_way, pCurrentAppli);
 	
 	// docks visibility on overlap any
+	_invalidate_overlaps ();  // the set of windows on the current desktop has changed entirely
 	gldi_docks_foreach_root ((GFunc)_hide_if_any_overlap_or_show, NULL);
 	
 	return GLDI_NOTIFICATION_LET_PASS;
 }
 
+static gboolean _on_desktop_geometry_changed (G_GNUC_UNUSED gpointer data)
+{
+	// viewports may have moved relatively to the windows
+	_invalidate_overlaps ();
+	
+	return GLDI_NOTIFICATION_LET_PASS;
+}
 
 static gboolean _on_active_window_changed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
@@ -321,36 +265,63 @@ static gboolean _on_active_window_changed (G_GNUC_UNUSED gpointer data, GldiWind
  // Utilities //
 ///////////////
 
-static inline gboolean _window_overlaps_area (const GldiWindowActor *actor, const GtkAllocation *pArea)
+static gboolean _window_is_overlapping_dock (GldiWindowActor *actor, gpointer data)
 {
-	const GtkAllocation *pWindowGeometry = &actor->windowGeometry;
-	return (pWindowGeometry->x < pArea->x + pArea->width &&
-		pWindowGeometry->x + pWindowGeometry->width > pArea->x &&
-		pWindowGeometry->y < pArea->y + pArea->height &&
-		pWindowGeometry->y + pWindowGeometry->height > pArea->y);
+	return gldi_window_is_overlapping_area (actor, (const GtkAllocation*)data);
 }
 
-static inline gboolean _window_overlaps_dock (const GldiWindowActor *actor, const CairoDock *pDock)
-{
-	if (actor->bIsHidden || !actor->bDisplayed) return FALSE;
-	GtkAllocation area;
-	_get_dock_geometry (pDock, &area);
-	return _window_overlaps_area (actor, &area);
-}
 
-static gboolean _window_is_overlapping_dock (GldiWindowActor *actor, gpointer data)
+  //////////////////////
+ // Overlap tracking //
+//////////////////////
+
+/* The docks that hide when any window overlaps them keep the set of the
+ * windows currently overlapping them (see cairo-dock-window-overlaps-priv.h).
+ */
+static GHashTable *s_pDockOverlaps = NULL;  // dock -> GldiWindowOverlaps
+
+static GldiWindowOverlaps *_get_dock_overlaps (CairoDock *pDock)
 {
-	const GtkAllocation *pArea = (const GtkAllocation*)data;
-	if (gldi_window_is_on_current_desktop (actor) && ! actor->bIsHidden && actor->bDisplayed)
+	if (s_pDockOverlaps == NULL)
+		s_pDockOverlaps = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify)gldi_window_overlaps_free);
+	
+	GldiWindowOverlaps *pOverlaps = g_hash_table_lookup (s_pDockOverlaps, pDock);
+	if (pOverlaps == NULL)
 	{
-		return _window_overlaps_area (actor, pArea);
+		pOverlaps = gldi_window_overlaps_new ();
+		g_hash_table_insert (s_pDockOverlaps, pDock, pOverlaps);
 	}
-	return FALSE;
+	return pOverlaps;
+}
+
+static void _update_one_dock_overlaps (G_GNUC_UNUSED CairoDock *pDock, GldiWindowOverlaps *pOverlaps, gpointer *data)
+{
+	gldi_window_overlaps_update_window (pOverlaps, data[0], GPOINTER_TO_INT (data[1]));
 }
 
-static inline gboolean _dock_has_overlapping_window (GtkAllocation *pArea)
+static void _update_window_overlaps (GldiWindowActor *actor, gboolean bDestroyed)
 {
-	return (gldi_windows_find (_window_is_overlapping_dock, pArea) != NULL);
+	if (s_pDockOverlaps == NULL)
+		return;
+	gpointer data[2] = {actor, GINT_TO_POINTER (bDestroyed)};
+	g_hash_table_foreach (s_pDockOverlaps, (GHFunc)_update_one_dock_overlaps, data);
+}
+
+static void _invalidate_one_dock_overlaps (G_GNUC_UNUSED CairoDock *pDock, GldiWindowOverlaps *pOverlaps, G_GNUC_UNUSED gpointer data)
+{
+	gldi_window_overlaps_invalidate (pOverlaps);
+}
+
+static void _invalidate_overlaps (void)
+{
+	if (s_pDockOverlaps != NULL)
+		g_hash_table_foreach (s_pDockOverlaps, (GHFunc)_invalidate_one_dock_overlaps, NULL);
+}
+
+static void _forget_dock_overlaps (CairoDock *pDock)
+{
+	if (s_pDockOverlaps != NULL)
+		g_hash_table_remove (s_pDockOverlaps, pDock);
 }
 
 
@@ -358,6 +329,9 @@ static gboolean _has_overlap (CairoDock *pDock)
 {
 	GtkAllocation area;
 	_get_dock_geometry (pDock, &area);
+	if (pDock->iVisibility == CAIRO_DOCK_VISI_AUTO_HIDE_ON_OVERLAP_ANY)
+		return gldi_window_overlaps_has_window (_get_dock_overlaps (pDock), &area);
+	// other docks are queried only occasionally, no need to track them.
 	return (gldi_windows_find (_window_is_overlapping_dock, &area) != NULL);
 }
 
@@ -374,6 +348,9 @@ gboolean gldi_dock_has_overlapping_window (CairoDock *pDock)
 
 static void _refresh (CairoDock *pDock)
 {	
+	if (pDock->iVisibility != CAIRO_DOCK_VISI_AUTO_HIDE_ON_OVERLAP_ANY)
+		_forget_dock_overlaps (pDock);  // also called when the dock is destroyed
+	
 	if (pDock->iVisibility == CAIRO_DOCK_VISI_AUTO_HIDE_ON_OVERLAP_ANY)
 		_hide_if_any_overlap_or_show (pDock, NULL);
 	else if (pDock->iVisibility == CAIRO_DOCK_VISI_AUTO_HIDE_ON_OVERLAP)
@@ -432,6 +409,10 @@ static void _start_default_backend (void)
 			NOTIFICATION_DESKTOP_CHANGED,
 			(GldiNotificationFunc) _on_desktop_changed,
 			GLDI_RUN_FIRST, NULL);
+		gldi_object_register_notification (&myDesktopMgr,
+			NOTIFICATION_DESKTOP_GEOMETRY_CHANGED,
+			(GldiNotificationFunc) _on_desktop_geometry_changed,
+			GLDI_RUN_FIRST, NULL);
 		gldi_object_register_notification (&myWindowObjectMgr,
 			NOTIFICATION_WINDOW_ACTIVATED,
 			(GldiNotificationFunc) _on_active_window_changed,
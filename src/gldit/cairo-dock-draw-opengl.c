@@ -32,6 +32,8 @@
 #include "cairo-dock-overlay.h"
 #include "cairo-dock-style-manager.h"
 #include "cairo-dock-opengl-path.h"
+#include "cairo-dock-opengl-batch.h"
+#include "cairo-dock-icon-manager.h"  // myIconObjectMgr
 #include "cairo-dock-opengl-priv.h"
 
 #include "cairo-dock-draw-opengl.h"
@@ -486,6 +488,120 @@ void cairo_dock_render_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDo
 }
 
 
+  /////////////////
+ // BATCHED ICONS //
+///////////////////
+
+static GldiNotificationList *s_pCoreIconRenderers[2] = {NULL, NULL};  // PRE_RENDER_ICON, RENDER_ICON
+
+void cairo_dock_set_core_icon_renderers (void)
+{
+	g_free (s_pCoreIconRenderers[0]);
+	g_free (s_pCoreIconRenderers[1]);
+	s_pCoreIconRenderers[0] = gldi_object_copy_notifications (&myIconObjectMgr, NOTIFICATION_PRE_RENDER_ICON);
+	s_pCoreIconRenderers[1] = gldi_object_copy_notifications (&myIconObjectMgr, NOTIFICATION_RENDER_ICON);
+}
+
+gboolean cairo_dock_icons_can_be_batched (void)
+{
+	return (s_pCoreIconRenderers[1] != NULL
+		&& gldi_object_notifications_match (&myIconObjectMgr, NOTIFICATION_PRE_RENDER_ICON, s_pCoreIconRenderers[0])
+		&& gldi_object_notifications_match (&myIconObjectMgr, NOTIFICATION_RENDER_ICON, s_pCoreIconRenderers[1]));
+}
+
+static inline gboolean _icon_may_have_indicators (Icon *icon)  // the indicators are drawn by the Indicators manager.
+{
+	return (icon->bHasIndicator  // window indicator
+		|| (icon->pAppli != NULL && (icon->pAppli == gldi_windows_get_active () || icon->pSubDock != NULL))  // active window indicator
+		|| (icon->pSubDock != NULL && icon->cClass != NULL));  // class indicator
+}
+
+gboolean cairo_dock_batch_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDockMagnitude, gboolean bUseText, CairoDockGLBatch *pBatch)
+{
+	if (icon->image.iTexture == 0)
+		return TRUE;  // nothing to draw, like cairo_dock_render_one_icon_opengl.
+	
+	//\_____________________ only plain icons can be batched.
+	if (icon->fOrientation != 0 || icon->iRotationX != 0 || icon->iRotationY != 0
+	|| GLDI_OBJECT_IS_SEPARATOR_ICON (icon)
+	|| pDock->container.bUseReflect
+	|| pDock->container.bPerspectiveView
+	|| _icon_may_have_indicators (icon))  // the rendering notifications are only emitted on the Icon manager, which cairo_dock_icons_can_be_batched() has checked.
+		return FALSE;
+	gboolean bDrawLabel = (bUseText && icon->label.iTexture != 0 && icon->iHideLabel == 0
+		&& (icon->bPointed || (icon->fScale > 1.01 && ! myIconsParam.bLabelForPointedIconOnly)));
+	if (bDrawLabel && (! pDock->container.bIsHorizontal || cairo_dock_image_buffer_is_animated (&icon->label)))  // labels of vertical docks may be faded on their last part.
+		return FALSE;
+	
+	if (CAIRO_DOCK_IS_APPLI (icon) && myTaskbarParam.fVisibleAppliAlpha != 0 && ! GLDI_OBJECT_IS_APPLET_ICON (icon) && !(myTaskbarParam.iMinimizedWindowRenderType == 1 && icon->pAppli->bIsHidden))
+	{
+		double fAlpha = (icon->pAppli->bIsHidden ? MIN (1 - myTaskbarParam.fVisibleAppliAlpha, 1) : MIN (myTaskbarParam.fVisibleAppliAlpha + 1, 1));
+		if (fAlpha != 1)
+			icon->fAlpha = fAlpha;
+	}
+	
+	//\_____________________ the center of the icon, as in cairo_dock_render_one_icon_opengl.
+	double fX=0, fY=0;
+	_compute_icon_coordinate (icon, CAIRO_CONTAINER (pDock), fDockMagnitude * pDock->fMagnitudeMax, &fX, &fY);
+	double x, y, z = - icon->fHeight * icon->fScale;
+	if (pDock->container.bIsHorizontal)
+	{
+		x = fX;
+		y = fY - icon->fHeight * icon->fScale * (1 - icon->fGlideScale/2);
+	}
+	else
+	{
+		x = fY + icon->fHeight * icon->fScale * (1 - icon->fGlideScale/2);
+		y = fX;
+	}
+	
+	//\_____________________ the icon, then its overlays.
+	double fSizeX, fSizeY;
+	cairo_dock_get_current_icon_size (icon, CAIRO_CONTAINER (pDock), &fSizeX, &fSizeY);
+	cairo_dock_gl_batch_add_quad (pBatch, CAIRO_DOCK_GL_BATCH_LAYER_ICONS, icon->image.iTexture,
+		icon->fAlpha == 1 ? CAIRO_DOCK_GL_BATCH_BLEND_PBUFFER : CAIRO_DOCK_GL_BATCH_BLEND_ALPHA,
+		x, y, z,
+		fSizeX * myIconsParam.fExtraScale, fSizeY * myIconsParam.fExtraScale,
+		icon->fAlpha);
+	
+	cairo_dock_batch_icon_overlays_opengl (icon, pDock->container.fRatio, pBatch, x, y, z);
+	
+	//\_____________________ the label (horizontal docks only).
+	if (bDrawLabel)
+	{
+		double fMagnitude;
+		if (myIconsParam.bLabelForPointedIconOnly || pDock->fMagnitudeMax == 0. || myIconsParam.fAmplitude == 0.)
+		{
+			fMagnitude = fDockMagnitude;
+		}
+		else
+		{
+			fMagnitude = (icon->fScale - 1) / myIconsParam.fAmplitude;
+			fMagnitude = pow (fMagnitude, myIconsParam.fLabelAlphaThreshold);
+		}
+		
+		double dx = .5 * (icon->label.iWidth & 1);  // stick the texture to the pixels grid.
+		double dy = .5 * (icon->label.iHeight & 1);
+		int gap = (myDocksParam.iDockLineWidth + myDocksParam.iFrameMargin) * (1 - pDock->fMagnitudeMax) + 1;
+		
+		if (fX + icon->label.iWidth/2 > pDock->container.iWidth)
+			fX = pDock->container.iWidth - icon->label.iWidth/2;
+		if (fX - icon->label.iWidth/2 < 0)
+			fX = icon->label.iWidth/2;
+		
+		cairo_dock_gl_batch_add_quad (pBatch, CAIRO_DOCK_GL_BATCH_LAYER_LABELS, icon->label.iTexture, CAIRO_DOCK_GL_BATCH_BLEND_OVER,
+			floor (fX) + dx,
+			pDock->container.bDirectionUp ?
+				floor (fY + icon->label.iHeight / 2) + gap + dy:
+				floor (fY - icon->fHeight * icon->fScale - icon->label.iHeight / 2) - gap - dy,
+			0.,
+			icon->label.iWidth, icon->label.iHeight,
+			fMagnitude);
+	}
+	return TRUE;
+}
+
+
 void cairo_dock_render_hidden_dock_opengl (CairoDock *pDock)
 {
 	//g_print ("%s (%d, %x)\n", __func__, pDock->bIsMainDock, g_pVisibleZoneSurface);
@@ -768,7 +884,9 @@ GLuint cairo_dock_create_texture_from_image_full (const gchar *cImageFile, doubl
 
 void cairo_dock_update_icon_texture (Icon *pIcon)
 {
-	if (pIcon != NULL && pIcon->image.pSurface != NULL)
+	if (pIcon == NULL || cairo_dock_image_buffer_is_texture_only (&pIcon->image))  // the texture is the only image of the icon, it's already up-to-date (re-creating the surface would just read it back).
+		return;
+	if (pIcon->image.pSurface != NULL)
 	{
 		_cairo_dock_enable_texture ();
 		_cairo_dock_set_blend_source ();
@@ -902,7 +1020,7 @@ void cairo_dock_draw_hidden_appli_icon (Icon *pIcon, GldiContainer *pContainer,
 		if (pIcon->pAppli->bIsHidden)
 		{
 			iOriginalTexture = pIcon->image.iTexture;
-			pIcon->image.iTexture = cairo_dock_create_texture_from_surface (pIcon->image.pSurface);
+			pIcon->image.iTexture = cairo_dock_create_texture_from_surface (cairo_dock_image_buffer_get_surface (&pIcon->image));
 			/// Using FBOs copies the texture data (pixels) within VRAM only:
 			/// - setup & bind FBO
 			/// - setup destination texture (using glTexImage() w/ pixels = 0)
@@ -912,7 +1030,7 @@ void cairo_dock_draw_hidden_appli_icon (Icon *pIcon, GldiContainer *pContainer,
 		}
 		else
 		{
-			iOriginalTexture = cairo_dock_create_texture_from_surface (pIcon->image.pSurface);
+			iOriginalTexture = cairo_dock_create_texture_from_surface (cairo_dock_image_buffer_get_surface (&pIcon->image));
 		}
 		
 		cairo_dock_set_transition_on_icon (pIcon, pContainer,
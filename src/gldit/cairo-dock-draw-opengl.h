@@ -53,6 +53,25 @@ void cairo_dock_translate_on_icon_opengl (Icon *icon, GldiContainer *pContainer,
 */
 void cairo_dock_render_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDockMagnitude, gboolean bUseText);
 
+/** Remember the callbacks that the core uses to render the icons. It is called once the managers are initialized; as long as nobody else hooks the rendering of the icons, they can be batched.
+*/
+void cairo_dock_set_core_icon_renderers (void);
+
+/** Tell if the icons can currently be drawn with \ref cairo_dock_batch_one_icon_opengl, that is to say if only the core renders them.
+*@return TRUE if the icons can be batched.
+*/
+gboolean cairo_dock_icons_can_be_batched (void);
+
+/** Same as \ref cairo_dock_render_one_icon_opengl, but adds the icon, its overlays and its label to a batch, to be drawn later with \ref cairo_dock_gl_batch_draw. Only plain icons (no rotation, indicator nor reflection) can be batched, and the dock must be in ortho view. Since the batch is drawn later, it has to be drawn before any icon that is not batched, to keep the order of the icons.
+*@param icon the icon to draw.
+*@param pDock the dock containing the icon.
+*@param fDockMagnitude current magnitude of the dock.
+*@param bUseText TRUE to draw the labels.
+*@param pBatch the batch
+*@return FALSE if the icon can't be batched and must be drawn with \ref cairo_dock_render_one_icon_opengl.
+*/
+gboolean cairo_dock_batch_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDockMagnitude, gboolean bUseText, CairoDockGLBatch *pBatch);
+
 void cairo_dock_render_hidden_dock_opengl (CairoDock *pDock);
 
   //////////////////
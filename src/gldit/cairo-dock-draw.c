@@ -22,6 +22,7 @@
 #include "cairo-dock-icon-facility.h"  // cairo_dock_get_next_element
 #include "cairo-dock-dock-factory.h"
 #include "cairo-dock-dock-facility.h"  // cairo_dock_get_first_drawn_element_linear
+#include "cairo-dock-dock-geometry-priv.h"  // gldi_dock_geometry_get_first_drawn_index
 #include "cairo-dock-animations.h"  // cairo_dock_calculate_magnitude
 #include "cairo-dock-log.h"
 #include "cairo-dock-dock-manager.h"  // myDocksParam
@@ -806,23 +807,25 @@ void cairo_dock_draw_string (cairo_t *pCairoContext, CairoDock *pDock, double fS
 
 void cairo_dock_render_icons_linear (cairo_t *pCairoContext, CairoDock *pDock)
 {
-	GList *pFirstDrawnElement = cairo_dock_get_first_drawn_element_linear (pDock->icons);
-	if (pFirstDrawnElement == NULL)
+	gint iFirstDrawnIndex = gldi_dock_geometry_get_first_drawn_index (pDock);
+	if (iFirstDrawnIndex < 0)
 		return;
 	
 	double fDockMagnitude = cairo_dock_calculate_magnitude (pDock->iMagnitudeIndex);  // * pDock->fMagnitudeMax
+	GldiDockGeometry *pGeometry = gldi_dock_get_geometry (pDock);
+	guint iNbIcons = pGeometry->iNbIcons, i, n;
 	Icon *icon;
-	GList *ic = pFirstDrawnElement;
-	do
+	for (n = 0; n < iNbIcons; n ++)
 	{
-		icon = ic->data;
+		i = (iFirstDrawnIndex + n) % iNbIcons;
+		if (i >= pGeometry->iNbIcons)  // an icon has been removed while drawing
+			break;
+		icon = pGeometry->pIcons[i];
 
 		cairo_save (pCairoContext);
 		cairo_dock_render_one_icon (icon, pDock, pCairoContext, fDockMagnitude, TRUE);
 		cairo_restore (pCairoContext);
-
-		ic = cairo_dock_get_next_element (ic, pDock->icons);
-	} while (ic != pFirstDrawnElement);
+	}
 }
 
 
@@ -27,6 +27,7 @@
 #include "cairo-dock-draw-opengl.h"
 #include "cairo-dock-icon-factory.h"
 #include "cairo-dock-icon-facility.h"
+#include "cairo-dock-image-buffer.h"  // cairo_dock_image_buffer_get_surface
 #include "cairo-dock-module-instance-manager.h"  // gldi_module_instance_detach_at_position
 #include "cairo-dock-applet-manager.h"  // GLDI_OBJECT_IS_APPLET_ICON
 #include "cairo-dock-log.h"
@@ -119,12 +120,13 @@ static gboolean _on_render_flying_container_notification (G_GNUC_UNUSED gpointer
 			cairo_save (pCairoContext);
 			
 			cairo_translate (pCairoContext, pIcon->fDrawX, pIcon->fDrawY);
-			if (pIcon->image.pSurface != NULL)  // we can't use cairo_dock_render_one_icon() here since it's not a dock, and anyway we don't need it.
+			cairo_surface_t *pSurface = cairo_dock_image_buffer_get_surface (&pIcon->image);  // the icon may only be kept in video memory.
+			if (pSurface != NULL)  // we can't use cairo_dock_render_one_icon() here since it's not a dock, and anyway we don't need it.
 			{
 				cairo_save (pCairoContext);
 				
 				cairo_dock_set_icon_scale_on_context (pCairoContext, pIcon, pFlyingContainer->container.bIsHorizontal, pFlyingContainer->container.fRatio, pFlyingContainer->container.bDirectionUp);
-				cairo_set_source_surface (pCairoContext, pIcon->image.pSurface, 0.0, 0.0);
+				cairo_set_source_surface (pCairoContext, pSurface, 0.0, 0.0);
 				cairo_paint (pCairoContext);
 				
 				cairo_restore (pCairoContext);
@@ -37,10 +37,19 @@
 #include "cairo-dock-icon-facility.h"
 #include "cairo-dock-data-renderer.h"
 #include "cairo-dock-overlay.h"
+#include "cairo-dock-opengl-font.h"  // cairo_dock_get_glyph_atlas_font
+#include "cairo-dock-task.h"  // decode the images in a worker
+#include "cairo-dock-image-cache.h"  // cairo_dock_image_cache_create_surface_full
+#include "cairo-dock-launcher-manager.h"  // GLDI_OBJECT_IS_LAUNCHER_ICON
+#include "cairo-dock-icon-manager.h"  // cairo_dock_search_icon_s_path
+#include "cairo-dock-trace.h"
 #include "cairo-dock-icon-factory.h"
 
 extern CairoDockImageBuffer g_pIconBackgroundBuffer;
-//extern gboolean g_bUseOpenGL;
+extern gboolean g_bUseOpenGL;
+
+// the task decoding the image of an icon is kept in its first reserved slot, so that the layout of the Icon structure doesn't change.
+#define _get_load_image_task(pIcon) ((GldiTask *) (pIcon)->reserved[0])
 
 const gchar *s_cRendererNames[4] = {NULL, "Emblem", "Stack", "Box"};  // c'est juste pour realiser la transition entre le chiffre en conf, et un nom (limitation du panneau de conf). On garde le numero pour savoir rapidement sur laquelle on set.
 
@@ -118,8 +127,10 @@ void cairo_dock_load_icon_image (Icon *icon, G_GNUC_UNUSED GldiContainer *pConta
 	GLuint iPrevTexture = icon->image.iTexture;
 	
 	//\______________ load the image buffer (surface + texture).
+	gint64 iStartTime = gldi_trace_begin ();
 	if (icon->iface.load_image)
 		icon->iface.load_image (icon);
+	gldi_trace_end ("icon", "load image", icon->cName, iStartTime);
 	
 	//\______________ if nothing has changed or no image was loaded, set a default image.
 	if ((icon->image.pSurface == pPrevSurface || icon->image.pSurface == NULL)
@@ -180,6 +191,10 @@ void cairo_dock_load_icon_image (Icon *icon, G_GNUC_UNUSED GldiContainer *pConta
 			pInstance->pDrawContext = NULL;
 		}
 	}
+	else if (myIconsParam.bTextureOnly)  // applets draw on their surface, the other icons are only drawn with OpenGL.
+	{
+		cairo_dock_image_buffer_drop_surface (&icon->image);
+	}
 }
 
 void cairo_dock_load_icon_text (Icon *icon)
@@ -201,6 +216,8 @@ void cairo_dock_load_icon_text (Icon *icon)
 		&iWidth,
 		&iHeight);
 	cairo_dock_load_image_buffer_from_surface (&icon->label, pSurface, iWidth, iHeight);
+	if (myIconsParam.bTextureOnly)
+		cairo_dock_image_buffer_drop_surface (&icon->label);
 	g_free (cTruncatedName);
 }
 
@@ -218,6 +235,22 @@ void cairo_dock_load_icon_quickinfo (Icon *icon)
 		if (iHeight / (myIconsParam.quickInfoTextDescription.iSize * fMaxScale) > 5)  // if the icon is very height (the text occupies less than 20% of the icon)
 			fMaxScale = MIN ((double)iHeight / (myIconsParam.quickInfoTextDescription.iSize * 5), MAX (1., 16./myIconsParam.quickInfoTextDescription.iSize) * fMaxScale);  // let's make it use 20% of the icon's height, limited to 16px
 		int w, h;
+		if (CAIRO_CONTAINER_IS_OPENGL (icon->pContainer)
+		&& ! myIconsParam.quickInfoTextDescription.bUseMarkup
+		&& myIconsParam.quickInfoTextDescription.fMaxRelativeWidth == 0
+		&& cairo_dock_glyph_atlas_can_draw_text (icon->cQuickInfo))  // draw the text from a glyph atlas shared by all the quick-infos, so that updating it costs no new texture.
+		{
+			CairoDockGLFont *pFont = cairo_dock_get_glyph_atlas_font (&myIconsParam.quickInfoTextDescription, fMaxScale);
+			if (pFont != NULL)
+			{
+				cairo_dock_get_gl_text_box_size (icon->cQuickInfo, pFont, iWidth, &w, &h);
+				CairoOverlay *pOverlay = cairo_dock_add_overlay_from_text (icon, icon->cQuickInfo, pFont, w, h, CAIRO_OVERLAY_BOTTOM, (gpointer)"quick-info");
+				if (pOverlay)
+					cairo_dock_set_overlay_scale (pOverlay, 0);
+				cairo_dock_release_glyph_atlas_font (pFont);  // the overlay has its own reference.
+				return;
+			}
+		}
 		cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_full (icon->cQuickInfo,
 			&myIconsParam.quickInfoTextDescription,
 			fMaxScale,
@@ -240,6 +273,11 @@ void cairo_dock_load_icon_buffers (Icon *pIcon, GldiContainer *pContainer)
 		pIcon->iSidLoadImage = 0;
 		bLoadText = FALSE;  // has been done in cairo_dock_trigger_load_icon_buffers(), the only function to schedule the image loading.
 	}
+	else if (_get_load_image_task (pIcon) != NULL)  // the image is being decoded; the label has been loaded already too.
+	{
+		cairo_dock_cancel_load_icon_image (pIcon);
+		bLoadText = FALSE;
+	}
 	
 	if (cairo_dock_icon_get_allocated_width (pIcon) > 0)
 	{
@@ -252,6 +290,123 @@ void cairo_dock_load_icon_buffers (Icon *pIcon, GldiContainer *pContainer)
 	}
 }
 
+static void _finish_loading_icon_buffers (Icon *pIcon, GldiContainer *pContainer)
+{
+	if (cairo_dock_get_icon_data_renderer (pIcon) != NULL)
+		cairo_dock_refresh_data_renderer (pIcon, pContainer);
+	
+	cairo_dock_load_icon_quickinfo (pIcon);
+	
+	cairo_dock_redraw_icon (pIcon);
+	//g_print ("icon-factory: do 1 main loop iteration\n");
+	//gtk_main_iteration_do (FALSE);  /// "unforseen consequences" : if _redraw_subdock_content_idle is planned just after, the container-icon stays blank in opengl only. couldn't figure why exactly :-/
+}
+
+typedef struct {
+	Icon *pIcon;
+	gchar *cImagePath;
+	gint iWidth, iHeight;
+	double fDeviceScale;  // taken in the main thread, the screen can't be queried from the worker.
+	gint bCancelled;  // set when the icon doesn't need the image anymore, so that a queued job doesn't decode it for nothing.
+	cairo_surface_t *pSurface;
+	} CairoIconImageJob;
+
+static void _decode_icon_image (CairoIconImageJob *pJob)  // in a worker thread
+{
+	if (g_atomic_int_get (&pJob->bCancelled))
+		return;
+	gint64 iStartTime = gldi_trace_begin ();
+	double fImageWidth = pJob->iWidth, fImageHeight = pJob->iHeight;
+	pJob->pSurface = cairo_dock_image_cache_create_surface_full (pJob->cImagePath,  // same as cairo_dock_create_surface_from_image_simple, the path being a complete one.
+		1.,
+		pJob->iWidth,
+		pJob->iHeight,
+		CAIRO_DOCK_FILL_SPACE,
+		&fImageWidth,
+		&fImageHeight,
+		NULL,
+		NULL,
+		pJob->fDeviceScale);
+	gldi_trace_end ("icon", "decode image", pJob->cImagePath, iStartTime);
+}
+
+static gboolean _on_icon_image_decoded (CairoIconImageJob *pJob)  // in the main thread; the jobs that are completed together are all dispatched in the same main loop iteration, so their textures are uploaded and their icons redrawn at once.
+{
+	Icon *pIcon = pJob->pIcon;
+	GldiContainer *pContainer = pIcon->pContainer;
+	if (pContainer != NULL)
+	{
+		cairo_dock_load_icon_image (pIcon, pContainer);  // the 'load_image' method takes the decoded surface, and the usual post-processing is applied (default image, background, etc).
+		_finish_loading_icon_buffers (pIcon, pContainer);
+	}
+	gldi_task_discard (_get_load_image_task (pIcon));  // frees the job and the surface if it was not taken.
+	pIcon->reserved[0] = NULL;
+	return FALSE;
+}
+
+static void _free_icon_image_job (CairoIconImageJob *pJob)
+{
+	if (pJob->pSurface != NULL)
+		cairo_surface_destroy (pJob->pSurface);
+	g_free (pJob->cImagePath);
+	g_free (pJob);
+}
+
+static gboolean _load_icon_image_async (Icon *pIcon)
+{
+	// only the launchers use the generic loader, which merely decodes an image file (the other icons draw on their image or need it immediately); and the surfaces of cairo are bound to the X server, so they must be created in the main thread.
+	if (! g_bUseOpenGL || ! GLDI_OBJECT_IS_LAUNCHER_ICON (pIcon) || pIcon->cFileName == NULL || pIcon->pSubDock != NULL)
+		return FALSE;
+	int iWidth = cairo_dock_icon_get_allocated_width (pIcon);
+	int iHeight = cairo_dock_icon_get_allocated_height (pIcon);
+	if (iWidth <= 0 || iHeight <= 0)
+		return FALSE;
+	
+	gchar *cImagePath = cairo_dock_search_icon_s_path (pIcon->cFileName, MAX (iWidth, iHeight));  // the icon theme can only be used in the main thread.
+	if (cImagePath == NULL || *cImagePath != '/')  // let the synchronous load set the default image (or search the image in the theme).
+	{
+		g_free (cImagePath);
+		return FALSE;
+	}
+	
+	cairo_dock_cancel_load_icon_image (pIcon);  // a previous image is not needed anymore.
+	CairoIconImageJob *pJob = g_new0 (CairoIconImageJob, 1);
+	pJob->pIcon = pIcon;
+	pJob->cImagePath = cImagePath;
+	pJob->iWidth = iWidth;
+	pJob->iHeight = iHeight;
+	pJob->fDeviceScale = cairo_dock_get_device_scale ();
+	pIcon->reserved[0] = gldi_task_new_full (0,
+		(GldiGetDataAsyncFunc) _decode_icon_image,
+		(GldiUpdateSyncFunc) _on_icon_image_decoded,
+		(GFreeFunc) _free_icon_image_job,
+		pJob);
+	gldi_task_launch (_get_load_image_task (pIcon));
+	return TRUE;
+}
+
+void cairo_dock_cancel_load_icon_image (Icon *pIcon)
+{
+	if (_get_load_image_task (pIcon) == NULL)
+		return;
+	CairoIconImageJob *pJob = _get_load_image_task (pIcon)->pSharedMemory;
+	g_atomic_int_set (&pJob->bCancelled, 1);
+	gldi_task_discard (_get_load_image_task (pIcon));  // the worker can still be decoding it; the job will be freed when it's done.
+	pIcon->reserved[0] = NULL;
+}
+
+cairo_surface_t *cairo_dock_take_decoded_icon_image (Icon *pIcon, int iWidth, int iHeight)
+{
+	if (_get_load_image_task (pIcon) == NULL)
+		return NULL;
+	CairoIconImageJob *pJob = _get_load_image_task (pIcon)->pSharedMemory;
+	if (pJob->pSurface == NULL || pJob->iWidth != iWidth || pJob->iHeight != iHeight)  // not decoded yet, or the icon has been resized meanwhile.
+		return NULL;
+	cairo_surface_t *pSurface = pJob->pSurface;
+	pJob->pSurface = NULL;
+	return pSurface;
+}
+
 static gboolean _load_icon_buffer_idle (Icon *pIcon)
 {
 	//g_print ("%s (%s; %dx%d; %.2fx%.2f; %x)\n", __func__, pIcon->cName, pIcon->iAllocatedWidth, pIcon->iAllocatedHeight, pIcon->fWidth, pIcon->fHeight, pIcon->pContainer);
@@ -260,16 +415,12 @@ static gboolean _load_icon_buffer_idle (Icon *pIcon)
 	GldiContainer *pContainer = pIcon->pContainer;
 	if (pContainer)
 	{
-		cairo_dock_load_icon_image (pIcon, pContainer);
-		
-		if (cairo_dock_get_icon_data_renderer (pIcon) != NULL)
-			cairo_dock_refresh_data_renderer (pIcon, pContainer);
+		if (_load_icon_image_async (pIcon))  // the current image is kept until the new one is decoded.
+			return FALSE;
 		
-		cairo_dock_load_icon_quickinfo (pIcon);
+		cairo_dock_load_icon_image (pIcon, pContainer);
 		
-		cairo_dock_redraw_icon (pIcon);
-		//g_print ("icon-factory: do 1 main loop iteration\n");
-		//gtk_main_iteration_do (FALSE);  /// "unforseen consequences" : if _redraw_subdock_content_idle is planned just after, the container-icon stays blank in opengl only. couldn't figure why exactly :-/
+		_finish_loading_icon_buffers (pIcon, pContainer);
 	}
 	return FALSE;
 }
@@ -179,7 +179,7 @@ struct _Icon {
 	gint iThumbnailWidth, iThumbnailHeight;
 	
 	gboolean bIsLaunching;  // a mere recopy of gldi_class_is_starting()
-	gpointer reserved[4];
+	gpointer reserved[4];  // reserved[0] is used by the icon factory to keep the task decoding the image in a worker thread.
 };
 
 typedef void (*CairoIconContainerLoadFunc) (void);
@@ -297,8 +297,25 @@ void cairo_dock_load_icon_quickinfo (Icon *icon);
 */
 void cairo_dock_load_icon_buffers (Icon *pIcon, GldiContainer *pContainer);
 
+/** Schedule the loading of the buffers of a given icon. The label is loaded immediately, since the view may need its size, and the image is loaded when the main loop is idle.
+* In OpenGL, the image file of a launcher is decoded in a worker thread; the icon keeps its current image until the new one is ready.
+*@param pIcon the icon.
+*/
 void cairo_dock_trigger_load_icon_buffers (Icon *pIcon);
 
+/** Cancel the loading of the image of an icon scheduled by \ref cairo_dock_trigger_load_icon_buffers.
+*@param pIcon the icon.
+*/
+void cairo_dock_cancel_load_icon_image (Icon *pIcon);
+
+/** Take the image that has been decoded in a worker thread for an icon, if any. This is meant to be used by the 'load_image' method of the icon.
+*@param pIcon the icon.
+*@param iWidth width of the image buffer that will be loaded.
+*@param iHeight height of the image buffer that will be loaded.
+*@return the surface, or NULL if no image has been decoded for this size. The caller takes ownership of it.
+*/
+cairo_surface_t *cairo_dock_take_decoded_icon_image (Icon *pIcon, int iWidth, int iHeight);
+
 
 void cairo_dock_draw_subdock_content_on_icon (Icon *pIcon, CairoDock *pDock);
 
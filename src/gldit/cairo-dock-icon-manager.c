@@ -50,6 +50,7 @@
 #include "cairo-dock-applet-manager.h"  // GLDI_OBJECT_IS_APPLET_ICON
 #include "cairo-dock-backends-manager.h"  // cairo_dock_foreach_icon_container_renderer
 #include "cairo-dock-style-manager.h"
+#include "cairo-dock-image-cache.h"  // cairo_dock_image_cache_clear
 #define _MANAGER_DEF_
 #include "cairo-dock-icon-manager.h"
 
@@ -65,6 +66,7 @@ extern CairoDock *g_pMainDock;
 extern gchar *g_cCurrentThemePath;
 extern gboolean g_bUseOpenGL;
 extern gchar *g_cCurrentIconsPath;
+extern gchar *g_cCurrentImagesPath;
 extern GldiManager myIndicatorsMgr;
 
 // private
@@ -74,6 +76,11 @@ static GtkIconTheme *s_pIconTheme = NULL;
 static gboolean s_bUseLocalIcons = FALSE;
 static gboolean s_bUseDefaultTheme = TRUE;
 static guint s_iSidReloadTheme = 0;
+#define CAIRO_DOCK_ICON_THEME_RESCAN_DELAY 5  // s; GTK checks the folders of the theme at the same pace.
+static GHashTable *s_hIconPaths = NULL;  // "name|size|scale" -> path of the icon, or "" if it doesn't exist
+static CairoDockPathCacheStats s_iconPathStats;
+static gint64 s_iLastIconThemeRescan = 0;
+static GList *s_pThemeDirMonitors = NULL;
 
 static void _cairo_dock_unload_icon_textures (void);
 static void _cairo_dock_unload_icon_theme (void);
@@ -225,24 +232,9 @@ gint cairo_dock_search_icon_size (GtkIconSize iIconSize)
 
 extern GldiContainer *g_pPrimaryContainer;
 
-gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize)
+static gchar *_search_icon_in_themes (const gchar *cFileName, gint iDesiredIconSize, gint scale)
 {
-	g_return_val_if_fail (cFileName != NULL, NULL);
-	
-	//\_______________________ easy cases: we receive a path.
-	if (*cFileName == '~')
-	{
-		return g_strdup_printf ("%s%s", g_getenv ("HOME"), cFileName+1);
-	}
-	
-	if (*cFileName == '/')
-	{
-		return g_strdup (cFileName);
-	}
-	
 	//\_______________________ check for the presence of suffix and version number.
-	g_return_val_if_fail (s_pIconTheme != NULL, NULL);
-	
 	GString *sIconPath = g_string_new ("");
 	const gchar *cSuffixTab[4] = {".svg", ".png", ".xpm", NULL};
 	gboolean bHasSuffix=FALSE, bFileFound=FALSE, bHasVersion=FALSE;
@@ -298,13 +290,6 @@ gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconS
 				*str = '\0';
 		}
 
-		gint scale = 1;
-		if (g_pPrimaryContainer != NULL)
-		{
-			// TODO: better way to determine the scale factor based on which screen this icon will appear !!
-			GdkWindow* gdkwindow = gldi_container_get_gdk_window (g_pPrimaryContainer);
-			scale = gdk_window_get_scale_factor (gdkwindow);
-		}
 		pIconInfo = gtk_icon_theme_lookup_icon_for_scale (s_pIconTheme,
 			sIconPath->str,
 			iDesiredIconSize, // GTK_ICON_LOOKUP_FORCE_SIZE if size < 30 ?? -> icons can be different // a lot of themes now use only svg files.
@@ -341,7 +326,7 @@ gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconS
 		{
 			*(str+1) = '\0';
 			cd_debug (" on cherche '%s'...", sIconPath->str);
-			gchar *cPath = cairo_dock_search_icon_s_path (sIconPath->str, iDesiredIconSize);
+			gchar *cPath = cairo_dock_search_icon_s_path (sIconPath->str, iDesiredIconSize);  // goes through the cache too
 			if (cPath != NULL)
 			{
 				bFileFound = TRUE;
@@ -360,6 +345,117 @@ gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconS
 	return g_string_free (sIconPath, FALSE);
 }
 
+gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize)
+{
+	g_return_val_if_fail (cFileName != NULL, NULL);
+	
+	//\_______________________ easy cases: we receive a path.
+	if (*cFileName == '~')
+	{
+		return g_strdup_printf ("%s%s", g_getenv ("HOME"), cFileName+1);
+	}
+	
+	if (*cFileName == '/')
+	{
+		return g_strdup (cFileName);
+	}
+	
+	g_return_val_if_fail (s_pIconTheme != NULL, NULL);
+	
+	gint scale = 1;
+	if (g_pPrimaryContainer != NULL)
+	{
+		// TODO: better way to determine the scale factor based on which screen this icon will appear !!
+		GdkWindow* gdkwindow = gldi_container_get_gdk_window (g_pPrimaryContainer);
+		scale = gdk_window_get_scale_factor (gdkwindow);
+	}
+	
+	//\_______________________ look in the cache first: the applis and the classes search the same names each time a window appears.
+	if (s_hIconPaths == NULL)
+		s_hIconPaths = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	gchar *cKey = g_strdup_printf ("%s|%d|%d", cFileName, iDesiredIconSize, scale);
+	const gchar *cCachedPath = g_hash_table_lookup (s_hIconPaths, cKey);
+	if (cCachedPath != NULL && *cCachedPath == '\0')  // known to not exist; let GTK check its folders from time to time (like it does on each lookup), since an application may install its icon later.
+	{
+		gint64 t = g_get_monotonic_time ();
+		if (t - s_iLastIconThemeRescan > CAIRO_DOCK_ICON_THEME_RESCAN_DELAY * G_TIME_SPAN_SECOND)
+		{
+			s_iLastIconThemeRescan = t;
+			if (gtk_icon_theme_rescan_if_needed (s_pIconTheme))  // the theme has changed, the cache has been cleared by the 'changed' signal.
+				cCachedPath = g_hash_table_lookup (s_hIconPaths, cKey);
+		}
+	}
+	if (cCachedPath != NULL)
+	{
+		g_free (cKey);
+		if (*cCachedPath == '\0')
+		{
+			s_iconPathStats.iNbNegativeHits ++;
+			return NULL;
+		}
+		s_iconPathStats.iNbHits ++;
+		return g_strdup (cCachedPath);
+	}
+	
+	//\_______________________ search in the local icons and the icon themes.
+	s_iconPathStats.iNbMisses ++;
+	gchar *cIconPath = _search_icon_in_themes (cFileName, iDesiredIconSize, scale);
+	g_hash_table_insert (s_hIconPaths, cKey, g_strdup (cIconPath ? cIconPath : ""));
+	return cIconPath;
+}
+
+void cairo_dock_clear_icon_path_cache (void)
+{
+	cairo_dock_clear_image_path_cache ();  // the images are also searched in the local icons folder.
+	if (s_hIconPaths == NULL || g_hash_table_size (s_hIconPaths) == 0)
+		return;
+	g_hash_table_remove_all (s_hIconPaths);
+	s_iconPathStats.iNbInvalidations ++;
+}
+
+gchar *cairo_dock_get_icon_path_cache_report (void)
+{
+	CairoDockPathCacheStats icons = s_iconPathStats, images;
+	icons.iNbEntries = (s_hIconPaths ? g_hash_table_size (s_hIconPaths) : 0);
+	cairo_dock_get_image_path_cache_stats (&images);
+	return g_strdup_printf ("icons: %u hits, %u negative hits, %u searches, %u invalidations, %u entries\n"
+		"images: %u hits, %u negative hits, %u searches, %u invalidations, %u entries",
+		icons.iNbHits, icons.iNbNegativeHits, icons.iNbMisses, icons.iNbInvalidations, icons.iNbEntries,
+		images.iNbHits, images.iNbNegativeHits, images.iNbMisses, images.iNbInvalidations, images.iNbEntries);
+}
+
+static void _on_theme_dir_changed (G_GNUC_UNUSED GFileMonitor *pMonitor, G_GNUC_UNUSED GFile *pFile, G_GNUC_UNUSED GFile *pOtherFile, GFileMonitorEvent iEventType, G_GNUC_UNUSED gpointer data)
+{
+	if (iEventType == G_FILE_MONITOR_EVENT_CREATED
+	|| iEventType == G_FILE_MONITOR_EVENT_DELETED
+	|| iEventType == G_FILE_MONITOR_EVENT_MOVED_IN
+	|| iEventType == G_FILE_MONITOR_EVENT_MOVED_OUT
+	|| iEventType == G_FILE_MONITOR_EVENT_RENAMED)
+		cairo_dock_clear_icon_path_cache ();
+}
+static void _monitor_theme_dirs (void)
+{
+	const gchar *cDirs[3] = {g_cCurrentIconsPath, g_cCurrentImagesPath, g_cCurrentThemePath};
+	int i;
+	for (i = 0; i < 3; i ++)
+	{
+		if (cDirs[i] == NULL)
+			continue;
+		GFile *pDir = g_file_new_for_path (cDirs[i]);
+		GFileMonitor *pMonitor = g_file_monitor_directory (pDir, G_FILE_MONITOR_WATCH_MOVES, NULL, NULL);
+		g_object_unref (pDir);
+		if (pMonitor == NULL)  // no monitoring available: the cache will only be cleared when the theme is reloaded.
+			continue;
+		g_signal_connect (pMonitor, "changed", G_CALLBACK (_on_theme_dir_changed), NULL);
+		s_pThemeDirMonitors = g_list_prepend (s_pThemeDirMonitors, pMonitor);
+	}
+}
+static void _unmonitor_theme_dirs (void)
+{
+	g_list_free_full (s_pThemeDirMonitors, (GDestroyNotify) g_object_unref);  // unref cancels the monitor
+	s_pThemeDirMonitors = NULL;
+}
+
 void cairo_dock_add_path_to_icon_theme (const gchar *cThemePath)
 {
 	if (s_bUseDefaultTheme)
@@ -371,6 +467,7 @@ void cairo_dock_add_path_to_icon_theme (const gchar *cThemePath)
 	gtk_icon_theme_append_search_path (s_pIconTheme,
 		cThemePath);  /// TODO: does it check for unicity ?...
 	gtk_icon_theme_rescan_if_needed (s_pIconTheme);
+	cairo_dock_clear_icon_path_cache ();  // the signal is blocked
 	if (s_bUseDefaultTheme)
 	{
 		g_signal_handlers_unblock_matched (s_pIconTheme,
@@ -407,6 +504,7 @@ void cairo_dock_remove_path_from_icon_theme (const gchar *cThemePath)
 		gtk_icon_theme_set_search_path (s_pIconTheme, (const gchar **)paths, iNbPaths - 1);
 	}
 	g_strfreev (paths);
+	cairo_dock_clear_icon_path_cache ();  // the signal is blocked
 	
 	g_signal_handlers_unblock_matched (s_pIconTheme,
 		(GSignalMatchType) G_SIGNAL_MATCH_FUNC,
@@ -490,6 +588,8 @@ static gboolean get_config (GKeyFile *pKeyFile, CairoIconsParam *pIcons)
 	}
 	pIcons->fExtraScale = cairo_dock_get_double_key_value (pKeyFile, "Icons", "extra scale", &bFlushConfFileNeeded, 1., NULL, NULL);
 	
+	pIcons->bTextureOnly = cairo_dock_get_boolean_key_value (pKeyFile, "System", "icons in video memory", &bFlushConfFileNeeded, FALSE, NULL, NULL);
+	
 	//\___________________ Parametres des separateurs.
 	cairo_dock_get_size_key_value_helper (pKeyFile, "Icons", "separator ", bFlushConfFileNeeded, pIcons->iSeparatorWidth, pIcons->iSeparatorHeight);
 	if (pIcons->iSeparatorWidth == 0)
@@ -704,10 +804,15 @@ static gboolean _on_icon_theme_changed_idle (G_GNUC_UNUSED gpointer data)
 static void _on_icon_theme_changed (G_GNUC_UNUSED GtkIconTheme *pIconTheme, G_GNUC_UNUSED gpointer data)
 {
 	cd_message ("theme has changed");
+	cairo_dock_clear_icon_path_cache ();
 	// Reload the icons in idle, because this signal is triggered directly by 'gtk_icon_theme_set_search_path()'; so we may end reloading an applet in the middle of its work (ex.: Status-Notifier when the watcher terminates)
 	if (s_iSidReloadTheme == 0)
 		s_iSidReloadTheme = g_idle_add (_on_icon_theme_changed_idle, NULL);
 }
+static void _on_custom_icon_theme_changed (G_GNUC_UNUSED GtkIconTheme *pIconTheme, G_GNUC_UNUSED gpointer data)
+{
+	cairo_dock_clear_icon_path_cache ();  // we don't reload the icons in this case, but the cache must follow the theme.
+}
 static void _cairo_dock_load_icon_theme (void)
 {
 	g_return_if_fail (s_pIconTheme == NULL);
@@ -723,6 +828,7 @@ static void _cairo_dock_load_icon_theme (void)
 	{
 		s_pIconTheme = gtk_icon_theme_new ();
 		gtk_icon_theme_set_custom_theme (s_pIconTheme, myIconsParam.cIconTheme);
+		g_signal_connect (G_OBJECT (s_pIconTheme), "changed", G_CALLBACK (_on_custom_icon_theme_changed), NULL);
 		s_bUseLocalIcons = FALSE;
 		s_bUseDefaultTheme = FALSE;
 	}
@@ -733,6 +839,8 @@ static void load (void)
 	cairo_dock_create_icon_fbo ();
 	
 	_cairo_dock_load_icon_theme ();
+	cairo_dock_clear_icon_path_cache ();  // the theme may be a new one
+	_monitor_theme_dirs ();
 	
 	_cairo_dock_load_icon_textures ();
 }
@@ -806,6 +914,7 @@ static void reload (CairoIconsParam *pPrevIcons, CairoIconsParam *pIcons)
 	if (bThemeChanged)
 	{
 		_cairo_dock_unload_icon_theme ();
+		cairo_dock_image_cache_clear ();  // the images of the previous theme won't be used anymore
 		
 		_cairo_dock_load_icon_theme ();
 	}
@@ -906,6 +1015,8 @@ static void unload (void)
 	}
 	
 	_cairo_dock_unload_icon_theme ();
+	_unmonitor_theme_dirs ();
+	cairo_dock_clear_icon_path_cache ();
 }
 
 
@@ -970,9 +1081,9 @@ static void _load_image (Icon *icon)
 	int iWidth = cairo_dock_icon_get_allocated_width (icon);
 	int iHeight = cairo_dock_icon_get_allocated_height (icon);
 	if (iWidth <= 0 || iHeight <= 0) return;
-	cairo_surface_t *pSurface = NULL;
+	cairo_surface_t *pSurface = cairo_dock_take_decoded_icon_image (icon, iWidth, iHeight);  // it may have been decoded in a worker already.
 	
-	if (icon->cFileName)
+	if (pSurface == NULL && icon->cFileName)
 	{
 		gchar *cIconPath = cairo_dock_search_icon_s_path (icon->cFileName, MAX (iWidth, iHeight));
 		if (cIconPath != NULL && *cIconPath != '\0')
@@ -1020,6 +1131,7 @@ static void reset_object (GldiObject *obj)
 		g_source_remove (icon->iSidRedrawSubdockContent);
 	if (icon->iSidLoadImage != 0)  // remove timers after any function that could trigger one (for instance, cairo_dock_deinhibite_class calls cairo_dock_trigger_load_icon_buffers)
 		g_source_remove (icon->iSidLoadImage);
+	cairo_dock_cancel_load_icon_image (icon);
 	if (icon->iSidDoubleClickDelay != 0)
 		g_source_remove (icon->iSidDoubleClickDelay);
 	
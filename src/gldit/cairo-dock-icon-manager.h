@@ -84,6 +84,8 @@ struct _CairoIconsParam {
 	gint iLabelSize;  // taille des etiquettes des icones, en prenant en compte le contour et la marge.
 	gdouble fLabelAlphaThreshold;
 	gdouble fExtraScale;
+	// memory
+	gboolean bTextureOnly;  // keep the icons only in video memory
 	};
 
 /// signals
@@ -132,6 +134,15 @@ gint cairo_dock_search_icon_size (GtkIconSize iIconSize);
  */
 gchar *cairo_dock_search_icon_s_path (const gchar *cFileName, gint iDesiredIconSize);
 
+/** Forget the paths found by \ref cairo_dock_search_icon_s_path and \ref cairo_dock_search_image_s_path. The names that could not be found are remembered too, so this is done automatically when the icon theme or the folders of the current theme change.
+*/
+void cairo_dock_clear_icon_path_cache (void);
+
+/** Get a human-readable report of the counters of the caches used by \ref cairo_dock_search_icon_s_path and \ref cairo_dock_search_image_s_path.
+*@return a newly allocated string.
+*/
+gchar *cairo_dock_get_icon_path_cache_report (void);
+
 void cairo_dock_add_path_to_icon_theme (const gchar *cPath);
 
 void cairo_dock_remove_path_from_icon_theme (const gchar *cPath);
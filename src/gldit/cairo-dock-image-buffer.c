@@ -19,6 +19,8 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <stdio.h>  // sscanf
+#include <unistd.h>  // sysconf
 
 #include "cairo-dock-icon-manager.h"  // myIconsParam.iIconWidth
 #include "cairo-dock-desklet-manager.h"  // CAIRO_DOCK_IS_DESKLET
@@ -27,6 +29,7 @@
 #include "cairo-dock-draw.h"
 #include "cairo-dock-draw-opengl.h"
 #include "cairo-dock-opengl-priv.h"  // gldi_gl_container_make_current
+#include "cairo-dock-image-cache.h"
 #include "cairo-dock-image-buffer.h"
 
 extern gchar *g_cCurrentThemePath;
@@ -39,6 +42,31 @@ extern gboolean g_bEasterEggs;
 extern GldiContainer *g_pPrimaryContainer;
 
 
+// where the images of the theme have been found, or "" if they have not; it's cleared when the theme or its folders change.
+static GHashTable *s_hImagePaths = NULL;
+static CairoDockPathCacheStats s_imagePathStats;
+
+static gchar *_search_image_in_theme (const gchar *cImageFile)
+{
+	gchar *cImagePath = g_strdup_printf ("%s/%s", g_cCurrentImagesPath, cImageFile);
+	if (!g_file_test (cImagePath, G_FILE_TEST_EXISTS))
+	{
+		g_free (cImagePath);
+		cImagePath = g_strdup_printf ("%s/%s", g_cCurrentThemePath, cImageFile);
+		if (!g_file_test (cImagePath, G_FILE_TEST_EXISTS))
+		{
+			g_free (cImagePath);
+			cImagePath = g_strdup_printf ("%s/%s", g_cCurrentIconsPath, cImageFile);
+			if (!g_file_test (cImagePath, G_FILE_TEST_EXISTS))
+			{
+				g_free (cImagePath);
+				cImagePath = NULL;
+			}
+		}
+	}
+	return cImagePath;
+}
+
 gchar *cairo_dock_search_image_s_path (const gchar *cImageFile)
 {
 	g_return_val_if_fail (cImageFile != NULL, NULL);
@@ -61,46 +89,44 @@ gchar *cairo_dock_search_image_s_path (const gchar *cImageFile)
 	}
 	else
 	{
-		cImagePath = g_strdup_printf ("%s/%s", g_cCurrentImagesPath, cImageFile);
-		if (!g_file_test (cImagePath, G_FILE_TEST_EXISTS))
+		if (s_hImagePaths == NULL)
+			s_hImagePaths = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+		const gchar *cCachedPath = g_hash_table_lookup (s_hImagePaths, cImageFile);
+		if (cCachedPath != NULL)
 		{
-			g_free (cImagePath);
-			cImagePath = g_strdup_printf ("%s/%s", g_cCurrentThemePath, cImageFile);
-			if (!g_file_test (cImagePath, G_FILE_TEST_EXISTS))
+			if (*cCachedPath == '\0')
 			{
-				g_free (cImagePath);
-				cImagePath = g_strdup_printf ("%s/%s", g_cCurrentIconsPath, cImageFile);
-				if (!g_file_test (cImagePath, G_FILE_TEST_EXISTS))
-				{
-					g_free (cImagePath);
-					cImagePath = NULL;
-				}
+				s_imagePathStats.iNbNegativeHits ++;
+				return NULL;
 			}
+			s_imagePathStats.iNbHits ++;
+			return g_strdup (cCachedPath);
 		}
+		
+		s_imagePathStats.iNbMisses ++;
+		cImagePath = _search_image_in_theme (cImageFile);
+		g_hash_table_insert (s_hImagePaths, g_strdup (cImageFile), g_strdup (cImagePath ? cImagePath : ""));
 	}
 	return cImagePath;
 }
 
-
-void cairo_dock_load_image_buffer_full (CairoDockImageBuffer *pImage, const gchar *cImageFile, int iWidth, int iHeight, CairoDockLoadImageModifier iLoadModifier, double fAlpha)
+void cairo_dock_clear_image_path_cache (void)
 {
-	if (cImageFile == NULL)
+	if (s_hImagePaths == NULL || g_hash_table_size (s_hImagePaths) == 0)
 		return;
-	gchar *cImagePath = cairo_dock_search_image_s_path (cImageFile);
-	double w=0, h=0;
-	pImage->pSurface = cairo_dock_create_surface_from_image (
-		cImagePath,
-		1.,
-		iWidth,
-		iHeight,
-		iLoadModifier,
-		&w,
-		&h,
-		&pImage->fZoomX,
-		&pImage->fZoomY);
-	pImage->iWidth = w;
-	pImage->iHeight = h;
-	
+	g_hash_table_remove_all (s_hImagePaths);
+	s_imagePathStats.iNbInvalidations ++;
+}
+
+void cairo_dock_get_image_path_cache_stats (CairoDockPathCacheStats *pStats)
+{
+	*pStats = s_imagePathStats;
+	pStats->iNbEntries = (s_hImagePaths ? g_hash_table_size (s_hImagePaths) : 0);
+}
+
+
+static void _guess_frames (CairoDockImageBuffer *pImage, double w, double h, CairoDockLoadImageModifier iLoadModifier)
+{
 	if ((iLoadModifier & CAIRO_DOCK_ANIMATED_IMAGE) && h != 0)
 	{
 		//g_print ("%dx%d\n", (int)w, (int)h);
@@ -133,6 +159,28 @@ void cairo_dock_load_image_buffer_full (CairoDockImageBuffer *pImage, const gcha
 			gettimeofday (&pImage->time, NULL);
 		}
 	}
+}
+
+void cairo_dock_load_image_buffer_full (CairoDockImageBuffer *pImage, const gchar *cImageFile, int iWidth, int iHeight, CairoDockLoadImageModifier iLoadModifier, double fAlpha)
+{
+	if (cImageFile == NULL)
+		return;
+	gchar *cImagePath = cairo_dock_search_image_s_path (cImageFile);
+	double w=0, h=0;
+	pImage->pSurface = cairo_dock_create_surface_from_image (
+		cImagePath,
+		1.,
+		iWidth,
+		iHeight,
+		iLoadModifier,
+		&w,
+		&h,
+		&pImage->fZoomX,
+		&pImage->fZoomY);
+	pImage->iWidth = w;
+	pImage->iHeight = h;
+	
+	_guess_frames (pImage, w, h, iLoadModifier);
 	
 	if (fAlpha < 1 && pImage->pSurface != NULL)
 	{
@@ -156,6 +204,34 @@ void cairo_dock_load_image_buffer_full (CairoDockImageBuffer *pImage, const gcha
 	g_free (cImagePath);
 }
 
+void cairo_dock_load_shared_image_buffer (CairoDockImageBuffer *pImage, const gchar *cImageFile, int iWidth, int iHeight, CairoDockLoadImageModifier iLoadModifier)
+{
+	if (cImageFile == NULL)
+		return;
+	gchar *cImagePath = cairo_dock_search_image_s_path (cImageFile);
+	double w=0, h=0;
+	pImage->pSurface = cairo_dock_image_cache_get_shared_surface (
+		cImagePath,
+		1.,
+		iWidth,
+		iHeight,
+		iLoadModifier,
+		&w,
+		&h,
+		&pImage->fZoomX,
+		&pImage->fZoomY);
+	pImage->iWidth = w;
+	pImage->iHeight = h;
+	
+	_guess_frames (pImage, w, h, iLoadModifier);
+	
+	if (g_bUseOpenGL && pImage->pSurface != NULL)
+		pImage->iTexture = cairo_dock_image_cache_get_shared_texture (pImage->pSurface,
+			&pImage->iTexWidth, &pImage->iTexHeight);
+	
+	g_free (cImagePath);
+}
+
 void cairo_dock_load_image_buffer_from_surface (CairoDockImageBuffer *pImage, cairo_surface_t *pSurface, int iWidth, int iHeight)
 {
 	if ((iWidth == 0 || iHeight == 0) && pSurface != NULL)  // should never happen, but just in case, prevent any inconsistency.
@@ -197,7 +273,7 @@ void cairo_dock_unload_image_buffer (CairoDockImageBuffer *pImage)
 	{
 		cairo_surface_destroy (pImage->pSurface);
 	}
-	if (pImage->iTexture != 0)
+	if (pImage->iTexture != 0 && ! cairo_dock_image_cache_release_texture (pImage->iTexture))
 	{
 		_cairo_dock_delete_texture (pImage->iTexture);
 	}
@@ -481,7 +557,7 @@ void cairo_dock_destroy_icon_fbo (void)
 
 cairo_t *cairo_dock_begin_draw_image_buffer_cairo (CairoDockImageBuffer *pImage, gint iRenderingMode, cairo_t *pCairoContext)
 {
-	g_return_val_if_fail (pImage->pSurface != NULL, NULL);
+	g_return_val_if_fail (cairo_dock_image_buffer_get_surface (pImage) != NULL, NULL);  // re-create the surface if the image was only kept in video memory
 	cairo_t *ctx = pCairoContext;
 	if (! ctx)
 	{
@@ -710,22 +786,144 @@ void cairo_dock_image_buffer_update_texture (CairoDockImageBuffer *pImage)
 }
 
 
+  //////////////////////////
+ // TEXTURE-ONLY BUFFERS //
+//////////////////////////
+
+static guint s_iNbDroppedSurfaces = 0;
+static guint s_iNbRecreatedSurfaces = 0;
+
+void cairo_dock_image_buffer_drop_surface (CairoDockImageBuffer *pImage)
+{
+	if (pImage->pSurface == NULL || pImage->iTexture == 0 || pImage->iTexWidth <= 0)  // nothing to drop, or nothing to re-create it from.
+		return;
+	cairo_surface_destroy (pImage->pSurface);
+	pImage->pSurface = NULL;
+	s_iNbDroppedSurfaces ++;
+}
+
+static gboolean _make_gl_context_current (void)
+{
+	// the textures are shared by all the contexts; like for the FBO, an offscreen context is preferred since the one of a container can't be used while it's not mapped (Wayland).
+	if (gldi_gl_offscreen_context_make_current ())
+		return TRUE;
+	return (g_pPrimaryContainer != NULL && gldi_gl_container_make_current (g_pPrimaryContainer));
+}
+
+static cairo_surface_t *_create_surface_from_texture (const CairoDockImageBuffer *pImage)
+{
+	// the surface is asked outside of any drawing (dragging an icon, opening a dialog, etc), so there may be no current context.
+	if (! _make_gl_context_current ())
+	{
+		cd_warning ("couldn't set the opengl context, the image can't be read from its texture");
+		return NULL;
+	}
+	
+	// read the texture back; it has the same layout as the surface it was made from, so there is no need to flip it.
+	cairo_surface_t *pTexSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, pImage->iTexWidth, pImage->iTexHeight);  // the stride of an ARGB32 surface is always 4*width.
+	cairo_surface_flush (pTexSurface);
+	glPixelStorei (GL_PACK_ALIGNMENT, 4);
+	glBindTexture (GL_TEXTURE_2D, pImage->iTexture);
+	glGetTexImage (GL_TEXTURE_2D, 0, GL_BGRA, GL_UNSIGNED_BYTE, cairo_image_surface_get_data (pTexSurface));
+	glBindTexture (GL_TEXTURE_2D, 0);
+	cairo_surface_mark_dirty (pTexSurface);
+	
+	// bring it back to the size of the image (the texture is larger if it had to be a power of 2).
+	cairo_surface_t *pSurface = cairo_dock_create_blank_surface (pImage->iWidth, pImage->iHeight);
+	cairo_t *pCairoContext = cairo_create (pSurface);
+	cairo_scale (pCairoContext, (double)pImage->iWidth / pImage->iTexWidth, (double)pImage->iHeight / pImage->iTexHeight);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
+	cairo_set_source_surface (pCairoContext, pTexSurface, 0., 0.);
+	cairo_paint (pCairoContext);
+	cairo_destroy (pCairoContext);
+	cairo_surface_destroy (pTexSurface);
+	
+	s_iNbRecreatedSurfaces ++;
+	return pSurface;
+}
+
+cairo_surface_t *cairo_dock_image_buffer_get_surface (CairoDockImageBuffer *pImage)
+{
+	if (cairo_dock_image_buffer_is_texture_only (pImage) && pImage->iTexWidth > 0)
+		pImage->pSurface = _create_surface_from_texture (pImage);
+	return pImage->pSurface;
+}
+
+typedef struct {
+	guint iNbIcons;
+	guint iNbTextureOnly;
+	gsize iRamSize;
+	gsize iVramSize;
+	} CDImageMemory;
+
+static void _measure_image_buffer (CairoDockImageBuffer *pImage, CDImageMemory *pMemory)
+{
+	if (pImage->pSurface != NULL && cairo_surface_get_type (pImage->pSurface) == CAIRO_SURFACE_TYPE_IMAGE)  // other surfaces are not in our memory
+		pMemory->iRamSize += (gsize)cairo_image_surface_get_stride (pImage->pSurface) * cairo_image_surface_get_height (pImage->pSurface);
+	if (pImage->iTexture != 0)
+		pMemory->iVramSize += 4 * (pImage->iTexWidth > 0 ? (gsize)pImage->iTexWidth * pImage->iTexHeight : (gsize)pImage->iWidth * pImage->iHeight);
+}
+static void _measure_icon (Icon *icon, CDImageMemory *pMemory)
+{
+	pMemory->iNbIcons ++;
+	if (cairo_dock_image_buffer_is_texture_only (&icon->image))
+		pMemory->iNbTextureOnly ++;
+	_measure_image_buffer (&icon->image, pMemory);
+	_measure_image_buffer (&icon->label, pMemory);
+}
+static gsize _get_resident_size (void)
+{
+	gsize iSize = 0;
+	gchar *cContent = NULL;
+	if (g_file_get_contents ("/proc/self/statm", &cContent, NULL, NULL))
+	{
+		gulong iNbPages = 0;
+		if (sscanf (cContent, "%*u %lu", &iNbPages) == 1)
+			iSize = (gsize)iNbPages * sysconf (_SC_PAGESIZE);
+		g_free (cContent);
+	}
+	return iSize;
+}
+gchar *cairo_dock_get_image_memory_report (void)
+{
+	CDImageMemory memory = {0, 0, 0, 0};
+	gldi_icons_foreach ((GldiIconFunc)_measure_icon, &memory);
+	CairoDockImageCacheStats stats;
+	cairo_dock_image_cache_get_stats (&stats);
+	
+	return g_strdup_printf ("icons: %u (%u in video memory only)\n"
+		"icons and labels: %.1f kB in RAM, %.1f kB in video memory\n"
+		"image cache: %.1f kB in RAM\n"
+		"surfaces dropped: %u, re-created: %u\n"
+		"process resident size: %.1f MB",
+		memory.iNbIcons, memory.iNbTextureOnly,
+		memory.iRamSize / 1024., memory.iVramSize / 1024.,
+		stats.iSize / 1024.,
+		s_iNbDroppedSurfaces, s_iNbRecreatedSurfaces,
+		_get_resident_size () / 1024. / 1024.);
+}
+
+
 cairo_surface_t *cairo_dock_image_buffer_copy_scale (CairoDockImageBuffer *pImage, int iWidth, int iHeight)
 {
 	if (iWidth <= 0 || iHeight <= 0) return NULL;
-	if (pImage->iWidth > 0 && pImage->iHeight > 0 && pImage->pSurface != NULL)
+	cairo_surface_t *pSourceSurface = pImage->pSurface;
+	if (pSourceSurface == NULL && pImage->iTexture != 0 && pImage->iTexWidth > 0)  // texture-only buffer: use a temporary surface, so that it stays in video memory only.
+		pSourceSurface = _create_surface_from_texture (pImage);
+	if (pImage->iWidth > 0 && pImage->iHeight > 0 && pSourceSurface != NULL)
 	{
 		// note: this will use iWidth and iHeight as a logical size and use the same
 		// device scale factor as our surface
-		cairo_surface_t *surface = cairo_surface_create_similar (pImage->pSurface,
+		cairo_surface_t *surface = cairo_surface_create_similar (pSourceSurface,
 			CAIRO_CONTENT_COLOR_ALPHA, iWidth, iHeight);
 		cairo_t *pCairoContext = cairo_create (surface);
 		cairo_scale (pCairoContext, (double)iWidth/pImage->iWidth, (double)iHeight/pImage->iHeight);
-		cairo_set_source_surface (pCairoContext, pImage->pSurface, 0., 0.);
+		cairo_set_source_surface (pCairoContext, pSourceSurface, 0., 0.);
 		cairo_paint (pCairoContext);
 		cairo_destroy (pCairoContext);
+		if (pSourceSurface != pImage->pSurface)
+			cairo_surface_destroy (pSourceSurface);
 		return surface;
 	}
 	else return NULL;
 }
-
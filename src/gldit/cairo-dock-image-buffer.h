@@ -56,13 +56,33 @@ struct _CairoDockImageBuffer {
 	gint iTexHeight; // real height of the texture
 	} ;
 
+/// Counters of a cache of paths.
+typedef struct _CairoDockPathCacheStats {
+	/// number of paths found in the cache, number of files known to not exist, and number of searches
+	guint iNbHits, iNbNegativeHits, iNbMisses;
+	/// number of times the cache has been cleared
+	guint iNbInvalidations;
+	/// number of entries in the cache
+	guint iNbEntries;
+	} CairoDockPathCacheStats;
+
 /** Find the path of an image. '~' is handled, as well as the 'images' folder of the current theme. Use \ref cairo_dock_search_icon_s_path to search theme icons.
+* The location of the images of the theme (or their absence) is remembered until the theme or its folders change.
 *@param cImageFile a file name or path. If it's already a path, it will just be duplicated.
 *@return the path of the file, or NULL if it has not been found.
 */
 gchar *cairo_dock_search_image_s_path (const gchar *cImageFile);
 #define cairo_dock_generate_file_path cairo_dock_search_image_s_path
 
+/** Forget the location of the images of the theme, found by \ref cairo_dock_search_image_s_path. It is done automatically when the theme or its folders change.
+*/
+void cairo_dock_clear_image_path_cache (void);
+
+/** Get the counters of the cache used by \ref cairo_dock_search_image_s_path.
+*@param pStats filled with the counters.
+*/
+void cairo_dock_get_image_path_cache_stats (CairoDockPathCacheStats *pStats);
+
 
 /** Load an image into an ImageBuffer with a given transparency. If the image is given by its sole name, it is taken in the root folder of the current theme.
 *@param pImage an ImageBuffer.
@@ -82,6 +102,15 @@ void cairo_dock_load_image_buffer_full (CairoDockImageBuffer *pImage, const gcha
 *@param iLoadModifier modifier
 */
 #define cairo_dock_load_image_buffer(pImage, cImageFile, iWidth, iHeight, iLoadModifier) cairo_dock_load_image_buffer_full (pImage, cImageFile, iWidth, iHeight, iLoadModifier, 1.)
+/** Load an image into an ImageBuffer, sharing it with all the other ImageBuffers loaded from the same image at the same size (see \ref cairo_dock_image_cache_get_shared_surface). Use it for images that are only displayed; the ImageBuffer must not be drawn on. It is unloaded as usual.
+*@param pImage an ImageBuffer.
+*@param cImageFile name of a file
+*@param iWidth width it should be loaded. The resulting width can be different depending on the modifier.
+*@param iHeight height it should be loaded. The resulting width can be different depending on the modifier.
+*@param iLoadModifier modifier
+*/
+void cairo_dock_load_shared_image_buffer (CairoDockImageBuffer *pImage, const gchar *cImageFile, int iWidth, int iHeight, CairoDockLoadImageModifier iLoadModifier);
+
 /** Load a surface into an ImageBuffer.
 *@param pImage an ImageBuffer.
 *@param pSurface a cairo surface
@@ -198,5 +227,31 @@ void cairo_dock_image_buffer_update_texture (CairoDockImageBuffer *pImage);
 /** Create a scaled copy of an image as Cairo surface suitable for e.g. using in menus. */
 cairo_surface_t *cairo_dock_image_buffer_copy_scale (CairoDockImageBuffer *pImage, int iWidth, int iHeight);
 
+
+  //////////////////////////
+ // TEXTURE-ONLY BUFFERS //
+//////////////////////////
+
+/** Free the surface of an ImageBuffer once its texture has been created, so that the image is only kept in video memory. Nothing is done if the ImageBuffer has no texture (Cairo mode). Don't use it on images that are drawn with Cairo, since their surface would be re-created each time.
+*@param pImage an ImageBuffer.
+*/
+void cairo_dock_image_buffer_drop_surface (CairoDockImageBuffer *pImage);
+
+/** Tell if an ImageBuffer is only kept in video memory.
+*@param pImage an ImageBuffer.
+*/
+#define cairo_dock_image_buffer_is_texture_only(pImage) ((pImage)->pSurface == NULL && (pImage)->iTexture != 0)
+
+/** Get the surface of an ImageBuffer. If it was only kept in video memory, the surface is re-created from the texture and kept. Use it instead of pSurface when you need the pixels of an image that might be texture-only, like the icons. Reading the texture makes an OpenGL context current, so don't call it while drawing in OpenGL.
+*@param pImage an ImageBuffer.
+*@return the surface of the ImageBuffer, or NULL.
+*/
+cairo_surface_t *cairo_dock_image_buffer_get_surface (CairoDockImageBuffer *pImage);
+
+/** Measure the memory used by the images of the icons, the image cache and the whole process.
+*@return a newly allocated text.
+*/
+gchar *cairo_dock_get_image_memory_report (void);
+
 G_END_DECLS
 #endif
@@ -0,0 +1,331 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>  // ceil
+#include <sys/stat.h>
+#include <glib/gstdio.h>  // g_stat
+#include <gtk/gtk.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-draw-opengl.h"  // cairo_dock_create_texture_from_surface_full
+#include "cairo-dock-surface-factory.h"  // cairo_dock_get_device_scale
+#include "cairo-dock-image-cache.h"
+
+// the images that are not used anymore are kept until the cache reaches this size.
+#define CD_IMAGE_CACHE_MAX_SIZE (16 * 1024 * 1024)
+
+typedef struct {
+	gchar *cKey;
+	cairo_surface_t *pSurface;  // the cache owns 1 reference; the image is in use as long as someone else holds another one.
+	double fImageWidth, fImageHeight;
+	double fZoomX, fZoomY;
+	double fMaxScale;
+	gsize iSize;
+	GLuint iTexture;
+	gint iTexWidth, iTexHeight;
+	guint iNbTextureRefs;
+	GList link;  // position in the LRU queue
+	} CairoDockImageCacheEntry;
+
+static GHashTable *s_hEntries = NULL;  // key -> entry
+static GHashTable *s_hTextures = NULL;  // texture -> entry, for the textures currently shared
+static GQueue s_lru = G_QUEUE_INIT;  // least recently used first
+static gsize s_iSize = 0;
+static CairoDockImageCacheStats s_stats;
+static cairo_user_data_key_t s_entryKey;
+static GMutex s_mutex;  // images can be decoded in worker threads (see cairo_dock_trigger_load_icon_buffers); the textures are only handled in the main thread.
+
+
+static gchar *_make_key (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double fDeviceScale)
+{
+	// the mtime makes a modified file a different image; the old one will just age out of the cache.
+	GStatBuf st;
+	gint64 iMTime = (g_stat (cImagePath, &st) == 0 ? (gint64)st.st_mtime : 0);  // resources have no mtime, but can't change either.
+	return g_strdup_printf ("%s|%" G_GINT64_FORMAT "|%dx%d|%d|%g",
+		cImagePath,
+		iMTime,
+		iWidthConstraint,
+		iHeightConstraint,
+		iLoadingModifier,
+		fMaxScale * fDeviceScale);
+}
+
+static inline gboolean _entry_is_used (CairoDockImageCacheEntry *pEntry)
+{
+	return (cairo_surface_get_reference_count (pEntry->pSurface) > 1 || pEntry->iNbTextureRefs != 0);
+}
+
+static void _free_entry (CairoDockImageCacheEntry *pEntry)
+{
+	g_queue_unlink (&s_lru, &pEntry->link);
+	s_iSize -= pEntry->iSize;  // an unused entry has no texture
+	cairo_surface_set_user_data (pEntry->pSurface, &s_entryKey, NULL, NULL);
+	cairo_surface_destroy (pEntry->pSurface);
+	g_free (pEntry->cKey);
+	g_free (pEntry);
+}
+
+static void _trim (CairoDockImageCacheEntry *pNewEntry)
+{
+	GList *l = s_lru.head, *next;
+	while (l != NULL && s_iSize > CD_IMAGE_CACHE_MAX_SIZE)
+	{
+		next = l->next;
+		CairoDockImageCacheEntry *pEntry = l->data;
+		if (pEntry != pNewEntry && ! _entry_is_used (pEntry))
+		{
+			g_hash_table_remove (s_hEntries, pEntry->cKey);  // frees the entry
+			s_stats.iNbEvictions ++;
+		}
+		l = next;
+	}
+}
+
+static inline CairoDockImageCacheEntry *_lookup_entry (const gchar *cKey)  // must be called with the lock held
+{
+	CairoDockImageCacheEntry *pEntry = g_hash_table_lookup (s_hEntries, cKey);
+	if (pEntry != NULL)
+	{
+		s_stats.iNbHits ++;
+		g_queue_unlink (&s_lru, &pEntry->link);  // it's now the most recently used
+		g_queue_push_tail_link (&s_lru, &pEntry->link);
+		cairo_surface_reference (pEntry->pSurface);
+	}
+	return pEntry;
+}
+
+// returns the entry with a new reference on its surface, so that it can't be evicted by another thread; the caller has to release it.
+// the device scale is given by the caller, since the screen can't be queried from a worker thread.
+static CairoDockImageCacheEntry *_get_entry (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double fDeviceScale)
+{
+	g_return_val_if_fail (cImagePath != NULL, NULL);
+	gchar *cKey = _make_key (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier, fDeviceScale);
+	g_mutex_lock (&s_mutex);
+	if (s_hEntries == NULL)
+	{
+		s_hEntries = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify)_free_entry);  // the key belongs to the entry
+		s_hTextures = g_hash_table_new (g_direct_hash, g_direct_equal);
+	}
+	CairoDockImageCacheEntry *pEntry = _lookup_entry (cKey);
+	if (pEntry == NULL)
+		s_stats.iNbMisses ++;
+	g_mutex_unlock (&s_mutex);
+	if (pEntry != NULL)
+	{
+		g_free (cKey);
+		return pEntry;
+	}
+	
+	// decode the image outside of the lock, so that several workers can decode at the same time.
+	double fImageWidth = 0, fImageHeight = 0, fZoomX = 1, fZoomY = 1;
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_image_full (cImagePath,
+		fMaxScale,
+		iWidthConstraint,
+		iHeightConstraint,
+		iLoadingModifier,
+		&fImageWidth,
+		&fImageHeight,
+		&fZoomX,
+		&fZoomY,
+		fDeviceScale);
+	if (pSurface == NULL)  // failures are not cached, the file may appear later.
+	{
+		g_free (cKey);
+		return NULL;
+	}
+	
+	g_mutex_lock (&s_mutex);
+	pEntry = g_hash_table_lookup (s_hEntries, cKey);
+	if (pEntry != NULL)  // another thread has decoded the same image in the meantime, use its entry.
+	{
+		cairo_surface_reference (pEntry->pSurface);
+		g_mutex_unlock (&s_mutex);
+		cairo_surface_destroy (pSurface);
+		g_free (cKey);
+		return pEntry;
+	}
+	pEntry = g_new0 (CairoDockImageCacheEntry, 1);
+	pEntry->cKey = cKey;
+	pEntry->pSurface = pSurface;
+	pEntry->fImageWidth = fImageWidth;
+	pEntry->fImageHeight = fImageHeight;
+	pEntry->fZoomX = fZoomX;
+	pEntry->fZoomY = fZoomY;
+	pEntry->fMaxScale = fMaxScale;
+	pEntry->iSize = 4 * ceil (fImageWidth * fMaxScale * fDeviceScale) * ceil (fImageHeight * fMaxScale * fDeviceScale);
+	pEntry->link.data = pEntry;
+	cairo_surface_set_user_data (pSurface, &s_entryKey, pEntry, NULL);
+	g_hash_table_insert (s_hEntries, cKey, pEntry);
+	g_queue_push_tail_link (&s_lru, &pEntry->link);
+	s_iSize += pEntry->iSize;
+	cairo_surface_reference (pSurface);
+	
+	_trim (pEntry);
+	g_mutex_unlock (&s_mutex);
+	return pEntry;
+}
+
+static inline void _get_size (CairoDockImageCacheEntry *pEntry, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+{
+	*fImageWidth = pEntry->fImageWidth;
+	*fImageHeight = pEntry->fImageHeight;
+	if (fZoomX != NULL)
+		*fZoomX = pEntry->fZoomX;
+	if (fZoomY != NULL)
+		*fZoomY = pEntry->fZoomY;
+}
+
+
+cairo_surface_t *cairo_dock_image_cache_create_surface_full (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY, double fDeviceScale)
+{
+	CairoDockImageCacheEntry *pEntry = _get_entry (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier, fDeviceScale);
+	if (pEntry == NULL)
+		return NULL;
+	_get_size (pEntry, fImageWidth, fImageHeight, fZoomX, fZoomY);
+	
+	// copy the image, with the same size and scale as the decoder would have created it.
+	cairo_surface_t *pNewSurface = cairo_surface_create_similar (pEntry->pSurface,  // same kind of surface and device scale, without querying the screen.
+		CAIRO_CONTENT_COLOR_ALPHA,
+		ceil (pEntry->fImageWidth * pEntry->fMaxScale),
+		ceil (pEntry->fImageHeight * pEntry->fMaxScale));
+	cairo_t *pCairoContext = cairo_create (pNewSurface);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
+	cairo_set_source_surface (pCairoContext, pEntry->pSurface, 0., 0.);
+	cairo_paint (pCairoContext);
+	cairo_destroy (pCairoContext);
+	cairo_surface_destroy (pEntry->pSurface);  // release the reference taken by _get_entry
+	return pNewSurface;
+}
+
+cairo_surface_t *cairo_dock_image_cache_create_surface (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+{
+	return cairo_dock_image_cache_create_surface_full (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier, fImageWidth, fImageHeight, fZoomX, fZoomY, cairo_dock_get_device_scale ());
+}
+
+cairo_surface_t *cairo_dock_image_cache_get_shared_surface (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+{
+	CairoDockImageCacheEntry *pEntry = _get_entry (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier, cairo_dock_get_device_scale ());
+	if (pEntry == NULL)
+		return NULL;
+	_get_size (pEntry, fImageWidth, fImageHeight, fZoomX, fZoomY);
+	return pEntry->pSurface;  // _get_entry has taken a reference for the caller
+}
+
+GLuint cairo_dock_image_cache_get_shared_texture (cairo_surface_t *pSurface, int *iTexWidth, int *iTexHeight)
+{
+	g_return_val_if_fail (pSurface != NULL, 0);
+	CairoDockImageCacheEntry *pEntry = cairo_surface_get_user_data (pSurface, &s_entryKey);
+	if (pEntry == NULL)
+		return 0;
+	
+	if (pEntry->iTexture == 0)
+	{
+		int iTexWidth_, iTexHeight_;
+		GLuint iTexture = cairo_dock_create_texture_from_surface_full (pEntry->pSurface,
+			&iTexWidth_, &iTexHeight_);  // the surface is in use by the caller, so the entry can't go away meanwhile.
+		if (iTexture == 0)
+			return 0;
+		g_mutex_lock (&s_mutex);
+		pEntry->iTexture = iTexture;
+		pEntry->iTexWidth = iTexWidth_;
+		pEntry->iTexHeight = iTexHeight_;
+		g_hash_table_insert (s_hTextures, GUINT_TO_POINTER (pEntry->iTexture), pEntry);
+	}
+	else
+	{
+		g_mutex_lock (&s_mutex);
+		s_stats.iNbTextureHits ++;
+	}
+	pEntry->iNbTextureRefs ++;
+	g_mutex_unlock (&s_mutex);
+	*iTexWidth = pEntry->iTexWidth;
+	*iTexHeight = pEntry->iTexHeight;
+	return pEntry->iTexture;
+}
+
+gboolean cairo_dock_image_cache_release_texture (GLuint iTexture)
+{
+	if (s_hTextures == NULL || iTexture == 0)
+		return FALSE;
+	g_mutex_lock (&s_mutex);
+	CairoDockImageCacheEntry *pEntry = g_hash_table_lookup (s_hTextures, GUINT_TO_POINTER (iTexture));
+	if (pEntry == NULL)
+	{
+		g_mutex_unlock (&s_mutex);
+		return FALSE;
+	}
+	
+	pEntry->iNbTextureRefs --;
+	gboolean bDelete = (pEntry->iNbTextureRefs == 0);  // unused textures are not kept, it's cheap to upload the surface again.
+	if (bDelete)
+	{
+		g_hash_table_remove (s_hTextures, GUINT_TO_POINTER (iTexture));
+		pEntry->iTexture = 0;
+	}
+	g_mutex_unlock (&s_mutex);
+	if (bDelete)
+		_cairo_dock_delete_texture (iTexture);
+	return TRUE;
+}
+
+static gboolean _remove_unused_entry (G_GNUC_UNUSED gchar *cKey, CairoDockImageCacheEntry *pEntry, G_GNUC_UNUSED gpointer data)
+{
+	return ! _entry_is_used (pEntry);
+}
+void cairo_dock_image_cache_clear (void)
+{
+	if (s_hEntries == NULL)
+		return;
+	g_mutex_lock (&s_mutex);
+	guint n = g_hash_table_foreach_remove (s_hEntries, (GHRFunc)_remove_unused_entry, NULL);
+	g_mutex_unlock (&s_mutex);
+	cd_debug ("%d images removed from the cache", n);
+}
+
+static void _count_shared_entry (G_GNUC_UNUSED gchar *cKey, CairoDockImageCacheEntry *pEntry, guint *iNbShared)
+{
+	if (_entry_is_used (pEntry))
+		(*iNbShared) ++;
+}
+void cairo_dock_image_cache_get_stats (CairoDockImageCacheStats *pStats)
+{
+	g_mutex_lock (&s_mutex);
+	*pStats = s_stats;
+	pStats->iNbEntries = (s_hEntries ? g_hash_table_size (s_hEntries) : 0);
+	pStats->iNbSharedEntries = 0;
+	if (s_hEntries != NULL)
+		g_hash_table_foreach (s_hEntries, (GHFunc)_count_shared_entry, &pStats->iNbSharedEntries);
+	pStats->iSize = s_iSize;
+	g_mutex_unlock (&s_mutex);
+}
+
+gchar *cairo_dock_image_cache_get_report (void)
+{
+	CairoDockImageCacheStats stats;
+	cairo_dock_image_cache_get_stats (&stats);
+	guint n = stats.iNbHits + stats.iNbMisses;
+	return g_strdup_printf ("images: %u hits, %u misses (%.1f%% hits)\n"
+		"textures shared: %u\n"
+		"evictions: %u\n"
+		"entries: %u (%u in use), %.1f kB",
+		stats.iNbHits, stats.iNbMisses, n != 0 ? 100. * stats.iNbHits / n : 0.,
+		stats.iNbTextureHits,
+		stats.iNbEvictions,
+		stats.iNbEntries, stats.iNbSharedEntries, stats.iSize / 1024.);
+}
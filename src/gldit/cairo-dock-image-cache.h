@@ -0,0 +1,117 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_IMAGE_CACHE__
+#define  __CAIRO_DOCK_IMAGE_CACHE__
+
+#include <glib.h>
+#include <GL/gl.h>
+#include <cairo.h>
+
+#include "cairo-dock-struct.h"
+#include "cairo-dock-surface-factory.h"  // CairoDockLoadImageModifier
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-image-cache.h This class keeps the images loaded from files, so that the same image at the same size is decoded only once for the whole process.
+* An image is identified by its path, the modification time of the file, the requested size, the load modifier and the scale it was rasterized at; so a modified file is simply loaded again.
+* 
+* Use \ref cairo_dock_image_cache_create_surface to get a private copy of an image, that you can draw on; use \ref cairo_dock_image_cache_get_shared_surface (or \ref cairo_dock_load_shared_image_buffer for an ImageBuffer) to share the surface and the texture with all the other users of the same image.
+* The images that are not used anymore are kept until the cache exceeds its size, so that reloading the theme or the icons doesn't decode them again.
+* \ref cairo_dock_image_cache_create_surface_full can be called from a worker thread, with a device scale taken in the main thread beforehand; the other functions must be called from the main thread.
+*/
+
+/// Counters of the image cache.
+typedef struct _CairoDockImageCacheStats {
+	/// number of images found in the cache, and number of images that had to be decoded
+	guint iNbHits, iNbMisses;
+	/// number of textures that could be shared instead of being created
+	guint iNbTextureHits;
+	/// number of images removed from the cache to respect its size
+	guint iNbEvictions;
+	/// number of images in the cache, and number of them currently shared by some ImageBuffers
+	guint iNbEntries, iNbSharedEntries;
+	/// memory used by the surfaces of the cache, in bytes
+	gsize iSize;
+	} CairoDockImageCacheStats;
+
+/** Create a surface from an image file, like \ref cairo_dock_create_surface_from_image, using the cache. The surface is a copy of the cached image, so the caller can draw on it and must destroy it.
+*@param cImagePath path of the image.
+*@param fMaxScale maximum zoom of the image.
+*@param iWidthConstraint constraint on the width, or 0 to not constraint it.
+*@param iHeightConstraint constraint on the height, or 0 to not constraint it.
+*@param iLoadingModifier a mask of different loading modifiers.
+*@param fImageWidth will be filled with the resulting width of the image (hors zoom).
+*@param fImageHeight will be filled with the resulting height of the image (hors zoom).
+*@param fZoomX if non NULL, will be filled with the zoom that has been applied on width.
+*@param fZoomY if non NULL, will be filled with the zoom that has been applied on height.
+*@return the newly allocated surface, or NULL if the image couldn't be loaded.
+*/
+cairo_surface_t *cairo_dock_image_cache_create_surface (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY);
+
+/** Like \ref cairo_dock_image_cache_create_surface, with a given device scale, so that the screen is not queried: in OpenGL mode, it can be called from a worker thread.
+*@param fDeviceScale device scale of the screen, as given by \ref cairo_dock_get_device_scale in the main thread.
+*/
+cairo_surface_t *cairo_dock_image_cache_create_surface_full (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY, double fDeviceScale);
+
+/** Get an image from the cache, loading it if needed. The surface is shared with the other users of the same image, and must not be modified; destroy it with cairo_surface_destroy when you don't need it anymore.
+*@param cImagePath path of the image.
+*@param fMaxScale maximum zoom of the image.
+*@param iWidthConstraint constraint on the width, or 0 to not constraint it.
+*@param iHeightConstraint constraint on the height, or 0 to not constraint it.
+*@param iLoadingModifier a mask of different loading modifiers.
+*@param fImageWidth will be filled with the resulting width of the image (hors zoom).
+*@param fImageHeight will be filled with the resulting height of the image (hors zoom).
+*@param fZoomX if non NULL, will be filled with the zoom that has been applied on width.
+*@param fZoomY if non NULL, will be filled with the zoom that has been applied on height.
+*@return a new reference on the surface, or NULL if the image couldn't be loaded.
+*/
+cairo_surface_t *cairo_dock_image_cache_get_shared_surface (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY);
+
+/** Get the texture of a surface given by \ref cairo_dock_image_cache_get_shared_surface. It is created on the first call, and shared by all the users of the image; release it with \ref cairo_dock_image_cache_release_texture.
+*@param pSurface a surface of the cache.
+*@param iTexWidth will be filled with the real width of the texture.
+*@param iTexHeight will be filled with the real height of the texture.
+*@return the texture, or 0 if the surface doesn't belong to the cache.
+*/
+GLuint cairo_dock_image_cache_get_shared_texture (cairo_surface_t *pSurface, int *iTexWidth, int *iTexHeight);
+
+/** Release a texture that was given by the cache. It is deleted when its last user releases it. This is done by \ref cairo_dock_unload_image_buffer.
+*@param iTexture a texture
+*@return TRUE if the texture belongs to the cache, in which case it must not be deleted by the caller.
+*/
+gboolean cairo_dock_image_cache_release_texture (GLuint iTexture);
+
+/** Remove all the images that are not currently used from the cache.
+*/
+void cairo_dock_image_cache_clear (void);
+
+/** Get the counters of the image cache.
+*@param pStats filled with the counters.
+*/
+void cairo_dock_image_cache_get_stats (CairoDockImageCacheStats *pStats);
+
+/** Get the counters of the image cache as a text, for diagnostics.
+*@return a newly allocated string.
+*/
+gchar *cairo_dock_image_cache_get_report (void);
+
+G_END_DECLS
+#endif
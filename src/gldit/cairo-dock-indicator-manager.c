@@ -542,7 +542,7 @@ static inline void _load_task_indicator (const gchar *cIndicatorImagePath, doubl
 	double fLauncherHeight = myIconsParam.iIconHeight;
 	double fScale = (myIndicatorsParam.bIndicatorOnIcon ? fMaxScale : 1.) * fIndicatorRatio;
 	
-	cairo_dock_load_image_buffer (&s_indicatorBuffer,
+	cairo_dock_load_shared_image_buffer (&s_indicatorBuffer,
 		cIndicatorImagePath,
 		fLauncherWidth * fScale,
 		fLauncherHeight * fScale,
@@ -559,7 +559,7 @@ static inline void _load_active_window_indicator (const gchar *cImagePath, doubl
 	
 	if (cImagePath != NULL)
 	{
-		cairo_dock_load_image_buffer (&s_activeIndicatorBuffer,
+		cairo_dock_load_shared_image_buffer (&s_activeIndicatorBuffer,
 			cImagePath,
 			iWidth,
 			iHeight,
@@ -623,7 +623,7 @@ static inline void _load_class_indicator (const gchar *cIndicatorImagePath)
 	int iLauncherWidth = myIconsParam.iIconWidth;
 	int iLauncherHeight = myIconsParam.iIconHeight;
 	
-	cairo_dock_load_image_buffer (&s_classIndicatorBuffer,
+	cairo_dock_load_shared_image_buffer (&s_classIndicatorBuffer,
 		cIndicatorImagePath,
 		iLauncherWidth/3,  // will be drawn at 1/3 of the icon, with no zoom.
 		iLauncherHeight/3,
@@ -23,6 +23,7 @@
 #include <gio/gunixoutputstream.h>
 
 #include "cairo-dock-log.h"
+#include "cairo-dock-theme-snapshot.h"
 #include "cairo-dock-keyfile-utilities.h"
 
 
@@ -30,7 +31,10 @@ GKeyFile *cairo_dock_open_key_file (const gchar *cConfFilePath)
 {
 	GKeyFile *pKeyFile = g_key_file_new ();
 	GError *erreur = NULL;
-	g_key_file_load_from_file (pKeyFile, cConfFilePath, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, &erreur);
+	if (gldi_theme_snapshot_is_active ())  // while the theme is loading
+		gldi_theme_snapshot_load_key_file (pKeyFile, cConfFilePath, &erreur);
+	else
+		g_key_file_load_from_file (pKeyFile, cConfFilePath, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, &erreur);
 	if (erreur != NULL)
 	{
 		cd_debug ("while trying to load %s : %s", cConfFilePath, erreur->message);  // on ne met pas de warning car un fichier de conf peut ne pas exister la 1ere fois.
@@ -71,6 +75,7 @@ void cairo_dock_write_keys_to_file_full (GKeyFile *pKeyFile, const gchar *cConfF
 		g_error_free (erreur);
 		return ;
 	}
+	gldi_theme_snapshot_forget_file (cConfFilePath);
 	g_free (cNewConfFileContent);
 }
 
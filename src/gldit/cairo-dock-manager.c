@@ -23,6 +23,7 @@
 #include "cairo-dock-log.h"
 #include "cairo-dock-module-manager.h"  // GldiVisitCard (for gldi_extend_manager)
 #include "cairo-dock-keyfile-utilities.h"
+#include "cairo-dock-trace.h"
 #define __MANAGER_DEF__
 #include "cairo-dock-manager.h"
 
@@ -56,7 +57,11 @@ static void _gldi_init_manager (GldiManager *pManager)
 static inline void _gldi_load_manager (GldiManager *pManager)
 {
 	if (pManager->load)
+	{
+		gint64 iStartTime = gldi_trace_begin ();
 		pManager->load ();
+		gldi_trace_end ("manager", "load", pManager->cModuleName, iStartTime);
+	}
 }
 
 static inline void _gldi_unload_manager (GldiManager *pManager)
@@ -81,12 +86,18 @@ static void _gldi_manager_reload_from_keyfile (GldiManager *pManager, GKeyFile *
 		pPrevConfig = g_memdup2 (pManager->pConfig, pManager->iSizeOfConfig);
 		memset (pManager->pConfig, 0, pManager->iSizeOfConfig);
 		
+		gint64 iStartTime = gldi_trace_begin ();
 		pManager->get_config (pKeyFile, pManager->pConfig);
+		gldi_trace_end ("manager", "get_config", pManager->cModuleName, iStartTime);
 	}
 	
 	// reload
 	if (pManager->reload && g_pPrimaryContainer != NULL)  // in maintenance mode, no need to reload.
+	{
+		gint64 iStartTime = gldi_trace_begin ();
 		pManager->reload (pPrevConfig, pManager->pConfig);
+		gldi_trace_end ("manager", "reload", pManager->cModuleName, iStartTime);
+	}
 	
 	// free old config
 	if (pManager->reset_config)
@@ -104,7 +115,10 @@ static gboolean gldi_manager_get_config (GldiManager *pManager, GKeyFile *pKeyFi
 		pManager->reset_config (pManager->pConfig);
 	}
 	memset (pManager->pConfig, 0, pManager->iSizeOfConfig);
-	return pManager->get_config (pKeyFile, pManager->pConfig);
+	gint64 iStartTime = gldi_trace_begin ();
+	gboolean bFlushConfFileNeeded = pManager->get_config (pKeyFile, pManager->pConfig);
+	gldi_trace_end ("manager", "get_config", pManager->cModuleName, iStartTime);
+	return bFlushConfFileNeeded;
 }
 
 
@@ -33,7 +33,9 @@
 #include "cairo-dock-desklet-manager.h"
 #include "cairo-dock-animations.h"
 #include "cairo-dock-config.h"
+#include "cairo-dock-keyfile-utilities.h"  // cairo_dock_write_keys_to_file
 #include "cairo-dock-module-instance-manager.h"
+#include "cairo-dock-trace.h"
 #define _MANAGER_DEF_
 #include "cairo-dock-module-manager-priv.h"
 
@@ -51,6 +53,7 @@ gchar **g_cExcludedModules = NULL; // specific modules to exclude (try loading t
 // dependencies
 extern gchar *g_cConfFile;
 extern gchar *g_cCurrentThemePath;
+extern gchar *g_cCairoDockDataDir;
 extern int g_iMajorVersion, g_iMinorVersion, g_iMicroVersion;
 extern gboolean g_bEasterEggs;
 extern gboolean g_bUseOpenGL;
@@ -60,6 +63,7 @@ static GHashTable *s_hModuleTable = NULL;
 static GList *s_AutoLoadedModules = NULL;
 static guint s_iSidWriteModules = 0;
 static gboolean s_bSelfNotify = FALSE;
+static GHashTable *s_hDeferredModules = NULL;  // modules whose .so file has not been opened yet -> CairoDockDeferredModule
 
 typedef struct _GldiModuleAttr {
 	GldiVisitCard *pVisitCard;
@@ -137,6 +141,314 @@ static void _trigger_write_modules (void)
 }
 
 
+  ///////////////////////
+ /// MODULE MANIFEST ///
+///////////////////////
+
+#define CD_MODULES_MANIFEST_FILE ".modules-manifest"
+
+typedef enum {
+	CD_INTERFACE_INIT         = 1<<0,
+	CD_INTERFACE_STOP         = 1<<1,
+	CD_INTERFACE_RELOAD       = 1<<2,
+	CD_INTERFACE_READ_CONF    = 1<<3,
+	CD_INTERFACE_RESET_CONFIG = 1<<4,
+	CD_INTERFACE_RESET_DATA   = 1<<5,
+	CD_INTERFACE_LOAD_WIDGET  = 1<<6,
+	CD_INTERFACE_SAVE_WIDGET  = 1<<7
+	} CairoDockInterfaceFlags;
+
+typedef struct {
+	GStringChunk *pStrings;  // strings of the visit card
+	gchar *cSoFilePath;
+	gboolean bOpened;  // TRUE once we tried to open the .so file
+	} CairoDockDeferredModule;
+
+static GKeyFile *s_pManifest = NULL;  // manifest written at the previous startup
+static GKeyFile *s_pNewManifest = NULL;  // manifest of the modules found this time
+static gboolean s_bManifestChanged = FALSE;
+
+// Only the modules that declare it can be loaded when they're needed: the pre_init of the other ones may do more than filling the visit card and the interface.
+static gboolean _visit_card_allows_deferred_loading (GldiVisitCard *pVisitCard)
+{
+	return (pVisitCard->iMajorVersionNeeded == 4 && (pVisitCard->iMicroVersionNeeded & CAIRO_DOCK_MODULE_DEFERRED_LOADING));
+}
+
+static gchar *_get_manifest_environment (void)
+{
+	// the visit card depends on the version of the dock, the language (the title is translated in the pre_init) and the backend.
+	const gchar * const *cLanguages = g_get_language_names ();
+	return g_strdup_printf ("%d;%s;%s;%s", GLDI_ABI_VERSION, GLDI_VERSION,
+		cLanguages[0],
+		gldi_container_is_wayland_backend () ? "wayland" : "x11");
+}
+
+static void _copy_group (GKeyFile *pKeyFile, GKeyFile *pNewKeyFile, const gchar *cGroupName)
+{
+	gchar **cKeys = g_key_file_get_keys (pKeyFile, cGroupName, NULL, NULL);
+	gchar *cValue;
+	int i;
+	for (i = 0; cKeys != NULL && cKeys[i] != NULL; i ++)
+	{
+		cValue = g_key_file_get_value (pKeyFile, cGroupName, cKeys[i], NULL);
+		if (cValue)
+			g_key_file_set_value (pNewKeyFile, cGroupName, cKeys[i], cValue);
+		g_free (cValue);
+	}
+	g_strfreev (cKeys);
+}
+
+// The manifest holds the modules of all the folders; only the ones that are about to be scanned are refreshed.
+static void _manifest_begin (const gchar **cDirs)
+{
+	gchar *cManifestPath = g_strdup_printf ("%s/%s", g_cCairoDockDataDir, CD_MODULES_MANIFEST_FILE);
+	gchar *cEnvironment = _get_manifest_environment ();
+	s_pManifest = g_key_file_new ();
+	if (! g_key_file_load_from_file (s_pManifest, cManifestPath, G_KEY_FILE_NONE, NULL))
+	{
+		g_key_file_free (s_pManifest);
+		s_pManifest = NULL;
+	}
+	else
+	{
+		gchar *cPrevEnvironment = g_key_file_get_string (s_pManifest, "Manifest", "environment", NULL);
+		if (g_strcmp0 (cPrevEnvironment, cEnvironment) != 0)  // the cached visit cards are not valid anymore.
+		{
+			cd_debug ("the modules manifest is outdated (%s)", cPrevEnvironment);
+			g_key_file_free (s_pManifest);
+			s_pManifest = NULL;
+		}
+		g_free (cPrevEnvironment);
+	}
+	s_pNewManifest = g_key_file_new ();
+	g_key_file_set_string (s_pNewManifest, "Manifest", "environment", cEnvironment);
+	if (s_pManifest != NULL)
+	{
+		gchar **cGroups = g_key_file_get_groups (s_pManifest, NULL);
+		gchar *cDir;
+		int i, j;
+		for (i = 0; cGroups[i] != NULL; i ++)
+		{
+			if (strcmp (cGroups[i], "Manifest") == 0)
+				continue;
+			cDir = g_path_get_dirname (cGroups[i]);
+			for (j = 0; cDirs[j] != NULL; j ++)
+			{
+				if (strcmp (cDir, cDirs[j]) == 0)
+					break;
+			}
+			if (cDirs[j] == NULL)  // not in the scanned folders, keep it as it is.
+				_copy_group (s_pManifest, s_pNewManifest, cGroups[i]);
+			g_free (cDir);
+		}
+		g_strfreev (cGroups);
+	}
+	s_bManifestChanged = (s_pManifest == NULL);
+	g_free (cEnvironment);
+	g_free (cManifestPath);
+}
+
+static void _manifest_end (void)
+{
+	if (! s_bManifestChanged)  // same modules as last time, unless some of them have been removed.
+	{
+		gsize n, n2;
+		g_strfreev (g_key_file_get_groups (s_pManifest, &n));
+		g_strfreev (g_key_file_get_groups (s_pNewManifest, &n2));
+		s_bManifestChanged = (n != n2);
+	}
+	if (s_bManifestChanged)
+	{
+		gchar *cManifestPath = g_strdup_printf ("%s/%s", g_cCairoDockDataDir, CD_MODULES_MANIFEST_FILE);
+		cairo_dock_write_keys_to_file (s_pNewManifest, cManifestPath);
+		g_free (cManifestPath);
+	}
+	if (s_pManifest)
+		g_key_file_free (s_pManifest);
+	s_pManifest = NULL;
+	g_key_file_free (s_pNewManifest);
+	s_pNewManifest = NULL;
+}
+
+static void _set_string (GKeyFile *pKeyFile, const gchar *cGroupName, const gchar *cKeyName, const gchar *cValue)
+{
+	if (cValue != NULL)  // a missing key means NULL.
+		g_key_file_set_string (pKeyFile, cGroupName, cKeyName, cValue);
+}
+
+static const gchar *_get_string (GKeyFile *pKeyFile, const gchar *cGroupName, const gchar *cKeyName, GStringChunk *pStrings)
+{
+	gchar *cValue = g_key_file_get_string (pKeyFile, cGroupName, cKeyName, NULL);
+	if (cValue == NULL)
+		return NULL;
+	const gchar *str = g_string_chunk_insert (pStrings, cValue);
+	g_free (cValue);
+	return str;
+}
+
+static void _manifest_add_module (const gchar *cSoFilePath, GStatBuf *st, GldiVisitCard *v, int iInterface)
+{
+	GKeyFile *k = s_pNewManifest;
+	const gchar *g = cSoFilePath;
+	g_key_file_set_int64 (k, g, "size", st->st_size);
+	g_key_file_set_int64 (k, g, "mtime", st->st_mtime);
+	g_key_file_set_integer (k, g, "interface", iInterface);
+	_set_string (k, g, "name", v->cModuleName);
+	g_key_file_set_integer (k, g, "major", v->iMajorVersionNeeded);
+	g_key_file_set_integer (k, g, "minor", v->iMinorVersionNeeded);
+	g_key_file_set_integer (k, g, "micro", v->iMicroVersionNeeded);
+	_set_string (k, g, "preview", v->cPreviewFilePath);
+	_set_string (k, g, "gettext domain", v->cGettextDomain);
+	_set_string (k, g, "dock version", v->cDockVersionOnCompilation);
+	_set_string (k, g, "version", v->cModuleVersion);
+	_set_string (k, g, "user dir", v->cUserDataDir);
+	_set_string (k, g, "share dir", v->cShareDataDir);
+	_set_string (k, g, "conf file", v->cConfFileName);
+	g_key_file_set_integer (k, g, "category", v->iCategory);
+	_set_string (k, g, "icon", v->cIconFilePath);
+	g_key_file_set_integer (k, g, "config size", v->iSizeOfConfig);
+	g_key_file_set_integer (k, g, "data size", v->iSizeOfData);
+	g_key_file_set_boolean (k, g, "multi-instance", v->bMultiInstance);
+	_set_string (k, g, "description", v->cDescription);
+	_set_string (k, g, "author", v->cAuthor);
+	_set_string (k, g, "internal module", v->cInternalModule);
+	_set_string (k, g, "title", v->cTitle);
+	g_key_file_set_integer (k, g, "container", v->iContainerType);
+	g_key_file_set_boolean (k, g, "static desklet size", v->bStaticDeskletSize);
+	g_key_file_set_boolean (k, g, "allow empty title", v->bAllowEmptyTitle);
+	g_key_file_set_boolean (k, g, "act as launcher", v->bActAsLauncher);
+}
+
+static GldiVisitCard *_manifest_get_visit_card (const gchar *cSoFilePath, GStatBuf *st, int *iInterface, GStringChunk **pStrings)
+{
+	GKeyFile *k = s_pManifest;
+	const gchar *g = cSoFilePath;
+	if (k == NULL || ! g_key_file_has_group (k, g))
+		return NULL;
+	if (g_key_file_get_int64 (k, g, "size", NULL) != st->st_size
+	|| g_key_file_get_int64 (k, g, "mtime", NULL) != st->st_mtime)  // the module has been updated.
+		return NULL;
+	
+	GStringChunk *s = g_string_chunk_new (256);
+	GldiVisitCard *v = g_new0 (GldiVisitCard, 1);
+	v->cModuleName = _get_string (k, g, "name", s);
+	v->iMajorVersionNeeded = g_key_file_get_integer (k, g, "major", NULL);
+	v->iMinorVersionNeeded = g_key_file_get_integer (k, g, "minor", NULL);
+	v->iMicroVersionNeeded = g_key_file_get_integer (k, g, "micro", NULL);
+	v->cPreviewFilePath = _get_string (k, g, "preview", s);
+	v->cGettextDomain = _get_string (k, g, "gettext domain", s);
+	v->cDockVersionOnCompilation = _get_string (k, g, "dock version", s);
+	v->cModuleVersion = _get_string (k, g, "version", s);
+	v->cUserDataDir = _get_string (k, g, "user dir", s);
+	v->cShareDataDir = _get_string (k, g, "share dir", s);
+	v->cConfFileName = _get_string (k, g, "conf file", s);
+	v->iCategory = g_key_file_get_integer (k, g, "category", NULL);
+	v->cIconFilePath = _get_string (k, g, "icon", s);
+	v->iSizeOfConfig = g_key_file_get_integer (k, g, "config size", NULL);
+	v->iSizeOfData = g_key_file_get_integer (k, g, "data size", NULL);
+	v->bMultiInstance = g_key_file_get_boolean (k, g, "multi-instance", NULL);
+	v->cDescription = _get_string (k, g, "description", s);
+	v->cAuthor = _get_string (k, g, "author", s);
+	v->cInternalModule = _get_string (k, g, "internal module", s);
+	v->cTitle = _get_string (k, g, "title", s);
+	v->iContainerType = g_key_file_get_integer (k, g, "container", NULL);
+	v->bStaticDeskletSize = g_key_file_get_boolean (k, g, "static desklet size", NULL);
+	v->bAllowEmptyTitle = g_key_file_get_boolean (k, g, "allow empty title", NULL);
+	v->bActAsLauncher = g_key_file_get_boolean (k, g, "act as launcher", NULL);
+	*iInterface = g_key_file_get_integer (k, g, "interface", NULL);
+	if (v->cModuleName == NULL  // broken entry
+	|| ! _visit_card_allows_deferred_loading (v))  // written by a former version that deferred legacy modules too.
+	{
+		g_free (v);
+		g_string_chunk_free (s);
+		return NULL;
+	}
+	*pStrings = s;
+	return v;
+}
+
+static int _get_interface_flags (GldiModuleInterface *pInterface)
+{
+	return (pInterface->initModule ? CD_INTERFACE_INIT : 0)
+		| (pInterface->stopModule ? CD_INTERFACE_STOP : 0)
+		| (pInterface->reloadModule ? CD_INTERFACE_RELOAD : 0)
+		| (pInterface->read_conf_file ? CD_INTERFACE_READ_CONF : 0)
+		| (pInterface->reset_config ? CD_INTERFACE_RESET_CONFIG : 0)
+		| (pInterface->reset_data ? CD_INTERFACE_RESET_DATA : 0)
+		| (pInterface->load_custom_widget ? CD_INTERFACE_LOAD_WIDGET : 0)
+		| (pInterface->save_custom_widget ? CD_INTERFACE_SAVE_WIDGET : 0);
+}
+
+// A module can be loaded only when it's needed if nothing has to run before it's activated.
+static gboolean _module_can_be_deferred (GldiModule *pModule)
+{
+	return (pModule->iState != CAIRO_DOCK_MODULE_DISABLED
+		&& ! gldi_module_is_auto_loaded (pModule)
+		&& _visit_card_allows_deferred_loading (pModule->pVisitCard));
+}
+
+static void _free_deferred_module (CairoDockDeferredModule *pDeferred)
+{
+	g_string_chunk_free (pDeferred->pStrings);
+	g_free (pDeferred->cSoFilePath);
+	g_free (pDeferred);
+}
+
+// Placeholders of the interface of a deferred module: they load the module and call its actual function.
+static void _deferred_init (GldiModuleInstance *pInstance, GKeyFile *pKeyFile)
+{
+	if (gldi_module_load_interface (pInstance->pModule) && pInstance->pModule->pInterface->initModule)
+		pInstance->pModule->pInterface->initModule (pInstance, pKeyFile);
+}
+static void _deferred_stop (GldiModuleInstance *pInstance)
+{
+	if (gldi_module_load_interface (pInstance->pModule) && pInstance->pModule->pInterface->stopModule)
+		pInstance->pModule->pInterface->stopModule (pInstance);
+}
+static gboolean _deferred_reload (GldiModuleInstance *pInstance, GldiContainer *pOldContainer, GKeyFile *pKeyFile)
+{
+	if (gldi_module_load_interface (pInstance->pModule) && pInstance->pModule->pInterface->reloadModule)
+		return pInstance->pModule->pInterface->reloadModule (pInstance, pOldContainer, pKeyFile);
+	return FALSE;
+}
+static gboolean _deferred_read_conf (GldiModuleInstance *pInstance, GKeyFile *pKeyFile)
+{
+	if (gldi_module_load_interface (pInstance->pModule) && pInstance->pModule->pInterface->read_conf_file)
+		return pInstance->pModule->pInterface->read_conf_file (pInstance, pKeyFile);
+	return FALSE;
+}
+static void _deferred_reset_config (GldiModuleInstance *pInstance)
+{
+	if (gldi_module_load_interface (pInstance->pModule) && pInstance->pModule->pInterface->reset_config)
+		pInstance->pModule->pInterface->reset_config (pInstance);
+}
+static void _deferred_reset_data (GldiModuleInstance *pInstance)
+{
+	if (gldi_module_load_interface (pInstance->pModule) && pInstance->pModule->pInterface->reset_data)
+		pInstance->pModule->pInterface->reset_data (pInstance);
+}
+static void _deferred_load_widget (GldiModuleInstance *pInstance, GKeyFile *pKeyFile, GSList *pWidgetList)
+{
+	if (pInstance == NULL)  // can't know the module, it should have been loaded by the caller.
+	{
+		cd_warning ("the interface of this module has not been loaded");
+		return;
+	}
+	if (gldi_module_load_interface (pInstance->pModule) && pInstance->pModule->pInterface->load_custom_widget)
+		pInstance->pModule->pInterface->load_custom_widget (pInstance, pKeyFile, pWidgetList);
+}
+static void _deferred_save_widget (GldiModuleInstance *pInstance, GKeyFile *pKeyFile, GSList *pWidgetList)
+{
+	if (pInstance == NULL)
+	{
+		cd_warning ("the interface of this module has not been loaded");
+		return;
+	}
+	if (gldi_module_load_interface (pInstance->pModule) && pInstance->pModule->pInterface->save_custom_widget)
+		pInstance->pModule->pInterface->save_custom_widget (pInstance, pKeyFile, pWidgetList);
+}
+
+
   /////////////////////
  /// MODULE LOADER ///
 /////////////////////
@@ -155,6 +467,134 @@ GldiModule *gldi_module_new (GldiVisitCard *pVisitCard, GldiModuleInterface *pIn
 	return (GldiModule*)gldi_object_new (&myModuleObjectMgr, &attr);
 }
 
+/* Check that a module can run with this version of the dock and in this environment.
+* Returns FALSE if the module must be discarded; bDisable is set if it must be loaded but disabled.
+*/
+static gboolean _check_module (const gchar *cSoFilePath, GldiVisitCard *pVisitCard, gboolean *bDisable, const gchar **cDisableReason)
+{
+	*bDisable = FALSE;
+	*cDisableReason = NULL;
+	if (g_bNoCheckModuleVersion || g_bEasterEggs)
+		return TRUE;
+	
+	// check module compatibility
+	
+	if (g_bDisableAllModules)
+		return FALSE;
+	if (g_cExcludedModules)
+	{
+		gchar **tmp;
+		for (tmp = g_cExcludedModules; *tmp; ++tmp)
+		{
+			const gchar *tmp2 = strrchr (cSoFilePath, '/');
+			if (tmp2) tmp2++;
+			else tmp2 = cSoFilePath;
+			if (!strcmp (*tmp, tmp2)) return FALSE;
+			size_t x = strlen (tmp2); // compare without the .so extension
+			if (x > 3 && !strncmp (*tmp, tmp2, x - 3)) return FALSE;
+		}
+	}
+	
+	if (pVisitCard->iMajorVersionNeeded == 4)
+	{
+		// new version matching, based on ABI versions (stored in iMinorVersionNeeded) instead of release versions
+		if (pVisitCard->iMinorVersionNeeded != GLDI_ABI_VERSION)
+		{
+			cd_warning ("this module ('%s') was compiled for Cairo-Dock ABI version %d, but currently running Cairo-Dock with ABI version %d\n  It will be ignored", cSoFilePath, pVisitCard->iMinorVersionNeeded, GLDI_ABI_VERSION);
+			return FALSE;
+		}
+		// test compatibility with the windowing system backend in use (X11 or Wayland)
+		// note: iMicroVersionNeeded stores additional module flags in this case
+		if (gldi_container_is_wayland_backend ())
+		{
+			if (! (pVisitCard->iMicroVersionNeeded & CAIRO_DOCK_MODULE_SUPPORTS_WAYLAND) &&
+				!g_bNoWaylandExclude)
+			{
+				cd_message ("Not loading module ('%s') as it does not support Wayland\n", cSoFilePath);
+				*bDisable = TRUE;
+				*cDisableReason = _("You are running Cairo-dock in a Wayland session, but this plug-in does not support Wayland.");
+			}
+		}
+		else if (! (pVisitCard->iMicroVersionNeeded & CAIRO_DOCK_MODULE_SUPPORTS_X11))
+		{
+			cd_message ("Not loading module ('%s') as it does not support X11\n", cSoFilePath);
+			*bDisable = TRUE;
+			*cDisableReason = _("You are running Cairo-dock in an X11 session, but this plug-in does not support X11.");
+		}
+		// test if module requires OpenGL
+		if (!*bDisable && (pVisitCard->iMicroVersionNeeded & CAIRO_DOCK_MODULE_REQUIRES_OPENGL) && !g_bUseOpenGL)
+		{
+			cd_message ("Not loading module ('%s') as it requires OpenGL\n", cSoFilePath);
+			*bDisable = TRUE;
+			*cDisableReason = _("This plug-in requires OpenGL, but it is not enabled.");
+		}
+	}
+	else
+	{
+		if (pVisitCard->iMajorVersionNeeded > g_iMajorVersion
+			|| (pVisitCard->iMajorVersionNeeded == g_iMajorVersion && pVisitCard->iMinorVersionNeeded > g_iMinorVersion)
+			|| (pVisitCard->iMajorVersionNeeded == g_iMajorVersion && pVisitCard->iMinorVersionNeeded == g_iMinorVersion && pVisitCard->iMicroVersionNeeded > g_iMicroVersion))
+		{
+			cd_warning ("this module ('%s') needs at least Cairo-Dock v%d.%d.%d, but Cairo-Dock is in v%d.%d.%d (%s)\n  It will be ignored", cSoFilePath, pVisitCard->iMajorVersionNeeded, pVisitCard->iMinorVersionNeeded, pVisitCard->iMicroVersionNeeded, g_iMajorVersion, g_iMinorVersion, g_iMicroVersion, GLDI_VERSION);
+			return FALSE;
+		}
+		if (pVisitCard->cDockVersionOnCompilation != NULL && strcmp (pVisitCard->cDockVersionOnCompilation, GLDI_VERSION) != 0)  // separation des versions en easter egg.
+		{
+			cd_warning ("this module ('%s') was compiled with Cairo-Dock v%s, but Cairo-Dock is in v%s\n  It will be ignored", cSoFilePath, pVisitCard->cDockVersionOnCompilation, GLDI_VERSION);
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/* Create a module from its entry in the manifest, without opening its .so file.
+* Returns FALSE if the manifest has no valid entry for this file.
+*/
+static gboolean _module_new_from_manifest (const gchar *cSoFilePath, GStatBuf *st)
+{
+	int iInterface = 0;
+	GStringChunk *pStrings = NULL;
+	GldiVisitCard *pVisitCard = _manifest_get_visit_card (cSoFilePath, st, &iInterface, &pStrings);
+	if (pVisitCard == NULL)
+		return FALSE;
+	_manifest_add_module (cSoFilePath, st, pVisitCard, iInterface);  // keep it for the next time
+	
+	gboolean bDisable;
+	const gchar *cDisableReason;
+	if (! _check_module (cSoFilePath, pVisitCard, &bDisable, &cDisableReason))
+		goto discard;
+	
+	// the interface is made of placeholders until the module is actually loaded.
+	GldiModuleInterface *pInterface = g_new0 (GldiModuleInterface, 1);
+	if (iInterface & CD_INTERFACE_INIT) pInterface->initModule = _deferred_init;
+	if (iInterface & CD_INTERFACE_STOP) pInterface->stopModule = _deferred_stop;
+	if (iInterface & CD_INTERFACE_RELOAD) pInterface->reloadModule = _deferred_reload;
+	if (iInterface & CD_INTERFACE_READ_CONF) pInterface->read_conf_file = _deferred_read_conf;
+	if (iInterface & CD_INTERFACE_RESET_CONFIG) pInterface->reset_config = _deferred_reset_config;
+	if (iInterface & CD_INTERFACE_RESET_DATA) pInterface->reset_data = _deferred_reset_data;
+	if (iInterface & CD_INTERFACE_LOAD_WIDGET) pInterface->load_custom_widget = _deferred_load_widget;
+	if (iInterface & CD_INTERFACE_SAVE_WIDGET) pInterface->save_custom_widget = _deferred_save_widget;
+	
+	GldiModule *pModule = gldi_module_new (pVisitCard, pInterface);  // takes ownership of pVisitCard and pInterface only if returns non-NULL
+	if (pModule == NULL)
+	{
+		g_free (pInterface);
+		goto discard;
+	}
+	CairoDockDeferredModule *pDeferred = g_new0 (CairoDockDeferredModule, 1);
+	pDeferred->pStrings = pStrings;
+	pDeferred->cSoFilePath = g_strdup (cSoFilePath);
+	g_hash_table_insert (s_hDeferredModules, pModule, pDeferred);
+	
+	if (bDisable) gldi_module_disable (pModule, cDisableReason); // keep it but disabled
+	return TRUE;
+	
+discard:
+	g_free (pVisitCard);
+	g_string_chunk_free (pStrings);
+	return TRUE;
+}
+
 /** Create a new module from a .so file and add it to our hashtable of modules.
 * @param cSoFilePath path to the .so file
 */
@@ -164,6 +604,12 @@ static void _module_new_from_so_file (const gchar *cSoFilePath)
 	GldiVisitCard *pVisitCard = NULL;
 	GldiModuleInterface *pInterface = NULL;
 	
+	// if the module has not changed since the last time, there is no need to open it now.
+	GStatBuf st;
+	gboolean bHaveStat = (g_stat (cSoFilePath, &st) == 0);
+	if (bHaveStat && _module_new_from_manifest (cSoFilePath, &st))
+		return;
+	
 	// open the .so file
 	gpointer handle = dlopen (cSoFilePath, RTLD_NOW | RTLD_LOCAL);
 	if (! handle)
@@ -190,79 +636,10 @@ static void _module_new_from_so_file (const gchar *cSoFilePath)
 		goto discard;
 	}
 	
-	gboolean bDisable = FALSE;
-	const gchar *cDisableReason = NULL;
-	
-	if (!g_bNoCheckModuleVersion && !g_bEasterEggs)
-	{
-		// check module compatibility
-		
-		if (g_bDisableAllModules)
-			goto discard;
-		if (g_cExcludedModules)
-		{
-			gchar **tmp;
-			for (tmp = g_cExcludedModules; *tmp; ++tmp)
-			{
-				const gchar *tmp2 = strrchr (cSoFilePath, '/');
-				if (tmp2) tmp2++;
-				else tmp2 = cSoFilePath;
-				if (!strcmp (*tmp, tmp2)) goto discard;
-				size_t x = strlen (tmp2); // compare without the .so extension
-				if (x > 3 && !strncmp (*tmp, tmp2, x - 3)) goto discard;
-			}
-		}
-		
-		if (pVisitCard->iMajorVersionNeeded == 4)
-		{
-			// new version matching, based on ABI versions (stored in iMinorVersionNeeded) instead of release versions
-			if (pVisitCard->iMinorVersionNeeded != GLDI_ABI_VERSION)
-			{
-				cd_warning ("this module ('%s') was compiled for Cairo-Dock ABI version %d, but currently running Cairo-Dock with ABI version %d\n  It will be ignored", cSoFilePath, pVisitCard->iMinorVersionNeeded, GLDI_ABI_VERSION);
-				goto discard;
-			}
-			// test compatibility with the windowing system backend in use (X11 or Wayland)
-			// note: iMicroVersionNeeded stores additional module flags in this case
-			if (gldi_container_is_wayland_backend ())
-			{
-				if (! (pVisitCard->iMicroVersionNeeded & CAIRO_DOCK_MODULE_SUPPORTS_WAYLAND) &&
-					!g_bNoWaylandExclude)
-				{
-					cd_message ("Not loading module ('%s') as it does not support Wayland\n", cSoFilePath);
-					bDisable = TRUE;
-					cDisableReason = _("You are running Cairo-dock in a Wayland session, but this plug-in does not support Wayland.");
-				}
-			}
-			else if (! (pVisitCard->iMicroVersionNeeded & CAIRO_DOCK_MODULE_SUPPORTS_X11))
-			{
-				cd_message ("Not loading module ('%s') as it does not support X11\n", cSoFilePath);
-				bDisable = TRUE;
-				cDisableReason = _("You are running Cairo-dock in an X11 session, but this plug-in does not support X11.");
-			}
-			// test if module requires OpenGL
-			if (!bDisable && (pVisitCard->iMicroVersionNeeded & CAIRO_DOCK_MODULE_REQUIRES_OPENGL) && !g_bUseOpenGL)
-			{
-				cd_message ("Not loading module ('%s') as it requires OpenGL\n", cSoFilePath);
-				bDisable = TRUE;
-				cDisableReason = _("This plug-in requires OpenGL, but it is not enabled.");
-			}
-		}
-		else
-		{
-			if (pVisitCard->iMajorVersionNeeded > g_iMajorVersion
-				|| (pVisitCard->iMajorVersionNeeded == g_iMajorVersion && pVisitCard->iMinorVersionNeeded > g_iMinorVersion)
-				|| (pVisitCard->iMajorVersionNeeded == g_iMajorVersion && pVisitCard->iMinorVersionNeeded == g_iMinorVersion && pVisitCard->iMicroVersionNeeded > g_iMicroVersion))
-			{
-				cd_warning ("this module ('%s') needs at least Cairo-Dock v%d.%d.%d, but Cairo-Dock is in v%d.%d.%d (%s)\n  It will be ignored", cSoFilePath, pVisitCard->iMajorVersionNeeded, pVisitCard->iMinorVersionNeeded, pVisitCard->iMicroVersionNeeded, g_iMajorVersion, g_iMinorVersion, g_iMicroVersion, GLDI_VERSION);
-				goto discard;
-			}
-			if (pVisitCard->cDockVersionOnCompilation != NULL && strcmp (pVisitCard->cDockVersionOnCompilation, GLDI_VERSION) != 0)  // separation des versions en easter egg.
-			{
-				cd_warning ("this module ('%s') was compiled with Cairo-Dock v%s, but Cairo-Dock is in v%s\n  It will be ignored", cSoFilePath, pVisitCard->cDockVersionOnCompilation, GLDI_VERSION);
-				goto discard;
-			}
-		}
-	}
+	gboolean bDisable;
+	const gchar *cDisableReason;
+	if (! _check_module (cSoFilePath, pVisitCard, &bDisable, &cDisableReason))
+		goto discard;
 	
 	// create a new module with these info
 	GldiModule *pModule = gldi_module_new (pVisitCard, pInterface);  // takes ownership of pVisitCard and pInterface only if returns non-NULL
@@ -283,6 +660,13 @@ static void _module_new_from_so_file (const gchar *cSoFilePath)
 			s_AutoLoadedModules = g_list_prepend (s_AutoLoadedModules, pModule);
 		}
 	
+	// remember it, so that it doesn't need to be opened the next time if it's not used.
+	if (bHaveStat && _module_can_be_deferred (pModule))
+	{
+		_manifest_add_module (cSoFilePath, &st, pVisitCard, _get_interface_flags (pInterface));
+		s_bManifestChanged = TRUE;
+	}
+	
 	return;
 	
 discard:
@@ -291,6 +675,51 @@ discard:
 	g_free (pInterface);
 }
 
+gboolean gldi_module_load_interface (GldiModule *pModule)
+{
+	g_return_val_if_fail (pModule != NULL, FALSE);
+	CairoDockDeferredModule *pDeferred = g_hash_table_lookup (s_hDeferredModules, pModule);
+	if (pDeferred == NULL)  // not a deferred module, its interface is already there.
+		return TRUE;
+	if (pDeferred->bOpened)  // already loaded, or failed to.
+		return (pModule->handle != NULL);
+	pDeferred->bOpened = TRUE;
+	cd_debug ("loading the deferred module %s", pModule->pVisitCard->cModuleName);
+	
+	// open the .so file
+	gpointer handle = dlopen (pDeferred->cSoFilePath, RTLD_NOW | RTLD_LOCAL);
+	if (! handle)
+	{
+		cd_warning ("while opening module '%s' : (%s)", pDeferred->cSoFilePath, dlerror());
+		goto fail;
+	}
+	GldiModulePreInit function_pre_init = dlsym (handle, "pre_init");
+	GldiVisitCard visitCard;
+	GldiModuleInterface interface;
+	memset (&visitCard, 0, sizeof (GldiVisitCard));
+	memset (&interface, 0, sizeof (GldiModuleInterface));
+	if (function_pre_init == NULL
+	|| ! function_pre_init (&visitCard, &interface)
+	|| g_strcmp0 (visitCard.cModuleName, pModule->pVisitCard->cModuleName) != 0)
+	{
+		cd_warning ("the module '%s' has changed since it was registered", pDeferred->cSoFilePath);
+		dlclose (handle);
+		goto fail;
+	}
+	
+	// replace the placeholders by the actual interface; we keep the visit card from the manifest, since other parts may point to it already.
+	pModule->handle = handle;
+	memcpy (pModule->pInterface, &interface, sizeof (GldiModuleInterface));
+	if (visitCard.postLoad)
+		visitCard.postLoad (pModule, NULL);
+	return (pModule->iState != CAIRO_DOCK_MODULE_DISABLED);
+	
+fail:
+	if (pModule->iState != CAIRO_DOCK_MODULE_DISABLED)
+		gldi_module_disable (pModule, _("This plug-in could not be loaded."));
+	return FALSE;
+}
+
 /* Load modules from cModuleDirPath which must be non-NULL */
 static void _gldi_modules_new_from_directory2 (const gchar *cModuleDirPath, GError **erreur)
 {
@@ -325,15 +754,29 @@ static void _gldi_modules_new_from_directory2 (const gchar *cModuleDirPath, GErr
 /* Load modules from cModuleDirPath or from the default paths if it is NULL */
 void gldi_modules_new_from_directory (const gchar *cModuleDirPath, GError **erreur)
 {
+	gint64 iStartTime = gldi_trace_begin ();
 	if (cModuleDirPath == NULL)
 	{
+		const gchar *cDirs[] = {GLDI_MODULES_DIR,
+#ifdef GLDI_MODULES_DIR_CORE
+			GLDI_MODULES_DIR_CORE,
+#endif
+			NULL};
+		_manifest_begin (cDirs);
 		_gldi_modules_new_from_directory2 (GLDI_MODULES_DIR, erreur);
 #ifdef GLDI_MODULES_DIR_CORE
 		// only if plugins are installed in a separate prefix
 		_gldi_modules_new_from_directory2 (GLDI_MODULES_DIR_CORE, erreur);
 #endif
 	}
-	else _gldi_modules_new_from_directory2 (cModuleDirPath, erreur);
+	else
+	{
+		const gchar *cDirs[] = {cModuleDirPath, NULL};
+		_manifest_begin (cDirs);
+		_gldi_modules_new_from_directory2 (cModuleDirPath, erreur);
+	}
+	_manifest_end ();
+	gldi_trace_end ("module", "register modules", cModuleDirPath, iStartTime);
 }
 
 gchar *gldi_module_get_config_dir (GldiModule *pModule)
@@ -380,6 +823,8 @@ static void _gldi_module_load_config_and_activate (GldiModule *module, gboolean
 	
 	if (module->iState == CAIRO_DOCK_MODULE_DISABLED) return; // avoid activating disabled modules
 	
+	if (! gldi_module_load_interface (module)) return; // open the .so file of a deferred module now.
+	
 	if (module->pVisitCard->cConfFileName != NULL)  // the module has a conf file -> create an instance for each of them.
 	{
 		// check that the module's config dir exists or create it.
@@ -544,9 +989,11 @@ void gldi_modules_activate_all (gboolean bOnlyAutoLoaded)
 	gchar *cModuleName;
 	GldiModule *pModule;
 	GList *m;
+	gint64 iStartTime;
 	for (m = s_AutoLoadedModules; m != NULL; m = m->next)
 	{
 		pModule = m->data;
+		iStartTime = gldi_trace_begin ();
 		if (pModule->pInstancesList == NULL)  // not yet active
 		{
 			_gldi_module_load_config_and_activate (pModule, TRUE); // do not update config
@@ -562,6 +1009,7 @@ void gldi_modules_activate_all (gboolean bOnlyAutoLoaded)
 					pModule->iState = CAIRO_DOCK_MODULE_ACTIVE;
 			}
 		}
+		gldi_trace_end ("module", "activate", pModule->pVisitCard->cModuleName, iStartTime);
 	}
 	
 	if (cActiveModuleList == NULL)
@@ -581,7 +1029,9 @@ void gldi_modules_activate_all (gboolean bOnlyAutoLoaded)
 		
 		if (pModule->iState == CAIRO_DOCK_MODULE_INACTIVE)  // not yet active
 		{
+			iStartTime = gldi_trace_begin ();
 			_gldi_module_load_config_and_activate (pModule, TRUE);
+			gldi_trace_end ("module", "activate", cModuleName, iStartTime);
 		}
 	}
 }
@@ -796,6 +1246,10 @@ static void init (void)
 		g_str_equal,
 		NULL,  // module name (points directly on the 'cModuleName' field of the module).
 		NULL);  // module
+	s_hDeferredModules = g_hash_table_new_full (NULL,
+		NULL,
+		NULL,
+		(GDestroyNotify) _free_deferred_module);
 }
 
   ///////////////
@@ -849,6 +1303,7 @@ static void reset_object (GldiObject *obj)
 	g_free (pModule->pInterface);
 	g_free (pModule->pVisitCard); // toutes les chaines sont statiques.
 	g_free (pModule->cDisableReason);
+	g_hash_table_remove (s_hDeferredModules, pModule);  // the strings of its visit card came from the manifest
 }
 
 static GKeyFile* reload_object (GldiObject *obj, gboolean bReloadConf, G_GNUC_UNUSED GKeyFile *pKeyFile)
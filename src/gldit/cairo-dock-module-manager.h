@@ -88,7 +88,9 @@ typedef enum {
 	/// This plug-in can function in a Wayland desktop environment
 	CAIRO_DOCK_MODULE_SUPPORTS_WAYLAND = 1<<1,
 	/// This plug-in requires OpenGL to function (if OpenGL is not available, it will be disabled)
-	CAIRO_DOCK_MODULE_REQUIRES_OPENGL = 1<<2
+	CAIRO_DOCK_MODULE_REQUIRES_OPENGL = 1<<2,
+	/// The postLoad () function of this plug-in only fills its interface, so it can be opened only when it is activated (set by \ref CD_APPLET_DEFINITION2)
+	CAIRO_DOCK_MODULE_DEFERRED_LOADING = 1<<3
 } GldiModuleFlags;
 
 /// Possible states of a module
@@ -265,6 +267,12 @@ GldiModule *gldi_module_new (GldiVisitCard *pVisitCard, GldiModuleInterface *pIn
 */
 gchar *gldi_module_get_config_dir (GldiModule *pModule);
 
+/** Make sure the interface of a module is available. A module that was not used at the previous startup is registered from the modules manifest without opening its .so file; its interface only holds placeholders until this function is called. It is called when the module is activated, and should be called before using the custom widgets of the module without an instance.
+* @param pModule the module
+* @return TRUE if the interface is available, FALSE if the module couldn't be loaded (it is disabled then).
+*/
+gboolean gldi_module_load_interface (GldiModule *pModule);
+
 
   /////////////
  // MANAGER //
@@ -17,6 +17,11 @@
 * along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#define _GNU_SOURCE  // dladdr
+#include <string.h>  // memcpy
+#include <stdio.h>  // snprintf
+#include <dlfcn.h>  // dladdr
+
 #include "cairo-dock-struct.h"
 #include "cairo-dock-manager.h"
 #include "cairo-dock-log.h"
@@ -28,6 +33,32 @@
  * GLDI_OBJECT_IS_xxx obj->mgr == pMgr || mgr->parent->mrg == pMgr || ...
  * */
 
+guint g_iGldiNotificationDepth = 0;
+static GSList *s_pPendingNotificationLists = NULL;  // lists replaced during a dispatch, freed once the dispatch is over
+
+static GldiNotificationList *_notification_list_new (guint iNbRecords)
+{
+	GldiNotificationList *pList = g_malloc (sizeof (GldiNotificationList) + iNbRecords * sizeof (GldiNotificationRecord));
+	pList->iNbRecords = iNbRecords;
+	return pList;
+}
+
+static void _notification_list_release (GldiNotificationList *pList)
+{
+	if (pList == NULL)
+		return;
+	if (g_iGldiNotificationDepth == 0)
+		g_free (pList);
+	else  // someone may be iterating on it, keep it until the end of the dispatch
+		s_pPendingNotificationLists = g_slist_prepend (s_pPendingNotificationLists, pList);
+}
+
+void gldi_object_release_notification_lists (void)
+{
+	g_slist_free_full (s_pPendingNotificationLists, g_free);
+	s_pPendingNotificationLists = NULL;
+}
+
 
 void gldi_object_set_manager (GldiObject *pObject, GldiObjectManager *pMgr)
 {
@@ -91,8 +122,8 @@ void gldi_object_unref (GldiObject *pObject)
 		guint i;
 		for (i = 0; i < pNotificationsTab->len; i ++)
 		{
-			GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, i);
-			g_slist_free_full (pNotificationRecordList, g_free);
+			GldiNotificationList *pNotificationList = g_ptr_array_index (pNotificationsTab, i);
+			_notification_list_release (pNotificationList);
 		}
 		g_ptr_array_free (pNotificationsTab, TRUE);
 		
@@ -154,19 +185,25 @@ void gldi_object_register_notification (gpointer pObject, GldiNotificationType i
 	g_return_if_fail (pObject != NULL);
 	// grab the notifications tab
 	GPtrArray *pNotificationsTab = GLDI_OBJECT(pObject)->pNotificationsTab;
-	if (!pNotificationsTab || pNotificationsTab->len < iNotifType)
+	if (!pNotificationsTab || pNotificationsTab->len <= iNotifType)
 	{
 		cd_warning ("someone tried to register to an inexisting notification (%d) on an object of type '%s'", iNotifType, gldi_object_get_type(pObject));
 		return ;  // don't try to create/resize the notifications tab, since noone will emit this notification.
 	}
 	
-	// add a record
-	GldiNotificationRecord *pNotificationRecord = g_new (GldiNotificationRecord, 1);
+	// build a new list with the record added
+	GldiNotificationList *pOldList = g_ptr_array_index (pNotificationsTab, iNotifType);
+	guint n = (pOldList ? pOldList->iNbRecords : 0);
+	GldiNotificationList *pNewList = _notification_list_new (n + 1);
+	GldiNotificationRecord *pNotificationRecord = (bRunFirst ? pNewList->pRecords : pNewList->pRecords + n);
+	if (n != 0)
+		memcpy (bRunFirst ? pNewList->pRecords + 1 : pNewList->pRecords, pOldList->pRecords, n * sizeof (GldiNotificationRecord));
 	pNotificationRecord->pFunction = pFunction;
 	pNotificationRecord->pUserData = pUserData;
 	
-	GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, iNotifType);
-	pNotificationsTab->pdata[iNotifType] = (bRunFirst ? g_slist_prepend : g_slist_append) (pNotificationRecordList, pNotificationRecord);
+	// publish it; the old list stays valid for any dispatch in progress
+	pNotificationsTab->pdata[iNotifType] = pNewList;
+	_notification_list_release (pOldList);
 }
 
 
@@ -175,19 +212,173 @@ void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNo
 	g_return_if_fail (pObject != NULL);
 	// grab the notifications tab
 	GPtrArray *pNotificationsTab = GLDI_OBJECT(pObject)->pNotificationsTab;
+	g_return_if_fail (pNotificationsTab != NULL && iNotifType < pNotificationsTab->len);
 	
-	// remove the record
-	GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, iNotifType);
-	GldiNotificationRecord *pNotificationRecord;
-	GSList *nr;
-	for (nr = pNotificationRecordList; nr != NULL; nr = nr->next)
+	// find the record
+	GldiNotificationList *pOldList = g_ptr_array_index (pNotificationsTab, iNotifType);
+	if (pOldList == NULL)
+		return;
+	guint i, n = pOldList->iNbRecords;
+	for (i = 0; i < n; i ++)
 	{
-		pNotificationRecord = nr->data;
-		if (pNotificationRecord->pFunction == pFunction && pNotificationRecord->pUserData == pUserData)
-		{
-			pNotificationsTab->pdata[iNotifType] = g_slist_delete_link (pNotificationRecordList, nr);
-			g_free (pNotificationRecord);
+		if (pOldList->pRecords[i].pFunction == pFunction && pOldList->pRecords[i].pUserData == pUserData)
 			break;
+	}
+	if (i == n)
+		return;
+	
+	// build a new list without it, and disable it in the old one, in case a dispatch is in progress on it
+	GldiNotificationList *pNewList = NULL;
+	if (n > 1)
+	{
+		pNewList = _notification_list_new (n - 1);
+		memcpy (pNewList->pRecords, pOldList->pRecords, i * sizeof (GldiNotificationRecord));
+		memcpy (pNewList->pRecords + i, pOldList->pRecords + i + 1, (n - i - 1) * sizeof (GldiNotificationRecord));
+	}
+	pOldList->pRecords[i].pFunction = NULL;
+	pNotificationsTab->pdata[iNotifType] = pNewList;
+	_notification_list_release (pOldList);
+}
+
+static inline GldiNotificationList *_get_notification_list (gpointer pObject, GldiNotificationType iNotifType)
+{
+	GPtrArray *pNotificationsTab = GLDI_OBJECT(pObject)->pNotificationsTab;
+	if (!pNotificationsTab || pNotificationsTab->len <= iNotifType)
+		return NULL;
+	return g_ptr_array_index (pNotificationsTab, iNotifType);
+}
+
+GldiNotificationList *gldi_object_copy_notifications (gpointer pObject, GldiNotificationType iNotifType)
+{
+	g_return_val_if_fail (pObject != NULL, NULL);
+	GldiNotificationList *pList = _get_notification_list (pObject, iNotifType);
+	if (pList == NULL)
+		return NULL;
+	GldiNotificationList *pCopy = _notification_list_new (pList->iNbRecords);
+	memcpy (pCopy->pRecords, pList->pRecords, pList->iNbRecords * sizeof (GldiNotificationRecord));
+	return pCopy;
+}
+
+gboolean gldi_object_notifications_match (gpointer pObject, GldiNotificationType iNotifType, const GldiNotificationList *pCopy)
+{
+	g_return_val_if_fail (pObject != NULL, FALSE);
+	GldiNotificationList *pList = _get_notification_list (pObject, iNotifType);  // a published list never contains disabled records
+	if (pList == NULL || pCopy == NULL)
+		return (pList == NULL && pCopy == NULL);
+	return (pList->iNbRecords == pCopy->iNbRecords
+		&& memcmp (pList->pRecords, pCopy->pRecords, pList->iNbRecords * sizeof (GldiNotificationRecord)) == 0);
+}
+
+
+  ///////////////
+ /// PROFILE ///
+///////////////
+
+gboolean g_bGldiProfileNotifications = FALSE;
+static GHashTable *s_pNotificationsProfile = NULL;  // (type, notification, callback) -> stats
+
+typedef struct {
+	const gchar *cObjectType;  // static string (name of a manager)
+	GldiNotificationType iNotifType;
+	GldiNotificationFunc pFunction;
+	guint iNbCalls;
+	gint64 iTotalTime;  // us
+	gint64 iMaxTime;  // us
+	} GldiNotificationProfile;
+
+static guint _profile_hash (gconstpointer key)
+{
+	const GldiNotificationProfile *p = key;
+	return g_direct_hash (p->cObjectType) ^ (p->iNotifType * 2654435761u) ^ g_direct_hash ((gpointer)p->pFunction);
+}
+
+static gboolean _profile_equal (gconstpointer a, gconstpointer b)
+{
+	const GldiNotificationProfile *p = a, *q = b;
+	return (p->cObjectType == q->cObjectType && p->iNotifType == q->iNotifType && p->pFunction == q->pFunction);
+}
+
+void gldi_object_profile_notification (GldiObject *pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction, gint64 iDuration)
+{
+	if (s_pNotificationsProfile == NULL)
+		s_pNotificationsProfile = g_hash_table_new_full (_profile_hash, _profile_equal, g_free, NULL);
+	
+	GldiNotificationProfile key = {gldi_object_get_type (pObject), iNotifType, pFunction, 0, 0, 0};
+	GldiNotificationProfile *pProfile = g_hash_table_lookup (s_pNotificationsProfile, &key);
+	if (pProfile == NULL)
+	{
+		pProfile = g_memdup2 (&key, sizeof (GldiNotificationProfile));
+		g_hash_table_add (s_pNotificationsProfile, pProfile);
+	}
+	pProfile->iNbCalls ++;
+	pProfile->iTotalTime += iDuration;
+	if (iDuration > pProfile->iMaxTime)
+		pProfile->iMaxTime = iDuration;
+}
+
+void gldi_object_enable_notifications_profile (gboolean bEnable)
+{
+	g_bGldiProfileNotifications = bEnable;
+}
+
+void gldi_object_reset_notifications_profile (void)
+{
+	if (s_pNotificationsProfile != NULL)
+		g_hash_table_remove_all (s_pNotificationsProfile);
+}
+
+static gint _compare_profiles (gconstpointer a, gconstpointer b)
+{
+	const GldiNotificationProfile *p = *(GldiNotificationProfile**)a, *q = *(GldiNotificationProfile**)b;
+	return (p->iTotalTime < q->iTotalTime ? 1 : p->iTotalTime > q->iTotalTime ? -1 : 0);
+}
+
+gchar *gldi_object_get_notifications_profile (guint iMaxLines)
+{
+	GString *sReport = g_string_new ("");
+	g_string_append_printf (sReport, "%-24s %-40s %-16s %5s %9s %11s %9s\n", "library", "callback", "object", "notif", "calls", "total (ms)", "max (us)");
+	if (s_pNotificationsProfile == NULL)
+		return g_string_free (sReport, FALSE);
+	
+	GPtrArray *pProfiles = g_ptr_array_sized_new (g_hash_table_size (s_pNotificationsProfile));
+	GHashTableIter iter;
+	gpointer key;
+	g_hash_table_iter_init (&iter, s_pNotificationsProfile);
+	while (g_hash_table_iter_next (&iter, &key, NULL))
+		g_ptr_array_add (pProfiles, key);
+	g_ptr_array_sort (pProfiles, _compare_profiles);
+	
+	guint i;
+	for (i = 0; i < pProfiles->len && (iMaxLines == 0 || i < iMaxLines); i ++)
+	{
+		GldiNotificationProfile *pProfile = g_ptr_array_index (pProfiles, i);
+		// resolve the callback to the library (core or applet) it belongs to.
+		const gchar *cLibrary = "?", *cSymbol = NULL;
+		Dl_info info;
+		if (dladdr ((gpointer)pProfile->pFunction, &info) != 0)
+		{
+			if (info.dli_fname != NULL)
+			{
+				cLibrary = strrchr (info.dli_fname, '/');
+				cLibrary = (cLibrary ? cLibrary + 1 : info.dli_fname);
+			}
+			cSymbol = info.dli_sname;
+		}
+		gchar cAddress[24];
+		if (cSymbol == NULL)  // static functions are usually not exported
+		{
+			snprintf (cAddress, sizeof (cAddress), "%p", (gpointer)pProfile->pFunction);
+			cSymbol = cAddress;
 		}
+		g_string_append_printf (sReport, "%-24s %-40s %-16s %5u %9u %11.2f %9" G_GINT64_FORMAT "\n",
+			cLibrary,
+			cSymbol,
+			pProfile->cObjectType,
+			pProfile->iNotifType,
+			pProfile->iNbCalls,
+			pProfile->iTotalTime / 1e3,
+			pProfile->iMaxTime);
 	}
+	g_ptr_array_free (pProfiles, TRUE);
+	return g_string_free (sReport, FALSE);
 }
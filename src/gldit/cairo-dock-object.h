@@ -117,6 +117,16 @@ typedef struct {
 	gpointer pUserData;
 	} GldiNotificationRecord;
 
+/// Contiguous, immutable list of the callbacks registered for a given notification on a given object.
+/// A published list is never resized : registering or removing a callback builds a new list (a removed callback is just disabled in the old one), and the old list is only freed once no notification is being dispatched anymore. This way, a callback can safely remove itself or another callback while being called.
+typedef struct {
+	guint iNbRecords;
+	GldiNotificationRecord pRecords[];
+	} GldiNotificationList;
+
+/// Number of notifications being currently dispatched (nested notifications are counted too).
+extern guint g_iGldiNotificationDepth;
+
 typedef guint GldiNotificationType;
 
 /// Use this in \ref gldi_object_register_notification to be called before the core.
@@ -148,7 +158,7 @@ typedef guint GldiNotificationType;
 void gldi_object_register_notification (gpointer pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction, gboolean bRunFirst, gpointer pUserData);
 
 /** Remove a callback from the list of callbacks of a given object for a given notification and a given data.
-Note: it is safe to remove the callback when it is called, but not another one.
+Note: it is safe to remove any callback at any time, including while it is being called; a removed callback is never called again.
 *@param pObject the object (Icon, Container, Manager) for which the action has been registered.
 *@param iNotifType type of the notification.
 *@param pFunction callback.
@@ -156,27 +166,73 @@ Note: it is safe to remove the callback when it is called, but not another one.
 */
 void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction, gpointer pUserData);
 
+/** Copy the list of callbacks currently registered for a given notification on a given object. This allows to know later if someone has registered to it in the meantime.
+*@param pObject the object (Icon, Container, Manager).
+*@param iNotifType type of the notification.
+*@return a newly allocated list, to be freed with g_free, or NULL if no callback is registered.
+*/
+GldiNotificationList *gldi_object_copy_notifications (gpointer pObject, GldiNotificationType iNotifType);
+
+/** Tell if the callbacks registered for a given notification on a given object are still the ones of a copy.
+*@param pObject the object (Icon, Container, Manager).
+*@param iNotifType type of the notification.
+*@param pCopy a list returned by \ref gldi_object_copy_notifications
+*@return TRUE if the same callbacks are registered, in the same order.
+*/
+gboolean gldi_object_notifications_match (gpointer pObject, GldiNotificationType iNotifType, const GldiNotificationList *pCopy);
+
+// frees the lists that were replaced while a notification was being dispatched; called automatically at the end of the outermost dispatch.
+void gldi_object_release_notification_lists (void);
 
-#define __notify(pNotificationRecordList, bStop, ...) do {\
-	GldiNotificationRecord *pNotificationRecord;\
-	GSList *pElement = pNotificationRecordList, *pNextElement;\
-	while (pElement != NULL && ! bStop) {\
-		pNotificationRecord = pElement->data;\
-		pNextElement = pElement->next;\
-		bStop = pNotificationRecord->pFunction (pNotificationRecord->pUserData, ##__VA_ARGS__);\
-		pElement = pNextElement; }\
+/// TRUE if the time spent in each notification callback is being measured (see \ref gldi_object_enable_notifications_profile).
+extern gboolean g_bGldiProfileNotifications;
+
+/* Accounts iDuration microseconds to the callback pFunction, called for the notification iNotifType on pObject. Only used while profiling.
+ */
+void gldi_object_profile_notification (GldiObject *pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction, gint64 iDuration);
+
+#define __notify(pNotificationList, pNotifiedObject, iNotifType, bStop, ...) do {\
+	const GldiNotificationRecord *pNotificationRecord = (pNotificationList)->pRecords;\
+	const GldiNotificationRecord *pLastRecord = pNotificationRecord + (pNotificationList)->iNbRecords;\
+	for (; pNotificationRecord < pLastRecord && ! bStop; pNotificationRecord ++) {\
+		if (pNotificationRecord->pFunction == NULL)\
+			continue;\
+		if (G_UNLIKELY (g_bGldiProfileNotifications)) {\
+			GldiNotificationFunc _pFunction = pNotificationRecord->pFunction;\
+			gint64 _t0 = g_get_monotonic_time ();\
+			bStop = _pFunction (pNotificationRecord->pUserData, ##__VA_ARGS__);\
+			gldi_object_profile_notification (pNotifiedObject, iNotifType, _pFunction, g_get_monotonic_time () - _t0); }\
+		else\
+			bStop = pNotificationRecord->pFunction (pNotificationRecord->pUserData, ##__VA_ARGS__); }\
 	} while (0)
 
-#define __notify_on_object(pObject, iNotifType, ...) \
+#define __notify_on_object(pObject, pNotifiedObject, iNotifType, ...) \
 	__extension__ ({\
 	gboolean _stop = FALSE;\
 	GPtrArray *pNotificationsTab = (pObject)->pNotificationsTab;\
 	if (pNotificationsTab && iNotifType < pNotificationsTab->len) {\
-		GSList *pNotificationRecordList = g_ptr_array_index (pNotificationsTab, iNotifType);\
-		__notify (pNotificationRecordList, _stop, ##__VA_ARGS__);} \
+		GldiNotificationList *pNotificationList = g_ptr_array_index (pNotificationsTab, iNotifType);\
+		if (pNotificationList != NULL)\
+			__notify (pNotificationList, pNotifiedObject, iNotifType, _stop, ##__VA_ARGS__);} \
 	else {_stop = TRUE;}\
 	_stop; })
 
+/* TRUE if someone listens to the given notification on the object or on one of its managers. It only reads a pointer per level, so that the vast majority of notifications (nobody listening) cost nearly nothing.
+ */
+#define __has_listeners(pObject, iNotifType) \
+	__extension__ ({\
+	gboolean _bHasListeners = FALSE;\
+	GldiObject *_o = (pObject);\
+	while (_o) {\
+		GPtrArray *_tab = _o->pNotificationsTab;\
+		if (!_tab || iNotifType >= _tab->len)\
+			break;\
+		if (g_ptr_array_index (_tab, iNotifType) != NULL) {\
+			_bHasListeners = TRUE;\
+			break; }\
+		_o = GLDI_OBJECT (_o->mgr); }\
+	_bHasListeners; })
+
 /** Broadcast a notification on a given object, and on all its managers.
 *@param pObject the object (Icon, Container, Manager, ...).
 *@param iNotifType type of the notification.
@@ -186,12 +242,31 @@ void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNo
 	__extension__ ({\
 	gboolean _bStop = FALSE;\
 	GldiObject *_obj = GLDI_OBJECT (pObject);\
-	while (_obj && !_bStop) {\
-		_bStop = __notify_on_object (_obj, iNotifType, ##__VA_ARGS__);\
-		_obj = GLDI_OBJECT (_obj->mgr); }\
+	if (__has_listeners (_obj, iNotifType)) {\
+		GldiObject *_pNotifiedObject = _obj;\
+		g_iGldiNotificationDepth ++;\
+		while (_obj && !_bStop) {\
+			_bStop = __notify_on_object (_obj, _pNotifiedObject, iNotifType, ##__VA_ARGS__);\
+			_obj = GLDI_OBJECT (_obj->mgr); }\
+		if (-- g_iGldiNotificationDepth == 0)\
+			gldi_object_release_notification_lists (); }\
 	})
 
 
+/** Start or stop measuring the time spent in each notification callback. Statistics are accumulated per (type of the notified object, notification, callback), until \ref gldi_object_reset_notifications_profile is called.
+*@param bEnable TRUE to start profiling, FALSE to stop it.
+*/
+void gldi_object_enable_notifications_profile (gboolean bEnable);
+
+/** Clear the statistics collected so far.
+*/
+void gldi_object_reset_notifications_profile (void);
+
+/** Get a human-readable report of the statistics collected so far, hottest callbacks first. Each callback is resolved to the library that contains it, so that the time spent in each applet can be seen at a glance.
+*@param iMaxLines maximum number of callbacks to list, or 0 to list all of them.
+*@return a newly allocated string.
+*/
+gchar *gldi_object_get_notifications_profile (guint iMaxLines);
 
 #define	GLDI_STR_HELPER(x) #x
 #define	GLDI_STR(x) GLDI_STR_HELPER(x)
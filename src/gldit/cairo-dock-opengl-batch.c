@@ -0,0 +1,195 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stddef.h>  // offsetof
+#include <GL/gl.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-draw-opengl.h"  // _cairo_dock_enable_texture
+#include "cairo-dock-opengl-batch.h"
+
+typedef struct {
+	GLfloat x, y, z;
+	GLfloat s, t;
+	GLfloat r, g, b, a;
+	} CairoDockGLBatchVertex;
+
+typedef struct {
+	GLuint iTexture;
+	CairoDockGLBatchBlend iBlend;
+	guint iNbQuads;
+	} CairoDockGLBatchRun;
+
+
+CairoDockGLBatch *cairo_dock_gl_batch_new (void)
+{
+	CairoDockGLBatch *pBatch = g_new0 (CairoDockGLBatch, 1);
+	int i;
+	for (i = 0; i < CAIRO_DOCK_GL_BATCH_NB_LAYERS; i ++)
+	{
+		pBatch->pVertices[i] = g_array_sized_new (FALSE, FALSE, sizeof (CairoDockGLBatchVertex), 4 * 32);
+		pBatch->pRuns[i] = g_array_sized_new (FALSE, FALSE, sizeof (CairoDockGLBatchRun), 32);
+	}
+	return pBatch;
+}
+
+void cairo_dock_gl_batch_free (CairoDockGLBatch *pBatch)
+{
+	if (pBatch == NULL)
+		return;
+	int i;
+	for (i = 0; i < CAIRO_DOCK_GL_BATCH_NB_LAYERS; i ++)
+	{
+		g_array_free (pBatch->pVertices[i], TRUE);
+		g_array_free (pBatch->pRuns[i], TRUE);
+	}
+	if (pBatch->iBuffer != 0)
+		glDeleteBuffers (1, &pBatch->iBuffer);
+	g_free (pBatch);
+}
+
+static inline void _set_vertex (CairoDockGLBatchVertex *v, double x, double y, double z, double s, double t, double fAlpha)
+{
+	v->x = x;
+	v->y = y;
+	v->z = z;
+	v->s = s;
+	v->t = t;
+	v->r = v->g = v->b = 1.;
+	v->a = fAlpha;
+}
+
+void cairo_dock_gl_batch_add_quad_portion (CairoDockGLBatch *pBatch, CairoDockGLBatchLayer iLayer, GLuint iTexture, CairoDockGLBatchBlend iBlend, double x, double y, double z, double w, double h, double u, double v, double du, double dv, double fAlpha)
+{
+	g_return_if_fail (iLayer < CAIRO_DOCK_GL_BATCH_NB_LAYERS);
+	if (iTexture == 0)
+		return;
+	
+	// same vertices as _cairo_dock_apply_current_texture_portion_at_size_with_offset
+	GArray *pVertices = pBatch->pVertices[iLayer];
+	guint n = pVertices->len;
+	g_array_set_size (pVertices, n + 4);
+	CairoDockGLBatchVertex *pv = &g_array_index (pVertices, CairoDockGLBatchVertex, n);
+	_set_vertex (&pv[0], x - .5*w, y + .5*h, z, u, v, fAlpha);
+	_set_vertex (&pv[1], x + .5*w, y + .5*h, z, u + du, v, fAlpha);
+	_set_vertex (&pv[2], x + .5*w, y - .5*h, z, u + du, v + dv, fAlpha);
+	_set_vertex (&pv[3], x - .5*w, y - .5*h, z, u, v + dv, fAlpha);
+	
+	// extend the current run, or start a new one
+	GArray *pRuns = pBatch->pRuns[iLayer];
+	CairoDockGLBatchRun *pRun = (pRuns->len != 0 ? &g_array_index (pRuns, CairoDockGLBatchRun, pRuns->len - 1) : NULL);
+	if (pRun != NULL && pRun->iTexture == iTexture && pRun->iBlend == iBlend)
+	{
+		pRun->iNbQuads ++;
+	}
+	else
+	{
+		CairoDockGLBatchRun run = {iTexture, iBlend, 1};
+		g_array_append_val (pRuns, run);
+	}
+}
+
+static inline void _set_blend (CairoDockGLBatchBlend iBlend)
+{
+	switch (iBlend)
+	{
+		case CAIRO_DOCK_GL_BATCH_BLEND_PBUFFER:
+			_cairo_dock_set_blend_pbuffer ();
+		break;
+		case CAIRO_DOCK_GL_BATCH_BLEND_ALPHA:
+			_cairo_dock_set_blend_alpha ();
+		break;
+		case CAIRO_DOCK_GL_BATCH_BLEND_OVER:
+		default:
+			_cairo_dock_set_blend_over ();
+		break;
+	}
+}
+
+void cairo_dock_gl_batch_draw (CairoDockGLBatch *pBatch)
+{
+	pBatch->iNbQuads = pBatch->iNbDrawCalls = 0;
+	if (cairo_dock_gl_batch_is_empty (pBatch))
+		return;
+	
+	//\_____________ upload all the vertices at once.
+	gsize iSize = 0;
+	int i;
+	for (i = 0; i < CAIRO_DOCK_GL_BATCH_NB_LAYERS; i ++)
+		iSize += pBatch->pVertices[i]->len * sizeof (CairoDockGLBatchVertex);
+	if (pBatch->iBuffer == 0)
+		glGenBuffers (1, &pBatch->iBuffer);
+	glBindBuffer (GL_ARRAY_BUFFER, pBatch->iBuffer);
+	if (iSize > pBatch->iBufferSize)
+		pBatch->iBufferSize = MAX (iSize, 2 * pBatch->iBufferSize);
+	glBufferData (GL_ARRAY_BUFFER, pBatch->iBufferSize, NULL, GL_STREAM_DRAW);  // new storage each frame, so that we don't wait for the previous frame to be drawn
+	gsize iOffset = 0;
+	for (i = 0; i < CAIRO_DOCK_GL_BATCH_NB_LAYERS; i ++)
+	{
+		gsize iLayerSize = pBatch->pVertices[i]->len * sizeof (CairoDockGLBatchVertex);
+		if (iLayerSize != 0)
+			glBufferSubData (GL_ARRAY_BUFFER, iOffset, iLayerSize, pBatch->pVertices[i]->data);
+		iOffset += iLayerSize;
+	}
+	
+	glEnableClientState (GL_VERTEX_ARRAY);
+	glEnableClientState (GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState (GL_COLOR_ARRAY);
+	glVertexPointer (3, GL_FLOAT, sizeof (CairoDockGLBatchVertex), (GLvoid *) offsetof (CairoDockGLBatchVertex, x));
+	glTexCoordPointer (2, GL_FLOAT, sizeof (CairoDockGLBatchVertex), (GLvoid *) offsetof (CairoDockGLBatchVertex, s));
+	glColorPointer (4, GL_FLOAT, sizeof (CairoDockGLBatchVertex), (GLvoid *) offsetof (CairoDockGLBatchVertex, r));
+	
+	//\_____________ draw each run of quads sharing the same texture and blending.
+	_cairo_dock_enable_texture ();
+	GLuint iCurrentTexture = 0;
+	int iCurrentBlend = -1;
+	GLint iFirst = 0;  // first vertex of the run
+	guint r;
+	CairoDockGLBatchRun *pRun;
+	for (i = 0; i < CAIRO_DOCK_GL_BATCH_NB_LAYERS; i ++)
+	{
+		for (r = 0; r < pBatch->pRuns[i]->len; r ++)
+		{
+			pRun = &g_array_index (pBatch->pRuns[i], CairoDockGLBatchRun, r);
+			if (pRun->iTexture != iCurrentTexture)
+			{
+				glBindTexture (GL_TEXTURE_2D, pRun->iTexture);
+				iCurrentTexture = pRun->iTexture;
+			}
+			if ((int)pRun->iBlend != iCurrentBlend)
+			{
+				_set_blend (pRun->iBlend);
+				iCurrentBlend = pRun->iBlend;
+			}
+			glDrawArrays (GL_QUADS, iFirst, 4 * pRun->iNbQuads);
+			iFirst += 4 * pRun->iNbQuads;
+			pBatch->iNbQuads += pRun->iNbQuads;
+			pBatch->iNbDrawCalls ++;
+		}
+		g_array_set_size (pBatch->pRuns[i], 0);
+		g_array_set_size (pBatch->pVertices[i], 0);
+	}
+	_cairo_dock_disable_texture ();
+	
+	glDisableClientState (GL_COLOR_ARRAY);
+	glDisableClientState (GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState (GL_VERTEX_ARRAY);
+	glBindBuffer (GL_ARRAY_BUFFER, 0);
+	_cairo_dock_set_alpha (1.);  // the color array has left the current color undefined.
+}
@@ -0,0 +1,121 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_OPENGL_BATCH__
+#define  __CAIRO_DOCK_OPENGL_BATCH__
+
+#include <glib.h>
+#include <GL/gl.h>
+
+#include "cairo-dock-struct.h"
+
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-opengl-batch.h This class collects textured quads and draws them with a few calls.
+* Instead of drawing each element with its own matrix and immediate-mode quad, you add it to a batch with \ref cairo_dock_gl_batch_add_quad, in the coordinates of the current GL matrix, and draw everything at once with \ref cairo_dock_gl_batch_draw. The vertices are uploaded in a single vertex buffer, and consecutive quads sharing the same texture and blending are drawn with one call.
+*/
+
+/// Blending used to draw a quad.
+typedef enum {
+	/// premultiplied texture drawn opaque (\ref _cairo_dock_set_blend_pbuffer)
+	CAIRO_DOCK_GL_BATCH_BLEND_PBUFFER = 0,
+	/// premultiplied texture drawn with a transparency (\ref _cairo_dock_set_blend_alpha)
+	CAIRO_DOCK_GL_BATCH_BLEND_ALPHA,
+	/// simple mix (\ref _cairo_dock_set_blend_over)
+	CAIRO_DOCK_GL_BATCH_BLEND_OVER,
+	CAIRO_DOCK_GL_BATCH_NB_BLENDS
+	} CairoDockGLBatchBlend;
+
+/// Layers of a batch: all the quads of a layer are drawn above the ones of the previous layers, whatever the order they were added in.
+typedef enum {
+	CAIRO_DOCK_GL_BATCH_LAYER_ICONS = 0,
+	CAIRO_DOCK_GL_BATCH_LAYER_OVERLAYS,
+	CAIRO_DOCK_GL_BATCH_LAYER_LABELS,
+	CAIRO_DOCK_GL_BATCH_NB_LAYERS
+	} CairoDockGLBatchLayer;
+
+/// Definition of a CairoDockGLBatch.
+struct _CairoDockGLBatch {
+	/// vertices of each layer (CairoDockGLBatchVertex)
+	GArray *pVertices[CAIRO_DOCK_GL_BATCH_NB_LAYERS];
+	/// runs of quads sharing the same texture and blending, for each layer (CairoDockGLBatchRun)
+	GArray *pRuns[CAIRO_DOCK_GL_BATCH_NB_LAYERS];
+	/// vertex buffer object, and its current size in bytes
+	GLuint iBuffer;
+	gsize iBufferSize;
+	/// number of quads and of draw calls of the last drawing
+	guint iNbQuads, iNbDrawCalls;
+	};
+
+/** Create a new empty batch. It can be created before any GL context is available.
+*@return a newly allocated batch, to be freed with \ref cairo_dock_gl_batch_free.
+*/
+CairoDockGLBatch *cairo_dock_gl_batch_new (void);
+
+/** Destroy a batch and free its resources. The GL context used to draw it should be current.
+*@param pBatch the batch
+*/
+void cairo_dock_gl_batch_free (CairoDockGLBatch *pBatch);
+
+/** Add a textured quad to a batch. The quad is aligned on the axis and the texture is applied the same way as \ref _cairo_dock_apply_current_texture_at_size_with_offset.
+*@param pBatch the batch
+*@param iLayer layer of the quad
+*@param iTexture the texture
+*@param iBlend the blending
+*@param x x coordinate of the center of the quad
+*@param y y coordinate of the center of the quad
+*@param z z coordinate of the quad
+*@param w width of the quad
+*@param h height of the quad
+*@param fAlpha transparency of the quad
+*/
+#define cairo_dock_gl_batch_add_quad(pBatch, iLayer, iTexture, iBlend, x, y, z, w, h, fAlpha) cairo_dock_gl_batch_add_quad_portion (pBatch, iLayer, iTexture, iBlend, x, y, z, w, h, 0., 0., 1., 1., fAlpha)
+
+/** Add a quad textured with a part of a texture to a batch, the same way as \ref _cairo_dock_apply_current_texture_portion_at_size_with_offset. This is useful to draw several images packed in a single texture, like the glyphs of a font.
+*@param pBatch the batch
+*@param iLayer layer of the quad
+*@param iTexture the texture
+*@param iBlend the blending
+*@param x x coordinate of the center of the quad
+*@param y y coordinate of the center of the quad
+*@param z z coordinate of the quad
+*@param w width of the quad
+*@param h height of the quad
+*@param u horizontal texture coordinate of the left side of the portion
+*@param v vertical texture coordinate of the top side of the portion
+*@param du width of the portion, in texture coordinates
+*@param dv height of the portion, in texture coordinates
+*@param fAlpha transparency of the quad
+*/
+void cairo_dock_gl_batch_add_quad_portion (CairoDockGLBatch *pBatch, CairoDockGLBatchLayer iLayer, GLuint iTexture, CairoDockGLBatchBlend iBlend, double x, double y, double z, double w, double h, double u, double v, double du, double dv, double fAlpha);
+
+/** Tell if a batch has no quad.
+*@param pBatch the batch
+*/
+#define cairo_dock_gl_batch_is_empty(pBatch) ((pBatch)->pVertices[CAIRO_DOCK_GL_BATCH_LAYER_ICONS]->len == 0 && (pBatch)->pVertices[CAIRO_DOCK_GL_BATCH_LAYER_OVERLAYS]->len == 0 && (pBatch)->pVertices[CAIRO_DOCK_GL_BATCH_LAYER_LABELS]->len == 0)
+
+/** Draw all the quads of a batch with the current GL matrix, layer by layer, and empty it.
+*@param pBatch the batch
+*/
+void cairo_dock_gl_batch_draw (CairoDockGLBatch *pBatch);
+
+G_END_DECLS
+#endif
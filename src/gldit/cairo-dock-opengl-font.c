@@ -18,14 +18,19 @@
 */
 
 #include <math.h>
+#include <string.h>
 #include <pango/pango.h>
+#include <pango/pangocairo.h>
 #include <cairo.h>
+#include <gtk/gtk.h>
 #include <GL/gl.h>
 
 #include "cairo-dock-surface-factory.h"  // cairo_dock_create_blank_surface
-#include "cairo-dock-draw.h"  // cairo_dock_create_drawing_context_generic
+#include "cairo-dock-draw.h"  // cairo_dock_create_drawing_context_generic, cairo_dock_draw_rounded_rectangle
 #include "cairo-dock-log.h"
 #include "cairo-dock-draw-opengl.h"
+#include "cairo-dock-opengl-batch.h"
+#include "cairo-dock-style-manager.h"  // myStyleParam, gldi_style_color_get
 
 #include "cairo-dock-opengl-font.h"
 
@@ -36,6 +41,10 @@ extern GldiContainer *g_pPrimaryContainer;
 
 extern CairoDockGLConfig g_openglConfig;
 
+static void _free_glyph_atlas (gpointer pAtlas);
+static void _get_glyph_atlas_text_extent (gpointer pAtlas, const gchar *cText, double *fWidth, double *fHeight);
+static void _draw_glyph_atlas_text (gpointer pAtlas, const gchar *cText);
+
 
 GLuint cairo_dock_create_texture_from_text_simple (const gchar *cText, const gchar *cFontDescription, cairo_t* pSourceContext, int *iWidth, int *iHeight)
 {
@@ -262,6 +271,8 @@ void cairo_dock_free_gl_font (CairoDockGLFont *pFont)
 		glDeleteLists (pFont->iListBase, pFont->iNbChars);
 	if (pFont->iTexture != 0)
 		_cairo_dock_delete_texture (pFont->iTexture);
+	if (pFont->pAtlas != NULL)
+		_free_glyph_atlas (pFont->pAtlas);
 	g_free (pFont);
 }
 
@@ -274,6 +285,14 @@ void cairo_dock_get_gl_text_extent (const gchar *cText, CairoDockGLFont *pFont,
 		*iHeight = 0;
 		return ;
 	}
+	if (pFont->pAtlas != NULL)
+	{
+		double fWidth, fHeight;
+		_get_glyph_atlas_text_extent (pFont->pAtlas, cText, &fWidth, &fHeight);
+		*iWidth = ceil (fWidth);
+		*iHeight = ceil (fHeight);
+		return;
+	}
 	int i, w=0, wmax=0, h=pFont->iCharHeight;
 	for (i = 0; cText[i] != '\0'; i ++)
 	{
@@ -295,7 +314,11 @@ void cairo_dock_get_gl_text_extent (const gchar *cText, CairoDockGLFont *pFont,
 void cairo_dock_draw_gl_text (const guchar *cText, CairoDockGLFont *pFont)
 {
 	int n = strlen ((char *) cText);
-	if (pFont->iListBase != 0)
+	if (pFont->pAtlas != NULL)
+	{
+		_draw_glyph_atlas_text (pFont->pAtlas, (const gchar *) cText);
+	}
+	else if (pFont->iListBase != 0)
 	{
 		if (pFont->iCharBase == 0 && strchr ((char *) cText, '\n') == NULL)  // version optimisee ou on a charge tous les caracteres.
 		{
@@ -409,3 +432,615 @@ void cairo_dock_draw_gl_text_at_position_in_area (const guchar *cText, CairoDock
 		cairo_dock_draw_gl_text_in_area (cText, pFont, iWidth, iHeight, bCentered);
 	}
 }
+
+
+  /////////////////
+ // GLYPH ATLAS //
+/////////////////
+
+#define CD_GLYPH_ATLAS_SIZE 512  // size of a page of the atlas
+#define CD_GLYPH_ATLAS_MAX_PAGES 4  // beyond that, the atlas is flushed and refilled with the glyphs currently in use
+#define CD_GLYPH_ATLAS_MAX_KERNINGS 4096  // beyond that, the kernings are measured again as they're needed
+
+typedef struct {
+	GLuint iTexture;  // page of the atlas holding the glyph
+	gint x, y;  // top-left corner of the glyph in the page
+	gint iWidth, iHeight;  // size of the glyph in the page, outline included; 0 for a blank glyph
+	gint iOffsetX, iOffsetY;  // position of the glyph relatively to the pen and the top of the line
+	gdouble fAdvance;  // horizontal advance of the pen
+	} CairoDockGLGlyph;
+
+typedef struct {
+	gchar *cKey;  // key of the font in the table of the atlas fonts
+	guint iRefCount;
+	GHashTable *pGlyphs;  // grapheme -> CairoDockGLGlyph
+	GHashTable *pKernings;  // pair of graphemes -> correction of the advance of the first one (gdouble)
+	PangoLayout *pLayout;
+	GldiColor fTextColor;
+	GldiColor fBgColor;
+	GldiColor fLineColor;
+	gboolean bOutlined;
+	gboolean bDrawFrame;
+	gint iLineHeight;
+	gint iOutline;  // margin taken by the outline around each glyph
+	gdouble fMargin;  // margin around the text, in pixels
+	gdouble fRadius;  // radius of the frame, in pixels
+	CairoDockGLGlyph frame;  // a tiny rounded rectangle, stretched as 9 slices to the size of the text
+	gint iFrameCorner;  // size of the corners of the frame in the page
+	GList *pPages;  // textures of the atlas, the current one first
+	gint iPenX, iPenY, iRowHeight;  // where the next glyph goes in the current page
+	} CairoDockGLAtlas;
+
+static GHashTable *s_hAtlasFonts = NULL;  // key -> CairoDockGLFont
+static GList *s_pRetiredPages = NULL;  // pages of flushed atlases, that may still be used by the current frame
+static guint s_iSidDeleteRetiredPages = 0;
+static CairoDockGLBatch *s_pImmediateBatch = NULL;
+
+static gboolean _delete_retired_pages (G_GNUC_UNUSED gpointer data);
+
+static void _retire_pages (GList *pPages)
+{
+	s_pRetiredPages = g_list_concat (pPages, s_pRetiredPages);
+	if (s_iSidDeleteRetiredPages == 0)  // the pages can't be deleted now, since quads waiting to be drawn in the current frame may still use them.
+		s_iSidDeleteRetiredPages = g_idle_add (_delete_retired_pages, NULL);
+}
+
+static gboolean _delete_retired_pages (G_GNUC_UNUSED gpointer data)
+{
+	GList *p;
+	GLuint iTexture;
+	for (p = s_pRetiredPages; p != NULL; p = p->next)
+	{
+		iTexture = GPOINTER_TO_UINT (p->data);
+		_cairo_dock_delete_texture (iTexture);
+	}
+	g_list_free (s_pRetiredPages);
+	s_pRetiredPages = NULL;
+	s_iSidDeleteRetiredPages = 0;
+	return FALSE;
+}
+
+static void _flush_glyph_atlas (CairoDockGLAtlas *pAtlas)
+{
+	cd_debug ("the glyph atlas is full, flush it");
+	g_hash_table_remove_all (pAtlas->pGlyphs);  // the kernings don't depend on the pages, they are kept.
+	_retire_pages (pAtlas->pPages);
+	pAtlas->pPages = NULL;
+	pAtlas->frame.iTexture = 0;
+}
+
+static void _new_atlas_page (CairoDockGLAtlas *pAtlas)
+{
+	GLuint iTexture;
+	glGenTextures (1, &iTexture);
+	glBindTexture (GL_TEXTURE_2D, iTexture);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	guchar *pBlank = g_new0 (guchar, 4 * CD_GLYPH_ATLAS_SIZE * CD_GLYPH_ATLAS_SIZE);  // the padding between glyphs must be transparent, and a NULL texture is undefined.
+	glTexImage2D (GL_TEXTURE_2D,
+		0,
+		GL_RGBA,
+		CD_GLYPH_ATLAS_SIZE,
+		CD_GLYPH_ATLAS_SIZE,
+		0,
+		GL_BGRA,
+		GL_UNSIGNED_BYTE,
+		pBlank);
+	g_free (pBlank);
+	glBindTexture (GL_TEXTURE_2D, 0);
+	
+	pAtlas->pPages = g_list_prepend (pAtlas->pPages, GUINT_TO_POINTER (iTexture));
+	pAtlas->iPenX = pAtlas->iPenY = 1;  // keep 1 blank pixel around each glyph, so that the linear filtering doesn't bleed on the neighbours.
+	pAtlas->iRowHeight = 0;
+}
+
+static gboolean _alloc_glyph (CairoDockGLAtlas *pAtlas, CairoDockGLGlyph *pGlyph)
+{
+	if (pGlyph->iWidth + 2 > CD_GLYPH_ATLAS_SIZE || pGlyph->iHeight + 2 > CD_GLYPH_ATLAS_SIZE)
+		return FALSE;
+	if (pAtlas->iPenX + pGlyph->iWidth + 1 > CD_GLYPH_ATLAS_SIZE)  // start a new row
+	{
+		pAtlas->iPenX = 1;
+		pAtlas->iPenY += pAtlas->iRowHeight + 1;
+		pAtlas->iRowHeight = 0;
+	}
+	if (pAtlas->pPages == NULL || pAtlas->iPenY + pGlyph->iHeight + 1 > CD_GLYPH_ATLAS_SIZE)  // start a new page
+	{
+		if (g_list_length (pAtlas->pPages) >= CD_GLYPH_ATLAS_MAX_PAGES)
+			_flush_glyph_atlas (pAtlas);
+		_new_atlas_page (pAtlas);
+	}
+	pGlyph->iTexture = GPOINTER_TO_UINT (pAtlas->pPages->data);
+	pGlyph->x = pAtlas->iPenX;
+	pGlyph->y = pAtlas->iPenY;
+	pAtlas->iPenX += pGlyph->iWidth + 1;
+	pAtlas->iRowHeight = MAX (pAtlas->iRowHeight, pGlyph->iHeight);
+	return TRUE;
+}
+
+static void _upload_glyph (CairoDockGLGlyph *pGlyph, cairo_surface_t *pSurface)
+{
+	cairo_surface_flush (pSurface);
+	glBindTexture (GL_TEXTURE_2D, pGlyph->iTexture);
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, cairo_image_surface_get_stride (pSurface) / 4);
+	glTexSubImage2D (GL_TEXTURE_2D,
+		0,
+		pGlyph->x,
+		pGlyph->y,
+		pGlyph->iWidth,
+		pGlyph->iHeight,
+		GL_BGRA,
+		GL_UNSIGNED_BYTE,
+		cairo_image_surface_get_data (pSurface));
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
+	glBindTexture (GL_TEXTURE_2D, 0);
+}
+
+static CairoDockGLGlyph *_get_glyph (CairoDockGLAtlas *pAtlas, const gchar *cGrapheme, int iLength)
+{
+	gchar cKey[32];
+	if (iLength >= (int)sizeof (cKey))  // a very long sequence of combining marks, only keep its base character.
+		iLength = g_utf8_next_char (cGrapheme) - cGrapheme;
+	memcpy (cKey, cGrapheme, iLength);
+	cKey[iLength] = '\0';
+	
+	CairoDockGLGlyph *pGlyph = g_hash_table_lookup (pAtlas->pGlyphs, cKey);
+	if (pGlyph != NULL)
+		return pGlyph;
+	
+	//\_________________ measure the grapheme.
+	pango_layout_set_text (pAtlas->pLayout, cKey, iLength);
+	PangoRectangle ink, log;
+	pango_layout_get_pixel_extents (pAtlas->pLayout, &ink, &log);
+	pGlyph = g_new0 (CairoDockGLGlyph, 1);
+	PangoRectangle extent;
+	pango_layout_get_extents (pAtlas->pLayout, NULL, &extent);
+	pGlyph->fAdvance = (double)extent.width / PANGO_SCALE;
+	
+	if (ink.width > 0 && ink.height > 0)  // not a blank
+	{
+		//\_________________ draw it like cairo_dock_create_surface_from_text_full() does, in a cell that contains both the ink and the logical extents.
+		int o = pAtlas->iOutline;
+		int x0 = MIN (ink.x, log.x) - o, y0 = MIN (ink.y, log.y) - o;
+		int x1 = MAX (ink.x + ink.width, log.x + log.width) + o, y1 = MAX (ink.y + ink.height, log.y + log.height) + o;
+		pGlyph->iWidth = x1 - x0;
+		pGlyph->iHeight = y1 - y0;
+		pGlyph->iOffsetX = x0 - log.x;
+		pGlyph->iOffsetY = y0 - log.y;
+		
+		cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, pGlyph->iWidth, pGlyph->iHeight);
+		cairo_t *pCairoContext = cairo_create (pSurface);
+		cairo_translate (pCairoContext, -x0, -y0);
+		if (pAtlas->bOutlined)
+		{
+			cairo_push_group (pCairoContext);
+			cairo_set_source_rgb (pCairoContext, 0.2, 0.2, 0.2);
+			int i;
+			for (i = 0; i < 2; i++)
+			{
+				cairo_move_to (pCairoContext, 0, 2*i-1);
+				pango_cairo_show_layout (pCairoContext, pAtlas->pLayout);
+			}
+			for (i = 0; i < 2; i++)
+			{
+				cairo_move_to (pCairoContext, 2*i-1, 0);
+				pango_cairo_show_layout (pCairoContext, pAtlas->pLayout);
+			}
+			cairo_pop_group_to_source (pCairoContext);
+			cairo_paint (pCairoContext);
+		}
+		gldi_color_set_cairo_rgb (pCairoContext, &pAtlas->fTextColor);
+		cairo_move_to (pCairoContext, 0, 0);
+		pango_cairo_show_layout (pCairoContext, pAtlas->pLayout);
+		cairo_destroy (pCairoContext);
+		
+		//\_________________ put it into the atlas.
+		if (_alloc_glyph (pAtlas, pGlyph))
+		{
+			_upload_glyph (pGlyph, pSurface);
+		}
+		else
+		{
+			cd_warning ("the glyph '%s' is too big for the atlas (%dx%d)", cKey, pGlyph->iWidth, pGlyph->iHeight);
+			pGlyph->iWidth = pGlyph->iHeight = 0;
+		}
+		cairo_surface_destroy (pSurface);
+	}
+	
+	g_hash_table_insert (pAtlas->pGlyphs, g_strdup (cKey), pGlyph);
+	return pGlyph;
+}
+
+// Since the glyphs are placed one after the other, the kerning of each pair of graphemes is measured once, as the difference between the width of the pair and the advances of its glyphs.
+static double _get_kerning (CairoDockGLAtlas *pAtlas, const gchar *cPrevGrapheme, int iPrevLength, double fPrevAdvance, const gchar *cGrapheme, int iLength, double fAdvance)
+{
+	gchar cKey[64];
+	if (iPrevLength + iLength >= (int)sizeof (cKey))  // very long sequences of combining marks, don't bother.
+		return 0.;
+	memcpy (cKey, cPrevGrapheme, iPrevLength);
+	memcpy (cKey + iPrevLength, cGrapheme, iLength);
+	cKey[iPrevLength + iLength] = '\0';
+	
+	gdouble *pKerning = g_hash_table_lookup (pAtlas->pKernings, cKey);
+	if (pKerning != NULL)
+		return *pKerning;
+	
+	if (g_hash_table_size (pAtlas->pKernings) >= CD_GLYPH_ATLAS_MAX_KERNINGS)
+		g_hash_table_remove_all (pAtlas->pKernings);
+	pango_layout_set_text (pAtlas->pLayout, cKey, iPrevLength + iLength);
+	PangoRectangle extent;
+	pango_layout_get_extents (pAtlas->pLayout, NULL, &extent);
+	pKerning = g_new (gdouble, 1);
+	*pKerning = (double)extent.width / PANGO_SCALE - fPrevAdvance - fAdvance;
+	g_hash_table_insert (pAtlas->pKernings, g_strdup (cKey), pKerning);
+	return *pKerning;
+}
+
+static void _load_frame (CairoDockGLAtlas *pAtlas)
+{
+	// the smallest rounded rectangle with straight sides of 1 pixel in its middle; same drawing as cairo_dock_create_surface_from_text_full().
+	int r = ceil (pAtlas->fRadius);
+	int n = 2 * r + 3;
+	pAtlas->frame.iWidth = pAtlas->frame.iHeight = n;
+	if (! _alloc_glyph (pAtlas, &pAtlas->frame))
+	{
+		pAtlas->frame.iTexture = 0;
+		pAtlas->bDrawFrame = FALSE;
+		return;
+	}
+	pAtlas->iFrameCorner = r + 1;
+	
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, n, n);
+	cairo_t *pCairoContext = cairo_create (pSurface);
+	double fLineWidth = 1;
+	cairo_dock_draw_rounded_rectangle (pCairoContext, pAtlas->fRadius, fLineWidth, n - 2 * pAtlas->fRadius - fLineWidth, n - fLineWidth);
+	gldi_color_set_cairo (pCairoContext, &pAtlas->fBgColor);
+	cairo_fill_preserve (pCairoContext);
+	gldi_color_set_cairo (pCairoContext, &pAtlas->fLineColor);
+	cairo_set_line_width (pCairoContext, fLineWidth);
+	cairo_stroke (pCairoContext);
+	cairo_destroy (pCairoContext);
+	
+	_upload_glyph (&pAtlas->frame, pSurface);
+	cairo_surface_destroy (pSurface);
+}
+
+static inline const gchar *_get_grapheme_end (const gchar *str)
+{
+	const gchar *end = g_utf8_next_char (str);
+	while (*end != '\0' && g_unichar_ismark (g_utf8_get_char (end)))  // keep the combining marks with their base character.
+		end = g_utf8_next_char (end);
+	return end;
+}
+
+static void _get_glyph_atlas_text_extent (gpointer data, const gchar *cText, double *fWidth, double *fHeight)
+{
+	CairoDockGLAtlas *pAtlas = data;
+	double w = 0, wmax = 0;
+	int iNbLines = 1;
+	const gchar *str, *end, *prev = NULL;
+	double fPrevAdvance = 0;
+	CairoDockGLGlyph *pGlyph;
+	for (str = cText; *str != '\0'; str = end)
+	{
+		end = _get_grapheme_end (str);
+		if (*str == '\n')
+		{
+			wmax = MAX (wmax, w);
+			w = 0;
+			iNbLines ++;
+			prev = NULL;
+			continue;
+		}
+		pGlyph = _get_glyph (pAtlas, str, end - str);
+		if (prev != NULL)
+			w += _get_kerning (pAtlas, prev, str - prev, fPrevAdvance, str, end - str, pGlyph->fAdvance);
+		w += pGlyph->fAdvance;
+		prev = str;
+		fPrevAdvance = pGlyph->fAdvance;
+	}
+	*fWidth = MAX (wmax, w);
+	*fHeight = iNbLines * pAtlas->iLineHeight;
+}
+
+static void _batch_glyph_atlas_text (CairoDockGLAtlas *pAtlas, const gchar *cText, CairoDockGLBatch *pBatch, CairoDockGLBatchLayer iLayer, double x, double y, double z, double sx, double sy, double fAlpha)  // (x, y) = top-left corner of the text
+{
+	double s = CD_GLYPH_ATLAS_SIZE;
+	double fPenX = 0, fPenY = 0;
+	const gchar *str, *end, *prev = NULL;
+	double fPrevAdvance = 0;
+	CairoDockGLGlyph *pGlyph;
+	for (str = cText; *str != '\0'; str = end)
+	{
+		end = _get_grapheme_end (str);
+		if (*str == '\n')
+		{
+			fPenX = 0;
+			fPenY += pAtlas->iLineHeight;
+			prev = NULL;
+			continue;
+		}
+		pGlyph = _get_glyph (pAtlas, str, end - str);
+		if (prev != NULL)
+			fPenX += _get_kerning (pAtlas, prev, str - prev, fPrevAdvance, str, end - str, pGlyph->fAdvance);
+		prev = str;
+		fPrevAdvance = pGlyph->fAdvance;
+		if (pGlyph->iWidth != 0)
+		{
+			cairo_dock_gl_batch_add_quad_portion (pBatch, iLayer, pGlyph->iTexture, CAIRO_DOCK_GL_BATCH_BLEND_OVER,
+				x + (round (fPenX) + pGlyph->iOffsetX + .5 * pGlyph->iWidth) * sx,  // keep the glyphs on the pixel grid of the atlas, to avoid blurring them.
+				y - (fPenY + pGlyph->iOffsetY + .5 * pGlyph->iHeight) * sy,
+				z,
+				pGlyph->iWidth * sx,
+				pGlyph->iHeight * sy,
+				pGlyph->x / s, pGlyph->y / s, pGlyph->iWidth / s, pGlyph->iHeight / s,
+				fAlpha);
+		}
+		fPenX += pGlyph->fAdvance;
+	}
+}
+
+static void _batch_frame (CairoDockGLAtlas *pAtlas, CairoDockGLBatch *pBatch, CairoDockGLBatchLayer iLayer, double x, double y, double z, double w, double h, double sx, double sy, double fAlpha)
+{
+	if (pAtlas->frame.iTexture == 0)
+		_load_frame (pAtlas);
+	CairoDockGLGlyph *f = &pAtlas->frame;
+	if (f->iTexture == 0)
+		return;
+	
+	// the corners keep their size, the middle pixels of the sides are stretched.
+	double s = CD_GLYPH_ATLAS_SIZE;
+	int k = pAtlas->iFrameCorner;
+	double cw = MIN (k * sx, w / 2), ch = MIN (k * sy, h / 2);  // size of the corners
+	double u[3] = {f->x / s, (f->x + k + .5) / s, (f->x + k + 1) / s};
+	double v[3] = {f->y / s, (f->y + k + .5) / s, (f->y + k + 1) / s};
+	double du[3] = {k / s, 0., k / s};
+	double dv[3] = {k / s, 0., k / s};
+	double px[3] = {x - w/2 + cw/2, x, x + w/2 - cw/2};
+	double py[3] = {y + h/2 - ch/2, y, y - h/2 + ch/2};
+	double pw[3] = {cw, w - 2*cw, cw};
+	double ph[3] = {ch, h - 2*ch, ch};
+	int i, j;
+	for (j = 0; j < 3; j ++)
+	{
+		if (ph[j] <= 0)
+			continue;
+		for (i = 0; i < 3; i ++)
+		{
+			if (pw[i] <= 0)
+				continue;
+			cairo_dock_gl_batch_add_quad_portion (pBatch, iLayer, f->iTexture, CAIRO_DOCK_GL_BATCH_BLEND_OVER,
+				px[i], py[j], z,
+				pw[i], ph[j],
+				u[i], v[j], du[i], dv[j],
+				fAlpha);
+		}
+	}
+}
+
+static void _get_glyph_atlas_box_extent (CairoDockGLAtlas *pAtlas, const gchar *cText, double *fTextWidth, double *fTextHeight, double *fBoxWidth, double *fBoxHeight)
+{
+	_get_glyph_atlas_text_extent (pAtlas, cText, fTextWidth, fTextHeight);
+	// same dimensions as cairo_dock_create_surface_from_text_full()
+	double fOutlineMargin = 2 * pAtlas->fMargin + (pAtlas->bOutlined ? 2 : 0);
+	double fLineWidth = 1;
+	*fBoxWidth = *fTextWidth + fOutlineMargin + 2*fLineWidth;
+	if (pAtlas->bDrawFrame)
+		*fBoxWidth = MAX (*fBoxWidth, 2 * pAtlas->fRadius + 10);
+	*fBoxHeight = *fTextHeight + fOutlineMargin + 2*fLineWidth;
+}
+
+static CairoDockGLAtlas *_new_glyph_atlas (GldiTextDescription *pTextDescription, double fScale, GldiColor *pTextColor, GldiColor *pBgColor, GldiColor *pLineColor)
+{
+	CairoDockGLAtlas *pAtlas = g_new0 (CairoDockGLAtlas, 1);
+	pAtlas->pGlyphs = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	pAtlas->pKernings = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	
+	//\_________________ a layout with the screen's font options, at the size of the text once zoomed.
+	PangoContext *pContext = pango_font_map_create_context (pango_cairo_font_map_get_default ());
+	GdkScreen *pScreen = gdk_screen_get_default ();
+	const cairo_font_options_t *pOptions = (pScreen != NULL ? gdk_screen_get_font_options (pScreen) : NULL);
+	if (pOptions != NULL)
+		pango_cairo_context_set_font_options (pContext, pOptions);
+	pAtlas->pLayout = pango_layout_new (pContext);
+	g_object_unref (pContext);
+	
+	int iSize = gldi_text_description_get_size (pTextDescription);
+	PangoFontDescription *fd = pango_font_description_copy (gldi_text_description_get_description (pTextDescription));
+	pango_font_description_set_absolute_size (fd, fScale * iSize * PANGO_SCALE);
+	pango_layout_set_font_description (pAtlas->pLayout, fd);
+	pango_font_description_free (fd);
+	
+	PangoRectangle log;
+	pango_layout_set_text (pAtlas->pLayout, "Ag", -1);
+	pango_layout_get_pixel_extents (pAtlas->pLayout, NULL, &log);
+	pAtlas->iLineHeight = log.height;
+	
+	//\_________________ decorations.
+	pAtlas->fTextColor = *pTextColor;
+	pAtlas->fBgColor = *pBgColor;
+	pAtlas->fLineColor = *pLineColor;
+	pAtlas->bOutlined = pTextDescription->bOutlined;
+	pAtlas->iOutline = (pAtlas->bOutlined ? 1 : 0);
+	pAtlas->bDrawFrame = ! pTextDescription->bNoDecorations;
+	pAtlas->fMargin = pTextDescription->iMargin * fScale;
+	pAtlas->fRadius = (pTextDescription->bUseDefaultColors ? MIN (myStyleParam.iCornerRadius * .75, iSize/2) : fScale * MAX (pTextDescription->iMargin, MIN (6, iSize/2)));
+	
+	return pAtlas;
+}
+
+static void _free_glyph_atlas (gpointer data)
+{
+	CairoDockGLAtlas *pAtlas = data;
+	g_hash_table_destroy (pAtlas->pGlyphs);
+	g_hash_table_destroy (pAtlas->pKernings);
+	g_object_unref (pAtlas->pLayout);
+	_retire_pages (pAtlas->pPages);  // like when the atlas is flushed, the current frame may still use them.
+	g_free (pAtlas->cKey);
+	g_free (pAtlas);
+}
+
+static void _draw_glyph_atlas_text (gpointer data, const gchar *cText)
+{
+	CairoDockGLAtlas *pAtlas = data;
+	if (s_pImmediateBatch == NULL)
+		s_pImmediateBatch = cairo_dock_gl_batch_new ();
+	double fWidth, fHeight;
+	_get_glyph_atlas_text_extent (pAtlas, cText, &fWidth, &fHeight);
+	_batch_glyph_atlas_text (pAtlas, cText, s_pImmediateBatch, CAIRO_DOCK_GL_BATCH_LAYER_LABELS, 0., fHeight, 0., 1., 1., 1.);
+	cairo_dock_gl_batch_draw (s_pImmediateBatch);
+}
+
+static inline void _append_color (GString *sKey, GldiColor *pColor)
+{
+	g_string_append_printf (sKey, ";%.3f,%.3f,%.3f,%.3f", pColor->rgba.red, pColor->rgba.green, pColor->rgba.blue, pColor->rgba.alpha);
+}
+
+CairoDockGLFont *cairo_dock_get_glyph_atlas_font (GldiTextDescription *pTextDescription, double fScale)
+{
+	g_return_val_if_fail (pTextDescription != NULL && gldi_text_description_get_description (pTextDescription) != NULL, NULL);
+	
+	//\_________________ the glyphs are drawn with their colors, so the colors are part of the font.
+	GldiColor fTextColor, fBgColor, fLineColor;
+	if (pTextDescription->bUseDefaultColors)
+	{
+		gldi_style_color_get (GLDI_COLOR_TEXT, &fTextColor);
+		gldi_style_color_get (GLDI_COLOR_BG, &fBgColor);
+		gldi_style_color_get (GLDI_COLOR_LINE, &fLineColor);
+	}
+	else
+	{
+		fTextColor = pTextDescription->fColorStart;
+		fBgColor = pTextDescription->fBackgroundColor;
+		fLineColor = pTextDescription->fLineColor;
+	}
+	
+	//\_________________ look for an existing font.
+	gchar *cDescription = pango_font_description_to_string (gldi_text_description_get_description (pTextDescription));
+	GString *sKey = g_string_new (cDescription);
+	g_free (cDescription);
+	g_string_append_printf (sKey, ";%d;%d;%d;%d;%d;%.3f",
+		gldi_text_description_get_size (pTextDescription),
+		pTextDescription->bOutlined,
+		pTextDescription->bNoDecorations,
+		pTextDescription->bUseDefaultColors,
+		pTextDescription->iMargin,
+		fScale);
+	_append_color (sKey, &fTextColor);
+	_append_color (sKey, &fBgColor);
+	_append_color (sKey, &fLineColor);
+	
+	if (s_hAtlasFonts == NULL)
+		s_hAtlasFonts = g_hash_table_new (g_str_hash, g_str_equal);  // the key belongs to the atlas; a font is removed when its last user releases it.
+	CairoDockGLFont *pFont = g_hash_table_lookup (s_hAtlasFonts, sKey->str);
+	if (pFont != NULL)
+	{
+		g_string_free (sKey, TRUE);
+		cairo_dock_ref_glyph_atlas_font (pFont);
+		return pFont;
+	}
+	
+	//\_________________ create a new one.
+	cd_debug ("new glyph atlas font '%s'", sKey->str);
+	CairoDockGLAtlas *pAtlas = _new_glyph_atlas (pTextDescription, fScale, &fTextColor, &fBgColor, &fLineColor);
+	pAtlas->cKey = g_string_free (sKey, FALSE);
+	pAtlas->iRefCount = 1;
+	pFont = g_new0 (CairoDockGLFont, 1);
+	pFont->pAtlas = pAtlas;
+	pFont->iCharHeight = pAtlas->iLineHeight;
+	g_hash_table_insert (s_hAtlasFonts, pAtlas->cKey, pFont);
+	return pFont;
+}
+
+void cairo_dock_ref_glyph_atlas_font (CairoDockGLFont *pFont)
+{
+	g_return_if_fail (pFont != NULL && pFont->pAtlas != NULL);
+	CairoDockGLAtlas *pAtlas = pFont->pAtlas;
+	pAtlas->iRefCount ++;
+}
+
+void cairo_dock_release_glyph_atlas_font (CairoDockGLFont *pFont)
+{
+	if (pFont == NULL)
+		return;
+	g_return_if_fail (pFont->pAtlas != NULL);
+	CairoDockGLAtlas *pAtlas = pFont->pAtlas;
+	g_return_if_fail (pAtlas->iRefCount > 0);
+	pAtlas->iRefCount --;
+	if (pAtlas->iRefCount == 0)  // the fonts are made for a given scale and colors, so an unused one is unlikely to be needed again.
+	{
+		cd_debug ("free the glyph atlas font '%s'", pAtlas->cKey);
+		g_hash_table_remove (s_hAtlasFonts, pAtlas->cKey);
+		cairo_dock_free_gl_font (pFont);
+	}
+}
+
+gboolean cairo_dock_glyph_atlas_can_draw_text (const gchar *cText)
+{
+	if (cText == NULL || ! g_utf8_validate (cText, -1, NULL))
+		return FALSE;
+	// the glyphs are placed one after the other, so scripts that need shaping across characters (Arabic, Indic, ...) are left to Pango.
+	const gchar *str;
+	for (str = cText; *str != '\0'; str = g_utf8_next_char (str))
+	{
+		switch (g_unichar_get_script (g_utf8_get_char (str)))
+		{
+			case G_UNICODE_SCRIPT_COMMON:
+			case G_UNICODE_SCRIPT_INHERITED:
+			case G_UNICODE_SCRIPT_LATIN:
+			case G_UNICODE_SCRIPT_GREEK:
+			case G_UNICODE_SCRIPT_CYRILLIC:
+			case G_UNICODE_SCRIPT_ARMENIAN:
+			case G_UNICODE_SCRIPT_GEORGIAN:
+			case G_UNICODE_SCRIPT_HAN:
+			case G_UNICODE_SCRIPT_HIRAGANA:
+			case G_UNICODE_SCRIPT_KATAKANA:
+			case G_UNICODE_SCRIPT_HANGUL:
+			case G_UNICODE_SCRIPT_BOPOMOFO:
+			break;
+			default:
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+void cairo_dock_get_gl_text_box_size (const gchar *cText, CairoDockGLFont *pFont, int iMaxWidth, int *iWidth, int *iHeight)
+{
+	g_return_if_fail (cText != NULL && pFont != NULL && pFont->pAtlas != NULL);
+	double fTextWidth, fTextHeight, fBoxWidth, fBoxHeight;
+	_get_glyph_atlas_box_extent (pFont->pAtlas, cText, &fTextWidth, &fTextHeight, &fBoxWidth, &fBoxHeight);
+	*iWidth = ceil (fBoxWidth);
+	if (iMaxWidth != 0 && *iWidth > iMaxWidth)
+		*iWidth = iMaxWidth;
+	*iHeight = ceil (fBoxHeight);
+}
+
+void cairo_dock_batch_gl_text_box (const gchar *cText, CairoDockGLFont *pFont, CairoDockGLBatch *pBatch, CairoDockGLBatchLayer iLayer, double x, double y, double z, double w, double h, double fAlpha)
+{
+	g_return_if_fail (cText != NULL && pFont != NULL && pFont->pAtlas != NULL);
+	CairoDockGLAtlas *pAtlas = pFont->pAtlas;
+	double fTextWidth, fTextHeight, fBoxWidth, fBoxHeight;
+	_get_glyph_atlas_box_extent (pAtlas, cText, &fTextWidth, &fTextHeight, &fBoxWidth, &fBoxHeight);
+	double sx = w / fBoxWidth, sy = h / fBoxHeight;  // the box is squeezed like the text surface would be.
+	
+	if (pAtlas->bDrawFrame)
+		_batch_frame (pAtlas, pBatch, iLayer, x, y, z, w, h, sx, sy, fAlpha);
+	
+	_batch_glyph_atlas_text (pAtlas, cText, pBatch, iLayer,
+		x - .5 * fTextWidth * sx,  // the text is centered in the box.
+		y + .5 * fTextHeight * sy,
+		z,
+		sx, sy,
+		fAlpha);
+}
+
+void cairo_dock_draw_gl_text_box (const gchar *cText, CairoDockGLFont *pFont, double w, double h, double fAlpha)
+{
+	if (s_pImmediateBatch == NULL)
+		s_pImmediateBatch = cairo_dock_gl_batch_new ();
+	cairo_dock_batch_gl_text_box (cText, pFont, s_pImmediateBatch, CAIRO_DOCK_GL_BATCH_LAYER_LABELS, 0., 0., 0., w, h, fAlpha);
+	cairo_dock_gl_batch_draw (s_pImmediateBatch);
+}
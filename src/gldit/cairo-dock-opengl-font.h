@@ -26,6 +26,7 @@
 #include <GL/glu.h>
 
 #include "cairo-dock-struct.h"
+#include "cairo-dock-opengl-batch.h"
 
 G_BEGIN_DECLS
 
@@ -35,6 +36,7 @@ G_BEGIN_DECLS
 * For a more efficient way, you load a font into a CairoDockGLFont with either :
 * \ref cairo_dock_load_textured_font to load a subset of a Mono font into textures.
 * You then use \ref cairo_dock_draw_gl_text_at_position to draw the text.
+* To draw texts that change often, like the quick-infos, use \ref cairo_dock_get_glyph_atlas_font : the glyphs are rasterized once into a texture shared by all the texts, and the texts are then drawn as a set of quads with \ref cairo_dock_batch_gl_text_box.
 */
 
 /** Create a texture from a text. The text is drawn in white, so that you can later colorize it with a mere glColor.
@@ -57,6 +59,8 @@ struct _CairoDockGLFont {
 	gint iNbChars;
 	gdouble iCharWidth;
 	gdouble iCharHeight;
+	/// private data of a font loaded with \ref cairo_dock_get_glyph_atlas_font
+	gpointer pAtlas;
 };
 
 /* Load a font into bitmaps. You can load any characters of font with this function. The drawback is that each character is a bitmap, that is to say you can't zoom them.
@@ -129,5 +133,61 @@ void cairo_dock_draw_gl_text_in_area (const guchar *cText, CairoDockGLFont *pFon
 void cairo_dock_draw_gl_text_at_position_in_area (const guchar *cText, CairoDockGLFont *pFont, int x, int y, int iWidth, int iHeight, gboolean bCentered);
 
 
+/** Get a font whose glyphs are loaded on demand into a texture atlas. The glyphs are drawn with the colors and the outline of the text description, and the font can draw the frame of the text description around a text. The font is shared with the other users of the same description, scale and colors: release it with \ref cairo_dock_release_glyph_atlas_font, don't free it.
+*@param pTextDescription description of the text
+*@param fScale scale at which the glyphs are rasterized, usually the max scale of the icons.
+*@return a new reference on the font.
+*/
+CairoDockGLFont *cairo_dock_get_glyph_atlas_font (GldiTextDescription *pTextDescription, double fScale);
+
+/** Take a reference on a glyph atlas font.
+*@param pFont a glyph atlas font
+*/
+void cairo_dock_ref_glyph_atlas_font (CairoDockGLFont *pFont);
+
+/** Release a reference on a glyph atlas font. The font is freed when it's not used anymore.
+*@param pFont a glyph atlas font, or NULL
+*/
+void cairo_dock_release_glyph_atlas_font (CairoDockGLFont *pFont);
+
+/** Tell if a text can be drawn with a glyph atlas font. The glyphs are placed one after the other, with the kerning of each pair of them; so invalid UTF-8 and scripts that need shaping are excluded (ligatures are not made either).
+*@param cText the text
+*@return TRUE if the text can be drawn with a glyph atlas font.
+*/
+gboolean cairo_dock_glyph_atlas_can_draw_text (const gchar *cText);
+
+/** Compute the size of a text drawn with its frame and margins by a glyph atlas font; it is the same size as the surface made by \ref cairo_dock_create_surface_from_text_full.
+*@param cText the text
+*@param pFont a glyph atlas font
+*@param iMaxWidth maximum width, or 0 for no limit
+*@param iWidth a pointer that will be filled with the width of the box
+*@param iHeight a pointer that will be filled with the height of the box
+*/
+void cairo_dock_get_gl_text_box_size (const gchar *cText, CairoDockGLFont *pFont, int iMaxWidth, int *iWidth, int *iHeight);
+
+/** Add a text with its frame to a batch, stretched to a given size.
+*@param cText the text
+*@param pFont a glyph atlas font
+*@param pBatch the batch
+*@param iLayer layer of the quads
+*@param x x coordinate of the center of the box
+*@param y y coordinate of the center of the box
+*@param z z coordinate of the box
+*@param w width of the box
+*@param h height of the box
+*@param fAlpha transparency of the text
+*/
+void cairo_dock_batch_gl_text_box (const gchar *cText, CairoDockGLFont *pFont, CairoDockGLBatch *pBatch, CairoDockGLBatchLayer iLayer, double x, double y, double z, double w, double h, double fAlpha);
+
+/** Like \ref cairo_dock_batch_gl_text_box, but draw the text immediately, centered on the current position.
+*@param cText the text
+*@param pFont a glyph atlas font
+*@param w width of the box
+*@param h height of the box
+*@param fAlpha transparency of the text
+*/
+void cairo_dock_draw_gl_text_box (const gchar *cText, CairoDockGLFont *pFont, double w, double h, double fAlpha);
+
+
 G_END_DECLS
 #endif
@@ -59,7 +59,33 @@ struct _GldiGLManagerBackend {
 #else
 	gpointer unused; // note: not sure if it is important to keep the same layout
 #endif
+	/// age of the back buffer that will be drawn: 0 if its content is undefined, n if it holds the frame that was presented n swaps ago (optional).
+	gint (*container_get_buffer_age) (GldiContainer *pContainer);
+	/// present the back buffer, telling the compositor that only the given area (in window coordinates) has changed (optional, container_end_draw is used otherwise).
+	void (*container_end_draw_with_damage) (GldiContainer *pContainer, GdkRectangle *pArea);
 };
+
+/// Number of previous frames whose repainted area is remembered, to repair back buffers that are several swaps old.
+#define GLDI_GL_DAMAGE_HISTORY 4
+
+/// Damage tracking of an OpenGL container.
+struct _GldiGLDamage {
+	/// union of the areas invalidated since the last frame.
+	GdkRectangle pending;
+	/// area repainted by the frame being drawn.
+	GdkRectangle current;
+	/// TRUE if the frame being drawn repaints the whole container.
+	gboolean bCurrentIsFull;
+	/// areas repainted by the previous frames, the most recent first (a zero width means the whole container).
+	GdkRectangle history[GLDI_GL_DAMAGE_HISTORY];
+	/// number of valid entries in the history.
+	guint iNbFrames;
+	/// size of the window when the history was recorded.
+	gint iWidth, iHeight;
+};
+
+/// Get the damage tracking of a container, or NULL if none has been tracked yet. It's kept in the first reserved slot of the container, so that the layout of the public structure doesn't change.
+#define gldi_gl_container_get_damage(pContainer) ((GldiGLDamage *) (pContainer)->reserved[0])
 	
 
 
@@ -130,6 +156,12 @@ gboolean gldi_gl_container_begin_draw_full (GldiContainer *pContainer, GdkRectan
 */
 void gldi_gl_container_end_draw (GldiContainer *pContainer);
 
+/** Add an area to the damage of a Container, that will be repainted on its next OpenGL frame. This is done automatically by the redraw functions of the containers.
+*@param pContainer the container
+*@param pArea the damaged area, in window coordinates
+*/
+void gldi_gl_container_add_damage (GldiContainer *pContainer, GdkRectangle *pArea);
+
 
 /** Set a shared default-initialized GL context on a window.
 *@param pContainer the container, not yet realized.
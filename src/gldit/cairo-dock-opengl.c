@@ -18,6 +18,7 @@
 */
 
 #include <math.h>
+#include <string.h>  // memset
 #include <GL/gl.h>
 #include <GL/glu.h>  // gluLookAt
 
@@ -234,6 +235,72 @@ static void _apply_desktop_background (GldiContainer *pContainer)
 	glPopMatrix ();
 }
 
+  ////////////
+ // DAMAGE //
+////////////
+
+static inline GldiGLDamage *_get_damage (GldiContainer *pContainer)
+{
+	if (pContainer->reserved[0] == NULL)
+		pContainer->reserved[0] = g_new0 (GldiGLDamage, 1);
+	return gldi_gl_container_get_damage (pContainer);
+}
+
+static inline void _union_area (GdkRectangle *pDest, const GdkRectangle *pArea)
+{
+	if (pDest->width <= 0 || pDest->height <= 0)
+		*pDest = *pArea;
+	else
+		gdk_rectangle_union (pDest, pArea, pDest);
+}
+
+void gldi_gl_container_add_damage (GldiContainer *pContainer, GdkRectangle *pArea)
+{
+	if (! g_bUseOpenGL || pArea->width <= 0 || pArea->height <= 0)
+		return;
+	_union_area (&_get_damage (pContainer)->pending, pArea);
+}
+
+// compute the area that the current frame has to repaint; returns FALSE if it's the whole window.
+static gboolean _compute_draw_area (GldiContainer *pContainer, GdkRectangle *pArea, GdkRectangle *pDrawArea)
+{
+	GldiGLDamage *pDamage = _get_damage (pContainer);
+	int w = (pContainer->bIsHorizontal ? pContainer->iWidth : pContainer->iHeight);
+	int h = (pContainer->bIsHorizontal ? pContainer->iHeight : pContainer->iWidth);
+	if (w != pDamage->iWidth || h != pDamage->iHeight)  // the previous frames don't match the window any more.
+	{
+		pDamage->iNbFrames = 0;
+		pDamage->iWidth = w;
+		pDamage->iHeight = h;
+	}
+	
+	GdkRectangle area = pDamage->pending;
+	memset (&pDamage->pending, 0, sizeof (GdkRectangle));
+	if (pArea == NULL)
+		return FALSE;
+	_union_area (&area, pArea);
+	
+	// if the back buffer is not the last presented frame, it also has to catch up with the frames it has missed.
+	if (s_backend.container_get_buffer_age != NULL)
+	{
+		gint iAge = s_backend.container_get_buffer_age (pContainer);
+		if (iAge <= 0 || (guint)iAge - 1 > pDamage->iNbFrames)  // undefined or too old content
+			return FALSE;
+		gint i;
+		for (i = 0; i < iAge - 1; i ++)
+		{
+			if (pDamage->history[i].width == 0)  // this frame repainted everything
+				return FALSE;
+			_union_area (&area, &pDamage->history[i]);
+		}
+	}  // otherwise the backend preserves the back buffer between frames.
+	
+	GdkRectangle window = {0, 0, w, h};
+	if (! gdk_rectangle_intersect (&area, &window, pDrawArea))
+		return FALSE;
+	return (pDrawArea->width < w || pDrawArea->height < h);
+}
+
 gboolean gldi_gl_container_begin_draw_full (GldiContainer *pContainer, GdkRectangle *pArea, gboolean bClear)
 {
 	if (! gldi_gl_container_make_current (pContainer))
@@ -244,14 +311,16 @@ gboolean gldi_gl_container_begin_draw_full (GldiContainer *pContainer, GdkRectan
 	gint scale = gdk_window_get_scale_factor (gdkwindow);
 	glScalef (scale, scale, 1.f);
 	
-	if (pArea != NULL)
+	GldiGLDamage *pDamage = _get_damage (pContainer);
+	pDamage->bCurrentIsFull = ! _compute_draw_area (pContainer, pArea, &pDamage->current);
+	if (! pDamage->bCurrentIsFull)
 	{
+		GdkRectangle *area = &pDamage->current;
 		glEnable (GL_SCISSOR_TEST);  // ou comment diviser par 4 l'occupation CPU !
-		glScissor ((int) pArea->x,
-			(int) (pContainer->bIsHorizontal ? pContainer->iHeight : pContainer->iWidth) -
-				pArea->y - pArea->height,  // lower left corner of the scissor box.
-			(int) pArea->width,
-			(int) pArea->height);
+		glScissor (area->x * scale,
+			(pDamage->iHeight - area->y - area->height) * scale,  // lower left corner of the scissor box.
+			area->width * scale,
+			area->height * scale);
 	}
 	
 	if (bClear)
@@ -266,8 +335,30 @@ gboolean gldi_gl_container_begin_draw_full (GldiContainer *pContainer, GdkRectan
 void gldi_gl_container_end_draw (GldiContainer *pContainer)
 {
 	glDisable (GL_SCISSOR_TEST);
-	if (s_backend.container_end_draw)
+	
+	GldiGLDamage *pDamage = _get_damage (pContainer);
+	memmove (&pDamage->history[1], &pDamage->history[0], (GLDI_GL_DAMAGE_HISTORY - 1) * sizeof (GdkRectangle));
+	if (pDamage->bCurrentIsFull)
+		memset (&pDamage->history[0], 0, sizeof (GdkRectangle));
+	else
+		pDamage->history[0] = pDamage->current;
+	if (pDamage->iNbFrames < GLDI_GL_DAMAGE_HISTORY)
+		pDamage->iNbFrames ++;
+	
+	if (! pDamage->bCurrentIsFull && s_backend.container_end_draw_with_damage)
+		s_backend.container_end_draw_with_damage (pContainer, &pDamage->current);
+	else if (s_backend.container_end_draw)
 		s_backend.container_end_draw (pContainer);
+	pDamage->bCurrentIsFull = TRUE;  // we're not inside a frame any more
+}
+
+gboolean gldi_gl_container_get_draw_area (GldiContainer *pContainer, GdkRectangle *pArea)
+{
+	GldiGLDamage *pDamage = gldi_gl_container_get_damage (pContainer);
+	if (pDamage == NULL || pDamage->bCurrentIsFull)
+		return FALSE;
+	*pArea = pDamage->current;
+	return TRUE;
 }
 
 
@@ -381,6 +472,8 @@ void gldi_gl_container_finish (GldiContainer *pContainer)
 {
 	if (g_bUseOpenGL && s_backend.container_finish)
 		s_backend.container_finish (pContainer);
+	g_free (gldi_gl_container_get_damage (pContainer));
+	pContainer->reserved[0] = NULL;
 }
 
 #ifdef HAVE_X11
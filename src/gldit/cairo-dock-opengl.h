@@ -56,5 +56,12 @@ void gldi_gl_container_set_ortho_view (GldiContainer *pContainer);
 */
 void gldi_gl_container_set_ortho_view_for_icon (Icon *pIcon);
 
+/** Get the area of a Container that is being repainted by the current OpenGL frame. Everything outside of it is clipped, so a renderer can skip the elements that don't intersect it.
+*@param pContainer the container
+*@param pArea filled with the repainted area, in window coordinates
+*@return FALSE if the whole Container is repainted (pArea is then left untouched).
+*/
+gboolean gldi_gl_container_get_draw_area (GldiContainer *pContainer, GdkRectangle *pArea);
+
 G_END_DECLS
 #endif
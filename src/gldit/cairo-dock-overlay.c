@@ -26,6 +26,8 @@
 #include "cairo-dock-icon-facility.h"
 #include "cairo-dock-draw.h"
 #include "cairo-dock-draw-opengl.h"
+#include "cairo-dock-opengl-batch.h"
+#include "cairo-dock-opengl-font.h"
 #include "cairo-dock-image-buffer.h"
 #include "cairo-dock-log.h"
 #define _MANAGER_DEF_
@@ -118,6 +120,48 @@ CairoOverlay *cairo_dock_add_overlay_from_texture (Icon *pIcon, GLuint iTexture,
 	return gldi_overlay_new (&attr);
 }
 
+CairoOverlay *cairo_dock_add_overlay_from_text (Icon *pIcon, const gchar *cText, CairoDockGLFont *pFont, int iWidth, int iHeight, CairoOverlayPosition iPosition, gpointer data)
+{
+	// if the text of an overlay changes, just update it.
+	if (data != NULL)
+	{
+		GList* ov;
+		CairoOverlay *p;
+		for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)
+		{
+			p = ov->data;
+			if (p->data == data && p->iPosition == iPosition && p->cText != NULL)
+			{
+				if (strcmp (p->cText, cText) != 0)
+				{
+					g_free (p->cText);
+					p->cText = g_strdup (cText);
+				}
+				if (p->pFont != pFont)
+				{
+					cairo_dock_ref_glyph_atlas_font (pFont);
+					cairo_dock_release_glyph_atlas_font (p->pFont);
+					p->pFont = pFont;
+				}
+				p->image.iWidth = iWidth;
+				p->image.iHeight = iHeight;
+				return p;
+			}
+		}
+	}
+	
+	CairoOverlayAttr attr;
+	memset (&attr, 0, sizeof (CairoOverlayAttr));
+	attr.iPosition = iPosition;
+	attr.pIcon = pIcon;
+	attr.data = data;
+	attr.cText = cText;
+	attr.pFont = pFont;
+	attr.iWidth = iWidth;
+	attr.iHeight = iHeight;
+	return gldi_overlay_new (&attr);
+}
+
 
 void cairo_dock_remove_overlay_at_position (Icon *pIcon, CairoOverlayPosition iPosition, gpointer data)
 {
@@ -275,7 +319,7 @@ void cairo_dock_draw_icon_overlays_opengl (Icon *pIcon, double fRatio)
 	for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)
 	{
 		p = ov->data;
-		if (! p->image.iTexture)
+		if (! p->image.iTexture && ! p->cText)
 			continue;
 		glPushMatrix ();
 		
@@ -297,13 +341,65 @@ void cairo_dock_draw_icon_overlays_opengl (Icon *pIcon, double fRatio)
 		glTranslatef (x, y, 0.);
 		
 		// draw.
-		_cairo_dock_apply_texture_at_size (p->image.iTexture, wo, ho);
+		if (p->cText != NULL)
+		{
+			cairo_dock_draw_gl_text_box (p->cText, p->pFont, wo, ho, pIcon->fAlpha);
+			_cairo_dock_enable_texture ();  // restore the state for the next overlays.
+			_cairo_dock_set_blend_over ();
+			_cairo_dock_set_alpha (pIcon->fAlpha);
+		}
+		else
+			_cairo_dock_apply_texture_at_size (p->image.iTexture, wo, ho);
 		
 		glPopMatrix ();
 	}
 	_cairo_dock_disable_texture ();
 }
 
+void cairo_dock_batch_icon_overlays_opengl (Icon *pIcon, double fRatio, CairoDockGLBatch *pBatch, double x0, double y0, double z0)
+{
+	if (pIcon->pOverlays == NULL)
+		return;
+	
+	int w, h;
+	cairo_dock_get_icon_extent (pIcon, &w, &h);
+	double fMaxScale = cairo_dock_get_icon_max_scale (pIcon);
+	double z = fRatio * pIcon->fScale / fMaxScale;
+	
+	GList* ov;
+	CairoOverlay *p;
+	int wo, ho;
+	double x, y;
+	for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)
+	{
+		p = ov->data;
+		if (! p->image.iTexture && ! p->cText)
+			continue;
+		_get_overlay_position_and_size (p, w, h, z, &x, &y, &wo, &ho);
+		if (pIcon->fScale == 1)  // same as cairo_dock_draw_icon_overlays_opengl
+		{
+			if (wo & 1)
+				x = floor (x) + .5;
+			else
+				x = round (x);
+			if (ho & 1)
+				y = floor (y) + .5;
+			else
+				y = round (y);
+		}
+		if (p->cText != NULL)
+			cairo_dock_batch_gl_text_box (p->cText, p->pFont, pBatch, CAIRO_DOCK_GL_BATCH_LAYER_OVERLAYS,
+				x0 + x, y0 + y, z0,
+				wo, ho,
+				pIcon->fAlpha);
+		else
+			cairo_dock_gl_batch_add_quad (pBatch, CAIRO_DOCK_GL_BATCH_LAYER_OVERLAYS, p->image.iTexture, CAIRO_DOCK_GL_BATCH_BLEND_OVER,
+				x0 + x, y0 + y, z0,
+				wo, ho,
+				pIcon->fAlpha);
+	}
+}
+
 
   /////////////
  /// PRINT ///
@@ -346,9 +442,13 @@ static void cairo_dock_print_overlay_on_icon (Icon *pIcon, CairoOverlay *pOverla
 		
 		cairo_dock_end_draw_icon (pIcon);
 	}
-	else if (pIcon->image.pSurface != NULL && pOverlay->image.pSurface != NULL)
+	else if (pOverlay->image.pSurface != NULL)
 	{
-		cairo_t *pCairoContext = cairo_create (pIcon->image.pSurface);
+		gboolean bTextureOnly = cairo_dock_image_buffer_is_texture_only (&pIcon->image);
+		cairo_surface_t *pSurface = cairo_dock_image_buffer_get_surface (&pIcon->image);
+		if (pSurface == NULL)
+			return;
+		cairo_t *pCairoContext = cairo_create (pSurface);
 		g_return_if_fail (cairo_status (pCairoContext) == CAIRO_STATUS_SUCCESS);
 		
 		cairo_translate (pCairoContext,
@@ -363,6 +463,12 @@ static void cairo_dock_print_overlay_on_icon (Icon *pIcon, CairoOverlay *pOverla
 		cairo_paint (pCairoContext);
 		
 		cairo_destroy (pCairoContext);
+		
+		if (bTextureOnly)  // the image of the icon is its texture, so update it and keep the icon in video memory only.
+		{
+			cairo_dock_image_buffer_update_texture (&pIcon->image);
+			cairo_dock_image_buffer_drop_surface (&pIcon->image);
+		}
 	}
 }
 
@@ -415,7 +521,7 @@ static void init_object (GldiObject *obj, gpointer attr)
 	{
 		int iWidth, iHeight;
 		cairo_dock_get_icon_extent (cattr->pIcon, &iWidth, &iHeight);
-		cairo_dock_load_image_buffer (&pOverlay->image, cattr->cImageFile, iWidth * pOverlay->fScale, iHeight * pOverlay->fScale, 0);
+		cairo_dock_load_shared_image_buffer (&pOverlay->image, cattr->cImageFile, iWidth * pOverlay->fScale, iHeight * pOverlay->fScale, 0);  // the same emblem is often put on many icons
 	}
 	else if (cattr->pSurface != NULL)
 	{
@@ -427,6 +533,14 @@ static void init_object (GldiObject *obj, gpointer attr)
 	{
 		cairo_dock_load_image_buffer_from_texture (&pOverlay->image, cattr->iTexture, 1, 1);  // size will be used to draw it if the scale is set to 0.
 	}
+	else if (cattr->cText != NULL)
+	{
+		pOverlay->cText = g_strdup (cattr->cText);
+		pOverlay->pFont = cattr->pFont;
+		cairo_dock_ref_glyph_atlas_font (pOverlay->pFont);  // the font is freed when its last text is removed.
+		pOverlay->image.iWidth = cattr->iWidth;  // no buffer, the size is only used to draw the text box.
+		pOverlay->image.iHeight = cattr->iHeight;
+	}
 	
 	if (cattr->data != NULL)
 	{
@@ -447,6 +561,8 @@ static void reset_object (GldiObject *obj)
 	
 	// free data
 	cairo_dock_unload_image_buffer (&pOverlay->image);
+	g_free (pOverlay->cText);
+	cairo_dock_release_glyph_atlas_font (pOverlay->pFont);
 }
 
 void gldi_register_overlays_manager (void)
@@ -69,6 +69,8 @@ struct _CairoOverlayAttr {
 	cairo_surface_t *pSurface;
 	int iWidth, iHeight;
 	GLuint iTexture;
+	const gchar *cText;
+	CairoDockGLFont *pFont;
 };
 
 // signals
@@ -91,6 +93,10 @@ struct _CairoOverlay {
 	Icon *pIcon;
 	/// data used to identify an overlay
 	gpointer data;
+	/// text drawn with a glyph atlas font instead of the image buffer, or NULL
+	gchar *cText;
+	/// the font used to draw the text
+	CairoDockGLFont *pFont;
 } ;
 
 
@@ -127,6 +133,18 @@ CairoOverlay *cairo_dock_add_overlay_from_surface (Icon *pIcon, cairo_surface_t
  */
 CairoOverlay *cairo_dock_add_overlay_from_texture (Icon *pIcon, GLuint iTexture, CairoOverlayPosition iPosition, gpointer data);
 
+/** Add an overlay on an icon from a text, drawn with a glyph atlas font. This is only possible in OpenGL, and is much faster than making a new surface each time the text changes: an existing text overlay with the same position and data is simply updated.
+ *@param pIcon the icon
+ *@param cText the text
+ *@param pFont a glyph atlas font, see \ref cairo_dock_get_glyph_atlas_font; the overlay takes its own reference on it.
+ *@param iWidth width of the text box, see \ref cairo_dock_get_gl_text_box_size
+ *@param iHeight height of the text box
+ *@param iPosition position where to display the overlay
+ *@param data data that will be used to look for the overlay in \ref cairo_dock_remove_overlay_at_position; if NULL, then this function can't be used
+ *@return the overlay.
+ */
+CairoOverlay *cairo_dock_add_overlay_from_text (Icon *pIcon, const gchar *cText, CairoDockGLFont *pFont, int iWidth, int iHeight, CairoOverlayPosition iPosition, gpointer data);
+
 
 /** Set the scale of an overlay; by default it's 0.5
  *@param pOverlay the overlay
@@ -158,6 +176,10 @@ void cairo_dock_draw_icon_overlays_cairo (Icon *pIcon, double fRatio, cairo_t *p
 
 void cairo_dock_draw_icon_overlays_opengl (Icon *pIcon, double fRatio);
 
+/* Same as cairo_dock_draw_icon_overlays_opengl, but adds the overlays to a batch; (x, y, z) is the center of the icon, and the icon must not be rotated.
+ */
+void cairo_dock_batch_icon_overlays_opengl (Icon *pIcon, double fRatio, CairoDockGLBatch *pBatch, double x, double y, double z);
+
 
   ///////////
  // PRINT //
@@ -484,6 +484,8 @@ typedef struct _CairoDockGLFont CairoDockGLFont;
 
 typedef struct _CairoDockGLPath CairoDockGLPath;
 
+typedef struct _CairoDockGLBatch CairoDockGLBatch;
+
 typedef struct _CairoDockImageBuffer CairoDockImageBuffer;
 
 typedef struct _CairoOverlay CairoOverlay;
@@ -512,6 +514,8 @@ typedef struct _GldiContainerManagerBackend GldiContainerManagerBackend;
 
 typedef struct _GldiGLManagerBackend GldiGLManagerBackend;
 
+typedef struct _GldiGLDamage GldiGLDamage;
+
 typedef void (*_GldiIconFunc) (Icon *icon, gpointer data);
 typedef _GldiIconFunc GldiIconFunc;
 typedef gboolean (*_GldiIconRFunc) (Icon *icon, gpointer data);  // TRUE to continue
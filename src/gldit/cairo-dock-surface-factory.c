@@ -23,12 +23,18 @@
 #include <pango/pango.h>
 #include <fcntl.h>
 #include <stdio.h>
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#elif defined (__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 #include "cairo-dock-log.h"
 #include "cairo-dock-draw.h"
 #include "cairo-dock-launcher-manager.h"
 #include "cairo-dock-container-priv.h"
 #include "cairo-dock-image-buffer.h"
+#include "cairo-dock-image-cache.h"
 #include "cairo-dock-desktop-manager.h"
 #include "cairo-dock-icon-manager.h"  // cairo_dock_search_icon_s_path
 #include "cairo-dock-dialog-manager.h"
@@ -190,6 +196,28 @@ static inline cairo_t *_get_source_context (void)
 	return pSourceContext;  // Note: we can't keep the context alive and reuse it later, because under Wayland it will make the container invisible
 }
 
+double cairo_dock_get_device_scale (void)
+{
+	if (g_pPrimaryContainer == NULL)
+		return 1.;
+	return gdk_window_get_scale_factor (gldi_container_get_gdk_window (g_pPrimaryContainer));
+}
+
+static inline cairo_surface_t *_create_image_surface (int iWidth, int iHeight, double xs, double ys)
+{
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, (int)ceil(iWidth * xs), (int)ceil(iHeight * ys));
+	cairo_surface_set_device_scale (pSurface, xs, ys);
+	return pSurface;
+}
+
+// in OpenGL mode the surfaces are mere image surfaces, so they can be made in any thread if the device scale is given; otherwise the screen is queried (main thread only).
+static cairo_surface_t *_create_blank_surface (int iWidth, int iHeight, double fDeviceScale)
+{
+	if (fDeviceScale > 0 && g_bUseOpenGL)
+		return _create_image_surface (iWidth, iHeight, fDeviceScale, fDeviceScale);
+	return cairo_dock_create_blank_surface (iWidth, iHeight);
+}
+
 cairo_surface_t *cairo_dock_create_blank_surface_full (int iWidth, int iHeight, cairo_t *pSourceContext)
 {
 	cairo_t *tmpContext = NULL;
@@ -204,13 +232,9 @@ cairo_surface_t *cairo_dock_create_blank_surface_full (int iWidth, int iHeight,
 		double xs = 1.0, ys = 1.0; // take into account the source context scale
 		if (pSourceContext != NULL)
 			cairo_surface_get_device_scale (cairo_get_target (pSourceContext), &xs, &ys);
-		else if (g_pPrimaryContainer != NULL)
-		{
-			GdkWindow* gdkwindow = gldi_container_get_gdk_window (g_pPrimaryContainer);
-			xs = ys = gdk_window_get_scale_factor (gdkwindow);
-		}
-		pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, (int)ceil(iWidth * xs), (int)ceil(iHeight * ys));
-		cairo_surface_set_device_scale (pSurface, xs, ys);
+		else
+			xs = ys = cairo_dock_get_device_scale ();
+		pSurface = _create_image_surface (iWidth, iHeight, xs, ys);
 	}
 	else
 		pSurface = cairo_surface_create_similar (cairo_get_target (pSourceContext),
@@ -278,21 +302,140 @@ static inline void _apply_orientation_and_scale (cairo_t *pCairoContext, CairoDo
 }
 
 
+static inline guint32 _premultiply_component (guint32 c, guint32 a)  // c*a/255, rounded; exact for 8 bits values.
+{
+	guint32 t = c * a + 128;
+	return (t + (t >> 8)) >> 8;
+}
+
+#if (defined (__SSE2__) || defined (__ARM_NEON)) && GLIB_SIZEOF_LONG == 8
+#define CD_XICON_SIMD 1
+#endif
+
+#if defined (CD_XICON_SIMD) && defined (__SSE2__)
+static inline __m128i _premultiply_component_sse2 (__m128i c, __m128i a)
+{
+	__m128i t = _mm_add_epi32 (_mm_mullo_epi16 (c, a), _mm_set1_epi32 (128));  // c and a are < 256 in each 32-bits lane, so a 16-bits product is enough.
+	return _mm_srli_epi32 (_mm_add_epi32 (t, _mm_srli_epi32 (t, 8)), 8);
+}
+#endif
+
+/* Pre-multiply the ARGB pixels of an X icon by their alpha, and pack them in 32 bits in place (X gives 1 pixel per long).
+ */
+static void _premultiply_xicon_pixels (gulong *pXPixels, guint32 *pPixels, int n)
+{
+	int i = 0;
+	#if defined (CD_XICON_SIMD) && defined (__SSE2__)
+	const __m128i mask = _mm_set1_epi32 (0xFF);
+	for (; i + 4 <= n; i += 4)  // we write 16 bytes behind the 32 bytes we've just read, so it's safe to work in place.
+	{
+		__m128i p01 = _mm_loadu_si128 ((const __m128i *) &pXPixels[i]);
+		__m128i p23 = _mm_loadu_si128 ((const __m128i *) &pXPixels[i+2]);
+		__m128i p = _mm_unpacklo_epi64 (_mm_shuffle_epi32 (p01, _MM_SHUFFLE (2, 0, 2, 0)),
+			_mm_shuffle_epi32 (p23, _MM_SHUFFLE (2, 0, 2, 0)));  // keep the lower 32 bits of each long
+		__m128i a = _mm_srli_epi32 (p, 24);
+		__m128i r = _premultiply_component_sse2 (_mm_and_si128 (_mm_srli_epi32 (p, 16), mask), a);
+		__m128i g = _premultiply_component_sse2 (_mm_and_si128 (_mm_srli_epi32 (p, 8), mask), a);
+		__m128i b = _premultiply_component_sse2 (_mm_and_si128 (p, mask), a);
+		p = _mm_or_si128 (_mm_or_si128 (_mm_slli_epi32 (a, 24), _mm_slli_epi32 (r, 16)),
+			_mm_or_si128 (_mm_slli_epi32 (g, 8), b));
+		_mm_storeu_si128 ((__m128i *) &pPixels[i], p);
+	}
+	#elif defined (CD_XICON_SIMD) && defined (__ARM_NEON)
+	const uint32x4_t mask = vdupq_n_u32 (0xFF), half = vdupq_n_u32 (128);
+	for (; i + 4 <= n; i += 4)  // same as above
+	{
+		uint32x4_t p = vld2q_u32 ((const uint32_t *) &pXPixels[i]).val[0];  // keep the lower 32 bits of each long
+		uint32x4_t a = vshrq_n_u32 (p, 24);
+		uint32x4_t r = vmlaq_u32 (half, vandq_u32 (vshrq_n_u32 (p, 16), mask), a);
+		uint32x4_t g = vmlaq_u32 (half, vandq_u32 (vshrq_n_u32 (p, 8), mask), a);
+		uint32x4_t b = vmlaq_u32 (half, vandq_u32 (p, mask), a);
+		r = vshrq_n_u32 (vsraq_n_u32 (r, r, 8), 8);
+		g = vshrq_n_u32 (vsraq_n_u32 (g, g, 8), 8);
+		b = vshrq_n_u32 (vsraq_n_u32 (b, b, 8), 8);
+		p = vorrq_u32 (vorrq_u32 (vshlq_n_u32 (a, 24), vshlq_n_u32 (r, 16)),
+			vorrq_u32 (vshlq_n_u32 (g, 8), b));
+		vst1q_u32 (&pPixels[i], p);
+	}
+	#endif
+	guint32 pixel, alpha;
+	for (; i < n; i ++)
+	{
+		pixel = (guint32) pXPixels[i];
+		alpha = pixel >> 24;
+		pPixels[i] = (pixel & 0xFF000000)
+			| (_premultiply_component ((pixel >> 16) & 0xFF, alpha) << 16)
+			| (_premultiply_component ((pixel >> 8) & 0xFF, alpha) << 8)
+			| _premultiply_component (pixel & 0xFF, alpha);
+	}
+}
+
+/* Shrink pre-multiplied ARGB pixels with a box filter: each destination pixel is the average of the source pixels it covers.
+ */
+static void _downscale_pixels (const guint32 *pSrc, int w, int h, guint32 *pDest, int dw, int dh)
+{
+	int x, y, sx, sy, sx0, sx1, sy0, sy1;
+	guint32 a, r, g, b, n, pixel;
+	for (y = 0; y < dh; y ++)
+	{
+		sy0 = y * h / dh;
+		sy1 = MAX ((y + 1) * h / dh, sy0 + 1);
+		for (x = 0; x < dw; x ++)
+		{
+			sx0 = x * w / dw;
+			sx1 = MAX ((x + 1) * w / dw, sx0 + 1);
+			a = r = g = b = 0;
+			for (sy = sy0; sy < sy1; sy ++)
+			{
+				for (sx = sx0; sx < sx1; sx ++)
+				{
+					pixel = pSrc[sy * w + sx];
+					a += pixel >> 24;
+					r += (pixel >> 16) & 0xFF;
+					g += (pixel >> 8) & 0xFF;
+					b += pixel & 0xFF;
+				}
+			}
+			n = (sx1 - sx0) * (sy1 - sy0);
+			pDest[y * dw + x] = (((a + n/2) / n) << 24)
+				| (((r + n/2) / n) << 16)
+				| (((g + n/2) / n) << 8)
+				| ((b + n/2) / n);
+		}
+	}
+}
+
 cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuffer, int iBufferNbElements, int iWidth, int iHeight)
 {
-	//\____________________ On recupere la plus grosse des icones presentes dans le tampon (meilleur rendu).
-	int iIndex = 0, iBestIndex = 0;
+	cairo_surface_t *pNewSurface = cairo_dock_create_blank_surface (
+		iWidth,
+		iHeight);
+	double fScaleX = 1., fScaleY = 1.;
+	cairo_surface_get_device_scale (pNewSurface, &fScaleX, &fScaleY);
+	int iPixelSize = MAX (iWidth * fScaleX, iHeight * fScaleY);  // size of the icon on the screen
+	
+	//\____________________ On recupere la plus petite des icones presentes dans le tampon qui soit au moins aussi grande que la taille voulue (sinon la plus grosse), pour avoir le meilleur rendu sans traiter de pixels inutiles.
+	int iIndex = 0, iBestIndex = 0, iSize, iBestSize = 0;
 	while (iIndex + 2 < iBufferNbElements)
 	{
 		if (pXIconBuffer[iIndex] == 0 || pXIconBuffer[iIndex+1] == 0)  // precaution au cas ou un buffer foirreux nous serait retourne, on risque de boucler sans fin.
 		{
 			cd_warning ("This icon is broken !\nThis means that one of the current applications has sent a buggy icon to X.");
 			if (iIndex == 0)  // tout le buffer est a jeter.
+			{
+				cairo_surface_destroy (pNewSurface);
 				return NULL;
+			}
 			break;
 		}
-		if (pXIconBuffer[iIndex] > pXIconBuffer[iBestIndex])
+		iSize = MAX (pXIconBuffer[iIndex], pXIconBuffer[iIndex+1]);
+		if (iBestSize == 0
+		|| (iBestSize < iPixelSize && iSize > iBestSize)  // the best one is too small, take a bigger one
+		|| (iSize >= iPixelSize && iSize < iBestSize))  // this one is big enough and smaller than the best one
+		{
 			iBestIndex = iIndex;
+			iBestSize = iSize;
+		}
 		iIndex += 2 + pXIconBuffer[iIndex] * pXIconBuffer[iIndex+1];
 	}
 
@@ -302,31 +445,54 @@ cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuff
 	iBestIndex += 2;
 	//g_print ("%s (%dx%d)\n", __func__, w, h);
 	
-	int i, n = w * h;
+	int n = w * h;
 	if (iBestIndex + n > iBufferNbElements)  // precaution au cas ou le nombre d'elements dans le buffer serait incorrect.
 	{
 		cd_warning ("This icon is broken !\nThis means that one of the current applications has sent a buggy icon to X.");
+		cairo_surface_destroy (pNewSurface);
 		return NULL;
 	}
-	gint pixel, alpha, red, green, blue;
-	float fAlphaFactor;
-	gint *pPixelBuffer = (gint *) &pXIconBuffer[iBestIndex];  // on va ecrire le resultat du filtre directement dans le tableau fourni en entree. C'est ok car sizeof(gulong) >= sizeof(gint), donc le tableau de pixels est plus petit que le buffer fourni en entree. merci a Hannemann pour ses tests et ses screenshots ! :-)
-	for (i = 0; i < n; i ++)
+	guint32 *pPixelBuffer = (guint32 *) &pXIconBuffer[iBestIndex];  // on va ecrire le resultat du filtre directement dans le tableau fourni en entree. C'est ok car sizeof(gulong) >= sizeof(guint32), donc le tableau de pixels est plus petit que le buffer fourni en entree. merci a Hannemann pour ses tests et ses screenshots ! :-)
+	_premultiply_xicon_pixels (&pXIconBuffer[iBestIndex], pPixelBuffer, n);
+	
+	cairo_t *pCairoContext = cairo_create (pNewSurface);
+	
+	//\____________________ if the icon is too big, shrink it directly into its final size, and just center it.
+	double fZoom = MIN ((double)iWidth * fScaleX / w, (double)iHeight * fScaleY / h);  // keep ratio and fill space
+	if (fZoom < 1)
 	{
-		pixel = (gint) pXIconBuffer[iBestIndex+i];
-		alpha = (pixel & 0xFF000000) >> 24;
-		red   = (pixel & 0x00FF0000) >> 16;
-		green = (pixel & 0x0000FF00) >> 8;
-		blue  = (pixel & 0x000000FF);
-		fAlphaFactor = (float) alpha / 255;
-		red *= fAlphaFactor;
-		green *= fAlphaFactor;
-		blue *= fAlphaFactor;
-		pPixelBuffer[i] = (pixel & 0xFF000000) + (red << 16) + (green << 8) + blue;
+		int dw = MAX (1, (int)(w * fZoom + .5));
+		int dh = MAX (1, (int)(h * fZoom + .5));
+		cairo_surface_t *surface_ini = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, dw, dh);
+		cairo_surface_flush (surface_ini);
+		guint32 *pDest = (guint32 *) cairo_image_surface_get_data (surface_ini);
+		int iDestStride = cairo_image_surface_get_stride (surface_ini);
+		if (iDestStride == dw * (int)sizeof (guint32))
+			_downscale_pixels (pPixelBuffer, w, h, pDest, dw, dh);
+		else  // shouldn't happen with ARGB32
+		{
+			guint32 *pTmp = g_new (guint32, dw * dh);
+			_downscale_pixels (pPixelBuffer, w, h, pTmp, dw, dh);
+			int y;
+			for (y = 0; y < dh; y ++)
+				memcpy ((guchar *)pDest + y * iDestStride, pTmp + y * dw, dw * sizeof (guint32));
+			g_free (pTmp);
+		}
+		cairo_surface_mark_dirty (surface_ini);
+		
+		cairo_scale (pCairoContext, 1. / fScaleX, 1. / fScaleY);  // work in pixels
+		cairo_set_source_surface (pCairoContext, surface_ini,
+			(int)((iWidth * fScaleX - dw) / 2),
+			(int)((iHeight * fScaleY - dh) / 2));
+		cairo_paint (pCairoContext);
+		
+		cairo_surface_destroy (surface_ini);
+		cairo_destroy (pCairoContext);
+		return pNewSurface;
 	}
-
+	
 	//\____________________ On cree la surface a partir du tampon.
-	int iStride = w * sizeof (gint);  // nbre d'octets entre le debut de 2 lignes.
+	int iStride = w * sizeof (guint32);  // nbre d'octets entre le debut de 2 lignes.
 	cairo_surface_t *surface_ini = cairo_image_surface_create_for_data ((guchar *)pPixelBuffer,
 		CAIRO_FORMAT_ARGB32,
 		w,
@@ -343,11 +509,6 @@ cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuff
 		&fIconWidthSaturationFactor,
 		&fIconHeightSaturationFactor);
 	
-	cairo_surface_t *pNewSurface = cairo_dock_create_blank_surface (
-		iWidth,
-		iHeight);
-	cairo_t *pCairoContext = cairo_create (pNewSurface);
-	
 	double fUsefulWidth = w * fIconWidthSaturationFactor;  // a part dans le cas fill && keep ratio, c'est la meme chose que fImageWidth et fImageHeight.
 	double fUsefulHeight = h * fIconHeightSaturationFactor;
 	_apply_orientation_and_scale (pCairoContext,
@@ -365,7 +526,7 @@ cairo_surface_t *cairo_dock_create_surface_from_xicon_buffer (gulong *pXIconBuff
 }
 
 
-cairo_surface_t *cairo_dock_create_surface_from_pixbuf (GdkPixbuf *pixbuf, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+static cairo_surface_t *_create_surface_from_pixbuf (GdkPixbuf *pixbuf, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY, double fDeviceScale)
 {
 	*fImageWidth = gdk_pixbuf_get_width (pixbuf);
 	*fImageHeight = gdk_pixbuf_get_height (pixbuf);
@@ -415,9 +576,10 @@ cairo_surface_t *cairo_dock_create_surface_from_pixbuf (GdkPixbuf *pixbuf, doubl
 		h,
 		iRowstride);
 
-	cairo_surface_t *pNewSurface = cairo_dock_create_blank_surface (
+	cairo_surface_t *pNewSurface = _create_blank_surface (
 		ceil ((*fImageWidth) * fMaxScale),
-		ceil ((*fImageHeight) * fMaxScale));
+		ceil ((*fImageHeight) * fMaxScale),
+		fDeviceScale);
 	cairo_t *pCairoContext = cairo_create (pNewSurface);
 	
 	double fUsefulWidth = w * fIconWidthSaturationFactor;  // a part dans le cas fill && keep ratio, c'est la meme chose que fImageWidth et fImageHeight.
@@ -444,6 +606,11 @@ cairo_surface_t *cairo_dock_create_surface_from_pixbuf (GdkPixbuf *pixbuf, doubl
 	return pNewSurface;
 }
 
+cairo_surface_t *cairo_dock_create_surface_from_pixbuf (GdkPixbuf *pixbuf, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+{
+	return _create_surface_from_pixbuf (pixbuf, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier, fImageWidth, fImageHeight, fZoomX, fZoomY, 0);
+}
+
 
 GdkPixbuf *cairo_dock_load_gdk_pixbuf (const gchar *cImagePath, int iWidth, int iHeight)
 {
@@ -511,7 +678,7 @@ static cairo_status_t _cairo_read_func (void *ptr, unsigned char *data, unsigned
 	return CAIRO_STATUS_READ_ERROR;
 }
 
-cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+cairo_surface_t *cairo_dock_create_surface_from_image_full (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY, double fDeviceScale)
 {
 	//g_print ("%s (%s, %dx%dx%.2f, %d)\n", __func__, cImagePath, iWidthConstraint, iHeightConstraint, fMaxScale, iLoadingModifier);
 	g_return_val_if_fail (cImagePath != NULL, NULL);
@@ -594,9 +761,10 @@ cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath,
 				&fIconWidthSaturationFactor,
 				&fIconHeightSaturationFactor);
 			
-			pNewSurface = cairo_dock_create_blank_surface (
+			pNewSurface = _create_blank_surface (
 				ceil ((*fImageWidth) * fMaxScale),
-				ceil ((*fImageHeight) * fMaxScale));
+				ceil ((*fImageHeight) * fMaxScale),
+				fDeviceScale);
 
 			pCairoContext = cairo_create (pNewSurface);
 			double fUsefulWidth = w * fIconWidthSaturationFactor;  // a part dans le cas fill && keep ratio, c'est la meme chose que fImageWidth et fImageHeight.
@@ -633,9 +801,10 @@ cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath,
 				&fIconWidthSaturationFactor,
 				&fIconHeightSaturationFactor);
 			
-			pNewSurface = cairo_dock_create_blank_surface (
+			pNewSurface = _create_blank_surface (
 				ceil ((*fImageWidth) * fMaxScale),
-				ceil ((*fImageHeight) * fMaxScale));
+				ceil ((*fImageHeight) * fMaxScale),
+				fDeviceScale);
 			pCairoContext = cairo_create (pNewSurface);
 			cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
 			cairo_set_source_rgba (pCairoContext, 0., 0., 0., 0.);
@@ -670,7 +839,7 @@ cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath,
 		else pixbuf = cairo_dock_load_gdk_pixbuf (cImagePath, -1, -1);
 		if (! pixbuf) return NULL; // warning message already printed above
 
-		pNewSurface = cairo_dock_create_surface_from_pixbuf (pixbuf,
+		pNewSurface = _create_surface_from_pixbuf (pixbuf,
 			fMaxScale,
 			iWidthConstraint,
 			iHeightConstraint,
@@ -678,7 +847,8 @@ cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath,
 			fImageWidth,
 			fImageHeight,
 			&fIconWidthSaturationFactor,
-			&fIconHeightSaturationFactor);
+			&fIconHeightSaturationFactor,
+			fDeviceScale);
 		g_object_unref (pixbuf);
 		
 	}
@@ -691,6 +861,11 @@ cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath,
 	return pNewSurface;
 }
 
+cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY)
+{
+	return cairo_dock_create_surface_from_image_full (cImagePath, fMaxScale, iWidthConstraint, iHeightConstraint, iLoadingModifier, fImageWidth, fImageHeight, fZoomX, fZoomY, 0);
+}
+
 cairo_surface_t *cairo_dock_create_surface_from_image_simple (const gchar *cImageFile, double fImageWidth, double fImageHeight)
 {
 	g_return_val_if_fail (cImageFile != NULL, NULL);
@@ -701,7 +876,7 @@ cairo_surface_t *cairo_dock_create_surface_from_image_simple (const gchar *cImag
 	else
 		cImagePath = cairo_dock_search_image_s_path (cImageFile);
 		
-	cairo_surface_t *pSurface = cairo_dock_create_surface_from_image (cImagePath,
+	cairo_surface_t *pSurface = cairo_dock_image_cache_create_surface (cImagePath,
 		1.,
 		fImageWidth,
 		fImageHeight,
@@ -725,7 +900,7 @@ cairo_surface_t *cairo_dock_create_surface_from_icon (const gchar *cImageFile, d
 	else
 		cIconPath = cairo_dock_search_icon_s_path (cImageFile, (gint) MAX (fImageWidth, fImageHeight));
 		
-	cairo_surface_t *pSurface = cairo_dock_create_surface_from_image (cIconPath,
+	cairo_surface_t *pSurface = cairo_dock_image_cache_create_surface (cIconPath,
 		1.,
 		fImageWidth,
 		fImageHeight,
@@ -70,7 +70,7 @@ typedef enum {
 #define CAIRO_DOCK_ORIENTATION_MASK (7<<3)
 
 
-/** Create a surface from raw data of an X icon. The biggest icon possible is taken. The ratio is kept, and the surface will fill the space with transparency if necessary.
+/** Create a surface from raw data of an X icon. The smallest icon at least as big as the surface is taken (or the biggest one if none is big enough). The ratio is kept, and the surface will fill the space with transparency if necessary.
 *@param pXIconBuffer raw data of the icon.
 *@param iBufferNbElements number of elements in the buffer.
 *@param iWidth will be filled with the resulting width of the surface.
@@ -101,6 +101,11 @@ cairo_surface_t *cairo_dock_create_surface_from_pixbuf (GdkPixbuf *pixbuf, doubl
 cairo_surface_t *cairo_dock_create_blank_surface_full (int iWidth, int iHeight, cairo_t *pSourceContext);
 #define cairo_dock_create_blank_surface(iWidth, iHeight) cairo_dock_create_blank_surface_full (iWidth, iHeight, NULL)
 
+/** Get the device scale of the screen (the scale factor of the main dock). Must be called from the main thread.
+*@return the device scale, 1 if it's not known yet.
+*/
+double cairo_dock_get_device_scale (void);
+
 /** Simple helper to read an image into a GdkPixbuf.
 *@param cImagePath complete path to the image.
 *@param iWidth desired width.
@@ -135,7 +140,12 @@ GdkPixbuf *cairo_dock_load_gdk_pixbuf_with_max_size (const gchar *cImagePath, in
 */
 cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY);
 
-/** Create a surface from any image, at a given size. If the image is given by its sole name, it is searched inside the current theme root folder.
+/** Like \ref cairo_dock_create_surface_from_image, with a given device scale. In OpenGL mode, the screen is then not queried, so it can be called from a worker thread.
+*@param fDeviceScale device scale of the surface (see \ref cairo_dock_get_device_scale), or 0 to use the one of the screen.
+*/
+cairo_surface_t *cairo_dock_create_surface_from_image_full (const gchar *cImagePath, double fMaxScale, int iWidthConstraint, int iHeightConstraint, CairoDockLoadImageModifier iLoadingModifier, double *fImageWidth, double *fImageHeight, double *fZoomX, double *fZoomY, double fDeviceScale);
+
+/** Create a surface from any image, at a given size. If the image is given by its sole name, it is searched inside the current theme root folder. The image is decoded only once for a given size, see \ref cairo_dock_image_cache_create_surface.
 *@param cImageFile path or name of an image.
 *@param fImageWidth the desired surface width.
 *@param fImageHeight the desired surface height.
@@ -143,7 +153,7 @@ cairo_surface_t *cairo_dock_create_surface_from_image (const gchar *cImagePath,
 */
 cairo_surface_t *cairo_dock_create_surface_from_image_simple (const gchar *cImageFile, double fImageWidth, double fImageHeight);
 
-/** Create a surface from any image, at a given size. If the image is given by its sole name, it is searched inside the icons themes known by Cairo-Dock. 
+/** Create a surface from any image, at a given size. If the image is given by its sole name, it is searched inside the icons themes known by Cairo-Dock. The image is decoded only once for a given size, see \ref cairo_dock_image_cache_create_surface.
 *@param cImagePath path or name of an image.
 *@param fImageWidth the desired surface width.
 *@param fImageHeight the desired surface height.
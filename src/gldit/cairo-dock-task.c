@@ -23,184 +23,325 @@
 #include "cairo-dock-log.h"
 #include "cairo-dock-task.h"
 
+/* Asynchronous jobs are run by a shared, bounded pool of worker threads.
+ * When a job is done, it is pushed in a completion queue, which is drained by a GSource in the main loop that performs the 'update'.
+ * Periodic iterations are kept in a queue sorted by due time, served by a single timer armed for the earliest one.
+ * Coalesced iterations may be postponed by up to a slack window, to join a wake-up that is already planned or to fall on the shared 1s grid; this way tasks with compatible periods wake the dock up together.
+ */
+
+struct _GldiTaskJob {
+	GldiTask *pTask;
+	gboolean bCancelled;  // the job has been stopped; its result must be ignored (protected by s_jobMutex)
+	gboolean bInThread;  // 'get_data' is being executed (protected by s_jobMutex)
+};
+
+static GThreadPool *s_pWorkerPool = NULL;
+static GAsyncQueue *s_pCompletedJobs = NULL;
+static GMutex s_jobMutex;
+static GCond s_jobCond;  // signaled when a job leaves a worker
+
+static GList *s_pScheduledTasks = NULL;  // sorted by iNextIterationTime
+static guint s_iSidScheduler = 0;
+static gint64 s_iSchedulerTime = 0;  // time at which the timer will fire
+
+#define GLDI_TASK_SLACK 1000  // ms a coalesced task can be delayed by to share a wake-up with other tasks
+
+static void _schedule_task (GldiTask *pTask, gint64 iTime, gboolean bOneShot);
+static void _unschedule_task (GldiTask *pTask);
+
+#define _get_timer_period(pTask) (pTask->iTimerPeriod != 0 ? pTask->iTimerPeriod : pTask->iPeriod)
+
 #define _schedule_next_iteration(pTask) do {\
 	if (pTask->iSidTimer == 0 && pTask->iPeriod)\
-		pTask->iSidTimer = g_timeout_add_seconds (pTask->iPeriod, (GSourceFunc) _launch_task_timer, pTask); } while (0)
+		_schedule_task (pTask, g_get_monotonic_time () + (gint64)_get_timer_period (pTask) * G_USEC_PER_SEC, FALSE); } while (0)
 
-#define _cancel_next_iteration(pTask) do {\
-	if (pTask->iSidTimer != 0) {\
-		g_source_remove (pTask->iSidTimer);\
-		pTask->iSidTimer = 0; } } while (0)
+#define _cancel_next_iteration(pTask) _unschedule_task (pTask)
 
 #define _set_elapsed_time(pTask) do {\
 	pTask->fElapsedTime = g_timer_elapsed (pTask->pClock, NULL);\
 	g_timer_start (pTask->pClock); } while (0)
 
-static void _free_task (GldiTask *pTask)
+static void _unref_task (GldiTask *pTask)
 {
-	if (pTask->free_data)
-		pTask->free_data (pTask->pSharedMemory);
-	g_timer_destroy (pTask->pClock);
-	g_mutex_clear (&pTask->mutex);
-	if (pTask->iPeriod) g_cond_clear (&pTask->cond);
-	if (pTask->pThread) g_thread_unref (pTask->pThread);
-	g_free (pTask);
+	pTask->iRef --;
+	if (pTask->iRef == 0)
+	{
+		g_timer_destroy (pTask->pClock);
+		g_free (pTask);
+	}
 }
 
-static gboolean _launch_task_timer (GldiTask *pTask)
+static void _free_task (GldiTask *pTask)  // release the owner's reference; the memory is freed when no job refers to the task anymore.
 {
-	gldi_task_launch (pTask);
-	return TRUE;
+	_cancel_next_iteration (pTask);
+	if (pTask->free_data)
+		pTask->free_data (pTask->pSharedMemory);
+	pTask->free_data = NULL;
+	pTask->bReleased = TRUE;
+	_unref_task (pTask);
 }
-static gboolean _check_for_update_idle (GldiTask *pTask)
+
+  //////////////////
+ /// SCHEDULING ///
+//////////////////
+
+static gboolean _on_scheduler_timer (gpointer data);
+
+static void _arm_scheduler (void)
 {
-	// process the data (we don't need to wait that the thread is over, so do it now, it will let more time for the thread to finish, and therefore often save a 'usleep').
-	if (pTask->bNeedsUpdate)  // data are ready to be processed -> perform the update
+	if (s_pScheduledTasks == NULL)
 	{
-		if (! pTask->bDiscard)  // of course if the task has been discarded before, don't do anything.
+		if (s_iSidScheduler != 0)
 		{
-			pTask->bContinue = pTask->update (pTask->pSharedMemory);
+			g_source_remove (s_iSidScheduler);
+			s_iSidScheduler = 0;
 		}
-		pTask->bNeedsUpdate = FALSE;  // now update is done, we won't do it any more until the next iteration, even is we loop on this function.
+		return;
 	}
+	GldiTask *pFirstTask = s_pScheduledTasks->data;
+	if (s_iSidScheduler != 0 && s_iSchedulerTime == pFirstTask->iNextIterationTime)
+		return;  // already armed for it
 	
-	// finish the iteration, and possibly schedule the next one (the thread must be finished for this part).
-	if (g_mutex_trylock (&pTask->mutex))  // if the thread is over
+	if (s_iSidScheduler != 0)
+		g_source_remove (s_iSidScheduler);
+	gint64 iDelay = pFirstTask->iNextIterationTime - g_get_monotonic_time ();
+	s_iSchedulerTime = pFirstTask->iNextIterationTime;
+	s_iSidScheduler = g_timeout_add (iDelay > 0 ? (iDelay + 999) / 1000 : 0, _on_scheduler_timer, NULL);
+}
+
+static gint _compare_next_iteration (gconstpointer a, gconstpointer b)
+{
+	const GldiTask *t1 = a, *t2 = b;
+	return (t1->iNextIterationTime < t2->iNextIterationTime ? -1 : t1->iNextIterationTime > t2->iNextIterationTime ? 1 : 0);
+}
+
+// the task must not be in the queue.
+static gint64 _coalesce_iteration_time (GldiTask *pTask, gint64 iTime)
+{
+	if (pTask->iSchedulingMode != GLDI_TASK_SCHEDULE_COALESCED)
+		return iTime;
+	gint64 iSlack = MIN ((gint64)GLDI_TASK_SLACK * 1000, (gint64)_get_timer_period (pTask) * G_USEC_PER_SEC / 2);
+	
+	// join the first wake-up already planned inside the slack window.
+	GList *t;
+	for (t = s_pScheduledTasks; t != NULL; t = t->next)
 	{
-		if (pTask->bDiscard)  // if the task has been discarded, it's the end of the journey for it.
-		{
-			if (pTask->iPeriod)
-			{
-				pTask->bRunThread = TRUE;
-				g_cond_signal (&pTask->cond);
-				g_mutex_unlock (&pTask->mutex);
-				g_thread_join (pTask->pThread); // unref the thread
-				pTask->pThread = NULL;
-			}
-			else g_mutex_unlock (&pTask->mutex);
-
-			_free_task (pTask);
-			return FALSE;
-		}
-		
-		if (! pTask->iPeriod)  // one-shot thread => the thread is over
+		GldiTask *pOtherTask = t->data;
+		if (pOtherTask->iNextIterationTime < iTime)
+			continue;
+		if (pOtherTask->iNextIterationTime <= iTime + iSlack)
+			return pOtherTask->iNextIterationTime;
+		break;
+	}
+	
+	// otherwise fall on the shared grid, so that the next iterations of tasks with compatible periods meet there.
+	gint64 iGridTime = (iTime + G_USEC_PER_SEC - 1) / G_USEC_PER_SEC * G_USEC_PER_SEC;
+	return (iGridTime - iTime <= iSlack ? iGridTime : iTime);
+}
+
+static void _schedule_task (GldiTask *pTask, gint64 iTime, gboolean bOneShot)
+{
+	if (pTask->iSidTimer != 0)
+		s_pScheduledTasks = g_list_remove (s_pScheduledTasks, pTask);
+	pTask->iNominalIterationTime = iTime;
+	pTask->iNextIterationTime = (bOneShot ? iTime : _coalesce_iteration_time (pTask, iTime));  // a delayed launch is expected on time
+	pTask->bOneShot = bOneShot;
+	pTask->iSidTimer = 1;
+	s_pScheduledTasks = g_list_insert_sorted (s_pScheduledTasks, pTask, _compare_next_iteration);
+	_arm_scheduler ();
+}
+
+static void _unschedule_task (GldiTask *pTask)
+{
+	if (pTask->iSidTimer == 0)
+		return;
+	pTask->iSidTimer = 0;
+	s_pScheduledTasks = g_list_remove (s_pScheduledTasks, pTask);
+	_arm_scheduler ();
+}
+
+static gboolean _on_scheduler_timer (G_GNUC_UNUSED gpointer data)
+{
+	s_iSidScheduler = 0;
+	gint64 iNow = g_get_monotonic_time ();
+	
+	// collect the due tasks and schedule their next iteration first, since launching a task can modify the queue.
+	GList *pDueTasks = NULL;
+	while (s_pScheduledTasks != NULL)
+	{
+		GldiTask *pTask = s_pScheduledTasks->data;
+		if (pTask->iNextIterationTime > iNow + 1000)  // 1ms tolerance
+			break;
+		s_pScheduledTasks = g_list_delete_link (s_pScheduledTasks, s_pScheduledTasks);
+		pTask->iSidTimer = 0;
+		if (! pTask->bOneShot && pTask->iPeriod)  // periodic timer: keep the pace, whether this iteration can run or not.
 		{
-			if (pTask->pThread)
-			{
-				g_thread_unref (pTask->pThread);
-				pTask->pThread = NULL;
-			}
+			gint64 iPeriod = (gint64)_get_timer_period (pTask) * G_USEC_PER_SEC;
+			gint64 iNext = pTask->iNominalIterationTime + iPeriod;
+			if (iNext <= iNow)
+				iNext = iNow + iPeriod;
+			pTask->iNominalIterationTime = iNext;
+			pTask->iNextIterationTime = _coalesce_iteration_time (pTask, iNext);
+			pTask->iSidTimer = 1;
+			s_pScheduledTasks = g_list_insert_sorted (s_pScheduledTasks, pTask, _compare_next_iteration);
 		}
+		pTask->iRef ++;  // keep it alive until we launch it
+		pDueTasks = g_list_prepend (pDueTasks, pTask);
+	}
+	_arm_scheduler ();
+	
+	GList *t;
+	pDueTasks = g_list_reverse (pDueTasks);
+	for (t = pDueTasks; t != NULL; t = t->next)
+	{
+		GldiTask *pTask = t->data;
+		if (! pTask->bReleased)
+			gldi_task_launch (pTask);
+		_unref_task (pTask);
+	}
+	g_list_free (pDueTasks);
+	return G_SOURCE_REMOVE;
+}
+
+  ///////////////
+ /// WORKERS ///
+///////////////
+
+static void _finish_iteration (GldiTask *pTask)
+{
+	if (! pTask->bContinue)
+	{
+		_cancel_next_iteration (pTask);
+	}
+	else
+	{
+		pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
+		_schedule_next_iteration (pTask);
+	}
+}
+
+static void _complete_job (GldiTaskJob *pJob)
+{
+	GldiTask *pTask = pJob->pTask;
+	if (! pJob->bCancelled)  // no need to lock, the job can't be cancelled anymore once it left the worker, since it's the main thread that cancels.
+	{
+		pTask->pJob = NULL;
+		if (! pTask->bDiscard)  // of course if the task has been discarded before, don't do anything.
+			pTask->bContinue = pTask->update (pTask->pSharedMemory);
 		
-		pTask->iSidUpdateIdle = 0;  // set it before the unlock, as it is accessed in the thread part
-		g_mutex_unlock (&pTask->mutex);
-		
-		// schedule the next iteration if necessary.
-		if (! pTask->bContinue)
-		{
-			_cancel_next_iteration (pTask);
-		}
-		else
+		if (! pTask->bReleased)  // the update may have freed the task
 		{
-			pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
-			_schedule_next_iteration (pTask);
+			pTask->bIsRunning = FALSE;
+			if (pTask->bDiscard)  // the task has been discarded before or during the update, it's the end of the journey for it.
+				_free_task (pTask);
+			else
+				_finish_iteration (pTask);
 		}
-		pTask->bIsRunning = FALSE;
-		return FALSE;  // the update is now finished, quit.
 	}
-	
-	// if the thread is not yet over, come back in 1ms.
-	g_usleep (1);  // we don't want to block the main loop until the thread is over; so just sleep 1ms to give it a chance to terminate. so it's a kind of 'sched_yield()' without blocking the main loop.
-	return TRUE;
+	g_free (pJob);
+	_unref_task (pTask);
 }
-static gpointer _get_data_threaded (GldiTask *pTask)
+
+static void _run_job (GldiTaskJob *pJob, G_GNUC_UNUSED gpointer data)
 {
-	g_mutex_lock (&pTask->mutex);
-	_run_thread:  // at this point the mutex is locked, either by the first execution of this function, or by 'g_cond_wait'
-	
-	//\_______________________ get the data
-	_set_elapsed_time (pTask);
-	pTask->get_data (pTask->pSharedMemory);
+	g_mutex_lock (&s_jobMutex);
+	gboolean bCancelled = pJob->bCancelled;
+	pJob->bInThread = ! bCancelled;
+	g_mutex_unlock (&s_jobMutex);
 	
-	// and signal that data are ready to be processed.
-	pTask->bNeedsUpdate = TRUE;  // this is only accessed by the update fonction, which is triggered just after, so no need to protect this variable.
-	
-	//\_______________________ call the update function from the main loop
-	if (pTask->iSidUpdateIdle == 0)
-		pTask->iSidUpdateIdle = g_idle_add ((GSourceFunc) _check_for_update_idle, pTask);  // note that 'iSidUpdateIdle' can actually be set after the 'update' is called. that's why the 'update' have to wait for the mutex to finish its job.
+	if (! bCancelled)
+	{
+		GldiTask *pTask = pJob->pTask;
+		pTask->get_data (pTask->pSharedMemory);
+		
+		g_mutex_lock (&s_jobMutex);
+		pJob->bInThread = FALSE;
+		g_cond_broadcast (&s_jobCond);
+		g_mutex_unlock (&s_jobMutex);
+	}
 	
-	// sleep until the next iteration or just leave.
-	if (pTask->iPeriod)  // periodic task -> block until the condition becomes TRUE again.
+	// hand the result over to the main loop (cancelled jobs too, so that they are freed there).
+	g_async_queue_push (s_pCompletedJobs, pJob);
+	g_main_context_wakeup (NULL);
+}
+
+static gboolean _completion_prepare (G_GNUC_UNUSED GSource *pSource, gint *iTimeout)
+{
+	*iTimeout = -1;
+	return (g_async_queue_length (s_pCompletedJobs) > 0);
+}
+static gboolean _completion_check (G_GNUC_UNUSED GSource *pSource)
+{
+	return (g_async_queue_length (s_pCompletedJobs) > 0);
+}
+static gboolean _completion_dispatch (G_GNUC_UNUSED GSource *pSource, G_GNUC_UNUSED GSourceFunc callback, G_GNUC_UNUSED gpointer data)
+{
+	GldiTaskJob *pJob;
+	while ((pJob = g_async_queue_try_pop (s_pCompletedJobs)) != NULL)
+		_complete_job (pJob);
+	return G_SOURCE_CONTINUE;
+}
+static GSourceFuncs s_completionFuncs = {_completion_prepare, _completion_check, _completion_dispatch, NULL, NULL, NULL};
+
+static GThreadPool *_get_worker_pool (void)
+{
+	if (s_pWorkerPool == NULL)
 	{
-		pTask->bRunThread = FALSE;
-		while (! pTask->bRunThread)
-			g_cond_wait (&pTask->cond, &pTask->mutex);  // releases the mutex, then takes it again when awakening.
-		if (g_atomic_int_get (&pTask->bDiscard) == 0)
-			goto _run_thread;
+		// enough threads to keep the CPUs busy, and some more since many jobs are blocked on the network or on a file.
+		gint iNbThreads = CLAMP (2 * (gint)g_get_num_processors (), 4, 16);
+		GError *erreur = NULL;
+		s_pWorkerPool = g_thread_pool_new ((GFunc) _run_job, NULL, iNbThreads, FALSE, &erreur);
+		if (erreur != NULL)
+		{
+			cd_warning (erreur->message);
+			g_error_free (erreur);
+			return NULL;
+		}
+		s_pCompletedJobs = g_async_queue_new ();
+		GSource *pSource = g_source_new (&s_completionFuncs, sizeof (GSource));
+		g_source_set_priority (pSource, G_PRIORITY_DEFAULT_IDLE);  // like the idle used before, don't delay drawing and events.
+		g_source_attach (pSource, NULL);
+		g_source_unref (pSource);
 	}
-	g_mutex_unlock (&pTask->mutex);
-	g_thread_exit (NULL);
-	return NULL;
+	return s_pWorkerPool;
 }
+
 void gldi_task_launch (GldiTask *pTask)
 {
 	g_return_if_fail (pTask != NULL);
+	if (pTask->iSidTimer == 0)  // not an iteration planned by the scheduler, so the task is (re)launched: it restarts at its normal frequency.
+	{
+		pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
+		pTask->iTimerPeriod = pTask->iPeriod;
+	}
 	if (pTask->get_data == NULL)  // no asynchronous work -> just call the 'update' and directly schedule the next iteration
 	{
 		_set_elapsed_time (pTask);
+		pTask->iRef ++;  // the update may free the task
 		pTask->bContinue = pTask->update (pTask->pSharedMemory);
-		if (! pTask->bContinue)
-		{
-			_cancel_next_iteration (pTask);
-		}
-		else
-		{
-			pTask->iFrequencyState = GLDI_TASK_FREQUENCY_NORMAL;
-			_schedule_next_iteration (pTask);
-		}
+		if (! pTask->bReleased)
+			_finish_iteration (pTask);
+		_unref_task (pTask);
 	}
-	else  // launch the asynchronous work in a thread
+	else if (! pTask->bIsRunning)  // launch the asynchronous work in a worker; if it's already running or has a pending update, skip this iteration.
 	{
-		if (pTask->pThread == NULL)  // no thread yet -> create and launch it
-		{
-			pTask->bIsRunning = TRUE;
-			GError *erreur = NULL;
-			pTask->pThread = g_thread_try_new ("Cairo-Dock Task", (GThreadFunc) _get_data_threaded, pTask, &erreur);
-			if (erreur != NULL)  // on n'a pas pu lancer le thread.
-			{
-				cd_warning (erreur->message);
-				g_error_free (erreur);
-				pTask->bIsRunning = FALSE;
-			}
-		}
-		else  // thread already exists; it's either running or sleeping or finished with a pending update
-		if (pTask->iPeriod && g_mutex_trylock (&pTask->mutex))  // it's a periodic thread, and it's not currently running...
-		{
-			if (pTask->iSidUpdateIdle == 0)  // ...and it doesn't have a pending update -> awake it and run it again.
-			{
-				pTask->bRunThread = TRUE;
-				pTask->bIsRunning = TRUE;
-				g_cond_signal (&pTask->cond);
-			}
-			g_mutex_unlock (&pTask->mutex);
-		}  // else it's a one-shot thread or it's currently running or has a pending update -> don't launch it. so if the task is periodic, it will skip this iteration.
+		GThreadPool *pPool = _get_worker_pool ();
+		if (pPool == NULL)
+			return;
+		_set_elapsed_time (pTask);
+		GldiTaskJob *pJob = g_new0 (GldiTaskJob, 1);
+		pJob->pTask = pTask;
+		pTask->pJob = pJob;
+		pTask->iRef ++;  // the job holds a reference until it's completed
+		pTask->bIsRunning = TRUE;
+		g_thread_pool_push (pPool, pJob, NULL);
 	}
 }
 
 
-static gboolean _one_shot_timer (GldiTask *pTask)
-{
-	pTask->iSidTimer = 0;
-	gldi_task_launch (pTask);
-	return FALSE;
-}
 void gldi_task_launch_delayed (GldiTask *pTask, guint delay)
 {
-	_cancel_next_iteration (pTask);
-	if (delay == 0)
-		pTask->iSidTimer = g_idle_add ((GSourceFunc) _one_shot_timer, pTask);
-	else
-		pTask->iSidTimer = g_timeout_add (delay, (GSourceFunc) _one_shot_timer, pTask);
+	_schedule_task (pTask, g_get_monotonic_time () + (gint64)delay * 1000, TRUE);
 }
 
 
@@ -213,11 +354,8 @@ GldiTask *gldi_task_new_full (int iPeriod, GldiGetDataAsyncFunc get_data, GldiUp
 	pTask->free_data = free_data;
 	pTask->pSharedMemory = pSharedMemory;
 	pTask->pClock = g_timer_new ();
-	g_mutex_init (&pTask->mutex);
-	if (iPeriod != 0)
-	{
-		g_cond_init (&pTask->cond);
-	}
+	pTask->iRef = 1;
+	pTask->iSchedulingMode = GLDI_TASK_SCHEDULE_EXACT;  // coalescing changes the timing of the iterations, so tasks have to opt in for it
 	return pTask;
 }
 
@@ -229,44 +367,19 @@ void gldi_task_stop (GldiTask *pTask)
 	
 	_cancel_next_iteration (pTask);
 	
-	if (gldi_task_is_running (pTask))
+	GldiTaskJob *pJob = pTask->pJob;
+	if (pJob != NULL)  // the job is queued, running, or waiting for its update.
 	{
-		if (pTask->pThread)
-		{
-			g_atomic_int_set (&pTask->bDiscard, 1);  // set the discard flag to help the 'get_data' callback knows that it should stop.
-			if (pTask->iPeriod)  // the thread might be sleeping, awake it.
-			{
-				if (g_mutex_trylock (&pTask->mutex))
-				{
-					pTask->bRunThread = TRUE;
-					g_cond_signal (&pTask->cond);
-					g_mutex_unlock (&pTask->mutex);
-				}
-			}
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
-			g_atomic_int_set (&pTask->bDiscard, 0);
-		}
-		if (pTask->iSidUpdateIdle != 0)  // do it after the thread has possibly scheduled the 'update'
-		{
-			g_source_remove (pTask->iSidUpdateIdle);
-			pTask->iSidUpdateIdle = 0;
-		}
-		pTask->bIsRunning = FALSE;  // since we didn't go through the 'update'
-	}
-	else
-	{
-		if (pTask->pThread && pTask->iPeriod && g_mutex_trylock (&pTask->mutex))  // the thread is sleeping, awake it and let it exit.
-		{
-			g_atomic_int_set (&pTask->bDiscard, 1);
-			pTask->bRunThread = TRUE;
-			g_cond_signal (&pTask->cond);
-			g_mutex_unlock (&pTask->mutex);
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
-			g_atomic_int_set (&pTask->bDiscard, 0);
-		}
+		g_atomic_int_set (&pTask->bDiscard, 1);  // set the discard flag to help the 'get_data' callback knows that it should stop.
+		g_mutex_lock (&s_jobMutex);
+		pJob->bCancelled = TRUE;  // if it's still queued, it won't run; in any case its update will be skipped.
+		while (pJob->bInThread)  // wait for 'get_data' to finish, since it uses the shared memory.
+			g_cond_wait (&s_jobCond, &s_jobMutex);
+		g_mutex_unlock (&s_jobMutex);
+		g_atomic_int_set (&pTask->bDiscard, 0);
+		pTask->pJob = NULL;  // the job will be freed when it reaches the completion queue.
 	}
+	pTask->bIsRunning = FALSE;  // since we don't go through the 'update'
 }
 
 
@@ -280,19 +393,10 @@ void gldi_task_discard (GldiTask *pTask)
 	g_atomic_int_set (&pTask->bDiscard, 1);
 	
 	// if the task is running, there is nothing to do:
-	//   if we're inside the thread, it will trigger the 'update' anyway, which will destroy the task.
-	//   if we're waiting for the 'update', same as above
-	//   if we're inside the 'update' user callback, the task will be destroyed in the 2nd stage of the function (the user callback is called in the 1st stage).
+	//   if we're inside the worker or waiting for the 'update', the completion will free the task.
+	//   if we're inside the 'update' user callback, the task will be destroyed just after the callback.
 	if (! gldi_task_is_running (pTask))  // we can free the task immediately.
 	{
-		if (pTask->pThread && pTask->iPeriod && g_mutex_trylock (&pTask->mutex))  // the thread is sleeping, awake it and let it exit before we can free everything
-		{
-			pTask->bRunThread = TRUE;
-			g_cond_signal (&pTask->cond);
-			g_mutex_unlock (&pTask->mutex);
-			g_thread_join (pTask->pThread);  // unref the thread
-			pTask->pThread = NULL;
-		}
 		_free_task (pTask);
 	}
 }
@@ -321,8 +425,9 @@ static void _restart_timer_with_frequency (GldiTask *pTask, int iNewPeriod)
 	gboolean bNeedsRestart = (pTask->iSidTimer != 0);
 	_cancel_next_iteration (pTask);
 	
+	pTask->iTimerPeriod = iNewPeriod;
 	if (bNeedsRestart && iNewPeriod != 0)
-		pTask->iSidTimer = g_timeout_add_seconds (iNewPeriod, (GSourceFunc) _launch_task_timer, pTask);
+		_schedule_task (pTask, g_get_monotonic_time () + (gint64)_get_timer_period (pTask) * G_USEC_PER_SEC, FALSE);
 }
 
 void gldi_task_change_frequency (GldiTask *pTask, int iNewPeriod)
@@ -376,3 +481,13 @@ void gldi_task_set_normal_frequency (GldiTask *pTask)
 		_restart_timer_with_frequency (pTask, pTask->iPeriod);
 	}
 }
+
+void gldi_task_set_scheduling_mode (GldiTask *pTask, GldiTaskSchedulingMode iMode)
+{
+	g_return_if_fail (pTask != NULL && iMode < GLDI_TASK_NB_SCHEDULE_MODES);
+	if (pTask->iSchedulingMode == iMode)
+		return;
+	pTask->iSchedulingMode = iMode;
+	if (pTask->iSidTimer != 0 && ! pTask->bOneShot)  // re-align the pending iteration with the new mode
+		_schedule_task (pTask, pTask->iNominalIterationTime, FALSE);
+}
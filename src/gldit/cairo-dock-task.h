@@ -27,7 +27,7 @@ G_BEGIN_DECLS
 *@file cairo-dock-task.h An easy way to define periodic and asynchronous tasks, that can perform heavy jobs without blocking the dock.
  *
  *  A Task is divided in 2 phases : 
- * - the asynchronous phase will be executed in another thread, while the dock continues to run on its own thread, in parallel. During this phase you will do all the heavy job (like downloading a file or computing something) but you can't interact on the dock.
+ * - the asynchronous phase will be executed in a thread of a shared worker pool, while the dock continues to run on its own thread, in parallel. During this phase you will do all the heavy job (like downloading a file or computing something) but you can't interact on the dock.
  * - the synchronous phase will be executed after the first one has finished. There you will update your applet with the result of the first phase.
  * 
  * \attention A data buffer is used to communicate between the 2 phases. It is important that these datas are never accessed outside the task, and vice versa that the asynchronous thread never accesses other data than this buffer.\n
@@ -48,16 +48,27 @@ typedef enum {
 	GLDI_TASK_NB_FREQUENCIES
 } GldiTaskFrequencyState;
 
+/// Scheduling policy of a periodic Task.
+typedef enum {
+	/// each iteration runs at its own due time. This is the default.
+	GLDI_TASK_SCHEDULE_EXACT = 0,
+	/// an iteration may be delayed by up to 1s (and half its period) so that it shares a wake-up with other Tasks. Tasks have to opt in for it.
+	GLDI_TASK_SCHEDULE_COALESCED,
+	GLDI_TASK_NB_SCHEDULE_MODES
+} GldiTaskSchedulingMode;
+
 /// Definition of the asynchronous job, that does the heavy part.
 typedef void (* GldiGetDataAsyncFunc ) (gpointer pSharedMemory);
 /// Definition of the synchronous job, that update the dock with the results of the previous job. Returns TRUE to continue, FALSE to stop
 typedef gboolean (* GldiUpdateSyncFunc ) (gpointer pSharedMemory);
 
+typedef struct _GldiTaskJob GldiTaskJob;
+
 /// Definition of a periodic and/or asynchronous Task.
 struct _GldiTask {
-	// ID of the timer of the Task (if periodic)
+	// non-zero while the next iteration of the Task is scheduled
 	gint iSidTimer;
-	// TRUE if the thread is running or about to run or if the update is pending
+	// TRUE if the job is running or about to run or if the update is pending
 	gboolean bIsRunning;
 	// function carrying out the heavy job.
 	GldiGetDataAsyncFunc get_data;
@@ -73,19 +84,19 @@ struct _GldiTask {
 	double fElapsedTime;
 	// function called when the task is destroyed to free the shared memory (optional).
 	GFreeFunc free_data;
-	// below are the parameters accessed inside the thread => only between mutex lock/unlock
 	/// structure passed as parameter of the 'get_data' and 'update' functions. Must not be accessed outside of these 2 functions !
 	gpointer pSharedMemory;
-	// ID of the idle source to perform the update.
-	gint iSidUpdateIdle;
-	/// TRUE when the task has been discarded.
+	/// TRUE when the task has been discarded (or is being stopped); 'get_data' can poll it to abort a long job.
 	gboolean bDiscard;
-	gboolean bNeedsUpdate;  // TRUE when new data are waiting to be processed.
 	gboolean bContinue;  // result of the 'update' function (TRUE -> continue, FALSE -> stop, if the task is periodic).
-	GThread *pThread;  // the thread that execute the asynchronous 'get_data' callback
-	GCond cond;  // condition to awake the thread (if periodic). Only used if iPeriod > 0
-	gboolean bRunThread;  // condition value: whether to run the thread or exit.
-	GMutex mutex;  // mutex associated with the condition. Always initialized when creating a task.
+	GldiTaskJob *pJob;  // the current execution of 'get_data' in the worker pool, if any
+	gint iRef;  // one reference for the owner, plus one for each job in flight
+	gboolean bReleased;  // TRUE when the owner has released the task
+	guint iTimerPeriod;  // period (in s) between 2 scheduled iterations; differs from iPeriod when the frequency is downgraded
+	gint64 iNextIterationTime;  // monotonic time (in us) of the next scheduled iteration
+	gboolean bOneShot;  // TRUE if the scheduled iteration is a delayed launch rather than a periodic one
+	GldiTaskSchedulingMode iSchedulingMode;  // how the iterations are aligned with the other tasks
+	gint64 iNominalIterationTime;  // due time of the next iteration before coalescing, so that the alignment doesn't drift
 } ;
 
 
@@ -140,7 +151,7 @@ void gldi_task_free (GldiTask *pTask);
 */
 gboolean gldi_task_is_active (GldiTask *pTask);
 
-/** Tell if a Task is running, that is to say it is either in the thread or waiting for the update.
+/** Tell if a Task is running, that is to say it is either waiting for a worker, in a worker or waiting for the update.
 *@param pTask the periodic Task.
 *@return TRUE if the Task is running.
 */
@@ -166,6 +177,12 @@ void gldi_task_downgrade_frequency (GldiTask *pTask);
 */
 void gldi_task_set_normal_frequency (GldiTask *pTask);
 
+/** Set how the periodic iterations of a Task are scheduled. By default, they run on time; use GLDI_TASK_SCHEDULE_COALESCED for a Task that can be delayed a little (like a Task polling some data for display).
+*@param pTask the periodic Task.
+*@param iMode the new scheduling mode.
+*/
+void gldi_task_set_scheduling_mode (GldiTask *pTask, GldiTaskSchedulingMode iMode);
+
 /** Get the time elapsed since the last time the Task has run.
 *@param pTask the periodic Task.
 */
@@ -0,0 +1,344 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <errno.h>
+#include <glib/gstdio.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-theme-snapshot.h"
+
+// dependencies
+extern gchar *g_cCairoDockDataDir;
+
+// private
+#define CD_SNAPSHOT_MAGIC "CDTHEME"  // 7 chars + '\0'
+#define CD_SNAPSHOT_VERSION 1  // to be increased each time the format changes.
+#define CD_KEY_FILE_FLAGS (G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS)  // same as cairo_dock_open_key_file()
+
+typedef struct {
+	gchar cMagic[8];
+	guint32 iVersion;  // also rejects a snapshot written by a machine of another endianness
+	guint32 iNbEntries;
+	} CairoDockSnapshotHeader;
+
+typedef struct {
+	guint32 iPathOffset, iPathLength;  // the path is followed by a '\0'
+	guint32 iDataOffset, iDataLength;
+	gint64 iModificationTime;
+	guint64 iSize;
+	guint32 iHash;  // of the data, to detect a corrupted snapshot
+	guint32 iPadding;
+	} CairoDockSnapshotEntry;
+
+typedef struct {
+	gint64 iModificationTime;
+	guint64 iSize;
+	const gchar *pData;  // either inside the mapped snapshot, or pOwnedData
+	gsize iLength;
+	gchar *pOwnedData;
+	} CairoDockSnapshotFile;
+
+static gboolean s_bEnabled = FALSE;
+static gboolean s_bActive = FALSE;
+static GMutex s_mutex;  // conf files are read from several threads (see gldi_user_icons_new_from_directory)
+static GMappedFile *s_pMappedFile = NULL;
+static GHashTable *s_hEntries = NULL;  // path -> entry of the mapped snapshot
+static GHashTable *s_hFiles = NULL;  // path -> CairoDockSnapshotFile, content of the next snapshot
+static gboolean s_bChanged = FALSE;
+static guint s_iNbHits = 0, s_iNbMisses = 0;
+
+
+static guint32 _hash_data (const gchar *pData, gsize iLength)  // FNV-1a
+{
+	guint32 h = 2166136261u;
+	gsize i;
+	for (i = 0; i < iLength; i ++)
+	{
+		h ^= (guchar)pData[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+
+static void _free_file (CairoDockSnapshotFile *pFile)
+{
+	g_free (pFile->pOwnedData);
+	g_free (pFile);
+}
+
+static gchar *_get_snapshot_path (void)
+{
+	return g_strdup_printf ("%s/%s", g_cCairoDockDataDir, CAIRO_DOCK_THEME_SNAPSHOT_FILE);
+}
+
+static void _map_snapshot (void)
+{
+	gchar *cSnapshotPath = _get_snapshot_path ();
+	GError *erreur = NULL;
+	s_pMappedFile = g_mapped_file_new (cSnapshotPath, FALSE, &erreur);
+	g_free (cSnapshotPath);
+	if (erreur != NULL)
+	{
+		cd_debug ("no theme snapshot (%s)", erreur->message);
+		g_error_free (erreur);
+		s_pMappedFile = NULL;
+		s_bChanged = TRUE;
+		return;
+	}
+	
+	//\_______________ check the header.
+	gsize iSize = g_mapped_file_get_length (s_pMappedFile);
+	const gchar *pContents = g_mapped_file_get_contents (s_pMappedFile);
+	const CairoDockSnapshotHeader *pHeader = (const CairoDockSnapshotHeader *)pContents;
+	if (iSize < sizeof (CairoDockSnapshotHeader)
+	|| memcmp (pHeader->cMagic, CD_SNAPSHOT_MAGIC, sizeof (pHeader->cMagic)) != 0
+	|| pHeader->iVersion != CD_SNAPSHOT_VERSION
+	|| pHeader->iNbEntries > (iSize - sizeof (CairoDockSnapshotHeader)) / sizeof (CairoDockSnapshotEntry))
+		goto invalid;
+	
+	//\_______________ index the entries.
+	const CairoDockSnapshotEntry *pEntries = (const CairoDockSnapshotEntry *)(pContents + sizeof (CairoDockSnapshotHeader));
+	const CairoDockSnapshotEntry *e;
+	guint i;
+	for (i = 0; i < pHeader->iNbEntries; i ++)
+	{
+		e = &pEntries[i];
+		if ((guint64)e->iPathOffset + e->iPathLength >= iSize  // room for the '\0'
+		|| pContents[e->iPathOffset + e->iPathLength] != '\0'
+		|| (guint64)e->iDataOffset + e->iDataLength > iSize)
+			goto invalid;
+		g_hash_table_insert (s_hEntries, (gpointer)(pContents + e->iPathOffset), (gpointer)e);
+	}
+	cd_debug ("theme snapshot: %d conf files", pHeader->iNbEntries);
+	return;
+	
+invalid:
+	cd_warning ("the theme snapshot is invalid, it will be rewritten");
+	g_hash_table_remove_all (s_hEntries);
+	g_mapped_file_unref (s_pMappedFile);
+	s_pMappedFile = NULL;
+	s_bChanged = TRUE;
+}
+
+static void _write_snapshot (void)
+{
+	guint n = g_hash_table_size (s_hFiles);
+	gsize iHeaderSize = sizeof (CairoDockSnapshotHeader) + n * sizeof (CairoDockSnapshotEntry);
+	CairoDockSnapshotEntry *pEntries = g_new0 (CairoDockSnapshotEntry, n);
+	GByteArray *pBuffer = g_byte_array_new ();
+	g_byte_array_set_size (pBuffer, iHeaderSize);  // the header and the entries are written at the end.
+	
+	//\_______________ write the paths and the data, and fill the entries.
+	GHashTableIter iter;
+	gpointer key, value;
+	const gchar *cPath;
+	CairoDockSnapshotFile *pFile;
+	CairoDockSnapshotEntry *e = pEntries;
+	g_hash_table_iter_init (&iter, s_hFiles);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		cPath = key;
+		pFile = value;
+		e->iPathOffset = pBuffer->len;
+		e->iPathLength = strlen (cPath);
+		g_byte_array_append (pBuffer, (const guint8 *)cPath, e->iPathLength + 1);
+		e->iDataOffset = pBuffer->len;
+		e->iDataLength = pFile->iLength;
+		g_byte_array_append (pBuffer, (const guint8 *)pFile->pData, pFile->iLength);
+		e->iModificationTime = pFile->iModificationTime;
+		e->iSize = pFile->iSize;
+		e->iHash = _hash_data (pFile->pData, pFile->iLength);
+		e ++;
+	}
+	
+	CairoDockSnapshotHeader header;
+	memset (&header, 0, sizeof (header));
+	memcpy (header.cMagic, CD_SNAPSHOT_MAGIC, sizeof (header.cMagic));
+	header.iVersion = CD_SNAPSHOT_VERSION;
+	header.iNbEntries = n;
+	memcpy (pBuffer->data, &header, sizeof (header));
+	memcpy (pBuffer->data + sizeof (header), pEntries, n * sizeof (CairoDockSnapshotEntry));
+	g_free (pEntries);
+	
+	//\_______________ replace the previous snapshot (it's still mapped, so write a new file).
+	gchar *cSnapshotPath = _get_snapshot_path ();
+	GError *erreur = NULL;
+	g_file_set_contents (cSnapshotPath, (const gchar *)pBuffer->data, pBuffer->len, &erreur);
+	if (erreur != NULL)
+	{
+		cd_warning ("couldn't write the theme snapshot %s: %s", cSnapshotPath, erreur->message);
+		g_error_free (erreur);
+	}
+	else
+		cd_debug ("theme snapshot written (%d conf files, %u bytes)", n, pBuffer->len);
+	g_free (cSnapshotPath);
+	g_byte_array_free (pBuffer, TRUE);
+}
+
+
+void gldi_theme_snapshot_enable (gboolean bEnable)
+{
+	s_bEnabled = bEnable;
+}
+
+void gldi_theme_snapshot_begin (void)
+{
+	if (! s_bEnabled || s_bActive)
+		return;
+	s_hEntries = g_hash_table_new (g_str_hash, g_str_equal);
+	s_hFiles = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)_free_file);
+	s_bChanged = FALSE;
+	s_iNbHits = s_iNbMisses = 0;
+	_map_snapshot ();
+	s_bActive = TRUE;
+}
+
+void gldi_theme_snapshot_end (void)
+{
+	if (! s_bActive)
+		return;
+	g_mutex_lock (&s_mutex);
+	s_bActive = FALSE;
+	g_mutex_unlock (&s_mutex);
+	
+	cd_message ("theme snapshot: %d conf files taken from the snapshot, %d read from the disk", s_iNbHits, s_iNbMisses);
+	if (g_hash_table_size (s_hFiles) != g_hash_table_size (s_hEntries))  // some files of the snapshot have not been used (removed launchers, etc)
+		s_bChanged = TRUE;
+	if (s_bChanged)
+		_write_snapshot ();
+	
+	g_hash_table_destroy (s_hFiles);
+	s_hFiles = NULL;
+	g_hash_table_destroy (s_hEntries);
+	s_hEntries = NULL;
+	if (s_pMappedFile != NULL)
+	{
+		g_mapped_file_unref (s_pMappedFile);
+		s_pMappedFile = NULL;
+	}
+}
+
+gboolean gldi_theme_snapshot_is_active (void)
+{
+	return s_bActive;
+}
+
+gboolean gldi_theme_snapshot_load_key_file (GKeyFile *pKeyFile, const gchar *cConfFilePath, GError **erreur)
+{
+	GStatBuf st;
+	if (g_stat (cConfFilePath, &st) != 0)
+	{
+		int iErrno = errno;
+		g_set_error (erreur, G_FILE_ERROR, g_file_error_from_errno (iErrno), "%s: %s", cConfFilePath, g_strerror (iErrno));
+		return FALSE;
+	}
+	
+	//\_______________ take the file from the snapshot if it hasn't changed since.
+	const gchar *pData = NULL;
+	gsize iLength = 0;
+	gchar *pCopy = NULL;
+	g_mutex_lock (&s_mutex);
+	if (s_bActive)
+	{
+		CairoDockSnapshotFile *pFile = g_hash_table_lookup (s_hFiles, cConfFilePath);  // already read since the beginning
+		if (pFile != NULL && pFile->iModificationTime == st.st_mtime && pFile->iSize == (guint64)st.st_size)
+		{
+			if (pFile->pOwnedData != NULL)  // it may be freed by another thread once we release the lock.
+				pData = pCopy = g_memdup2 (pFile->pData, pFile->iLength);
+			else  // the mapped snapshot stays until the end.
+				pData = pFile->pData;
+			iLength = pFile->iLength;
+		}
+		else if (pFile == NULL)
+		{
+			const CairoDockSnapshotEntry *e = g_hash_table_lookup (s_hEntries, cConfFilePath);
+			if (e != NULL && e->iModificationTime == st.st_mtime && e->iSize == (guint64)st.st_size)
+			{
+				const gchar *pContents = g_mapped_file_get_contents (s_pMappedFile);
+				if (_hash_data (pContents + e->iDataOffset, e->iDataLength) == e->iHash)
+				{
+					pFile = g_new0 (CairoDockSnapshotFile, 1);
+					pFile->iModificationTime = e->iModificationTime;
+					pFile->iSize = e->iSize;
+					pFile->pData = pContents + e->iDataOffset;
+					pFile->iLength = e->iDataLength;
+					g_hash_table_insert (s_hFiles, g_strdup (cConfFilePath), pFile);
+					pData = pFile->pData;
+					iLength = pFile->iLength;
+				}
+				else
+					cd_warning ("the theme snapshot is corrupted for %s", cConfFilePath);
+			}
+		}
+		if (pData != NULL)
+			s_iNbHits ++;
+	}
+	g_mutex_unlock (&s_mutex);
+	if (pData != NULL)
+	{
+		gboolean bLoaded = g_key_file_load_from_data (pKeyFile, pData, iLength, CD_KEY_FILE_FLAGS, erreur);
+		g_free (pCopy);
+		return bLoaded;
+	}
+	
+	//\_______________ otherwise read it from the disk, and keep it for the next snapshot.
+	gchar *pContent = NULL;
+	if (! g_file_get_contents (cConfFilePath, &pContent, &iLength, erreur))
+		return FALSE;
+	if (! g_key_file_load_from_data (pKeyFile, pContent, iLength, CD_KEY_FILE_FLAGS, erreur))
+	{
+		g_free (pContent);
+		return FALSE;
+	}
+	gint64 iNow = g_get_real_time () / G_USEC_PER_SEC;
+	g_mutex_lock (&s_mutex);
+	if (s_bActive)
+	{
+		if (st.st_mtime < iNow - 1)  // a file modified within the last second could be modified again without changing its time, so don't keep it.
+		{
+			CairoDockSnapshotFile *pFile = g_new0 (CairoDockSnapshotFile, 1);
+			pFile->iModificationTime = st.st_mtime;
+			pFile->iSize = st.st_size;
+			pFile->pData = pFile->pOwnedData = pContent;
+			pFile->iLength = iLength;
+			g_hash_table_replace (s_hFiles, g_strdup (cConfFilePath), pFile);
+			pContent = NULL;
+		}
+		s_iNbMisses ++;
+		s_bChanged = TRUE;
+	}
+	g_mutex_unlock (&s_mutex);
+	g_free (pContent);
+	return TRUE;
+}
+
+void gldi_theme_snapshot_forget_file (const gchar *cConfFilePath)
+{
+	if (! s_bActive)
+		return;
+	g_mutex_lock (&s_mutex);
+	if (s_bActive)
+	{
+		g_hash_table_remove (s_hFiles, cConfFilePath);
+		g_hash_table_remove (s_hEntries, cConfFilePath);
+		s_bChanged = TRUE;
+	}
+	g_mutex_unlock (&s_mutex);
+}
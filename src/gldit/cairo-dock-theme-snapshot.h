@@ -0,0 +1,70 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_THEME_SNAPSHOT__
+#define  __CAIRO_DOCK_THEME_SNAPSHOT__
+
+#include <glib.h>
+
+#include "cairo-dock-struct.h"
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-theme-snapshot.h This class keeps a snapshot of the conf files read while loading the current theme, to start faster when the files are slow to read (like on a network home directory).
+* The snapshot is a single binary file in the Cairo-Dock data directory, holding the content of each conf file with its modification time and size. It is mapped in memory when the theme is loaded; a conf file is taken from the snapshot only if it has not changed on the disk, and is read from the disk otherwise. Once the theme is loaded, the snapshot is rewritten if anything changed.
+* The snapshot is only used during the loading of the theme (between \ref gldi_theme_snapshot_begin and \ref gldi_theme_snapshot_end), and only if it has been enabled with \ref gldi_theme_snapshot_enable.
+*/
+
+/// Name of the snapshot file, in the Cairo-Dock data directory.
+#define CAIRO_DOCK_THEME_SNAPSHOT_FILE ".theme-snapshot"
+
+/** Enable or disable the theme snapshot. It is disabled by default.
+*@param bEnable TRUE to enable it.
+*/
+void gldi_theme_snapshot_enable (gboolean bEnable);
+
+/** Map the snapshot of the current theme, if it is enabled. Called before the theme is loaded.
+*/
+void gldi_theme_snapshot_begin (void);
+
+/** Rewrite the snapshot if some conf files have changed, and unmap it. Called once the theme is loaded.
+*/
+void gldi_theme_snapshot_end (void);
+
+/** Tell if the snapshot is in use, that is to say if the conf files should be read with \ref gldi_theme_snapshot_load_key_file.
+*@return TRUE if the theme is being loaded with a snapshot.
+*/
+gboolean gldi_theme_snapshot_is_active (void);
+
+/** Load a conf file into a key file, from the snapshot if it is up-to-date, or from the disk otherwise (in which case the file is added to the next snapshot). Can be called from any thread.
+*@param pKeyFile the key file
+*@param cConfFilePath path of the conf file
+*@param erreur location of an error, or NULL
+*@return TRUE if the key file was loaded.
+*/
+gboolean gldi_theme_snapshot_load_key_file (GKeyFile *pKeyFile, const gchar *cConfFilePath, GError **erreur);
+
+/** Remove a conf file from the snapshot, because it has been modified. Can be called from any thread.
+*@param cConfFilePath path of the conf file
+*/
+void gldi_theme_snapshot_forget_file (const gchar *cConfFilePath);
+
+G_END_DECLS
+#endif
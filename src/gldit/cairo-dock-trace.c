@@ -0,0 +1,227 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <unistd.h>  // getpid
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-trace.h"
+
+#define GLDI_TRACE_TAIL 1000  // ms after the first frame, to include the work it triggered (asynchronous image loads, etc).
+#define GLDI_TRACE_MAX_DURATION 60  // s, in case no frame is ever drawn.
+
+// public
+gboolean g_bGldiTrace = FALSE;
+
+// private
+typedef struct {
+	const gchar *cCategory;
+	gchar *cName;
+	gchar *cDetail;
+	gint64 iStartTime;  // relative to the start of the trace
+	gint64 iDuration;
+	guint iThread;
+	} CairoDockTraceEvent;
+
+static GMutex s_mutex;  // spans are added from the worker threads too.
+static GArray *s_pEvents = NULL;
+static gchar *s_cTraceFile = NULL;
+static gint64 s_iTraceStartTime = 0;
+static gboolean s_bFirstFrameDrawn = FALSE;
+static guint s_iSidStopTrace = 0;
+static GPrivate s_threadId;  // small id of each thread, the main thread being 1.
+static gint s_iNbThreads = 0;
+
+
+static guint _get_thread_id (void)
+{
+	guint iThread = GPOINTER_TO_UINT (g_private_get (&s_threadId));
+	if (iThread == 0)
+	{
+		iThread = g_atomic_int_add (&s_iNbThreads, 1) + 1;
+		g_private_set (&s_threadId, GUINT_TO_POINTER (iThread));
+	}
+	return iThread;
+}
+
+static void _append_json_string (GString *s, const gchar *str)
+{
+	g_string_append_c (s, '"');
+	const gchar *c;
+	for (c = str; *c != '\0'; c ++)
+	{
+		switch (*c)
+		{
+			case '"': g_string_append (s, "\\\""); break;
+			case '\\': g_string_append (s, "\\\\"); break;
+			case '\n': g_string_append (s, "\\n"); break;
+			case '\t': g_string_append (s, "\\t"); break;
+			default:
+				if ((guchar)*c < 0x20)
+					g_string_append_printf (s, "\\u%04x", (guchar)*c);
+				else
+					g_string_append_c (s, *c);
+		}
+	}
+	g_string_append_c (s, '"');
+}
+
+static void _write_trace (GArray *pEvents, const gchar *cFilePath)
+{
+	int iPid = getpid ();
+	GString *s = g_string_sized_new (pEvents->len * 128 + 256);
+	g_string_append (s, "{\"traceEvents\":[\n");
+	
+	// name the threads
+	guint i, iNbThreads = 0;
+	for (i = 0; i < pEvents->len; i ++)
+		iNbThreads = MAX (iNbThreads, g_array_index (pEvents, CairoDockTraceEvent, i).iThread);
+	for (i = 1; i <= iNbThreads; i ++)
+	{
+		g_string_append_printf (s, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":", iPid, i);
+		if (i == 1)
+			g_string_append (s, "\"main\"");
+		else
+			g_string_append_printf (s, "\"thread %u\"", i);
+		g_string_append (s, "}},\n");
+	}
+	
+	// one complete event per span
+	CairoDockTraceEvent *e;
+	for (i = 0; i < pEvents->len; i ++)
+	{
+		e = &g_array_index (pEvents, CairoDockTraceEvent, i);
+		g_string_append (s, "{\"name\":");
+		_append_json_string (s, e->cName);
+		g_string_append (s, ",\"cat\":");
+		_append_json_string (s, e->cCategory);
+		g_string_append_printf (s, ",\"ph\":\"X\",\"ts\":%"G_GINT64_FORMAT",\"dur\":%"G_GINT64_FORMAT",\"pid\":%d,\"tid\":%u",
+			e->iStartTime, e->iDuration, iPid, e->iThread);
+		if (e->cDetail != NULL)
+		{
+			g_string_append (s, ",\"args\":{\"detail\":");
+			_append_json_string (s, e->cDetail);
+			g_string_append_c (s, '}');
+		}
+		g_string_append (s, i + 1 < pEvents->len ? "},\n" : "}\n");
+	}
+	g_string_append (s, "],\n\"displayTimeUnit\":\"ms\"}\n");
+	
+	GError *erreur = NULL;
+	g_file_set_contents (cFilePath, s->str, s->len, &erreur);
+	if (erreur != NULL)
+	{
+		cd_warning ("couldn't write the trace into %s: %s", cFilePath, erreur->message);
+		g_error_free (erreur);
+	}
+	else
+		cd_message ("trace written into %s (%d spans)", cFilePath, pEvents->len);
+	g_string_free (s, TRUE);
+}
+
+static void _free_event (CairoDockTraceEvent *e)
+{
+	g_free (e->cName);
+	g_free (e->cDetail);
+}
+
+static gboolean _stop_trace_timeout (G_GNUC_UNUSED gpointer data)
+{
+	s_iSidStopTrace = 0;
+	gldi_trace_stop ();
+	return FALSE;
+}
+
+
+void gldi_trace_add_span (const gchar *cCategory, const gchar *cName, const gchar *cDetail, gint64 iStartTime)
+{
+	gint64 iEndTime = g_get_monotonic_time ();
+	guint iThread = _get_thread_id ();
+	g_mutex_lock (&s_mutex);
+	if (g_bGldiTrace && iStartTime >= s_iTraceStartTime)  // the span may have started before the trace, or ended after it.
+	{
+		CairoDockTraceEvent e;
+		e.cCategory = cCategory;
+		e.cName = g_strdup (cName ? cName : "?");
+		e.cDetail = g_strdup (cDetail);
+		e.iStartTime = iStartTime - s_iTraceStartTime;
+		e.iDuration = iEndTime - iStartTime;
+		e.iThread = iThread;
+		g_array_append_val (s_pEvents, e);
+	}
+	g_mutex_unlock (&s_mutex);
+}
+
+gboolean gldi_trace_start (const gchar *cFilePath)
+{
+	g_return_val_if_fail (cFilePath != NULL, FALSE);
+	if (g_bGldiTrace)
+	{
+		cd_warning ("a trace is already being recorded into %s", s_cTraceFile);
+		return FALSE;
+	}
+	cd_message ("recording a trace into %s", cFilePath);
+	_get_thread_id ();  // the first thread to trace is the main thread.
+	g_mutex_lock (&s_mutex);
+	s_pEvents = g_array_sized_new (FALSE, FALSE, sizeof (CairoDockTraceEvent), 1024);
+	s_cTraceFile = g_strdup (cFilePath);
+	s_iTraceStartTime = g_get_monotonic_time ();
+	s_bFirstFrameDrawn = FALSE;
+	g_bGldiTrace = TRUE;
+	g_mutex_unlock (&s_mutex);
+	s_iSidStopTrace = g_timeout_add_seconds (GLDI_TRACE_MAX_DURATION, _stop_trace_timeout, NULL);
+	return TRUE;
+}
+
+void gldi_trace_stop (void)
+{
+	if (! g_bGldiTrace)
+		return;
+	if (s_iSidStopTrace != 0)
+	{
+		g_source_remove (s_iSidStopTrace);
+		s_iSidStopTrace = 0;
+	}
+	g_mutex_lock (&s_mutex);
+	g_bGldiTrace = FALSE;
+	GArray *pEvents = s_pEvents;
+	s_pEvents = NULL;
+	gchar *cFilePath = s_cTraceFile;
+	s_cTraceFile = NULL;
+	g_mutex_unlock (&s_mutex);
+	
+	_write_trace (pEvents, cFilePath);
+	guint i;
+	for (i = 0; i < pEvents->len; i ++)
+		_free_event (&g_array_index (pEvents, CairoDockTraceEvent, i));
+	g_array_free (pEvents, TRUE);
+	g_free (cFilePath);
+}
+
+void gldi_trace_frame_drawn (gint64 iStartTime)
+{
+	if (! g_bGldiTrace || s_bFirstFrameDrawn)
+		return;
+	s_bFirstFrameDrawn = TRUE;
+	gldi_trace_end ("draw", "first frame", NULL, iStartTime);
+	
+	if (s_iSidStopTrace != 0)
+		g_source_remove (s_iSidStopTrace);
+	s_iSidStopTrace = g_timeout_add (GLDI_TRACE_TAIL, _stop_trace_timeout, NULL);
+}
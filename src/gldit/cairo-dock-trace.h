@@ -0,0 +1,68 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_TRACE__
+#define  __CAIRO_DOCK_TRACE__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-trace.h This class records timed spans of the startup or of a reload of the theme (config of the managers, activation of the modules, loading of the launchers and of their images, first frame), and writes them in the trace-event JSON format, which can be opened in a trace viewer (chrome://tracing, Perfetto, etc).
+* A trace starts with \ref gldi_trace_start, and stops by itself shortly after the first frame has been drawn.
+*/
+
+/// TRUE while a trace is being recorded.
+extern gboolean g_bGldiTrace;
+
+/** Start a span. Returns 0 when no trace is recorded, so that tracing costs nothing.
+*/
+#define gldi_trace_begin(...) (G_UNLIKELY (g_bGldiTrace) ? g_get_monotonic_time () : 0)
+
+/** End a span started with \ref gldi_trace_begin. Can be called from any thread.
+*@param cCategory category of the span (a static string)
+*@param cName name of the span
+*@param cDetail additional information, or NULL
+*@param iStartTime value returned by \ref gldi_trace_begin
+*/
+#define gldi_trace_end(cCategory, cName, cDetail, iStartTime) do {\
+	if (G_UNLIKELY ((iStartTime) != 0))\
+		gldi_trace_add_span (cCategory, cName, cDetail, iStartTime); } while (0)
+
+void gldi_trace_add_span (const gchar *cCategory, const gchar *cName, const gchar *cDetail, gint64 iStartTime);
+
+/** Start recording a trace. It is written into the given file once the first frame after this call has been drawn, and the work it triggered has had a moment to complete.
+*@param cFilePath path of the JSON file to write
+*@return FALSE if a trace is already being recorded.
+*/
+gboolean gldi_trace_start (const gchar *cFilePath);
+
+/** Stop recording the current trace, and write it. Does nothing if no trace is being recorded.
+*/
+void gldi_trace_stop (void);
+
+/** Tell that a frame has been drawn. The first one ends the trace shortly after.
+*@param iStartTime value returned by \ref gldi_trace_begin when the frame started
+*/
+void gldi_trace_frame_drawn (gint64 iStartTime);
+
+G_END_DECLS
+#endif
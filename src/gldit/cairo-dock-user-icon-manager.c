@@ -124,10 +124,46 @@ Icon *gldi_user_icon_new (const gchar *cConfFile)
 }
 
 
-static void _load_one_icon (gpointer pAttr, G_GNUC_UNUSED gpointer dummy)
+typedef struct {
+	gchar *cFileName;
+	GldiUserIconAttr attr;
+	gboolean bRead;
+	} GldiUserIconConf;
+
+static void _read_one_conf (GldiUserIconConf *pConf, G_GNUC_UNUSED gpointer data)  // runs in a thread
+{
+	pConf->bRead = _user_icon_conf_open (pConf->cFileName, &pConf->attr);
+}
+
+static void _read_all_confs (GPtrArray *pConfs)
+{
+	// reading the files is mostly waiting for the disk (or the network for a remote home), so read several of them at once.
+	GThreadPool *pPool = NULL;
+	if (pConfs->len > 1)
+	{
+		GError *erreur = NULL;
+		pPool = g_thread_pool_new ((GFunc) _read_one_conf, NULL, CLAMP (2 * (gint)g_get_num_processors (), 2, 8), TRUE, &erreur);
+		if (erreur != NULL)
+		{
+			cd_warning (erreur->message);
+			g_error_free (erreur);
+			pPool = NULL;
+		}
+	}
+	guint i;
+	for (i = 0; i < pConfs->len; i ++)
+	{
+		if (pPool != NULL)
+			g_thread_pool_push (pPool, g_ptr_array_index (pConfs, i), NULL);
+		else
+			_read_one_conf (g_ptr_array_index (pConfs, i), NULL);
+	}
+	if (pPool != NULL)
+		g_thread_pool_free (pPool, FALSE, TRUE);  // wait for all the files to be read.
+}
+
+static Icon *_load_one_icon (GldiUserIconAttr *attr)
 {
-	GldiUserIconAttr *attr = (GldiUserIconAttr*)pAttr;
-	
 	Icon *icon = _user_icon_create (attr);
 	if (icon == NULL || icon->bNotFound)  // if the icon couldn't be loaded, remove it from the theme (it's useless to try and fail to load it each time).
 	{
@@ -137,16 +173,19 @@ static void _load_one_icon (gpointer pAttr, G_GNUC_UNUSED gpointer dummy)
 		cd_warning ("Unable to load a valid icon from '%s'; the file is either unreadable, invalid or does not correspond to any installed program, and will be deleted", cDesktopFilePath);
 		cairo_dock_delete_conf_file (cDesktopFilePath);
 		g_free (cDesktopFilePath);
-	}
-	else
-	{
-		CairoDock *pParentDock = gldi_dock_get (icon->cParentDockName);
-		if (pParentDock != NULL)  // a priori toujours vrai.
-		{
-			gldi_icon_insert_in_container (icon, CAIRO_CONTAINER(pParentDock), ! CAIRO_DOCK_ANIMATE_ICON);
-		}
+		icon = NULL;
 	}
 	g_free ((void*)attr->cConfFileName);
+	return icon;
+}
+
+static void _add_icon_to_its_dock (Icon *icon, GHashTable *pIconsByDock, GPtrArray *pDockNames)
+{
+	GList *pIcons = g_hash_table_lookup (pIconsByDock, icon->cParentDockName);
+	gchar *cDockName = g_strdup (icon->cParentDockName);
+	if (pIcons == NULL)
+		g_ptr_array_add (pDockNames, cDockName);
+	g_hash_table_insert (pIconsByDock, cDockName, g_list_prepend (pIcons, icon));  // if the dock is already known, the new key is freed and the first one is kept.
 }
 
 void gldi_user_icons_new_from_directory (const gchar *cDirectory)
@@ -155,34 +194,70 @@ void gldi_user_icons_new_from_directory (const gchar *cDirectory)
 	GDir *dir = g_dir_open (cDirectory, 0, NULL);
 	g_return_if_fail (dir != NULL);
 	
+	//\__________________ read all the conf files in parallel.
 	const gchar *cFileName;
-	GPtrArray *array = g_ptr_array_new_full (10, g_free);
-
+	GPtrArray *pConfs = g_ptr_array_new ();
+	GldiUserIconConf *pConf;
 	while ((cFileName = g_dir_read_name (dir)) != NULL)
 	{
 		if (g_str_has_suffix (cFileName, ".desktop"))
 		{
-			GldiUserIconAttr *attr = g_new0 (GldiUserIconAttr, 1);
-			gboolean bRead = _user_icon_conf_open (cFileName, attr);
-			if (bRead)
-			{
-				if (attr->iType == GLDI_USER_ICON_TYPE_STACK)
-				{
-					// this is a subdock, create it now
-					_load_one_icon (attr, NULL);
-					g_free (attr);
-				}
-				// this is a launcher or separator, save it for later, after all subdocks have been created
-				else g_ptr_array_add (array, attr);
-			}
-			else g_free (attr);
+			pConf = g_new0 (GldiUserIconConf, 1);
+			pConf->cFileName = g_strdup (cFileName);
+			g_ptr_array_add (pConfs, pConf);
 		}
 	}
 	g_dir_close (dir);
 	
-	// we have created all subdock, load launchers and separators now
-	g_ptr_array_foreach (array, _load_one_icon, NULL);
-	g_ptr_array_free (array, TRUE);
+	_read_all_confs (pConfs);
+	
+	//\__________________ create the icons; sub-docks first, so that the launchers and separators find their parent dock.
+	GHashTable *pIconsByDock = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);  // dock name -> list of icons
+	GPtrArray *pDockNames = g_ptr_array_new ();  // in the order of creation, so that the sub-docks are filled after their icon is inserted.
+	Icon *icon;
+	guint i;
+	int iStep;
+	for (iStep = 0; iStep < 2; iStep ++)
+	{
+		for (i = 0; i < pConfs->len; i ++)
+		{
+			pConf = g_ptr_array_index (pConfs, i);
+			if (! pConf->bRead || (pConf->attr.iType == GLDI_USER_ICON_TYPE_STACK) != (iStep == 0))
+				continue;
+			icon = _load_one_icon (&pConf->attr);
+			if (icon != NULL)
+				_add_icon_to_its_dock (icon, pIconsByDock, pDockNames);
+		}
+	}
+	
+	//\__________________ insert them dock by dock, so that each dock computes its layout only once.
+	CairoDock *pParentDock;
+	GList *pIcons, *ic;
+	for (i = 0; i < pDockNames->len; i ++)
+	{
+		pIcons = g_hash_table_lookup (pIconsByDock, g_ptr_array_index (pDockNames, i));
+		pParentDock = gldi_dock_get (g_ptr_array_index (pDockNames, i));
+		if (pParentDock != NULL)  // a priori toujours vrai.
+		{
+			gldi_dock_insert_icons (pParentDock, pIcons);
+		}
+		else
+		{
+			for (ic = pIcons; ic != NULL; ic = ic->next)
+				gldi_object_unref (GLDI_OBJECT (ic->data));
+		}
+		g_list_free (pIcons);
+	}
+	
+	g_hash_table_destroy (pIconsByDock);
+	g_ptr_array_free (pDockNames, TRUE);
+	for (i = 0; i < pConfs->len; i ++)
+	{
+		pConf = g_ptr_array_index (pConfs, i);
+		g_free (pConf->cFileName);
+		g_free (pConf);
+	}
+	g_ptr_array_free (pConfs, TRUE);
 }
 
 
@@ -0,0 +1,91 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __GLDI_WINDOW_OVERLAPS_PRIV__
+#define  __GLDI_WINDOW_OVERLAPS_PRIV__
+
+#include <glib.h>
+#include "cairo-dock-struct.h"
+
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-window-overlaps-priv.h This class keeps the set of the windows that overlap an area of the screen (the area of a dock), so that a window event only needs to test this window against the area, instead of testing all the windows.
+* The set is recomputed from scratch only when the area changes, or after it has been invalidated (when the current desktop or the desktop geometry changes).
+* It's internal to the core: the docks that hide when any window overlaps them use it.
+*/
+
+typedef struct _GldiWindowOverlaps GldiWindowOverlaps;
+
+/// Set of the windows overlapping an area.
+struct _GldiWindowOverlaps {
+	/// the area the windows were tested against.
+	GtkAllocation area;
+	/// set of the windows overlapping the area.
+	GHashTable *pWindows;
+	/// FALSE if the set has to be recomputed.
+	gboolean bValid;
+};
+
+/** Tell if the geometry of a window intersects an area, whatever its desktop and its state.
+*@param actor the window
+*@param pArea the area
+*@return TRUE if they intersect.
+*/
+gboolean gldi_window_intersects_area (const GldiWindowActor *actor, const GtkAllocation *pArea);
+
+/** Tell if a window overlaps an area: it has to be visible on the current desktop, and intersect the area.
+*@param actor the window
+*@param pArea the area
+*@return TRUE if the window overlaps the area.
+*/
+gboolean gldi_window_is_overlapping_area (GldiWindowActor *actor, const GtkAllocation *pArea);
+
+/** Make a new empty set of overlapping windows; it will be computed on the first query.
+*@return the new set, to be freed with \ref gldi_window_overlaps_free.
+*/
+GldiWindowOverlaps *gldi_window_overlaps_new (void);
+
+/** Free a set of overlapping windows.
+*@param pOverlaps the set
+*/
+void gldi_window_overlaps_free (GldiWindowOverlaps *pOverlaps);
+
+/** Tell if any window overlaps an area. The set is recomputed from all the windows if the area is not the one it was computed for, or if it was invalidated; otherwise it's only read.
+*@param pOverlaps the set
+*@param pArea the area
+*@return TRUE if at least one window overlaps the area.
+*/
+gboolean gldi_window_overlaps_has_window (GldiWindowOverlaps *pOverlaps, const GtkAllocation *pArea);
+
+/** Take into account the new state of a window (created, moved, resized, shown, hidden, moved to another desktop or destroyed).
+*@param pOverlaps the set
+*@param actor the window
+*@param bDestroyed TRUE if the window is being destroyed
+*/
+void gldi_window_overlaps_update_window (GldiWindowOverlaps *pOverlaps, GldiWindowActor *actor, gboolean bDestroyed);
+
+/** Make a set be recomputed on the next query, because the windows on the current desktop may have all changed.
+*@param pOverlaps the set
+*/
+void gldi_window_overlaps_invalidate (GldiWindowOverlaps *pOverlaps);
+
+G_END_DECLS
+#endif
@@ -0,0 +1,90 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "cairo-dock-windows-manager-priv.h"
+#include "cairo-dock-window-overlaps-priv.h"
+
+gboolean gldi_window_intersects_area (const GldiWindowActor *actor, const GtkAllocation *pArea)
+{
+	const GtkAllocation *pWindowGeometry = &actor->windowGeometry;
+	return (pWindowGeometry->x < pArea->x + pArea->width &&
+		pWindowGeometry->x + pWindowGeometry->width > pArea->x &&
+		pWindowGeometry->y < pArea->y + pArea->height &&
+		pWindowGeometry->y + pWindowGeometry->height > pArea->y);
+}
+
+gboolean gldi_window_is_overlapping_area (GldiWindowActor *actor, const GtkAllocation *pArea)
+{
+	if (gldi_window_is_on_current_desktop (actor) && ! actor->bIsHidden && actor->bDisplayed)
+	{
+		return gldi_window_intersects_area (actor, pArea);
+	}
+	return FALSE;
+}
+
+GldiWindowOverlaps *gldi_window_overlaps_new (void)
+{
+	GldiWindowOverlaps *pOverlaps = g_new0 (GldiWindowOverlaps, 1);
+	pOverlaps->pWindows = g_hash_table_new (NULL, NULL);
+	return pOverlaps;
+}
+
+void gldi_window_overlaps_free (GldiWindowOverlaps *pOverlaps)
+{
+	if (pOverlaps == NULL)
+		return;
+	g_hash_table_destroy (pOverlaps->pWindows);
+	g_free (pOverlaps);
+}
+
+static void _add_if_overlapping (GldiWindowActor *actor, GldiWindowOverlaps *pOverlaps)
+{
+	if (gldi_window_is_overlapping_area (actor, &pOverlaps->area))
+		g_hash_table_add (pOverlaps->pWindows, actor);
+}
+
+gboolean gldi_window_overlaps_has_window (GldiWindowOverlaps *pOverlaps, const GtkAllocation *pArea)
+{
+	if (! pOverlaps->bValid
+	|| pArea->x != pOverlaps->area.x || pArea->y != pOverlaps->area.y
+	|| pArea->width != pOverlaps->area.width || pArea->height != pOverlaps->area.height)
+	{
+		pOverlaps->area = *pArea;
+		g_hash_table_remove_all (pOverlaps->pWindows);
+		gldi_windows_foreach_unordered ((GFunc)_add_if_overlapping, pOverlaps);
+		pOverlaps->bValid = TRUE;
+	}
+	return (g_hash_table_size (pOverlaps->pWindows) != 0);
+}
+
+void gldi_window_overlaps_update_window (GldiWindowOverlaps *pOverlaps, GldiWindowActor *actor, gboolean bDestroyed)
+{
+	if (! pOverlaps->bValid)
+		return;  // will be recomputed entirely on the next query
+	// if the area has changed since, the set will be recomputed on the next query anyway.
+	if (! bDestroyed && gldi_window_is_overlapping_area (actor, &pOverlaps->area))
+		g_hash_table_add (pOverlaps->pWindows, actor);
+	else
+		g_hash_table_remove (pOverlaps->pWindows, actor);
+}
+
+void gldi_window_overlaps_invalidate (GldiWindowOverlaps *pOverlaps)
+{
+	pOverlaps->bValid = FALSE;
+}
@@ -65,6 +65,8 @@
 // drawing
 #include <gldit/cairo-dock-opengl.h>
 #include <gldit/cairo-dock-opengl-path.h>
+#include <gldit/cairo-dock-opengl-batch.h>
+#include <gldit/cairo-dock-image-cache.h>
 #include <gldit/cairo-dock-opengl-font.h>
 #include <gldit/cairo-dock-draw-opengl.h>
 #include <gldit/cairo-dock-draw.h>
@@ -86,6 +88,8 @@
 #include <gldit/cairo-dock-log.h>
 #include <gldit/cairo-dock-dbus.h>
 #include <gldit/cairo-dock-keyfile-utilities.h>
+#include <gldit/cairo-dock-theme-snapshot.h>
+#include <gldit/cairo-dock-trace.h>
 #include <gldit/cairo-dock-keybinder.h>
 #include <gldit/cairo-dock-task.h>
 #include <gldit/cairo-dock-particle-system.h>
@@ -114,8 +114,15 @@ static Atom s_aGTKDBusName;
 static Atom s_aGTKAppID;
 static GHashTable *s_hXWindowTable = NULL;  // table of (Xid,actor)
 static GHashTable *s_hXClientMessageTable = NULL;  // table of (Xid,client-message)
+static GHashTable *s_hXPendingProps = NULL;  // table of (Xid,XPendingProp), the changes to process at the end of the current dispatch
+static guint s_iNbPropEvents = 0;  // number of name/icon changes received
+static guint s_iNbMergedPropEvents = 0;  // number of them that were merged with a previous change of the same dispatch
+static guint s_iNbIconUpdates = 0;  // number of icon reloads notified
+static guint s_iNbDelayedIconUpdates = 0;  // number of icon changes delayed by the minimum interval
 static int s_iTime = 1;  // on peut aller jusqu'a 2^31, soit 17 ans a 4Hz.
 static int s_iNumWindow = 1;  // used to order appli icons by age (=creation date).
+static Window *s_pLastWindowsList = NULL;  // last list of windows by z-order
+static gulong s_iNbLastWindows = 0;
 static Window s_iCurrentActiveWindow = 0;
 static guint num_lock_mask=0, caps_lock_mask=0, scroll_lock_mask=0;
 static GPollFD s_poll_fd;
@@ -125,6 +132,14 @@ typedef enum {
 	X_URGENCY_HINT = (1 << 2)
 } XAttentionFlag;
 
+// property changes that are coalesced within one dispatch, because some applications (terminals, browsers) change them many times in a row.
+typedef enum {
+	X_PENDING_NET_NAME = (1<<0),
+	X_PENDING_WM_NAME = (1<<1),
+	X_PENDING_ICON = (1<<2)
+} XPendingProp;
+#define X_PENDING_NAME (X_PENDING_NET_NAME | X_PENDING_WM_NAME)
+
 // signals
 typedef enum {
 	NB_NOTIFICATIONS_X_MANAGER = NB_NOTIFICATIONS_WINDOWS
@@ -142,36 +157,49 @@ struct _GldiXWindowActor {
 	guint iDemandsAttention;  // a mask of XAttentionFlag
 	gboolean bIgnored;
 	gint iWidthOrig, iHeightOrig; // width and height without scaling
+	gint64 iLastIconUpdate;  // monotonic time of the last icon change notified
+	guint iSidIconUpdate;  // delayed icon change
 	};
 
 
-static GldiXWindowActor *_make_new_actor (Window Xid)
+// additional string properties fetched for each new window
+typedef enum {
+	X_PROP_KDE_APPMENU_OBJ = 0,
+	X_PROP_KDE_APPMENU_NAME,
+	X_PROP_GTK_DBUS_NAME,
+	X_PROP_GTK_MENUBAR_PATH,
+	X_PROP_GTK_WINDOW_PATH,
+	X_PROP_GTK_APP_PATH,
+	X_PROP_GTK_APP_ID,
+	X_NB_STRING_PROPS
+} XStringProp;
+
+// get the properties of all the new windows at once
+static CairoDockXWindowInfo *_fetch_windows_info (const Window *pXids, gulong iNbWindows)
+{
+	Atom aStringProps[X_NB_STRING_PROPS] = {s_aKDEAppmenuObj, s_aKDEAppmenuName, s_aGTKDBusName, s_aGTKMenuBarPath, s_aGTKWindowPath, s_aGTKAppPath, s_aGTKAppID};
+	return cairo_dock_fetch_xwindows_info (pXids, iNbWindows, aStringProps, X_NB_STRING_PROPS);
+}
+
+// takes the strings of pInfo
+static GldiXWindowActor *_make_new_actor (CairoDockXWindowInfo *pInfo)
 {
 	GldiXWindowActor *xactor;
-	gboolean bShowInTaskbar = FALSE;
-	gboolean bNormalWindow = FALSE;
-	Window iTransientFor = None;
-	gchar *cClass = NULL, *cWmClass = NULL, *cWmName = NULL;
-	gboolean bIsHidden = FALSE, bIsFullScreen = FALSE, bIsMaximized = FALSE, bDemandsAttention = FALSE, bIsSticky = FALSE;
+	Window Xid = pInfo->Xid;
+	gboolean bShowInTaskbar = pInfo->bShowInTaskbar;
 	
 	//\__________________ see if we should skip it
 	// check its 'skip taskbar' property
-	bShowInTaskbar = cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Xid, &bIsFullScreen, &bIsHidden, &bIsMaximized, &bDemandsAttention, &bIsSticky);
-	
 	if (bShowInTaskbar)
 	{
 		// check its type
-		bNormalWindow = cairo_dock_get_xwindow_type (Xid, &iTransientFor);
-		if (bNormalWindow || iTransientFor != None)
+		if (pInfo->bNormalWindow || pInfo->iTransientFor != None)
 		{
 			// check get its class
-			cClass = cairo_dock_get_xwindow_class (Xid, &cWmClass, &cWmName);
-			if (cClass == NULL)
+			if (pInfo->cClass == NULL)
 			{
-				gchar *cName = cairo_dock_get_xwindow_name (Xid, TRUE);
 				cd_warning ("this window (%s, %ld) doesn't belong to any class, skip it.\n"
-					"Please report this bug to the application's devs.", cName, Xid);
-				g_free (cName);
+					"Please report this bug to the application's devs.", pInfo->cName, Xid);
 				bShowInTaskbar = FALSE;
 			}
 		}
@@ -181,57 +209,50 @@ static GldiXWindowActor *_make_new_actor (Window Xid)
 			bShowInTaskbar = FALSE;
 		}
 	}
-	else
-	{
-		XGetTransientForHint (s_XDisplay, Xid, &iTransientFor);
-	}
 	
 	//\__________________ if the window passed all the tests, make a new actor
 	if (bShowInTaskbar)  // make a new actor and fill the properties we got before
 	{
-		xactor = (GldiXWindowActor*)gldi_object_new (&myXObjectMgr, &Xid);
+		xactor = (GldiXWindowActor*)gldi_object_new (&myXObjectMgr, pInfo);
 		GldiWindowActor *actor = (GldiWindowActor*)xactor;
-		actor->bDisplayed = bNormalWindow;
-		actor->cClass = cClass;
-		actor->cWmClass = cWmClass;
-		actor->cWmName = cWmName;
-		actor->bIsHidden = bIsHidden;
-		actor->bIsMaximized = bIsMaximized;
-		actor->bIsFullScreen = bIsFullScreen;
-		actor->bDemandsAttention = bDemandsAttention;
-		actor->bIsSticky = bIsSticky;
+		actor->bDisplayed = pInfo->bNormalWindow;
+		actor->cClass = pInfo->cClass;
+		actor->cWmClass = pInfo->cWmClass;
+		actor->cWmName = pInfo->cWmName;
+		pInfo->cClass = pInfo->cWmClass = pInfo->cWmName = NULL;
+		actor->bIsHidden = pInfo->bIsHidden;
+		actor->bIsMaximized = pInfo->bIsMaximized;
+		actor->bIsFullScreen = pInfo->bIsFullScreen;
+		actor->bDemandsAttention = pInfo->bDemandsAttention;
+		actor->bIsSticky = pInfo->bIsSticky;
 		
+		gchar **props = pInfo->pStringProps;
 		// KDE Appmenu props
-		gchar *obj  = cairo_dock_get_xwindow_string_prop (Xid, s_aKDEAppmenuObj);
-		gchar *name = cairo_dock_get_xwindow_string_prop (Xid, s_aKDEAppmenuName);
-		if (obj || name)
+		if (props[X_PROP_KDE_APPMENU_OBJ] || props[X_PROP_KDE_APPMENU_NAME])
 		{
 			actor->pDBusProps = g_new0 (GldiWindowDBusProperties, 1);
-			actor->pDBusProps->cKDEObjectPath = obj;
-			actor->pDBusProps->cKDEServiceName = name;
+			actor->pDBusProps->cKDEObjectPath = props[X_PROP_KDE_APPMENU_OBJ];
+			actor->pDBusProps->cKDEServiceName = props[X_PROP_KDE_APPMENU_NAME];
 		}
 		
 		// GTK Appmenu props
-		name = cairo_dock_get_xwindow_string_prop (Xid, s_aGTKDBusName);
-		gchar *menu_path = cairo_dock_get_xwindow_string_prop (Xid, s_aGTKMenuBarPath);
-		gchar *window_path = cairo_dock_get_xwindow_string_prop (Xid, s_aGTKWindowPath);
-		gchar *app_path = cairo_dock_get_xwindow_string_prop (Xid, s_aGTKAppPath);
-		if (name || menu_path || window_path || app_path)
+		if (props[X_PROP_GTK_DBUS_NAME] || props[X_PROP_GTK_MENUBAR_PATH] || props[X_PROP_GTK_WINDOW_PATH] || props[X_PROP_GTK_APP_PATH])
 		{
 			if (!actor->pDBusProps) actor->pDBusProps = g_new0 (GldiWindowDBusProperties, 1);
-			actor->pDBusProps->cGTKAppPath = app_path;
-			actor->pDBusProps->cGTKWindowPath = window_path;
-			actor->pDBusProps->cGTKMenuBarPath = menu_path;
-			actor->pDBusProps->cGTKBusName = name;
+			actor->pDBusProps->cGTKAppPath = props[X_PROP_GTK_APP_PATH];
+			actor->pDBusProps->cGTKWindowPath = props[X_PROP_GTK_WINDOW_PATH];
+			actor->pDBusProps->cGTKMenuBarPath = props[X_PROP_GTK_MENUBAR_PATH];
+			actor->pDBusProps->cGTKBusName = props[X_PROP_GTK_DBUS_NAME];
 		}
 		
 		// GTK app-id
-		gchar *app_id = cairo_dock_get_xwindow_string_prop (Xid, s_aGTKAppID);
-		if (app_id)
+		if (props[X_PROP_GTK_APP_ID])
 		{
 			if (!actor->pDBusProps) actor->pDBusProps = g_new0 (GldiWindowDBusProperties, 1);
-			actor->pDBusProps->cGTKAppID = app_id;
+			actor->pDBusProps->cGTKAppID = props[X_PROP_GTK_APP_ID];
 		}
+		if (actor->pDBusProps)  // the strings are now owned by the actor
+			memset (props, 0, X_NB_STRING_PROPS * sizeof (gchar*));
 	}
 	else  // make a dumy actor, so that we don't try to check it any more
 	{
@@ -245,8 +266,8 @@ static GldiXWindowActor *_make_new_actor (Window Xid)
 		*pXid = xactor->Xid;
 		g_hash_table_insert (s_hXWindowTable, pXid, xactor);
 	}
-	xactor->XTransientFor = iTransientFor;
-	((GldiWindowActor*)xactor)->bIsTransientFor = (iTransientFor != None);
+	xactor->XTransientFor = pInfo->iTransientFor;
+	((GldiWindowActor*)xactor)->bIsTransientFor = (pInfo->iTransientFor != None);
 	xactor->iLastCheckTime = s_iTime;
 	return xactor;
 }
@@ -258,6 +279,8 @@ static void _delete_actor (GldiXWindowActor *actor)
 		// remove from table
 		if (actor->iLastCheckTime != -1)  // if not already removed
 			g_hash_table_remove (s_hXWindowTable, &actor->Xid);
+		if (actor->iSidIconUpdate != 0)  // it may have been ignored after its icon changed
+			g_source_remove (actor->iSidIconUpdate);
 		g_free (actor);
 	}
 	else
@@ -338,41 +361,94 @@ static gboolean _remove_old_applis (Window *Xid, GldiXWindowActor *actor, gpoint
 }
 static void _on_update_applis_list (void)
 {
-	s_iTime ++;
 	// get all windows sorted by z-order
+	// _NET_CLIENT_LIST_STACKING carries no delta, so the whole list has to be read and compared; the z-order of the known windows is then set in one walk,
+	// but the windows that appeared or disappeared are only looked for among the new and the previous lists, not in the whole table.
 	gulong i, iNbWindows = 0;
 	Window *pXWindowsList = cairo_dock_get_windows_list (&iNbWindows, TRUE);  // TRUE => ordered by z-stack.
 	
-	// set the z-order of existing windows, and create actors for new windows
+	// skip the updates that change nothing (the list is often re-set as it is); if a window was removed from the table to be checked again, the sizes differ.
+	if (iNbWindows == s_iNbLastWindows && iNbWindows == g_hash_table_size (s_hXWindowTable)
+	&& (iNbWindows == 0 || memcmp (pXWindowsList, s_pLastWindowsList, iNbWindows * sizeof (Window)) == 0))
+	{
+		XFree (pXWindowsList);
+		return;
+	}
+	Window *pPrevWindowsList = s_pLastWindowsList;  // kept until the end: a window that disappeared can only be in it.
+	gulong iNbPrevWindows = s_iNbLastWindows;
+	s_pLastWindowsList = g_new (Window, iNbWindows);
+	if (iNbWindows != 0)
+		memcpy (s_pLastWindowsList, pXWindowsList, iNbWindows * sizeof (Window));
+	s_iNbLastWindows = iNbWindows;
+	s_iTime ++;
+	
+	// look up each window once, and get the properties of the new windows all at once
 	Window Xid;
 	GldiXWindowActor *actor;
+	GldiXWindowActor **pActors = g_new (GldiXWindowActor*, iNbWindows + 1);
+	Window *pNewXids = g_new (Window, iNbWindows + 1);
+	gulong iNbNewWindows = 0;
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		Xid = pXWindowsList[i];
+		pActors[i] = g_hash_table_lookup (s_hXWindowTable, &Xid);
+		if (pActors[i] == NULL)
+			pNewXids[iNbNewWindows++] = Xid;
+	}
+	CairoDockXWindowInfo *pNewInfos = _fetch_windows_info (pNewXids, iNbNewWindows);
+	gulong iNewWindow = 0;
+	
+	// set the z-order of existing windows, and create actors for new windows
+	guint iNbSeenWindows = 0;
 	int iStackOrder = 0;
 	for (i = 0; i < iNbWindows; i ++)
 	{
 		Xid = pXWindowsList[i];
-		
-		// check if the window is already known
-		actor = g_hash_table_lookup (s_hXWindowTable, &Xid);
+		actor = pActors[i];
 		if (actor == NULL)
 		{
 			// create a window actor
 			cd_message (" cette fenetre (%ld) de la pile n'est pas dans la liste", Xid);
-			actor = _make_new_actor (Xid);
+			while (iNewWindow < iNbNewWindows && pNewInfos[iNewWindow].Xid != Xid)  // same order as the list
+				iNewWindow ++;
+			if (iNewWindow == iNbNewWindows)  // can't happen
+				continue;
+			actor = _make_new_actor (&pNewInfos[iNewWindow]);
 			
 			// notify everybody
 			if (! actor->bIgnored)
 				gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_CREATED, actor);
+			iNbSeenWindows ++;
 		}
-		else  // just update its check-time
+		else if (actor->iLastCheckTime != s_iTime)  // just update its check-time
+		{
 			actor->iLastCheckTime = s_iTime;
+			iNbSeenWindows ++;
+		}
 		
 		// update the z-order
 		if (! actor->bIgnored)
 			actor->actor.iStackOrder = iStackOrder ++;
 	}
+	cairo_dock_free_xwindows_info (pNewInfos, iNbNewWindows);
+	g_free (pNewXids);
+	g_free (pActors);
 	
-	// remove old actors for windows that disappeared
-	g_hash_table_foreach_remove (s_hXWindowTable, (GHRFunc) _remove_old_applis, GINT_TO_POINTER (s_iTime));
+	// remove old actors for windows that disappeared: they are the ones of the previous list that were not seen this time.
+	if (g_hash_table_size (s_hXWindowTable) != iNbSeenWindows)
+	{
+		for (i = 0; i < iNbPrevWindows; i ++)
+		{
+			Xid = pPrevWindowsList[i];
+			actor = g_hash_table_lookup (s_hXWindowTable, &Xid);
+			if (actor != NULL && _remove_old_applis (&Xid, actor, GINT_TO_POINTER (s_iTime)))
+				g_hash_table_remove (s_hXWindowTable, &Xid);  // the actor is already deleted, only the key is freed.
+		}
+		// the windows known before any list was received (at startup) are not in the previous list; walk the whole table only if one of them disappeared.
+		if (g_hash_table_size (s_hXWindowTable) != iNbSeenWindows)
+			g_hash_table_foreach_remove (s_hXWindowTable, (GHRFunc) _remove_old_applis, GINT_TO_POINTER (s_iTime));
+	}
+	g_free (pPrevWindowsList);
 	
 	// notify everybody that the stack order has changed
 	gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_Z_ORDER_CHANGED, NULL);
@@ -415,6 +491,81 @@ static void lookup_ignorable_modifiers (void)
 	scroll_lock_mask = XkbKeysymToModifiers (s_XDisplay, GDK_KEY_Scroll_Lock);
 }
 
+static void _update_icon (GldiXWindowActor *xactor);
+static gboolean _on_icon_update_timeout (GldiXWindowActor *xactor)
+{
+	xactor->iSidIconUpdate = 0;
+	if (! xactor->bIgnored)
+		_update_icon (xactor);
+	return FALSE;
+}
+static void _update_icon (GldiXWindowActor *xactor)
+{
+	if (xactor->iSidIconUpdate != 0)  // an update is already planned, it will take this change into account too.
+	{
+		s_iNbDelayedIconUpdates ++;
+		return;
+	}
+	// reloading an icon is expensive, so do it at most once per interval.
+	gint64 t = g_get_monotonic_time ();
+	gint64 iDelay = (gint64)myTaskbarParam.iIconUpdateDelay * 1000;  // us
+	if (xactor->iLastIconUpdate != 0 && t - xactor->iLastIconUpdate < iDelay)
+	{
+		s_iNbDelayedIconUpdates ++;
+		xactor->iSidIconUpdate = g_timeout_add ((iDelay - (t - xactor->iLastIconUpdate)) / 1000 + 1, (GSourceFunc)_on_icon_update_timeout, xactor);
+		return;
+	}
+	xactor->iLastIconUpdate = t;
+	s_iNbIconUpdates ++;
+	gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_ICON_CHANGED, xactor);
+}
+
+static void _add_pending_prop (Window Xid, XPendingProp prop)
+{
+	gpointer key = GSIZE_TO_POINTER (Xid);  // Window is an unsigned long
+	guint flags = GPOINTER_TO_UINT (g_hash_table_lookup (s_hXPendingProps, key));
+	s_iNbPropEvents ++;
+	if (flags & ((prop & X_PENDING_NAME) ? X_PENDING_NAME : prop))  // already pending (note: apps generally set both names at once)
+		s_iNbMergedPropEvents ++;
+	g_hash_table_insert (s_hXPendingProps, key, GUINT_TO_POINTER (flags | prop));
+}
+
+static void _process_pending_props (void)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+	g_hash_table_iter_init (&iter, s_hXPendingProps);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		Window Xid = GPOINTER_TO_SIZE (key);
+		guint flags = GPOINTER_TO_UINT (value);
+		GldiXWindowActor *xactor = g_hash_table_lookup (s_hXWindowTable, &Xid);
+		if (! xactor || xactor->bIgnored)  // destroyed or removed from the taskbar in the meantime
+			continue;
+		GldiWindowActor *actor = (GldiWindowActor*)xactor;
+		
+		if (flags & X_PENDING_NAME)
+		{
+			// update the actor
+			g_free (actor->cName);
+			actor->cName = cairo_dock_get_xwindow_name (Xid, (flags & X_PENDING_WM_NAME) != 0);
+			// notify everybody
+			gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_NAME_CHANGED, actor);
+		}
+		if (flags & X_PENDING_ICON)
+			_update_icon (xactor);
+	}
+	g_hash_table_remove_all (s_hXPendingProps);
+}
+
+gchar *gldi_X_manager_get_events_report (void)
+{
+	return g_strdup_printf ("name/icon changes: %u (%u merged within a dispatch)\n"
+		"icon reloads: %u (%u changes delayed by the minimum interval of %d ms)\n",
+		s_iNbPropEvents, s_iNbMergedPropEvents,
+		s_iNbIconUpdates, s_iNbDelayedIconUpdates, myTaskbarParam.iIconUpdateDelay);
+}
+
 static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 {
 	static XEvent event;
@@ -690,11 +841,8 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 				{
 					if (xactor->bIgnored)  // skip taskbar
 						continue;
-					// update the actor
-					g_free (actor->cName);
-					actor->cName = cairo_dock_get_xwindow_name (Xid, event.xproperty.atom == s_aWmName);
-					// notify everybody
-					gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_NAME_CHANGED, actor);
+					// the name is read and notified once at the end of the dispatch
+					_add_pending_prop (Xid, event.xproperty.atom == s_aWmName ? X_PENDING_WM_NAME : X_PENDING_NET_NAME);
 				}
 				else if (event.xproperty.atom == s_aWmHints)
 				{
@@ -712,7 +860,7 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 						
 						if (event.xproperty.state == PropertyNewValue && (pWMHints->flags & (IconPixmapHint | IconMaskHint | IconWindowHint)))
 						{
-							gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_ICON_CHANGED, actor);
+							_add_pending_prop (Xid, X_PENDING_ICON);
 						}
 						XFree (pWMHints);
 					}
@@ -725,8 +873,8 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 				{
 					if (xactor->bIgnored)  // skip taskbar
 						continue;
-					// notify everybody
-					gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_ICON_CHANGED, actor);
+					// notified once at the end of the dispatch
+					_add_pending_prop (Xid, X_PENDING_ICON);
 				}
 				else if (event.xproperty.atom == s_aWmClass)
 				{
@@ -839,6 +987,8 @@ static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
 		}  // end of event
 	}
 	
+	_process_pending_props ();
+	
 	XFlush (s_XDisplay);  // now that there are no more messages in the input queue, flush the output queue
 	return TRUE;
 }
@@ -1758,17 +1908,19 @@ static void init (void)
 		g_free,  // Xid
 		(GDestroyNotify)_string_free);  // GString
 	
+	s_hXPendingProps = g_hash_table_new (g_direct_hash, g_direct_equal);
+	
 	//\__________________ get the list of windows
 	gulong i, iNbWindows = 0;
 	Window *pXWindowsList = cairo_dock_get_windows_list (&iNbWindows, FALSE);  // ordered by creation date; this allows us to set the correct age to the icon, which is constant. On the next updates, the z-order (which is dynamic) will be set.
 	cd_debug ("got %d X windows", iNbWindows);
 	
-	Window Xid;
+	CairoDockXWindowInfo *pInfos = _fetch_windows_info (pXWindowsList, iNbWindows);
 	for (i = 0; i < iNbWindows; i ++)
 	{
-		Xid = pXWindowsList[i];
-		(void)_make_new_actor (Xid);
+		(void)_make_new_actor (&pInfos[i]);
 	}
+	cairo_dock_free_xwindows_info (pInfos, iNbWindows);
 	if (pXWindowsList != NULL)
 		XFree (pXWindowsList);
 	
@@ -1880,17 +2032,18 @@ static void init_object (GldiObject *obj, gpointer attr)
 {
 	GldiXWindowActor *xactor = (GldiXWindowActor*)obj;
 	GldiWindowActor *actor = (GldiWindowActor*)xactor;
-	Window *xid = (Window*)attr;
-	Window Xid = *xid;
+	CairoDockXWindowInfo *pInfo = (CairoDockXWindowInfo*)attr;
+	Window Xid = pInfo->Xid;
 	
 	xactor->Xid = Xid;
 	
-	// get additional properties
-	actor->cName = cairo_dock_get_xwindow_name (Xid, TRUE);
-	actor->iNumDesktop = cairo_dock_get_xwindow_desktop (Xid);
+	// get additional properties (fetched along with the other new windows)
+	actor->cName = pInfo->cName;
+	pInfo->cName = NULL;
+	actor->iNumDesktop = pInfo->iNumDesktop;
 	
-	int iLocalPositionX=0, iLocalPositionY=0, iWidthExtent=0, iHeightExtent=0;
-	cairo_dock_get_xwindow_geometry (Xid, &iLocalPositionX, &iLocalPositionY, &iWidthExtent, &iHeightExtent);
+	int iLocalPositionX = pInfo->iLocalPositionX, iLocalPositionY = pInfo->iLocalPositionY;
+	int iWidthExtent = pInfo->iWidthExtent, iHeightExtent = pInfo->iHeightExtent;
 	
 	iLocalPositionX /= cairo_dock_X_display_scale;
 	iLocalPositionY /= cairo_dock_X_display_scale;
@@ -1943,6 +2096,8 @@ static void reset_object (GldiObject *obj)
 		g_hash_table_remove (s_hXWindowTable, &actor->Xid);
 	
 	// free data
+	if (actor->iSidIconUpdate != 0)
+		g_source_remove (actor->iSidIconUpdate);
 	#ifdef HAVE_XEXTEND
 	if (actor->iBackingPixmap != 0)
 	{
@@ -2001,4 +2156,9 @@ void gldi_register_X_manager (void)
 {
 	cd_message ("Cairo-Dock was not built with X support");
 }
+
+gchar *gldi_X_manager_get_events_report (void)
+{
+	return g_strdup ("Cairo-Dock was not built with X support\n");
+}
 #endif
@@ -34,5 +34,10 @@ void gldi_register_X_manager (void);
 
 unsigned long gldi_X_manager_get_window_xid (GldiWindowActor *actor);
 
+/** Get a summary of the window property changes received from X, and how many of them were merged or delayed.
+*@return a newly allocated string.
+*/
+gchar *gldi_X_manager_get_events_report (void);
+
 G_END_DECLS
 #endif
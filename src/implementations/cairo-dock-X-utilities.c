@@ -19,6 +19,8 @@
 
 #include "gldi-config.h"
 #ifdef HAVE_X11
+#include <string.h>  // memcpy
+#include <stdlib.h>  // free
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
 #include <X11/Xutil.h>
@@ -31,6 +33,10 @@
 #endif
 #include <X11/extensions/Xrandr.h>
 #endif
+#ifdef HAVE_XCB
+#include <X11/Xlib-xcb.h>  // XGetXCBConnection
+#include <xcb/xcb.h>
+#endif
 
 #include "cairo-dock-log.h"
 #include "cairo-dock-utils.h"  // cairo_dock_remove_version_from_string, cairo_dock_check_xrandr
@@ -85,6 +91,7 @@ static Atom s_aNetWmDesktop;
 static Atom s_aNetWmIcon;
 static Atom s_aNetWmName;
 static Atom s_aWmName;
+static Atom s_aNetFrameExtents;
 static Atom s_aUtf8String;
 static Atom s_aString;
 static unsigned char error_code = Success;
@@ -160,6 +167,7 @@ Display *cairo_dock_initialize_X_desktop_support (void)
     s_aWmName                   = XInternAtom (s_XDisplay, "WM_NAME", False);
     s_aUtf8String               = XInternAtom (s_XDisplay, "UTF8_STRING", False);
     s_aString                   = XInternAtom (s_XDisplay, "STRING", False);
+    s_aNetFrameExtents          = XInternAtom (s_XDisplay, "_NET_FRAME_EXTENTS", False);
 	
 	return s_XDisplay;
 }
@@ -986,18 +994,24 @@ gchar *cairo_dock_get_xwindow_name (Window Xid, gboolean bSearchWmName)
 	return cName;
 }
 
+static gchar *_parse_xwindow_class (const gchar *res_class, const gchar *res_name, gchar **cWMClass, gchar **cWMName)
+{
+	gchar *cClass = gldi_window_parse_class(res_class, res_name);
+	if (cClass)
+	{
+		if (cWMClass) *cWMClass = g_strdup (res_class);
+		if (res_name && cWMName) *cWMName = g_ascii_strdown (res_name, -1);
+	}
+	return cClass;
+}
+
 gchar *cairo_dock_get_xwindow_class (Window Xid, gchar **cWMClass, gchar **cWMName)
 {
 	XClassHint *pClassHint = XAllocClassHint ();
 	gchar *cClass = NULL;
 	if (XGetClassHint (s_XDisplay, Xid, pClassHint) != 0 && pClassHint->res_class)
 	{
-		cClass = gldi_window_parse_class(pClassHint->res_class, pClassHint->res_name);
-		if (cClass)
-		{
-			if (cWMClass) *cWMClass = g_strdup (pClassHint->res_class);
-			if (pClassHint->res_name && cWMName) *cWMName = g_ascii_strdown (pClassHint->res_name, -1);
-		}
+		cClass = _parse_xwindow_class (pClassHint->res_class, pClassHint->res_name, cWMClass, cWMName);
 		XFree (pClassHint->res_name);
 		XFree (pClassHint->res_class);
 		XFree (pClassHint);
@@ -1128,16 +1142,8 @@ void cairo_dock_xwindow_is_above_or_below (Window Xid, gboolean *bIsAbove, gbool
 	XFree (pXStateBuffer);
 }
 
-gboolean cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Window Xid, gboolean *bIsFullScreen, gboolean *bIsHidden, gboolean *bIsMaximized, gboolean *bDemandsAttention, gboolean *bIsSticky)
+static gboolean _parse_xwindow_state (const gulong *pXStateBuffer, unsigned long iBufferNbElements, gboolean *bIsFullScreen, gboolean *bIsHidden, gboolean *bIsMaximized, gboolean *bDemandsAttention, gboolean *bIsSticky)
 {
-	g_return_val_if_fail (Xid > 0, FALSE);
-	//cd_debug ("%s (%d)", __func__, Xid);
-	Atom aReturnedType = 0;
-	int aReturnedFormat = 0;
-	unsigned long iLeftBytes, iBufferNbElements = 0;
-	gulong *pXStateBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
-	
 	gboolean bValid = TRUE;
 	*bIsFullScreen = FALSE;
 	*bIsHidden = FALSE;
@@ -1187,6 +1193,20 @@ gboolean cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Window Xid, gb
 			}
 		}
 	}
+	return bValid;
+}
+
+gboolean cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Window Xid, gboolean *bIsFullScreen, gboolean *bIsHidden, gboolean *bIsMaximized, gboolean *bDemandsAttention, gboolean *bIsSticky)
+{
+	g_return_val_if_fail (Xid > 0, FALSE);
+	//cd_debug ("%s (%d)", __func__, Xid);
+	Atom aReturnedType = 0;
+	int aReturnedFormat = 0;
+	unsigned long iLeftBytes, iBufferNbElements = 0;
+	gulong *pXStateBuffer = NULL;
+	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
+	
+	gboolean bValid = _parse_xwindow_state (pXStateBuffer, iBufferNbElements, bIsFullScreen, bIsHidden, bIsMaximized, bDemandsAttention, bIsSticky);
 	
 	XFree (pXStateBuffer);
 	return bValid;
@@ -1250,6 +1270,19 @@ int cairo_dock_get_xwindow_desktop (Window Xid)
 	return iDesktopNumber;
 }
 
+static void _apply_frame_extents (const gulong *pBuffer, gulong iBufferNbElements, int x, int y, int *iLocalPositionX, int *iLocalPositionY, int *iWidthExtent, int *iHeightExtent)
+{
+	int left=0, right=0, top=0, bottom=0;
+	if (iBufferNbElements > 3)
+	{
+		left=pBuffer[0], right=pBuffer[1], top=pBuffer[2], bottom=pBuffer[3];
+	}
+	*iLocalPositionX = x - left;
+	*iLocalPositionY = y - top;
+	*iWidthExtent += left + right;
+	*iHeightExtent += top + bottom;
+}
+
 void cairo_dock_get_xwindow_geometry (Window Xid, int *iLocalPositionX, int *iLocalPositionY, int *iWidthExtent, int *iHeightExtent)  // renvoie les coordonnees du coin haut gauche dans le referentiel du viewport actuel. // sous KDE, x et y sont toujours nuls ! (meme avec XGetWindowAttributes).
 {
 	// get the geometry from X.
@@ -1275,23 +1308,14 @@ void cairo_dock_get_xwindow_geometry (Window Xid, int *iLocalPositionX, int *iLo
 	XTranslateCoordinates (s_XDisplay, Xid, root, 0, 0, &dest_x_return, &dest_y_return, &child_return);  // translate into the coordinate space of the root window. we need to do this, because (x_return,;y_return) is always (0;0)
 	
 	// take into account the window borders
-	int left=0, right=0, top=0, bottom=0;
 	gulong iLeftBytes, iBufferNbElements = 0;
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
 	gulong *pBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, XInternAtom (s_XDisplay, "_NET_FRAME_EXTENTS", False), 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pBuffer);
-	if (iBufferNbElements > 3)
-	{
-		left=pBuffer[0], right=pBuffer[1], top=pBuffer[2], bottom=pBuffer[3];
-	}
+	XGetWindowProperty (s_XDisplay, Xid, s_aNetFrameExtents, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pBuffer);
+	_apply_frame_extents (pBuffer, iBufferNbElements, dest_x_return, dest_y_return, iLocalPositionX, iLocalPositionY, iWidthExtent, iHeightExtent);
 	if (pBuffer)
 		XFree (pBuffer);
-	
-	*iLocalPositionX = dest_x_return - left;
-	*iLocalPositionY = dest_y_return - top;
-	*iWidthExtent += left + right;
-	*iHeightExtent += top + bottom;
 }
 
 
@@ -1467,14 +1491,18 @@ cairo_surface_t *cairo_dock_create_surface_from_xpixmap (Pixmap Xid, int iWidth,
 	return cCommand;
 }*/
 
-gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
+// pKnownTransientFor is the WM_TRANSIENT_FOR property if it has been fetched already, else NULL.
+static void _get_transient_for (Window Xid, const Window *pKnownTransientFor, Window *pTransientFor)
+{
+	if (pKnownTransientFor)
+		*pTransientFor = *pKnownTransientFor;
+	else
+		XGetTransientForHint (s_XDisplay, Xid, pTransientFor);
+}
+
+static gboolean _parse_xwindow_type (Window Xid, const gulong *pTypeBuffer, unsigned long iBufferNbElements, const Window *pKnownTransientFor, Window *pTransientFor)
 {
 	gboolean bKeep = FALSE;  // we only want to know if we can display this window in the dock or not, so a boolean is enough.
-	Atom aReturnedType = 0;
-	int aReturnedFormat = 0;
-	unsigned long iLeftBytes, iBufferNbElements;
-	gulong *pTypeBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmWindowType, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTypeBuffer);
 	if (iBufferNbElements != 0)
 	{
 		guint i;
@@ -1487,7 +1515,7 @@ gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
 			}
 			if (pTypeBuffer[i] == s_aNetWmWindowTypeDialog)  // dialog -> skip modal dialog, because we can't act on it independently from the parent window (it's most probably a dialog box like an open/save dialog)
 			{
-				XGetTransientForHint (s_XDisplay, Xid, pTransientFor);  // maybe we should also get the _NET_WM_STATE_MODAL property, although if a dialog is set modal but not transient, that would probably be an error from the application.
+				_get_transient_for (Xid, pKnownTransientFor, pTransientFor);  // maybe we should also get the _NET_WM_STATE_MODAL property, although if a dialog is set modal but not transient, that would probably be an error from the application.
 				if (*pTransientFor == None)
 				{
 					bKeep = TRUE;
@@ -1499,14 +1527,262 @@ gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
 				break;
 			}
 		}
-		XFree (pTypeBuffer);
 	}
 	else  // no type, take it by default, unless it's transient.
 	{
-		XGetTransientForHint (s_XDisplay, Xid, pTransientFor);
+		_get_transient_for (Xid, pKnownTransientFor, pTransientFor);
 		bKeep = (*pTransientFor == None);
 	}
 	return bKeep;
 }
 
+gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
+{
+	Atom aReturnedType = 0;
+	int aReturnedFormat = 0;
+	unsigned long iLeftBytes, iBufferNbElements = 0;
+	gulong *pTypeBuffer = NULL;
+	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmWindowType, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTypeBuffer);
+	gboolean bKeep = _parse_xwindow_type (Xid, pTypeBuffer, iBufferNbElements, NULL, pTransientFor);
+	if (pTypeBuffer)
+		XFree (pTypeBuffer);
+	return bKeep;
+}
+
+  ///////////////////
+ // WINDOWS BATCH //
+///////////////////
+
+static void _fill_xwindow_info (CairoDockXWindowInfo *pInfo, gboolean bShowInTaskbar, const gulong *pTypeBuffer, unsigned long iNbTypes, Window iTransientFor)
+{
+	// same logic as when the properties are fetched one by one (see _make_new_actor in the X manager)
+	pInfo->bShowInTaskbar = bShowInTaskbar;
+	if (bShowInTaskbar)
+		pInfo->bNormalWindow = _parse_xwindow_type (pInfo->Xid, pTypeBuffer, iNbTypes, &iTransientFor, &pInfo->iTransientFor);
+	else
+		pInfo->iTransientFor = iTransientFor;
+}
+
+#ifdef HAVE_XCB
+// the properties we fetch for each window, in this order.
+typedef enum {
+	_XPROP_STATE = 0,
+	_XPROP_TYPE,
+	_XPROP_TRANSIENT_FOR,
+	_XPROP_CLASS,
+	_XPROP_NET_NAME,
+	_XPROP_WM_NAME,
+	_XPROP_DESKTOP,
+	_XPROP_FRAME_EXTENTS,
+	_XPROP_NB_FIXED
+} _XProp;
+
+// the values of a format-32 property, as an array of longs like Xlib gives them.
+static gulong *_get_reply_longs (xcb_get_property_reply_t *pReply, unsigned long *iNbElements)
+{
+	*iNbElements = 0;
+	if (!pReply || pReply->format != 32)
+		return NULL;
+	int n = xcb_get_property_value_length (pReply) / 4;
+	if (n <= 0)
+		return NULL;
+	const uint32_t *pValues = xcb_get_property_value (pReply);
+	gulong *pBuffer = g_new (gulong, n);
+	int i;
+	for (i = 0; i < n; i ++)
+		pBuffer[i] = pValues[i];
+	*iNbElements = n;
+	return pBuffer;
+}
+
+// the value of a format-8 property, as a nul-terminated string.
+static gchar *_get_reply_string (xcb_get_property_reply_t *pReply)
+{
+	if (!pReply || pReply->format != 8 || xcb_get_property_value_length (pReply) <= 0)
+		return NULL;
+	return g_strndup (xcb_get_property_value (pReply), xcb_get_property_value_length (pReply));
+}
+
+static xcb_get_property_reply_t *_get_property_reply (xcb_connection_t *c, xcb_get_property_cookie_t cookie)
+{
+	xcb_generic_error_t *err = NULL;
+	xcb_get_property_reply_t *pReply = xcb_get_property_reply (c, cookie, &err);
+	free (err);  // the window may have been destroyed in the meantime, it will be removed with the next client list.
+	return pReply;
+}
+
+static void _fetch_xwindows_info_xcb (xcb_connection_t *c, CairoDockXWindowInfo *pInfos, gulong n, const Atom *pStringProps, guint iNbStringProps)
+{
+	const xcb_atom_t aProps[_XPROP_NB_FIXED] = {s_aNetWmState, s_aNetWmWindowType, XA_WM_TRANSIENT_FOR, XA_WM_CLASS, s_aNetWmName, s_aWmName, s_aNetWmDesktop, s_aNetFrameExtents};
+	const xcb_atom_t aTypes[_XPROP_NB_FIXED] = {XA_ATOM, XA_ATOM, XA_WINDOW, XA_STRING, s_aUtf8String, s_aString, XA_CARDINAL, XA_CARDINAL};
+	guint iNbProps = _XPROP_NB_FIXED + 2 * iNbStringProps;  // string props are tried as STRING, then as UTF8_STRING
+	xcb_window_t root = DefaultRootWindow (s_XDisplay);
+	
+	// send all the requests, for all the windows
+	xcb_get_property_cookie_t *pPropCookies = g_new (xcb_get_property_cookie_t, n * iNbProps);
+	xcb_get_geometry_cookie_t *pGeomCookies = g_new (xcb_get_geometry_cookie_t, n);
+	xcb_translate_coordinates_cookie_t *pCoordCookies = g_new (xcb_translate_coordinates_cookie_t, n);
+	gulong i;
+	guint j;
+	for (i = 0; i < n; i ++)
+	{
+		xcb_window_t Xid = pInfos[i].Xid;
+		xcb_get_property_cookie_t *pCookies = pPropCookies + i * iNbProps;
+		for (j = 0; j < _XPROP_NB_FIXED; j ++)
+			pCookies[j] = xcb_get_property (c, 0, Xid, aProps[j], aTypes[j], 0, G_MAXUINT32);
+		for (j = 0; j < iNbStringProps; j ++)
+		{
+			pCookies[_XPROP_NB_FIXED + 2*j]     = xcb_get_property (c, 0, Xid, pStringProps[j], s_aString, 0, G_MAXUINT32);
+			pCookies[_XPROP_NB_FIXED + 2*j + 1] = xcb_get_property (c, 0, Xid, pStringProps[j], s_aUtf8String, 0, G_MAXUINT32);
+		}
+		pGeomCookies[i] = xcb_get_geometry (c, Xid);
+		pCoordCookies[i] = xcb_translate_coordinates (c, Xid, root, 0, 0);
+	}
+	xcb_flush (c);
+	
+	// then collect the replies; only the first one waits for the server
+	xcb_get_property_reply_t **pReplies = g_new0 (xcb_get_property_reply_t*, iNbProps);
+	for (i = 0; i < n; i ++)
+	{
+		CairoDockXWindowInfo *pInfo = &pInfos[i];
+		for (j = 0; j < iNbProps; j ++)
+			pReplies[j] = _get_property_reply (c, pPropCookies[i * iNbProps + j]);
+		
+		// state and type
+		unsigned long iNbStates, iNbTypes, iNbTransient;
+		gulong *pStates = _get_reply_longs (pReplies[_XPROP_STATE], &iNbStates);
+		gulong *pTypes = _get_reply_longs (pReplies[_XPROP_TYPE], &iNbTypes);
+		gulong *pTransient = _get_reply_longs (pReplies[_XPROP_TRANSIENT_FOR], &iNbTransient);
+		gboolean bShowInTaskbar = _parse_xwindow_state (pStates, iNbStates, &pInfo->bIsFullScreen, &pInfo->bIsHidden, &pInfo->bIsMaximized, &pInfo->bDemandsAttention, &pInfo->bIsSticky);
+		_fill_xwindow_info (pInfo, bShowInTaskbar, pTypes, iNbTypes, iNbTransient != 0 ? pTransient[0] : None);
+		g_free (pStates);
+		g_free (pTypes);
+		g_free (pTransient);
+		
+		// class ("res_name\0res_class\0")
+		xcb_get_property_reply_t *pReply = pReplies[_XPROP_CLASS];
+		if (pReply && pReply->format == 8 && xcb_get_property_value_length (pReply) > 0)
+		{
+			int len = xcb_get_property_value_length (pReply);
+			gchar *buf = g_new0 (gchar, len + 2);  // so that both strings are terminated
+			memcpy (buf, xcb_get_property_value (pReply), len);
+			const gchar *res_name = buf;
+			const gchar *res_class = buf + strlen (buf) + 1;
+			pInfo->cClass = _parse_xwindow_class (res_class, res_name, &pInfo->cWmClass, &pInfo->cWmName);
+			g_free (buf);
+		}
+		
+		// name and desktop
+		pInfo->cName = _get_reply_string (pReplies[_XPROP_NET_NAME]);
+		if (! pInfo->cName)
+			pInfo->cName = _get_reply_string (pReplies[_XPROP_WM_NAME]);
+		unsigned long iNbDesktops;
+		gulong *pDesktop = _get_reply_longs (pReplies[_XPROP_DESKTOP], &iNbDesktops);
+		pInfo->iNumDesktop = (iNbDesktops > 0 ? (int)pDesktop[0] : 0);
+		g_free (pDesktop);
+		
+		// geometry
+		xcb_generic_error_t *err = NULL;
+		xcb_get_geometry_reply_t *pGeom = xcb_get_geometry_reply (c, pGeomCookies[i], &err);
+		free (err);
+		err = NULL;
+		xcb_translate_coordinates_reply_t *pCoord = xcb_translate_coordinates_reply (c, pCoordCookies[i], &err);
+		free (err);
+		pInfo->iWidthExtent = (pGeom ? pGeom->width : 0);
+		pInfo->iHeightExtent = (pGeom ? pGeom->height : 0);
+		unsigned long iNbExtents;
+		gulong *pExtents = _get_reply_longs (pReplies[_XPROP_FRAME_EXTENTS], &iNbExtents);
+		_apply_frame_extents (pExtents, iNbExtents, pCoord ? pCoord->dst_x : 0, pCoord ? pCoord->dst_y : 0,
+			&pInfo->iLocalPositionX, &pInfo->iLocalPositionY, &pInfo->iWidthExtent, &pInfo->iHeightExtent);
+		g_free (pExtents);
+		free (pGeom);
+		free (pCoord);
+		
+		// additional string properties
+		for (j = 0; j < iNbStringProps; j ++)
+		{
+			pInfo->pStringProps[j] = _get_reply_string (pReplies[_XPROP_NB_FIXED + 2*j]);
+			if (! pInfo->pStringProps[j])
+				pInfo->pStringProps[j] = _get_reply_string (pReplies[_XPROP_NB_FIXED + 2*j + 1]);
+		}
+		
+		for (j = 0; j < iNbProps; j ++)
+			free (pReplies[j]);
+	}
+	g_free (pReplies);
+	g_free (pPropCookies);
+	g_free (pGeomCookies);
+	g_free (pCoordCookies);
+}
+#endif
+
+static void _fetch_xwindow_info_xlib (CairoDockXWindowInfo *pInfo, const Atom *pStringProps, guint iNbStringProps)
+{
+	Window Xid = pInfo->Xid;
+	pInfo->bShowInTaskbar = cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Xid, &pInfo->bIsFullScreen, &pInfo->bIsHidden, &pInfo->bIsMaximized, &pInfo->bDemandsAttention, &pInfo->bIsSticky);
+	if (pInfo->bShowInTaskbar)
+	{
+		pInfo->bNormalWindow = cairo_dock_get_xwindow_type (Xid, &pInfo->iTransientFor);
+		if (pInfo->bNormalWindow || pInfo->iTransientFor != None)
+			pInfo->cClass = cairo_dock_get_xwindow_class (Xid, &pInfo->cWmClass, &pInfo->cWmName);
+	}
+	else
+		XGetTransientForHint (s_XDisplay, Xid, &pInfo->iTransientFor);
+	if (pInfo->bShowInTaskbar)
+		pInfo->cName = cairo_dock_get_xwindow_name (Xid, TRUE);
+	if (! pInfo->cClass)  // the window won't be displayed, no need to go further
+		return;
+	
+	pInfo->iNumDesktop = cairo_dock_get_xwindow_desktop (Xid);
+	cairo_dock_get_xwindow_geometry (Xid, &pInfo->iLocalPositionX, &pInfo->iLocalPositionY, &pInfo->iWidthExtent, &pInfo->iHeightExtent);
+	guint j;
+	for (j = 0; j < iNbStringProps; j ++)
+		pInfo->pStringProps[j] = cairo_dock_get_xwindow_string_prop (Xid, pStringProps[j]);
+}
+
+CairoDockXWindowInfo *cairo_dock_fetch_xwindows_info (const Window *pXids, gulong iNbWindows, const Atom *pStringProps, guint iNbStringProps)
+{
+	CairoDockXWindowInfo *pInfos = g_new0 (CairoDockXWindowInfo, iNbWindows);
+	gulong i;
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		pInfos[i].Xid = pXids[i];
+		pInfos[i].iTransientFor = None;
+		pInfos[i].pStringProps = g_new0 (gchar*, iNbStringProps);
+		pInfos[i].iNbStringProps = iNbStringProps;
+	}
+	if (iNbWindows == 0)
+		return pInfos;
+	
+	#ifdef HAVE_XCB
+	xcb_connection_t *c = XGetXCBConnection (s_XDisplay);
+	if (c)
+	{
+		_fetch_xwindows_info_xcb (c, pInfos, iNbWindows, pStringProps, iNbStringProps);
+		return pInfos;
+	}
+	#endif
+	for (i = 0; i < iNbWindows; i ++)
+		_fetch_xwindow_info_xlib (&pInfos[i], pStringProps, iNbStringProps);
+	return pInfos;
+}
+
+void cairo_dock_free_xwindows_info (CairoDockXWindowInfo *pInfos, gulong iNbWindows)
+{
+	gulong i;
+	for (i = 0; i < iNbWindows; i ++)
+	{
+		CairoDockXWindowInfo *pInfo = &pInfos[i];
+		g_free (pInfo->cClass);
+		g_free (pInfo->cWmClass);
+		g_free (pInfo->cWmName);
+		g_free (pInfo->cName);
+		guint j;
+		for (j = 0; j < pInfo->iNbStringProps; j ++)
+			g_free (pInfo->pStringProps[j]);
+		g_free (pInfo->pStringProps);
+	}
+	g_free (pInfos);
+}
+
 #endif
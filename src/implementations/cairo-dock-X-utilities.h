@@ -142,6 +142,33 @@ int cairo_dock_get_xwindow_desktop (Window Xid);  // desklet
 void cairo_dock_get_xwindow_geometry (Window Xid, int *iLocalPositionX, int *iLocalPositionY, int *iWidthExtent, int *iHeightExtent);  // desklet
 void cairo_dock_move_xwindow_to_absolute_position (Window Xid, int iDesktopNumber, int iPositionX, int iPositionY);  // desklet
 
+  ///////////////////
+ // WINDOWS BATCH //
+///////////////////
+
+/* Properties of a window needed to make its actor; the same as the ones given by the functions above.
+ */
+typedef struct _CairoDockXWindowInfo {
+	Window Xid;
+	gboolean bShowInTaskbar;  // FALSE if it skips the taskbar
+	gboolean bIsFullScreen, bIsHidden, bIsMaximized, bDemandsAttention, bIsSticky;
+	gboolean bNormalWindow;  // see cairo_dock_get_xwindow_type
+	Window iTransientFor;
+	gchar *cClass, *cWmClass, *cWmName;  // see cairo_dock_get_xwindow_class
+	gchar *cName;
+	int iNumDesktop;
+	int iLocalPositionX, iLocalPositionY, iWidthExtent, iHeightExtent;  // see cairo_dock_get_xwindow_geometry
+	gchar **pStringProps;  // values of the additional string properties (can be NULL)
+	guint iNbStringProps;
+} CairoDockXWindowInfo;
+
+/* Get the properties of several windows at once. If XCB is available, all the requests are sent at once and the replies are collected afterwards, which makes 1 round trip to the X server instead of about 20 per window.
+ * The strings of the result can be stolen (set them to NULL), and the result is freed with cairo_dock_free_xwindows_info.
+ */
+CairoDockXWindowInfo *cairo_dock_fetch_xwindows_info (const Window *pXids, gulong iNbWindows, const Atom *pStringProps, guint iNbStringProps);
+
+void cairo_dock_free_xwindows_info (CairoDockXWindowInfo *pInfos, gulong iNbWindows);
+
 #endif
 
 G_END_DECLS
@@ -32,15 +32,30 @@
 #include "cairo-dock-draw.h"
 #include "cairo-dock-animations.h"  // cairo_dock_calculate_magnitude
 #include "cairo-dock-draw-opengl.h"
+#include "cairo-dock-opengl-batch.h"
 #include "cairo-dock-opengl-path.h"
 #include "cairo-dock-log.h"
 #include "cairo-dock-dock-facility.h"
+#include "cairo-dock-dock-geometry-priv.h"
 #include "cairo-dock-object.h"
 #include "cairo-dock-dock-manager.h"
 #include "cairo-dock-style-manager.h"
 #include "cairo-dock-desktop-manager.h"  // gldi_dock_get_screen_width
 #include "cairo-dock-default-view.h"
 
+static CairoDockGLBatch *s_pIconsBatch = NULL;  // shared by all the docks, they are drawn one after the other.
+// how much the batch is used, logged from time to time in debug mode.
+static guint s_iNbFrames = 0, s_iNbBatchedIcons = 0, s_iNbSingleIcons = 0, s_iNbBatchDraws = 0, s_iNbBatchDrawCalls = 0;
+#define CD_BATCH_STATS_PERIOD 1000  // frames
+
+static void _draw_icons_batch (void)
+{
+	if (cairo_dock_gl_batch_is_empty (s_pIconsBatch))
+		return;
+	cairo_dock_gl_batch_draw (s_pIconsBatch);
+	s_iNbBatchDraws ++;
+	s_iNbBatchDrawCalls += s_pIconsBatch->iNbDrawCalls;
+}
 
 static void cd_calculate_max_dock_size_default (CairoDock *pDock)
 {
@@ -263,16 +278,20 @@ static void cd_render_default (cairo_t *pCairoContext, CairoDock *pDock)
 		cairo_dock_draw_string (pCairoContext, pDock, myIconsParam.iStringLineWidth, FALSE, FALSE);
 
 	//\____________________ On dessine les icones et les etiquettes, en tenant compte de l'ordre pour dessiner celles en arriere-plan avant celles en avant-plan.
-	GList *pFirstDrawnElement = cairo_dock_get_first_drawn_element_linear (pDock->icons);
-	if (pFirstDrawnElement == NULL)
+	gint iFirstDrawnIndex = gldi_dock_geometry_get_first_drawn_index (pDock);
+	if (iFirstDrawnIndex < 0)
 		return;
 	
 	double fDockMagnitude = cairo_dock_calculate_magnitude (pDock->iMagnitudeIndex);  // * pDock->fMagnitudeMax
+	GldiDockGeometry *pGeometry = gldi_dock_get_geometry (pDock);
+	guint iNbIcons = pGeometry->iNbIcons, i, n;
 	Icon *icon;
-	GList *ic = pFirstDrawnElement;
-	do
+	for (n = 0; n < iNbIcons; n ++)
 	{
-		icon = ic->data;
+		i = (iFirstDrawnIndex + n) % iNbIcons;
+		if (i >= pGeometry->iNbIcons)  // an icon has been removed while drawing
+			break;
+		icon = pGeometry->pIcons[i];
 
 		cairo_save (pCairoContext);
 		if (myIconsParam.iSeparatorType != CAIRO_DOCK_NORMAL_SEPARATOR && icon->cFileName == NULL && GLDI_OBJECT_IS_SEPARATOR_ICON (icon))
@@ -280,9 +299,7 @@ static void cd_render_default (cairo_t *pCairoContext, CairoDock *pDock)
 		else
 			cairo_dock_render_one_icon (icon, pDock, pCairoContext, fDockMagnitude, TRUE);
 		cairo_restore (pCairoContext);
-
-		ic = cairo_dock_get_next_element (ic, pDock->icons);
-	} while (ic != pFirstDrawnElement);
+	}
 }
 
 
@@ -620,25 +637,55 @@ static void cd_render_opengl_default (CairoDock *pDock)
 	GLfloat fDirection[4] = {.3, .0, -.8, 0.};  // le dernier 0 <=> direction.
 	glLightfv(GL_LIGHT0, GL_POSITION, fDirection);*/
 	
-	pFirstDrawnElement = cairo_dock_get_first_drawn_element_linear (pDock->icons);
-	if (pFirstDrawnElement == NULL)
+	gint iFirstDrawnIndex = gldi_dock_geometry_get_first_drawn_index (pDock);
+	if (iFirstDrawnIndex < 0)
 		return;
 	
+	// runs of plain icons are gathered and drawn all together; the others (animated, with indicators, etc) are drawn one by one, after the previous run, so that the icons are still drawn in order.
+	gboolean bBatch = cairo_dock_icons_can_be_batched ();
+	if (bBatch && s_pIconsBatch == NULL)
+		s_pIconsBatch = cairo_dock_gl_batch_new ();
+	
+	GldiDockGeometry *pGeometry = gldi_dock_get_geometry (pDock);
+	guint iNbIcons = pGeometry->iNbIcons, i, n;
 	Icon *icon;
-	GList *ic = pFirstDrawnElement;
-	do
+	for (n = 0; n < iNbIcons; n ++)
 	{
-		icon = ic->data;
+		i = (iFirstDrawnIndex + n) % iNbIcons;
+		if (i >= pGeometry->iNbIcons)  // an icon has been removed while drawing
+			break;
+		icon = pGeometry->pIcons[i];
 		
-		glPushMatrix ();
 		if (myIconsParam.iSeparatorType != CAIRO_DOCK_NORMAL_SEPARATOR && icon->cFileName == NULL && GLDI_OBJECT_IS_SEPARATOR_ICON (icon))
+		{
+			if (bBatch)
+				_draw_icons_batch ();
+			glPushMatrix ();
 			_cairo_dock_draw_separator_opengl (icon, pDock, fDockMagnitude);
+			glPopMatrix ();
+		}
+		else if (bBatch && cairo_dock_batch_one_icon_opengl (icon, pDock, fDockMagnitude, TRUE, s_pIconsBatch))
+		{
+			s_iNbBatchedIcons ++;
+		}
 		else
+		{
+			if (bBatch)
+				_draw_icons_batch ();
+			glPushMatrix ();
 			cairo_dock_render_one_icon_opengl (icon, pDock, fDockMagnitude, TRUE);
-		glPopMatrix ();
-		
-		ic = cairo_dock_get_next_element (ic, pDock->icons);
-	} while (ic != pFirstDrawnElement);
+			glPopMatrix ();
+			s_iNbSingleIcons ++;
+		}
+	}
+	if (bBatch)
+		_draw_icons_batch ();
+	
+	if (++ s_iNbFrames == CD_BATCH_STATS_PERIOD)
+	{
+		cd_debug ("in the last %d frames: %u icons batched, drawn in %u batches (%u draw calls), %u icons drawn one by one", CD_BATCH_STATS_PERIOD, s_iNbBatchedIcons, s_iNbBatchDraws, s_iNbBatchDrawCalls, s_iNbSingleIcons);
+		s_iNbFrames = s_iNbBatchedIcons = s_iNbSingleIcons = s_iNbBatchDraws = s_iNbBatchDrawCalls = 0;
+	}
 	//glDisable (GL_LIGHTING);
 }
 
@@ -659,13 +706,10 @@ static Icon *cd_calculate_icons_default (CairoDock *pDock)
 	Icon *pPointedIcon = cairo_dock_apply_wave_effect_linear (pDock);
 	
 	//\____________________ On calcule les position/etirements/alpha des icones.
-	Icon* icon;
-	GList* ic;
-	for (ic = pDock->icons; ic != NULL; ic = ic->next)
-	{
-		icon = ic->data;
-		_cd_calculate_construction_parameters_generic (icon, pDock);
-	}
+	GldiDockGeometry *pGeometry = gldi_dock_get_geometry (pDock);  // up-to-date, since the wave has just used it.
+	guint i;
+	for (i = 0; i < pGeometry->iNbIcons; i ++)
+		_cd_calculate_construction_parameters_generic (pGeometry->pIcons[i], pDock);
 	
 	cairo_dock_check_if_mouse_inside_linear (pDock);
 	
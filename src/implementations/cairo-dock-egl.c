@@ -54,6 +54,13 @@ static EGLConfig s_eglConfig = 0;
 static gboolean s_eglX11 = FALSE;
 static gboolean s_eglWayland = FALSE;
 static gboolean s_bNativePixmap = FALSE;
+static gboolean s_bBufferAge = FALSE;
+
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+typedef EGLBoolean (EGLAPIENTRYP CD_PFNEGLSWAPBUFFERSWITHDAMAGEPROC) (EGLDisplay dpy, EGLSurface surface, const EGLint *rects, EGLint n_rects);
+static CD_PFNEGLSWAPBUFFERSWITHDAMAGEPROC s_eglSwapBuffersWithDamage = NULL;
 
 // platform functions -- use these if supported
 // note: eglCreatePlatformWindowSurface and eglCreatePlatformWindowSurfaceEXT differ
@@ -259,6 +266,14 @@ static gboolean _initialize_opengl_backend (gboolean bForceOpenGL)
 	
 	s_bNativePixmap = _check_client_egl_extension ("EGL_KHR_image_pixmap");
 	
+	// partial redraws: know what the back buffer contains, and tell the compositor what has changed.
+	s_bBufferAge = _check_client_egl_extension ("EGL_EXT_buffer_age");
+	if (_check_client_egl_extension ("EGL_KHR_swap_buffers_with_damage"))
+		s_eglSwapBuffersWithDamage = (CD_PFNEGLSWAPBUFFERSWITHDAMAGEPROC) eglGetProcAddress ("eglSwapBuffersWithDamageKHR");
+	else if (_check_client_egl_extension ("EGL_EXT_swap_buffers_with_damage"))
+		s_eglSwapBuffersWithDamage = (CD_PFNEGLSWAPBUFFERSWITHDAMAGEPROC) eglGetProcAddress ("eglSwapBuffersWithDamageEXT");
+	cd_debug ("EGL buffer age: %d, swap with damage: %d", s_bBufferAge, s_eglSwapBuffersWithDamage != NULL);
+	
 	return TRUE;
 }
 
@@ -300,6 +315,43 @@ static void _container_end_draw (GldiContainer *pContainer)
 	eglSwapBuffers (s_eglDisplay, surface);
 }
 
+static void _container_end_draw_with_damage (GldiContainer *pContainer, GdkRectangle *pArea)
+{
+	EGLSurface surface = pContainer->eglSurface;
+	if (!surface) return;
+	if (s_eglSwapBuffersWithDamage == NULL)
+	{
+		eglSwapBuffers (s_eglDisplay, surface);
+		return;
+	}
+	gint scale = gdk_window_get_scale_factor (gldi_container_get_gdk_window (pContainer));
+	int h = (pContainer->bIsHorizontal ? pContainer->iHeight : pContainer->iWidth);
+	EGLint rect[4] = {pArea->x * scale,
+		(h - pArea->y - pArea->height) * scale,  // the origin is the bottom-left corner of the surface.
+		pArea->width * scale,
+		pArea->height * scale};
+	s_eglSwapBuffersWithDamage (s_eglDisplay, surface, rect, 1);
+}
+
+static gint _container_get_buffer_age (GldiContainer *pContainer)
+{
+	EGLSurface surface = pContainer->eglSurface;
+	if (!surface) return 0;
+	EGLint iAge = 0;
+	if (s_bBufferAge)
+	{
+		if (! eglQuerySurface (s_eglDisplay, surface, EGL_BUFFER_AGE_EXT, &iAge))  // the surface must be current
+			iAge = 0;
+	}
+	else
+	{
+		EGLint iSwapBehavior = EGL_BUFFER_DESTROYED;
+		if (eglQuerySurface (s_eglDisplay, surface, EGL_SWAP_BEHAVIOR, &iSwapBehavior) && iSwapBehavior == EGL_BUFFER_PRESERVED)
+			iAge = 1;  // the back buffer always holds the last frame.
+	}
+	return iAge;
+}
+
 static void _init_surface (GtkWidget *pWidget, GldiContainer *pContainer)
 {
 	cd_debug ("pWidget: %p, pContainer: %p (%dx%d)", pWidget, pContainer, pContainer->iWidth, pContainer->iHeight);
@@ -502,6 +554,8 @@ void gldi_register_egl_backend (void)
 	gmb.container_make_current = _container_make_current;
 	gmb.offscreen_make_current = _offscreen_make_current;
 	gmb.container_end_draw = _container_end_draw;
+	gmb.container_end_draw_with_damage = _container_end_draw_with_damage;
+	gmb.container_get_buffer_age = _container_get_buffer_age;
 	gmb.container_init = _container_init;
 	gmb.container_finish = _container_finish;
 #ifdef HAVE_WAYLAND
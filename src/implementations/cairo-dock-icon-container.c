@@ -32,6 +32,7 @@
 #include "cairo-dock-separator-manager.h"
 #include "cairo-dock-backends-manager.h"
 #include "cairo-dock-icon-facility.h"
+#include "cairo-dock-image-buffer.h"  // cairo_dock_image_buffer_get_surface
 #include "cairo-dock-icon-container.h"
 
 CairoDockImageBuffer g_pBoxAboveBuffer;
@@ -49,20 +50,24 @@ static void _cairo_dock_draw_subdock_content_as_emblem (Icon *pIcon, G_GNUC_UNUS
 	int i;
 	Icon *icon;
 	GList *ic;
+	cairo_surface_t *pSurface;
 	for (ic = pIcon->pSubDock->icons, i = 0; ic != NULL && i < 4; ic = ic->next)
 	{
 		icon = ic->data;
-		if (GLDI_OBJECT_IS_SEPARATOR_ICON (icon) || icon->image.pSurface == NULL)
+		if (GLDI_OBJECT_IS_SEPARATOR_ICON (icon))
+			continue;
+		pSurface = cairo_dock_image_buffer_get_surface (&icon->image);  // the icon may only be kept in video memory.
+		if (pSurface == NULL)
 			continue;
 		
 		cairo_dock_get_icon_extent (icon, &wi, &hi);
-		// we could use cairo_dock_print_overlay_on_icon_from_surface (pIcon, icon->image.pSurface, wi, hi, i), but it's slightly optimized to draw it ourselves.
+		// we could use cairo_dock_print_overlay_on_icon_from_surface (pIcon, pSurface, wi, hi, i), but it's slightly optimized to draw it ourselves.
 		
 		cairo_save (pCairoContext);
 		cairo_translate (pCairoContext, (i&1) * w/2, (i/2) * h/2);
 		
 		cairo_scale (pCairoContext, .5 * w / wi, .5 * h / hi);
-		cairo_set_source_surface (pCairoContext, icon->image.pSurface, 0, 0);
+		cairo_set_source_surface (pCairoContext, pSurface, 0, 0);
 		cairo_paint (pCairoContext);
 		
 		cairo_restore (pCairoContext);
@@ -97,10 +102,14 @@ static void _cairo_dock_draw_subdock_content_as_stack (Icon *pIcon, G_GNUC_UNUSE
 	int i, k=0;
 	Icon *icon;
 	GList *ic;
+	cairo_surface_t *pSurface;
 	for (ic = pIcon->pSubDock->icons, i = 0; ic != NULL && i < 3; ic = ic->next)
 	{
 		icon = ic->data;
-		if (CAIRO_DOCK_ICON_TYPE_IS_SEPARATOR (icon) || !icon->image.pSurface)
+		if (CAIRO_DOCK_ICON_TYPE_IS_SEPARATOR (icon))
+			continue;
+		pSurface = cairo_dock_image_buffer_get_surface (&icon->image);  // the icon may only be kept in video memory.
+		if (pSurface == NULL)
 			continue;
 		
 		switch (i)
@@ -126,7 +135,7 @@ static void _cairo_dock_draw_subdock_content_as_stack (Icon *pIcon, G_GNUC_UNUSE
 		cairo_translate (pCairoContext, k * w / 10, k * h / 10);
 		
 		cairo_scale (pCairoContext, .8 * w / wi, .8 * h / hi);
-		cairo_set_source_surface (pCairoContext, icon->image.pSurface, 0, 0);
+		cairo_set_source_surface (pCairoContext, pSurface, 0, 0);
 		cairo_paint (pCairoContext);
 		
 		cairo_restore (pCairoContext);
@@ -246,6 +255,7 @@ static void _cairo_dock_draw_subdock_content_as_box (Icon *pIcon, GldiContainer
 	int wi, hi;
 	Icon *icon;
 	GList *ic;
+	cairo_surface_t *pSurface;
 	for (ic = pIcon->pSubDock->icons, i = 0; ic != NULL && i < 3; ic = ic->next, i++)
 	{
 		icon = ic->data;
@@ -254,6 +264,9 @@ static void _cairo_dock_draw_subdock_content_as_box (Icon *pIcon, GldiContainer
 			i --;
 			continue;
 		}
+		pSurface = cairo_dock_image_buffer_get_surface (&icon->image);  // the icon may only be kept in video memory.
+		if (pSurface == NULL)
+			continue;
 		
 		if (pContainer->bIsHorizontal)
 		{
@@ -278,7 +291,7 @@ static void _cairo_dock_draw_subdock_content_as_box (Icon *pIcon, GldiContainer
 		cairo_translate (pCairoContext, dx, dy);
 		cairo_scale (pCairoContext, .8 * w / wi, .8 * h / hi);
 		cairo_set_source_surface (pCairoContext,
-			icon->image.pSurface,
+			pSurface,
 			0,
 			0);
 		cairo_paint (pCairoContext);
@@ -0,0 +1,249 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Cost of the search of the desktop file of a window class, as done by the class manager: an exact lookup in the desktop file DB,
+ * then the known variants of the desktop file IDs (org.gnome./org.kde./org.freedesktop. prefices, snap's "name_name" IDs and the apps
+ * with known problems). The variants are one lookup in a table built by the DB (gldi_desktop_file_db_lookup_variant), compared to the
+ * former heuristics, which built each spelling and looked it up in turn.
+ * The classes of data/window-classes.txt are replayed against the desktop files of data/desktop-files.txt, installed in a temporary
+ * directory; it also checks that both searches find the same desktop file for each class. Both lists are synthetic: they are written
+ * by hand from common applications, not captured from a real session.
+ * The normalisation of the classes (cairo_dock_guess_class) is not part of it, it's the same for both.
+ */
+
+#include <glib/gstdio.h>
+#include "cairo-dock-desktop-file-db.h"
+#include "bench-utils.h"
+
+#define NB_LOOKUPS 1000000
+
+extern gchar *g_cCairoDockDataDir;
+
+static gchar **_read_fixture (const gchar *cFileName)
+{
+	gchar *cPath = g_build_filename (BENCH_DATA_DIR, cFileName, NULL);
+	gchar *cContent = NULL;
+	gboolean r = g_file_get_contents (cPath, &cContent, NULL, NULL);
+	BENCH_CHECK (r, "can't read %s", cPath);
+	g_free (cPath);
+
+	GPtrArray *pLines = g_ptr_array_new ();
+	gchar **pAllLines = g_strsplit (cContent, "\n", -1);
+	gchar **l;
+	for (l = pAllLines; *l != NULL; l ++)
+	{
+		if (**l != '\0' && **l != '#')
+			g_ptr_array_add (pLines, g_strdup (*l));
+	}
+	g_ptr_array_add (pLines, NULL);
+	g_strfreev (pAllLines);
+	g_free (cContent);
+	return (gchar **) g_ptr_array_free (pLines, FALSE);
+}
+
+/* Write the desktop files in <cRootDir>/data/applications, and make it the only applications directory.
+ * GIO only loads a desktop file if the program of its Exec key exists, so they all run 'true'.
+ */
+static void _install_desktop_files (const gchar *cRootDir, gchar **pDesktopFiles)
+{
+	gchar *cUserDir = g_build_filename (cRootDir, "data", NULL);
+	gchar *cSystemDir = g_build_filename (cRootDir, "system", NULL);
+	gchar *cAppsDir = g_build_filename (cUserDir, "applications", NULL);
+	g_mkdir_with_parents (cAppsDir, 0700);
+	g_mkdir_with_parents (cSystemDir, 0700);
+	g_setenv ("XDG_DATA_HOME", cUserDir, TRUE);
+	g_setenv ("XDG_DATA_DIRS", cSystemDir, TRUE);
+
+	gchar **d;
+	for (d = pDesktopFiles; *d != NULL; d ++)
+	{
+		gchar **pFields = g_strsplit (*d, " ", 2);
+		gchar *cContent = g_strdup_printf ("[Desktop Entry]\nType=Application\nName=%s\nExec=true\n%s%s%s",
+			pFields[0],
+			pFields[1] ? "StartupWMClass=" : "",
+			pFields[1] ? pFields[1] : "",
+			pFields[1] ? "\n" : "");
+		gchar *cFileName = g_strdup_printf ("%s/%s.desktop", cAppsDir, pFields[0]);
+		gboolean r = g_file_set_contents (cFileName, cContent, -1, NULL);
+		BENCH_CHECK (r, "can't write %s", cFileName);
+		g_free (cFileName);
+		g_free (cContent);
+		g_strfreev (pFields);
+	}
+	g_free (cAppsDir);
+	g_free (cSystemDir);
+	g_free (cUserDir);
+}
+
+static void _remove_dir (const gchar *cDir)  // recursively
+{
+	GDir *dir = g_dir_open (cDir, 0, NULL);
+	if (dir != NULL)
+	{
+		const gchar *cName;
+		while ((cName = g_dir_read_name (dir)) != NULL)
+		{
+			gchar *cPath = g_build_filename (cDir, cName, NULL);
+			if (g_file_test (cPath, G_FILE_TEST_IS_DIR))
+				_remove_dir (cPath);
+			else
+				g_remove (cPath);
+			g_free (cPath);
+		}
+		g_dir_close (dir);
+	}
+	g_rmdir (cDir);
+}
+
+  /////////////////////////
+ /// FORMER HEURISTICS ///
+/////////////////////////
+
+/* The heuristics of _search_desktop_file () as they were before the variants were indexed (verbatim, apart from the refs:
+ * the apps are returned as the DB owns them).
+ */
+static GDesktopAppInfo *_former_lookup_variant (const gchar *cDesktopFile)
+{
+	GDesktopAppInfo *app;
+	if (!strcmp (cDesktopFile, "gnome-terminal-server"))
+	{
+		const char *tmpkey = "org.gnome.terminal";
+		app = gldi_desktop_file_db_lookup (tmpkey, TRUE); // we want exact match for org.gnome.terminal.desktop
+		if (app)
+			return app;
+	}
+	if (!strcmp (cDesktopFile, "gted"))
+	{
+		const char *tmpkey = "org.gnome.texteditor";
+		app = gldi_desktop_file_db_lookup (tmpkey, TRUE); // we want exact match
+		if (app)
+			return app;
+	}
+
+	GString *sID = g_string_new (NULL);
+	const char *prefices[] = {"org.gnome.", "org.kde.", "org.freedesktop.", NULL};
+	int j;
+
+	app = NULL;
+	for (j = 0; prefices[j]; j++)
+	{
+		g_string_printf (sID, "%s%s", prefices[j], cDesktopFile);
+		app = gldi_desktop_file_db_lookup (sID->str, TRUE); // we want exact match for the file name
+		if (app) break;
+	}
+
+	if (!app)
+	{
+		g_string_printf (sID, "%s_%s", cDesktopFile, cDesktopFile);
+		app = gldi_desktop_file_db_lookup (sID->str, TRUE); // we want exact match for the file name
+	}
+
+	g_string_free(sID, TRUE);
+	return app;
+}
+
+static GDesktopAppInfo *_former_search_desktop_file (const gchar *cClass)
+{
+	GDesktopAppInfo *app = gldi_desktop_file_db_lookup (cClass, FALSE);
+	return (app ? app : _former_lookup_variant (cClass));
+}
+
+static GDesktopAppInfo *_search_desktop_file (const gchar *cClass)
+{
+	GDesktopAppInfo *app = gldi_desktop_file_db_lookup (cClass, FALSE);
+	return (app ? app : gldi_desktop_file_db_lookup_variant (cClass));
+}
+
+  /////////////
+ /// TESTS ///
+/////////////
+
+static void _test_same_desktop_files (gchar **pClasses)
+{
+	guint iNbFound = 0, iNbVariants = 0;
+	gchar **c;
+	GDesktopAppInfo *app, *pFormerApp;
+	for (c = pClasses; *c != NULL; c ++)
+	{
+		app = _search_desktop_file (*c);
+		pFormerApp = _former_search_desktop_file (*c);
+		BENCH_CHECK (app == pFormerApp, "'%s': %s instead of %s", *c,
+			app ? g_desktop_app_info_get_filename (app) : "nothing",
+			pFormerApp ? g_desktop_app_info_get_filename (pFormerApp) : "nothing");
+		if (app)
+			iNbFound ++;
+		if (app && ! gldi_desktop_file_db_lookup (*c, FALSE))
+			iNbVariants ++;
+	}
+	// the fixture is meant to have all the cases.
+	BENCH_CHECK (iNbVariants != 0 && iNbFound != iNbVariants && iNbFound != g_strv_length (pClasses), "%u classes found, %u through a variant", iNbFound, iNbVariants);
+	printf ("%u classes: %u found, %u of them through a variant\n", g_strv_length (pClasses), iNbFound, iNbVariants);
+}
+
+  //////////////////
+ /// BENCHMARKS ///
+//////////////////
+
+static void _bench_lookups (gchar **pClasses)
+{
+	guint iNbClasses = g_strv_length (pClasses), i = 0;
+	GDesktopAppInfo *app;
+
+	BENCH ("search a class, former heuristics", NB_LOOKUPS,
+		app = _former_search_desktop_file (pClasses[i]);
+		s_iBenchSink += (app != NULL);
+		if (++ i == iNbClasses) i = 0);
+
+	i = 0;
+	BENCH ("search a class, indexed variants", NB_LOOKUPS,
+		app = _search_desktop_file (pClasses[i]);
+		s_iBenchSink += (app != NULL);
+		if (++ i == iNbClasses) i = 0);
+}
+
+int main (int argc, char **argv)
+{
+	bench_init (argc, argv);
+	gchar **pDesktopFiles = _read_fixture ("desktop-files.txt");
+	gchar **pClasses = _read_fixture ("window-classes.txt");
+
+	gchar *cRootDir = g_dir_make_tmp ("bench-desktop-file-db-XXXXXX", NULL);
+	BENCH_CHECK (cRootDir != NULL, "can't make a temporary directory");
+	_install_desktop_files (cRootDir, pDesktopFiles);
+	g_cCairoDockDataDir = cRootDir;  // there is no index there yet, so the DB is built from the desktop files; it saves its index there too.
+
+	gldi_desktop_file_db_init ();
+	(void) gldi_desktop_file_db_lookup ("", FALSE);  // wait for the index
+
+	// the variants are built on the first lookup that needs them.
+	gint64 t0 = g_get_monotonic_time ();
+	(void) gldi_desktop_file_db_lookup_variant ("");
+	bench_report ("build the variants", g_get_monotonic_time () - t0, 1);
+
+	_test_same_desktop_files (pClasses);
+
+	_bench_lookups (pClasses);
+
+	gldi_desktop_file_db_stop ();
+	_remove_dir (cRootDir);
+	g_free (cRootDir);
+	g_strfreev (pClasses);
+	g_strfreev (pDesktopFiles);
+	return 0;
+}
@@ -0,0 +1,168 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Cost of the geometry of a dock (the contiguous copy of its icons): getting it when it's up-to-date (once per frame and per loop),
+ * rebuilding it after the icons changed, and walking it compared to walking the list of icons.
+ * It also checks that the geometry follows the changes of the list, including the ones that keep the same head.
+ * The dock and the icons are bare structures: only the fields used by the geometry are set.
+ */
+
+#include "cairo-dock-icon-factory.h"
+#include "cairo-dock-dock-factory.h"
+#include "cairo-dock-dock-geometry-priv.h"
+#include "bench-utils.h"
+
+#define NB_LOOKUPS 10000000
+#define NB_REBUILDS 200000
+#define NB_WALKS 1000000
+
+static Icon *_new_icon (double fXAtRest)
+{
+	Icon *icon = g_new0 (Icon, 1);
+	icon->fWidth = 48;
+	icon->fXAtRest = fXAtRest;
+	icon->fX = fXAtRest;
+	icon->fScale = 1.;
+	return icon;
+}
+
+static CairoDock *_new_dock (guint iNbIcons)
+{
+	CairoDock *pDock = g_new0 (CairoDock, 1);
+	guint i;
+	for (i = 0; i < iNbIcons; i ++)
+		pDock->icons = g_list_prepend (pDock->icons, _new_icon (48. * (iNbIcons - 1 - i)));
+	return pDock;
+}
+
+static void _free_dock (CairoDock *pDock)
+{
+	gldi_dock_free_geometry (pDock);
+	g_list_free_full (pDock->icons, g_free);
+	g_free (pDock);
+}
+
+static void _check_geometry (CairoDock *pDock)
+{
+	GldiDockGeometry *pGeometry = gldi_dock_get_geometry (pDock);
+	BENCH_CHECK (pGeometry->iNbIcons == g_list_length (pDock->icons), "%u icons in the geometry, %u in the dock", pGeometry->iNbIcons, g_list_length (pDock->icons));
+	guint i = 0;
+	GList *ic;
+	for (ic = pDock->icons; ic != NULL; ic = ic->next, i ++)
+		BENCH_CHECK (pGeometry->pIcons[i] == ic->data, "icon %u differs from the list", i);
+}
+
+  /////////////
+ /// TESTS ///
+/////////////
+
+static void _test_invalidation (void)
+{
+	CairoDock *pDock = _new_dock (10);
+	_check_geometry (pDock);
+
+	// insert in the middle: the head of the list doesn't change.
+	pDock->icons = g_list_insert (pDock->icons, _new_icon (0.), 5);
+	gldi_dock_invalidate_geometry (pDock);
+	_check_geometry (pDock);
+
+	// replace the first icon: the new head is likely to be allocated where the former one was.
+	Icon *pFirstIcon = pDock->icons->data;
+	pDock->icons = g_list_delete_link (pDock->icons, pDock->icons);
+	g_free (pFirstIcon);
+	pDock->icons = g_list_prepend (pDock->icons, _new_icon (0.));
+	gldi_dock_invalidate_geometry (pDock);
+	_check_geometry (pDock);
+
+	// reorder.
+	pDock->icons = g_list_reverse (pDock->icons);
+	gldi_dock_invalidate_geometry (pDock);
+	_check_geometry (pDock);
+
+	// empty, then free and get a new geometry.
+	GList *icons = pDock->icons;
+	pDock->icons = NULL;
+	gldi_dock_invalidate_geometry (pDock);
+	_check_geometry (pDock);
+	pDock->icons = icons;
+	gldi_dock_free_geometry (pDock);
+	_check_geometry (pDock);
+
+	_free_dock (pDock);
+}
+
+  //////////////////
+ /// BENCHMARKS ///
+//////////////////
+
+static void _bench_dock (guint iNbIcons)
+{
+	gchar *cName;
+	CairoDock *pDock = _new_dock (iNbIcons);
+	GldiDockGeometry *pGeometry;
+
+	cName = g_strdup_printf ("get up-to-date geometry (%u icons)", iNbIcons);
+	BENCH (cName, NB_LOOKUPS,
+		pGeometry = gldi_dock_get_geometry (pDock);
+		s_iBenchSink += pGeometry->iNbIcons);
+	g_free (cName);
+
+	cName = g_strdup_printf ("invalidate + rebuild geometry (%u icons)", iNbIcons);
+	BENCH (cName, NB_REBUILDS,
+		gldi_dock_invalidate_geometry (pDock);
+		pGeometry = gldi_dock_get_geometry (pDock);
+		s_iBenchSink += pGeometry->iNbIcons);
+	g_free (cName);
+
+	guint i;
+	double x = 0.;
+	cName = g_strdup_printf ("walk the geometry (%u icons)", iNbIcons);
+	BENCH (cName, NB_WALKS / iNbIcons,
+		pGeometry = gldi_dock_get_geometry (pDock);
+		for (i = 0; i < pGeometry->iNbIcons; i ++)
+			x += pGeometry->pIcons[i]->fX * pGeometry->pIcons[i]->fScale);
+	g_free (cName);
+
+	GList *ic;
+	Icon *icon;
+	cName = g_strdup_printf ("walk the list of icons (%u icons)", iNbIcons);
+	BENCH (cName, NB_WALKS / iNbIcons,
+		for (ic = pDock->icons; ic != NULL; ic = ic->next)
+		{
+			icon = ic->data;
+			x += icon->fX * icon->fScale;
+		});
+	g_free (cName);
+	s_iBenchSink += (gsize) x;
+
+	_free_dock (pDock);
+}
+
+int main (int argc, char **argv)
+{
+	bench_init (argc, argv);
+
+	_test_invalidation ();
+
+	_bench_dock (10);
+	_bench_dock (40);
+	_bench_dock (200);
+
+	return 0;
+}
@@ -0,0 +1,151 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Cost of gldi_object_notify, compared to the former dispatch (a GSList of records per object).
+ * Objects are created from a 3-level hierarchy of managers, like UserIcon -> Launcher -> Icon,
+ * and the listeners are registered on the top manager, like the plug-ins do for the per-frame notifications.
+ */
+
+#include "cairo-dock-object.h"
+#include "bench-utils.h"
+
+#define NB_DISPATCHES 2000000
+
+enum {
+	NOTIFICATION_BENCH = NB_NOTIFICATIONS_OBJECT,
+	NB_NOTIFICATIONS_BENCH
+	};
+
+static GldiObjectManager myBenchIconObjectMgr;
+static GldiObjectManager myBenchLauncherObjectMgr;
+static GldiObjectManager myBenchUserIconObjectMgr;
+
+static gboolean _on_bench (gpointer pUserData, G_GNUC_UNUSED GldiObject *obj, gsize *pCount)
+{
+	*pCount += GPOINTER_TO_SIZE (pUserData);
+	return GLDI_NOTIFICATION_LET_PASS;
+}
+
+static void _init_manager (GldiObjectManager *pMgr, const gchar *cName, GldiObjectManager *pParentMgr)
+{
+	memset (pMgr, 0, sizeof (GldiObjectManager));
+	pMgr->cName       = cName;
+	pMgr->iObjectSize = sizeof (GldiObject);
+	gldi_object_install_notifications (pMgr, NB_NOTIFICATIONS_BENCH);
+	if (pParentMgr)
+		gldi_object_set_manager (GLDI_OBJECT (pMgr), pParentMgr);
+}
+
+
+  ///////////////////////
+ /// FORMER DISPATCH ///
+///////////////////////
+
+/* What gldi_object_notify used to do: for each level of the hierarchy, walk a GSList of individually allocated records.
+ */
+#define NB_LEVELS 4  // object, UserIcon, Launcher, Icon
+
+static void _legacy_register (GSList **pLevels, guint iLevel, GldiNotificationFunc pFunction, gpointer pUserData)
+{
+	GldiNotificationRecord *pRecord = g_new (GldiNotificationRecord, 1);
+	pRecord->pFunction = pFunction;
+	pRecord->pUserData = pUserData;
+	pLevels[iLevel] = g_slist_append (pLevels[iLevel], pRecord);
+}
+
+static gboolean _legacy_notify (GSList **pLevels, GldiObject *obj, gsize *pCount)
+{
+	gboolean bStop = FALSE;
+	guint i;
+	for (i = 0; i < NB_LEVELS && ! bStop; i ++)
+	{
+		GldiNotificationRecord *pRecord;
+		GSList *pElement = pLevels[i], *pNextElement;
+		while (pElement != NULL && ! bStop)
+		{
+			pRecord = pElement->data;
+			pNextElement = pElement->next;
+			bStop = pRecord->pFunction (pRecord->pUserData, obj, pCount);
+			pElement = pNextElement;
+		}
+	}
+	return bStop;
+}
+
+
+  ////////////
+ /// MAIN ///
+////////////
+
+static void _bench_listeners (GldiObject *obj, guint iNbListeners, gboolean bSpread)
+{
+	GSList *pLevels[NB_LEVELS] = {NULL};
+	GldiObjectManager *pMgrs[NB_LEVELS-1] = {&myBenchUserIconObjectMgr, &myBenchLauncherObjectMgr, &myBenchIconObjectMgr};
+	guint i;
+	for (i = 0; i < iNbListeners; i ++)
+	{
+		guint iLevel = (bSpread ? i % (NB_LEVELS-1) : NB_LEVELS-2);  // on all the managers, or on the top one only
+		gldi_object_register_notification (pMgrs[iLevel], NOTIFICATION_BENCH, (GldiNotificationFunc) _on_bench, GLDI_RUN_AFTER, GSIZE_TO_POINTER (i + 1));
+		_legacy_register (pLevels, iLevel + 1, (GldiNotificationFunc) _on_bench, GSIZE_TO_POINTER (i + 1));
+	}
+	
+	// both paths must call the same callbacks
+	gsize iCount = 0, iLegacyCount = 0;
+	gldi_object_notify (obj, NOTIFICATION_BENCH, obj, &iCount);
+	_legacy_notify (pLevels, obj, &iLegacyCount);
+	BENCH_CHECK (iCount == iLegacyCount, "%lu != %lu", (gulong)iCount, (gulong)iLegacyCount);
+	
+	gchar *cName = g_strdup_printf ("%u listeners%s, gldi_object_notify", iNbListeners, bSpread ? " (spread)" : "");
+	BENCH (cName, NB_DISPATCHES,
+		gldi_object_notify (obj, NOTIFICATION_BENCH, obj, &iCount));
+	g_free (cName);
+	cName = g_strdup_printf ("%u listeners%s, former GSList dispatch", iNbListeners, bSpread ? " (spread)" : "");
+	BENCH (cName, NB_DISPATCHES,
+		_legacy_notify (pLevels, obj, &iLegacyCount));
+	g_free (cName);
+	s_iBenchSink += iCount + iLegacyCount;
+	
+	for (i = 0; i < iNbListeners; i ++)
+	{
+		guint iLevel = (bSpread ? i % (NB_LEVELS-1) : NB_LEVELS-2);
+		gldi_object_remove_notification (pMgrs[iLevel], NOTIFICATION_BENCH, (GldiNotificationFunc) _on_bench, GSIZE_TO_POINTER (i + 1));
+	}
+	for (i = 0; i < NB_LEVELS; i ++)
+		g_slist_free_full (pLevels[i], g_free);
+}
+
+int main (int argc, char **argv)
+{
+	bench_init (argc, argv);
+	
+	_init_manager (&myBenchIconObjectMgr, "BenchIcon", NULL);
+	_init_manager (&myBenchLauncherObjectMgr, "BenchLauncher", &myBenchIconObjectMgr);
+	_init_manager (&myBenchUserIconObjectMgr, "BenchUserIcon", &myBenchLauncherObjectMgr);
+	GldiObject *obj = gldi_object_new (&myBenchUserIconObjectMgr, NULL);
+	
+	guint iNbListeners[] = {0, 1, 8, 64};
+	guint i;
+	for (i = 0; i < G_N_ELEMENTS (iNbListeners); i ++)
+		_bench_listeners (obj, iNbListeners[i], FALSE);
+	for (i = 1; i < G_N_ELEMENTS (iNbListeners); i ++)
+		_bench_listeners (obj, iNbListeners[i], TRUE);
+	
+	gldi_object_unref (obj);
+	return 0;
+}
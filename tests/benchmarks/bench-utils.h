@@ -0,0 +1,74 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __GLDI_BENCH_UTILS__
+#define  __GLDI_BENCH_UTILS__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+/* Small helpers shared by the benchmarks of this directory.
+ * Each benchmark is a standalone program; with '--quick' (used by ctest), it only runs a few iterations.
+ */
+
+static gboolean s_bBenchQuick = FALSE;
+
+// written by the benchmarks so that the compiler can't drop the code being measured.
+static volatile gsize s_iBenchSink = 0;
+
+static inline void bench_init (int argc, char **argv)
+{
+	int i;
+	for (i = 1; i < argc; i ++)
+	{
+		if (strcmp (argv[i], "--quick") == 0)
+			s_bBenchQuick = TRUE;
+	}
+}
+
+static inline guint bench_iterations (guint n)
+{
+	return (s_bBenchQuick ? MAX (1, n / 1000) : n);
+}
+
+static inline void bench_report (const gchar *cName, gint64 iDuration, guint iNbOps)
+{
+	printf ("%-56s %10.1f ns/op  (%u ops)\n", cName, 1000. * iDuration / MAX (1, iNbOps), iNbOps);
+}
+
+/* Runs the statement 'code' n times (less in quick mode) and prints the time per run.
+ */
+#define BENCH(cName, n, code) do {\
+	guint _iNbOps = bench_iterations (n), _i;\
+	gint64 _t0 = g_get_monotonic_time ();\
+	for (_i = 0; _i < _iNbOps; _i ++) { code; }\
+	bench_report (cName, g_get_monotonic_time () - _t0, _iNbOps); } while (0)
+
+/* Fails the program if the condition doesn't hold; used by the tests comparing two paths.
+ */
+#define BENCH_CHECK(cond, ...) do {\
+	if (! (cond)) {\
+		fprintf (stderr, "%s:%d: check failed: %s\n  ", __FILE__, __LINE__, #cond);\
+		fprintf (stderr, __VA_ARGS__);\
+		fprintf (stderr, "\n");\
+		exit (1); } } while (0)
+
+#endif
@@ -0,0 +1,294 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Cost of a window being dragged continuously among 200 windows, for a dock that hides when any window overlaps it:
+ * each motion of the window updates the set of the windows overlapping the dock (GldiWindowOverlaps), and the dock is hidden or shown.
+ * It's compared to the former handling of the motion, which walked all the windows each time the dock was hidden and the moved window didn't overlap it.
+ * Two cases: no other window overlaps the dock (the dock is shown each time the dragged window leaves it), and a maximized window overlaps it
+ * (the dock stays hidden, the former handling walked the windows on each motion).
+ * It also checks that the set always gives the same answer as walking all the windows, including when windows are hidden, destroyed,
+ * or change of desktop, and when the current desktop changes.
+ * The windows are actors of a fake window manager that gives their geometry and desktop; the dock is only its area.
+ */
+
+#include "cairo-dock-windows-manager-priv.h"
+#include "cairo-dock-desktop-manager.h"
+#include "cairo-dock-window-overlaps-priv.h"
+#include "bench-utils.h"
+
+#define NB_WINDOWS 200
+#define NB_DESKTOPS 4
+#define SCREEN_WIDTH 1920
+#define SCREEN_HEIGHT 1080
+#define NB_MOTIONS 1000000
+
+static const GtkAllocation s_dockArea = {560, SCREEN_HEIGHT - 48, 800, 48};  // a dock at the bottom of the screen
+
+static GldiWindowActor *_new_window (int x, int y, int w, int h, int iNumDesktop)
+{
+	GldiWindowActor *actor = (GldiWindowActor*)gldi_object_new (&myWindowObjectMgr, NULL);
+	actor->windowGeometry.x = x;
+	actor->windowGeometry.y = y;
+	actor->windowGeometry.width = w;
+	actor->windowGeometry.height = h;
+	actor->iNumDesktop = iNumDesktop;
+	actor->bDisplayed = TRUE;
+	return actor;
+}
+
+/* Make the windows, spread over the desktops, and none of them over the dock: they are above it, or on another desktop, or minimized.
+ */
+static GPtrArray *_new_windows (GRand *pRand)
+{
+	GPtrArray *pWindows = g_ptr_array_new ();
+	int i, w, h, iNumDesktop;
+	GldiWindowActor *actor;
+	for (i = 0; i < NB_WINDOWS; i ++)
+	{
+		w = g_rand_int_range (pRand, 200, 1200);
+		h = g_rand_int_range (pRand, 150, 800);
+		iNumDesktop = g_rand_int_range (pRand, 0, NB_DESKTOPS);
+		if (iNumDesktop == 0)
+			actor = _new_window (g_rand_int_range (pRand, 0, SCREEN_WIDTH - w), g_rand_int_range (pRand, 0, s_dockArea.y - h), w, h, iNumDesktop);
+		else
+			actor = _new_window (g_rand_int_range (pRand, 0, SCREEN_WIDTH - w), g_rand_int_range (pRand, 0, SCREEN_HEIGHT - h), w, h, iNumDesktop);
+		actor->bIsHidden = (iNumDesktop != 0 && g_rand_int_range (pRand, 0, 4) == 0);
+		g_ptr_array_add (pWindows, actor);
+	}
+	return pWindows;
+}
+
+static void _free_windows (GPtrArray *pWindows)
+{
+	guint i;
+	for (i = 0; i < pWindows->len; i ++)
+		gldi_object_unref (GLDI_OBJECT (g_ptr_array_index (pWindows, i)));
+	g_ptr_array_free (pWindows, TRUE);
+}
+
+/* Move the dragged window to the next point of its path: it goes back and forth across the dock, by steps of a few pixels, as the mouse does.
+ */
+static void _drag_window (GldiWindowActor *actor, guint iStep)
+{
+	int iNbSteps = 2 * (SCREEN_WIDTH / 4);
+	int i = iStep % iNbSteps;
+	int x = (i < iNbSteps / 2 ? 4 * i : 4 * (iNbSteps - i));
+	actor->windowGeometry.x = x - actor->windowGeometry.width / 2;
+	actor->windowGeometry.y = s_dockArea.y - actor->windowGeometry.height + 24 + (iStep / iNbSteps % 2 ? -48 : 0);  // every other sweep, the window passes just above the dock.
+}
+
+static gboolean _is_overlapping (GldiWindowActor *actor, gpointer data)
+{
+	return gldi_window_is_overlapping_area (actor, (const GtkAllocation*)data);
+}
+
+static gboolean _scan_windows (const GtkAllocation *pArea)
+{
+	return (gldi_windows_find (_is_overlapping, (gpointer)pArea) != NULL);
+}
+
+  /////////////////////////////////
+ /// FORMER HANDLING OF MOTION ///
+/////////////////////////////////
+
+/* What the dock visibility did on NOTIFICATION_WINDOW_SIZE_POSITION_CHANGED before the overlapping windows were tracked
+ * (_hide_if_overlap_or_show_if_no_overlapping_window and _show_if_no_overlapping_window); bHidden stands for the dock being temporarily hidden.
+ */
+static void _former_on_window_moved (GldiWindowActor *actor, const GtkAllocation *pArea, gboolean *bHidden)
+{
+	if (! gldi_window_is_on_current_desktop (actor))
+	{
+		if (*bHidden && ! _scan_windows (pArea))
+			*bHidden = FALSE;
+	}
+	else if (gldi_window_intersects_area (actor, pArea))
+	{
+		*bHidden = TRUE;
+	}
+	else if (*bHidden)
+	{
+		if (! _scan_windows (pArea))
+			*bHidden = FALSE;
+	}
+}
+
+/* What it does now (_on_window_size_position_changed and _hide_if_any_overlap_or_show).
+ */
+static void _on_window_moved (GldiWindowOverlaps *pOverlaps, GldiWindowActor *actor, const GtkAllocation *pArea, gboolean *bHidden)
+{
+	gldi_window_overlaps_update_window (pOverlaps, actor, FALSE);
+	*bHidden = gldi_window_overlaps_has_window (pOverlaps, pArea);
+}
+
+  /////////////
+ /// TESTS ///
+/////////////
+
+static void _check_overlaps (GldiWindowOverlaps *pOverlaps, const gchar *cWhen)
+{
+	gboolean bOverlap = _scan_windows (&s_dockArea);
+	BENCH_CHECK (gldi_window_overlaps_has_window (pOverlaps, &s_dockArea) == bOverlap, "%s: the set says %d", cWhen, ! bOverlap);
+}
+
+static void _test_overlaps (GRand *pRand)
+{
+	GPtrArray *pWindows = _new_windows (pRand);
+	GldiWindowOverlaps *pOverlaps = gldi_window_overlaps_new ();
+	_check_overlaps (pOverlaps, "start");
+
+	// drag a window, and compare with the former handling.
+	GldiWindowActor *pDragged = g_ptr_array_index (pWindows, 0);
+	pDragged->iNumDesktop = 0;
+	pDragged->bIsHidden = FALSE;
+	gboolean bHidden = FALSE, bFormerHidden = FALSE;
+	guint i;
+	for (i = 0; i < 4 * SCREEN_WIDTH; i ++)
+	{
+		_drag_window (pDragged, i);
+		_on_window_moved (pOverlaps, pDragged, &s_dockArea, &bHidden);
+		_former_on_window_moved (pDragged, &s_dockArea, &bFormerHidden);
+		BENCH_CHECK (bHidden == bFormerHidden, "motion %u: hidden = %d, %d before", i, bHidden, bFormerHidden);
+		_check_overlaps (pOverlaps, "drag");
+	}
+
+	// random changes of the windows.
+	GldiWindowActor *actor;
+	guint j;
+	for (i = 0; i < 2000; i ++)
+	{
+		actor = g_ptr_array_index (pWindows, g_rand_int_range (pRand, 0, pWindows->len));
+		switch (g_rand_int_range (pRand, 0, 5))
+		{
+			case 0:  // (un)minimize
+				actor->bIsHidden = ! actor->bIsHidden;
+				gldi_window_overlaps_update_window (pOverlaps, actor, FALSE);
+			break;
+			case 1:  // send to another desktop
+				actor->iNumDesktop = g_rand_int_range (pRand, -1, NB_DESKTOPS);  // -1 = on all desktops
+				gldi_window_overlaps_update_window (pOverlaps, actor, FALSE);
+			break;
+			case 2:  // move it anywhere
+				actor->windowGeometry.x = g_rand_int_range (pRand, -200, SCREEN_WIDTH);
+				actor->windowGeometry.y = g_rand_int_range (pRand, -200, SCREEN_HEIGHT);
+				gldi_window_overlaps_update_window (pOverlaps, actor, FALSE);
+			break;
+			case 3:  // destroy it and make a new one
+				gldi_window_overlaps_update_window (pOverlaps, actor, TRUE);
+				g_ptr_array_remove_fast (pWindows, actor);
+				gldi_object_unref (GLDI_OBJECT (actor));
+				actor = _new_window (g_rand_int_range (pRand, 0, SCREEN_WIDTH), g_rand_int_range (pRand, 0, SCREEN_HEIGHT), 400, 300, g_rand_int_range (pRand, 0, NB_DESKTOPS));
+				g_ptr_array_add (pWindows, actor);
+				gldi_window_overlaps_update_window (pOverlaps, actor, FALSE);
+			break;
+			default:  // change the current desktop (as the dock visibility does, the set is invalidated)
+				g_desktopGeometry.iCurrentDesktop = g_rand_int_range (pRand, 0, NB_DESKTOPS);
+				gldi_window_overlaps_invalidate (pOverlaps);
+			break;
+		}
+		_check_overlaps (pOverlaps, "random change");
+	}
+
+	// the set holds exactly the overlapping windows, and none of the destroyed ones.
+	guint iNbOverlapping = 0;
+	for (j = 0; j < pWindows->len; j ++)
+	{
+		actor = g_ptr_array_index (pWindows, j);
+		BENCH_CHECK (g_hash_table_contains (pOverlaps->pWindows, actor) == gldi_window_is_overlapping_area (actor, &s_dockArea), "window %u", j);
+		if (gldi_window_is_overlapping_area (actor, &s_dockArea))
+			iNbOverlapping ++;
+	}
+	BENCH_CHECK (g_hash_table_size (pOverlaps->pWindows) == iNbOverlapping, "%u windows in the set, %u overlapping", g_hash_table_size (pOverlaps->pWindows), iNbOverlapping);
+
+	g_desktopGeometry.iCurrentDesktop = 0;
+	gldi_window_overlaps_free (pOverlaps);
+	_free_windows (pWindows);
+}
+
+  //////////////////
+ /// BENCHMARKS ///
+//////////////////
+
+static void _bench_drag (GRand *pRand, gboolean bMaximizedWindow)
+{
+	GPtrArray *pWindows = _new_windows (pRand);
+	GldiWindowActor *pDragged = g_ptr_array_index (pWindows, 0);
+	pDragged->iNumDesktop = 0;
+	pDragged->bIsHidden = FALSE;
+	if (bMaximizedWindow)
+	{
+		GldiWindowActor *pMaximized = g_ptr_array_index (pWindows, NB_WINDOWS / 2);  // in the middle of the list of windows
+		pMaximized->windowGeometry = (GtkAllocation){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+		pMaximized->iNumDesktop = 0;
+		pMaximized->bIsHidden = FALSE;
+	}
+	const gchar *cCase = (bMaximizedWindow ? "a maximized window" : "no window");
+	gchar *cName;
+	gboolean bHidden = FALSE;
+	guint i = 0;
+
+	cName = g_strdup_printf ("former motion, %s over the dock", cCase);
+	BENCH (cName, NB_MOTIONS,
+		_drag_window (pDragged, i ++);
+		_former_on_window_moved (pDragged, &s_dockArea, &bHidden));
+	g_free (cName);
+	s_iBenchSink += bHidden;
+
+	GldiWindowOverlaps *pOverlaps = gldi_window_overlaps_new ();
+	i = 0;
+	cName = g_strdup_printf ("tracked motion, %s over the dock", cCase);
+	BENCH (cName, NB_MOTIONS,
+		_drag_window (pDragged, i ++);
+		_on_window_moved (pOverlaps, pDragged, &s_dockArea, &bHidden));
+	g_free (cName);
+	s_iBenchSink += bHidden;
+
+	cName = g_strdup_printf ("recompute the set, %s over the dock", cCase);
+	BENCH (cName, NB_MOTIONS / 100,
+		gldi_window_overlaps_invalidate (pOverlaps);
+		s_iBenchSink += gldi_window_overlaps_has_window (pOverlaps, &s_dockArea));
+	g_free (cName);
+
+	gldi_window_overlaps_free (pOverlaps);
+	_free_windows (pWindows);
+}
+
+static GldiWindowManagerBackend s_backend;
+
+int main (int argc, char **argv)
+{
+	bench_init (argc, argv);
+
+	gldi_register_windows_manager ();
+	s_backend.name = "bench";
+	s_backend.flags = GINT_TO_POINTER (GLDI_WM_HAVE_WORKSPACES | GLDI_WM_HAVE_WINDOW_GEOMETRY);
+	gldi_windows_manager_register_backend (&s_backend);
+	g_desktopGeometry.Xscreen = (GtkAllocation){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+	g_desktopGeometry.iNbDesktops = NB_DESKTOPS;
+	g_desktopGeometry.iCurrentDesktop = 0;
+
+	GRand *pRand = g_rand_new_with_seed (25);
+
+	_test_overlaps (pRand);
+
+	_bench_drag (pRand, FALSE);
+	_bench_drag (pRand, TRUE);
+
+	g_rand_free (pRand);
+	return 0;
+}
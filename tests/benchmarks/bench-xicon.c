@@ -0,0 +1,277 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Cost of the conversion of the X icon of a window (_NET_WM_ICON) into a surface (cairo_dock_create_surface_from_xicon_buffer),
+ * compared to the former conversion, which always took the biggest icon of the buffer, pre-multiplied it with floats and scaled it through cairo.
+ * It also checks that the pre-multiplication is exactly rounded (including the pixels left to the scalar loop after the SIMD one),
+ * that the smallest icon big enough is taken, and that a too big icon is shrunk with a box filter.
+ * The buffer is converted in place, so it is restored before each conversion; the copy is part of the timings of both conversions.
+ * The surfaces are image surfaces, as in OpenGL mode, so that no display is needed.
+ */
+
+#include "cairo-dock-surface-factory.h"
+#include "cairo-dock-global-variables.h"  // g_bUseOpenGL
+#include "bench-utils.h"
+
+#define NB_CONVERSIONS 20000
+
+static const int s_iSizes[] = {16, 32, 47, 64, 128, 256};  // typical sizes of the icons set by the applications; 47 is not a multiple of 4 pixels.
+
+static guint32 _random_pixel (GRand *pRand)
+{
+	switch (g_rand_int_range (pRand, 0, 4))
+	{
+		case 0: return 0;  // transparent
+		case 1: return 0xFF000000 | (g_rand_int (pRand) & 0xFFFFFF);  // opaque
+		default: return g_rand_int (pRand);
+	}
+}
+
+/* Make a buffer holding the icons of the given sizes, as X gives it (1 pixel per long).
+ */
+static gulong *_new_xicon_buffer (GRand *pRand, const int *pSizes, guint iNbSizes, int *iNbElements)
+{
+	guint i;
+	int n = 0, j;
+	for (i = 0; i < iNbSizes; i ++)
+		n += 2 + pSizes[i] * pSizes[i];
+	gulong *pBuffer = g_new (gulong, n);
+	gulong *p = pBuffer;
+	for (i = 0; i < iNbSizes; i ++)
+	{
+		*p++ = pSizes[i];
+		*p++ = pSizes[i];
+		for (j = 0; j < pSizes[i] * pSizes[i]; j ++)
+			*p++ = _random_pixel (pRand);
+	}
+	*iNbElements = n;
+	return pBuffer;
+}
+
+static const gulong *_get_xicon_pixels (const gulong *pBuffer, int iNbElements, int iSize)
+{
+	int i = 0;
+	while (i + 2 < iNbElements && pBuffer[i] != (gulong)iSize)
+		i += 2 + pBuffer[i] * pBuffer[i+1];
+	return pBuffer + i + 2;
+}
+
+static guint32 _reference_premultiply (guint32 pixel)  // rounded to the nearest
+{
+	guint32 a = pixel >> 24;
+	return (pixel & 0xFF000000)
+		| (((2 * ((pixel >> 16) & 0xFF) * a + 255) / 510) << 16)
+		| (((2 * ((pixel >> 8) & 0xFF) * a + 255) / 510) << 8)
+		| ((2 * (pixel & 0xFF) * a + 255) / 510);
+}
+
+static guint32 _get_surface_pixel (cairo_surface_t *pSurface, int x, int y)
+{
+	const guchar *pData = cairo_image_surface_get_data (pSurface);
+	return *(const guint32 *)(pData + y * cairo_image_surface_get_stride (pSurface) + x * sizeof (guint32));
+}
+
+  /////////////////////////
+ /// FORMER CONVERSION ///
+/////////////////////////
+
+/* The conversion as it was before (the constrained size and the transformation are reduced to the case of the X icons: keep ratio and fill space).
+ */
+static cairo_surface_t *_former_create_surface_from_xicon_buffer (gulong *pXIconBuffer, int iBufferNbElements, int iWidth, int iHeight)
+{
+	int iIndex = 0, iBestIndex = 0;
+	while (iIndex + 2 < iBufferNbElements)
+	{
+		if (pXIconBuffer[iIndex] == 0 || pXIconBuffer[iIndex+1] == 0)
+		{
+			if (iIndex == 0)
+				return NULL;
+			break;
+		}
+		if (pXIconBuffer[iIndex] > pXIconBuffer[iBestIndex])
+			iBestIndex = iIndex;
+		iIndex += 2 + pXIconBuffer[iIndex] * pXIconBuffer[iIndex+1];
+	}
+	int w = pXIconBuffer[iBestIndex];
+	int h = pXIconBuffer[iBestIndex+1];
+	iBestIndex += 2;
+
+	int i, n = w * h;
+	if (iBestIndex + n > iBufferNbElements)
+		return NULL;
+	gint pixel, alpha, red, green, blue;
+	float fAlphaFactor;
+	gint *pPixelBuffer = (gint *) &pXIconBuffer[iBestIndex];
+	for (i = 0; i < n; i ++)
+	{
+		pixel = (gint) pXIconBuffer[iBestIndex+i];
+		alpha = (pixel & 0xFF000000) >> 24;
+		red   = (pixel & 0x00FF0000) >> 16;
+		green = (pixel & 0x0000FF00) >> 8;
+		blue  = (pixel & 0x000000FF);
+		fAlphaFactor = (float) alpha / 255;
+		red *= fAlphaFactor;
+		green *= fAlphaFactor;
+		blue *= fAlphaFactor;
+		pPixelBuffer[i] = (pixel & 0xFF000000) + (red << 16) + (green << 8) + blue;
+	}
+
+	cairo_surface_t *surface_ini = cairo_image_surface_create_for_data ((guchar *)pPixelBuffer,
+		CAIRO_FORMAT_ARGB32,
+		w,
+		h,
+		w * sizeof (gint));
+	double fZoom = MIN ((double)iWidth / w, (double)iHeight / h);
+
+	cairo_surface_t *pNewSurface = cairo_dock_create_blank_surface (
+		iWidth,
+		iHeight);
+	cairo_t *pCairoContext = cairo_create (pNewSurface);
+	cairo_translate (pCairoContext, iWidth/2., iHeight/2.);
+	cairo_scale (pCairoContext, fZoom, fZoom);
+	cairo_translate (pCairoContext, - w/2., - h/2.);
+	cairo_set_source_surface (pCairoContext, surface_ini, 0, 0);
+	cairo_paint (pCairoContext);
+	cairo_destroy (pCairoContext);
+	cairo_surface_destroy (surface_ini);
+	return pNewSurface;
+}
+
+  /////////////
+ /// TESTS ///
+/////////////
+
+static void _test_premultiply (GRand *pRand)
+{
+	int iNbElements;
+	gulong *pBuffer = _new_xicon_buffer (pRand, s_iSizes, G_N_ELEMENTS (s_iSizes), &iNbElements);
+	gulong *pCopy = g_memdup2 (pBuffer, iNbElements * sizeof (gulong));
+
+	// 47 is the smallest size big enough, so it's taken as it is, and its pixels are just pre-multiplied.
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_xicon_buffer (pCopy, iNbElements, 47, 47);
+	BENCH_CHECK (pSurface != NULL, "no surface");
+	cairo_surface_flush (pSurface);
+	const gulong *pPixels = _get_xicon_pixels (pBuffer, iNbElements, 47);
+	int x, y;
+	guint32 iExpected, iPixel;
+	for (y = 0; y < 47; y ++)
+	{
+		for (x = 0; x < 47; x ++)
+		{
+			iExpected = _reference_premultiply (pPixels[y * 47 + x]);
+			iPixel = _get_surface_pixel (pSurface, x, y);
+			BENCH_CHECK (iPixel == iExpected, "pixel (%d;%d) of %08lx: %08x instead of %08x", x, y, pPixels[y * 47 + x], iPixel, iExpected);
+		}
+	}
+	cairo_surface_destroy (pSurface);
+	g_free (pCopy);
+	g_free (pBuffer);
+}
+
+static void _test_downscale (GRand *pRand)
+{
+	int iNbElements;
+	int iSize = 128;
+	gulong *pBuffer = _new_xicon_buffer (pRand, &iSize, 1, &iNbElements);
+	gulong *pCopy = g_memdup2 (pBuffer, iNbElements * sizeof (gulong));
+
+	// the only icon is 4 times too big, so each pixel of the surface is the average of 4x4 pixels.
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_xicon_buffer (pCopy, iNbElements, 32, 32);
+	BENCH_CHECK (pSurface != NULL, "no surface");
+	cairo_surface_flush (pSurface);
+	const gulong *pPixels = pBuffer + 2;
+	int x, y, i, j, c;
+	guint32 iSum[4], pixel, iExpected, iPixel;
+	for (y = 0; y < 32; y ++)
+	{
+		for (x = 0; x < 32; x ++)
+		{
+			memset (iSum, 0, sizeof (iSum));
+			for (j = 0; j < 4; j ++)
+			{
+				for (i = 0; i < 4; i ++)
+				{
+					pixel = _reference_premultiply (pPixels[(4*y + j) * 128 + 4*x + i]);
+					for (c = 0; c < 4; c ++)
+						iSum[c] += (pixel >> (8*c)) & 0xFF;
+				}
+			}
+			iExpected = 0;
+			for (c = 0; c < 4; c ++)
+				iExpected |= ((iSum[c] + 8) / 16) << (8*c);
+			iPixel = _get_surface_pixel (pSurface, x, y);
+			BENCH_CHECK (iPixel == iExpected, "pixel (%d;%d): %08x instead of %08x", x, y, iPixel, iExpected);
+		}
+	}
+	cairo_surface_destroy (pSurface);
+	g_free (pCopy);
+	g_free (pBuffer);
+}
+
+  //////////////////
+ /// BENCHMARKS ///
+//////////////////
+
+static void _bench_buffer (const gchar *cBufferName, gulong *pBuffer, int iNbElements, int iIconSize)
+{
+	gchar *cName;
+	gulong *pCopy = g_new (gulong, iNbElements);
+	cairo_surface_t *pSurface;
+
+	cName = g_strdup_printf ("former conversion (%s -> %d)", cBufferName, iIconSize);
+	BENCH (cName, NB_CONVERSIONS,
+		memcpy (pCopy, pBuffer, iNbElements * sizeof (gulong));
+		pSurface = _former_create_surface_from_xicon_buffer (pCopy, iNbElements, iIconSize, iIconSize);
+		cairo_surface_destroy (pSurface));
+	g_free (cName);
+
+	cName = g_strdup_printf ("conversion (%s -> %d)", cBufferName, iIconSize);
+	BENCH (cName, NB_CONVERSIONS,
+		memcpy (pCopy, pBuffer, iNbElements * sizeof (gulong));
+		pSurface = cairo_dock_create_surface_from_xicon_buffer (pCopy, iNbElements, iIconSize, iIconSize);
+		cairo_surface_destroy (pSurface));
+	g_free (cName);
+
+	g_free (pCopy);
+}
+
+int main (int argc, char **argv)
+{
+	bench_init (argc, argv);
+	g_bUseOpenGL = TRUE;  // image surfaces, no display needed
+	GRand *pRand = g_rand_new_with_seed (42);
+
+	_test_premultiply (pRand);
+	_test_downscale (pRand);
+
+	int iNbElements;
+	gulong *pBuffer = _new_xicon_buffer (pRand, s_iSizes, G_N_ELEMENTS (s_iSizes), &iNbElements);
+	_bench_buffer ("16..256 px", pBuffer, iNbElements, 32);
+	_bench_buffer ("16..256 px", pBuffer, iNbElements, 48);
+	_bench_buffer ("16..256 px", pBuffer, iNbElements, 64);
+	g_free (pBuffer);
+
+	int iSize = 256;
+	pBuffer = _new_xicon_buffer (pRand, &iSize, 1, &iNbElements);
+	_bench_buffer ("256 px only", pBuffer, iNbElements, 48);
+	g_free (pBuffer);
+
+	g_rand_free (pRand);
+	return 0;
+}
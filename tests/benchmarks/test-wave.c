@@ -0,0 +1,446 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Golden-output test of the linear wave: the layout of the dock (cairo_dock_calculate_max_dock_width, cairo_dock_apply_wave_effect_linear
+ * and cairo_dock_calculate_wave_with_position_linear) must give exactly the same icons as the former layout, which walked the list of icons.
+ * The icons are randomized (number, sizes, gap, insertion/removal, wave parameters, cursor positions), including docks narrower than their icons,
+ * where the icons at rest are wrapped around the dock and can't be bisected.
+ * It then times both layouts on a motion event, and the computation of the max width.
+ * The dock and the icons are bare structures: only the fields used by the layout are set.
+ */
+
+#include <math.h>
+
+#include "cairo-dock-icon-factory.h"
+#include "cairo-dock-icon-facility.h"  // cairo_dock_get_last_icon
+#include "cairo-dock-icon-manager.h"  // myIconsParam
+#include "cairo-dock-dock-factory.h"
+#include "cairo-dock-dock-manager.h"  // myDocksParam
+#include "cairo-dock-dock-facility.h"
+#include "cairo-dock-dock-geometry-priv.h"
+#include "cairo-dock-animations.h"  // cairo_dock_calculate_magnitude
+#include "bench-utils.h"
+
+#define NB_DOCKS 3000
+#define NB_POSITIONS 20
+#define NB_MOTIONS 200000
+
+  /////////////////////
+ /// FORMER LAYOUT ///
+/////////////////////
+
+/* The layout as it was before the icons were gathered in the geometry of the dock (verbatim, apart from the names).
+ */
+static Icon * _former_calculate_wave_with_position_linear (GList *pIconList, int x_abs, gdouble fMagnitude, double fFlatDockWidth, int iWidth, int iHeight, double fAlign, double fFoldingFactor, gboolean bDirectionUp)
+{
+	if (pIconList == NULL)
+		return NULL;
+	if (x_abs < 0 && iWidth > 0)
+		x_abs = 0;
+	else if (x_abs > fFlatDockWidth && iWidth > 0)
+		x_abs = (int) fFlatDockWidth;
+
+	float x_cumulated = 0, fXMiddle, fDeltaExtremum;
+	GList* ic, *pointed_ic;
+	Icon *icon, *prev_icon;
+	double fScale = 0.;
+	double offset = 0.;
+	pointed_ic = (x_abs < 0 ? pIconList : NULL);
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		x_cumulated = icon->fXAtRest;
+		fXMiddle = icon->fXAtRest + icon->fWidth / 2;
+
+		icon->fPhase = (fXMiddle - x_abs) / myIconsParam.iSinusoidWidth * G_PI + G_PI / 2;
+		if (icon->fPhase < 0)
+		{
+			icon->fPhase = 0;
+		}
+		else if (icon->fPhase > G_PI)
+		{
+			icon->fPhase = G_PI;
+		}
+
+		icon->fScale = 1 + fMagnitude * myIconsParam.fAmplitude * sin (icon->fPhase);
+		if (iWidth > 0 && icon->fInsertRemoveFactor != 0)
+		{
+			fScale = icon->fScale;
+			if (icon->fInsertRemoveFactor > 0)
+				icon->fScale *= icon->fInsertRemoveFactor;
+			else
+				icon->fScale *= (1 + icon->fInsertRemoveFactor);
+		}
+
+		icon->fY = (bDirectionUp ? iHeight - myDocksParam.iDockLineWidth - myDocksParam.iFrameMargin - icon->fScale * icon->fHeight : myDocksParam.iDockLineWidth + myDocksParam.iFrameMargin);
+
+		if (pointed_ic != NULL)
+		{
+			if (ic == pIconList)
+			{
+				icon->fX = x_cumulated - 1. * (fFlatDockWidth - iWidth) / 2;
+			}
+			else
+			{
+				prev_icon = (ic->prev != NULL ? ic->prev->data : cairo_dock_get_last_icon (pIconList));
+				icon->fX = prev_icon->fX + (prev_icon->fWidth + myIconsParam.iIconGap) * prev_icon->fScale;
+
+				if (icon->fX + icon->fWidth * icon->fScale > icon->fXMax - myIconsParam.fAmplitude * fMagnitude * (icon->fWidth + 1.5*myIconsParam.iIconGap) / 8 && iWidth != 0)
+				{
+					fDeltaExtremum = icon->fX + icon->fWidth * icon->fScale - (icon->fXMax - myIconsParam.fAmplitude * fMagnitude * (icon->fWidth + 1.5*myIconsParam.iIconGap) / 16);
+					if (myIconsParam.fAmplitude != 0)
+						icon->fX -= fDeltaExtremum * (1 - (icon->fScale - 1) / myIconsParam.fAmplitude) * fMagnitude;
+				}
+			}
+			icon->fX = fAlign * iWidth + (icon->fX - fAlign * iWidth) * (1. - fFoldingFactor);
+		}
+
+		if (pointed_ic == NULL
+		    && x_cumulated + icon->fWidth + .5*myIconsParam.iIconGap >= x_abs
+		    && x_cumulated - .5*myIconsParam.iIconGap <= x_abs)
+		{
+			pointed_ic = ic;
+			icon->bPointed = (x_abs != (int) fFlatDockWidth && x_abs != 0);
+			icon->fX = x_cumulated - (fFlatDockWidth - iWidth) / 2 + (1 - icon->fScale) * (x_abs - x_cumulated + .5*myIconsParam.iIconGap);
+			icon->fX = fAlign * iWidth + (icon->fX - fAlign * iWidth) * (1. - fFoldingFactor);
+		}
+		else
+			icon->bPointed = FALSE;
+
+		if (iWidth > 0 && icon->fInsertRemoveFactor != 0)
+		{
+			if (pointed_ic != ic)
+				offset += (icon->fWidth * (fScale - icon->fScale)) * (pointed_ic == NULL ? 1 : -1);
+			else
+				offset += (2*(fXMiddle - x_abs) * (fScale - icon->fScale)) * (pointed_ic == NULL ? 1 : -1);
+		}
+	}
+
+	if (pointed_ic == NULL)
+	{
+		pointed_ic = g_list_last (pIconList);
+		icon = pointed_ic->data;
+		icon->fX = x_cumulated - (fFlatDockWidth - iWidth) / 2 + (1 - icon->fScale) * (icon->fWidth + .5*myIconsParam.iIconGap);
+		icon->fX = fAlign * iWidth + (icon->fX - fAlign * iWidth) * (1 - fFoldingFactor);
+	}
+
+	ic = pointed_ic;
+	while (ic != pIconList)
+	{
+		icon = ic->data;
+
+		ic = ic->prev;
+		prev_icon = ic->data;
+
+		prev_icon->fX = icon->fX - (prev_icon->fWidth + myIconsParam.iIconGap) * prev_icon->fScale;
+		if (prev_icon->fX < prev_icon->fXMin + myIconsParam.fAmplitude * fMagnitude * (prev_icon->fWidth + 1.5*myIconsParam.iIconGap) / 8
+		    && iWidth != 0 && x_abs < iWidth && fMagnitude > 0)
+		{
+			fDeltaExtremum = prev_icon->fX - (prev_icon->fXMin + myIconsParam.fAmplitude * fMagnitude * (prev_icon->fWidth + 1.5*myIconsParam.iIconGap) / 16);
+			if (myIconsParam.fAmplitude != 0)
+				prev_icon->fX -= fDeltaExtremum * (1 - (prev_icon->fScale - 1) / myIconsParam.fAmplitude) * fMagnitude;
+		}
+		prev_icon->fX = fAlign * iWidth + (prev_icon->fX - fAlign * iWidth) * (1. - fFoldingFactor);
+	}
+
+	if (offset != 0)
+	{
+		offset /= 2;
+		for (ic = pIconList; ic != NULL; ic = ic->next)
+		{
+			icon = ic->data;
+			icon->fX -= offset;
+		}
+	}
+
+	icon = pointed_ic->data;
+	return (icon->bPointed ? icon : NULL);
+}
+
+static double _former_calculate_max_dock_width (CairoDock *pDock, double fFlatDockWidth, double fWidthConstraintFactor, double fExtraWidth)
+{
+	double fMaxDockWidth = 0.;
+	GList *pIconList = pDock->icons;
+	if (pIconList == NULL)
+		return 2 * myDocksParam.iDockRadius + myDocksParam.iDockLineWidth + 2 * myDocksParam.iFrameMargin;
+
+	GList* ic;
+	Icon *icon;
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		icon->fXMax = -1e4;
+		icon->fXMin = 1e4;
+	}
+
+	GList *ic2;
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+
+		_former_calculate_wave_with_position_linear (pIconList, icon->fXAtRest, pDock->fMagnitudeMax, fFlatDockWidth, 0, 0, 0.5, 0, pDock->container.bDirectionUp);
+
+		for (ic2 = pIconList; ic2 != NULL; ic2 = ic2->next)
+		{
+			icon = ic2->data;
+
+			if (icon->fX + icon->fWidth * icon->fScale > icon->fXMax)
+				icon->fXMax = icon->fX + icon->fWidth * icon->fScale;
+			if (icon->fX < icon->fXMin)
+				icon->fXMin = icon->fX;
+		}
+	}
+	_former_calculate_wave_with_position_linear (pIconList, fFlatDockWidth - 1, pDock->fMagnitudeMax, fFlatDockWidth, 0, 0, pDock->fAlign, 0, pDock->container.bDirectionUp);
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+
+		if (icon->fX + icon->fWidth * icon->fScale > icon->fXMax)
+			icon->fXMax = icon->fX + icon->fWidth * icon->fScale;
+		if (icon->fX < icon->fXMin)
+			icon->fXMin = icon->fX;
+	}
+
+	fMaxDockWidth = (icon->fXMax - ((Icon *) pIconList->data)->fXMin) * fWidthConstraintFactor + fExtraWidth;
+	fMaxDockWidth = ceil (fMaxDockWidth) + 1;
+
+	for (ic = pIconList; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		icon->fXMin += fMaxDockWidth / 2;
+		icon->fXMax += fMaxDockWidth / 2;
+		icon->fX = icon->fXAtRest;
+		icon->fScale = 1;
+	}
+
+	return fMaxDockWidth;
+}
+
+static Icon *_former_apply_wave_effect_linear (CairoDock *pDock)
+{
+	double offset = (pDock->container.iWidth - pDock->iActiveWidth) * pDock->fAlign + (pDock->iActiveWidth - pDock->fFlatDockWidth) / 2;
+	int x_abs = pDock->container.iMouseX - offset;
+
+	double fMagnitude = cairo_dock_calculate_magnitude (pDock->iMagnitudeIndex);
+	return _former_calculate_wave_with_position_linear (pDock->icons, x_abs, fMagnitude, pDock->fFlatDockWidth, pDock->container.iWidth, pDock->container.iHeight, pDock->fAlign, pDock->fFoldingFactor, pDock->container.bDirectionUp);
+}
+
+  /////////////
+ /// DOCKS ///
+/////////////
+
+/* A random dock, and its twin laid out by the former code.
+ */
+static CairoDock *_new_random_dock (GRand *pRand, guint iNbIcons)
+{
+	CairoDock *pDock = g_new0 (CairoDock, 1);
+	double fFlatDockWidth = 0;
+	guint i;
+	for (i = 0; i < iNbIcons; i ++)
+	{
+		Icon *icon = g_new0 (Icon, 1);
+		icon->fWidth = g_rand_int_range (pRand, 16, 97);
+		icon->fHeight = g_rand_int_range (pRand, 16, 97);
+		icon->fScale = 1.;
+		if (g_rand_int_range (pRand, 0, 8) == 0)  // an icon being inserted or removed
+			icon->fInsertRemoveFactor = g_rand_double_range (pRand, -.99, .99);
+		pDock->icons = g_list_prepend (pDock->icons, icon);
+		fFlatDockWidth += icon->fWidth + myIconsParam.iIconGap;
+	}
+	if (g_rand_int_range (pRand, 0, 5) == 0)  // a dock narrower than its icons: some of them are wrapped at rest.
+		fFlatDockWidth *= g_rand_double_range (pRand, .3, 1.);
+	pDock->fFlatDockWidth = fFlatDockWidth;
+	pDock->fMagnitudeMax = g_rand_double_range (pRand, 0., 1.);
+	pDock->fAlign = g_rand_double (pRand);
+	pDock->container.bDirectionUp = g_rand_boolean (pRand);
+	pDock->iMaxDockHeight = 200;
+	return pDock;
+}
+
+static CairoDock *_copy_dock (CairoDock *pDock)
+{
+	CairoDock *pCopy = g_new0 (CairoDock, 1);
+	memcpy (pCopy, pDock, sizeof (CairoDock));
+	pCopy->icons = NULL;
+	GList *ic;
+	for (ic = pDock->icons; ic != NULL; ic = ic->next)
+		pCopy->icons = g_list_prepend (pCopy->icons, g_memdup2 (ic->data, sizeof (Icon)));
+	pCopy->icons = g_list_reverse (pCopy->icons);
+	return pCopy;
+}
+
+static void _free_dock (CairoDock *pDock)
+{
+	gldi_dock_free_geometry (pDock);
+	g_list_free_full (pDock->icons, g_free);
+	g_free (pDock);
+}
+
+#define _check_field(field) BENCH_CHECK (memcmp (&icon->field, &pFormerIcon->field, sizeof (icon->field)) == 0,\
+	"%s, case %u: icon %u has %s = %.17g instead of %.17g", cStep, iCase, i, #field, (double) icon->field, (double) pFormerIcon->field)
+
+static void _check_same_icons (CairoDock *pDock, CairoDock *pFormerDock, Icon *pPointedIcon, Icon *pFormerPointedIcon, const gchar *cStep, guint iCase)
+{
+	GList *ic, *fic;
+	guint i = 0;
+	gint iPointed = -1, iFormerPointed = -1;
+	for (ic = pDock->icons, fic = pFormerDock->icons; ic != NULL; ic = ic->next, fic = fic->next, i ++)
+	{
+		Icon *icon = ic->data, *pFormerIcon = fic->data;
+		_check_field (fX);
+		_check_field (fY);
+		_check_field (fScale);
+		_check_field (fPhase);
+		_check_field (fXMin);
+		_check_field (fXMax);
+		_check_field (bPointed);
+		if (icon == pPointedIcon)
+			iPointed = i;
+		if (pFormerIcon == pFormerPointedIcon)
+			iFormerPointed = i;
+	}
+	BENCH_CHECK (iPointed == iFormerPointed, "%s, case %u: icon %d is pointed instead of %d", cStep, iCase, iPointed, iFormerPointed);
+}
+
+  /////////////
+ /// TESTS ///
+/////////////
+
+static void _randomize_params (GRand *pRand)
+{
+	myIconsParam.iIconGap = g_rand_int_range (pRand, 0, 51);
+	myIconsParam.fAmplitude = g_rand_double_range (pRand, 0., 1.5);
+	myIconsParam.iSinusoidWidth = g_rand_int_range (pRand, 20, 501);
+	myDocksParam.iDockLineWidth = g_rand_int_range (pRand, 0, 4);
+	myDocksParam.iFrameMargin = g_rand_int_range (pRand, 0, 6);
+}
+
+static void _test_golden_output (void)
+{
+	GRand *pRand = g_rand_new_with_seed (1234);
+	guint iNbCases = bench_iterations (NB_DOCKS), iCase, p;
+	for (iCase = 0; iCase < iNbCases; iCase ++)
+	{
+		_randomize_params (pRand);
+		CairoDock *pDock = _new_random_dock (pRand, g_rand_int_range (pRand, 1, 81));
+		cairo_dock_calculate_icons_positions_at_rest_linear (pDock);
+		CairoDock *pFormerDock = _copy_dock (pDock);
+
+		// max width (the wave without constraint, for each icon).
+		double fMaxDockWidth = cairo_dock_calculate_max_dock_width (pDock, pDock->fFlatDockWidth, 1., 0.);
+		double fFormerMaxDockWidth = _former_calculate_max_dock_width (pFormerDock, pFormerDock->fFlatDockWidth, 1., 0.);
+		BENCH_CHECK (fMaxDockWidth == fFormerMaxDockWidth, "case %u: max width %.17g instead of %.17g", iCase, fMaxDockWidth, fFormerMaxDockWidth);
+		_check_same_icons (pDock, pFormerDock, NULL, NULL, "max width", iCase);
+
+		// motion events, inside and outside of the dock.
+		pDock->iActiveWidth = pFormerDock->iActiveWidth = fMaxDockWidth;
+		pDock->container.iWidth = pFormerDock->container.iWidth = fMaxDockWidth + g_rand_int_range (pRand, 0, 100);
+		pDock->container.iHeight = pFormerDock->container.iHeight = g_rand_int_range (pRand, 48, 200);
+		for (p = 0; p < NB_POSITIONS; p ++)
+		{
+			pDock->container.iMouseX = pFormerDock->container.iMouseX = g_rand_int_range (pRand, -50, pDock->container.iWidth + 50);
+			pDock->iMagnitudeIndex = pFormerDock->iMagnitudeIndex = g_rand_int_range (pRand, 0, CAIRO_DOCK_NB_MAX_ITERATIONS + 1);
+			pDock->fFoldingFactor = pFormerDock->fFoldingFactor = (g_rand_boolean (pRand) ? 0. : g_rand_double (pRand));
+			Icon *pPointedIcon = cairo_dock_apply_wave_effect_linear (pDock);
+			Icon *pFormerPointedIcon = _former_apply_wave_effect_linear (pFormerDock);
+			_check_same_icons (pDock, pFormerDock, pPointedIcon, pFormerPointedIcon, "wave", iCase);
+
+			// the public function, on a list that is not the one of a dock.
+			int x_abs = g_rand_int_range (pRand, -50, pDock->fFlatDockWidth + 50);
+			double fMagnitude = g_rand_double (pRand);
+			pPointedIcon = cairo_dock_calculate_wave_with_position_linear (pDock->icons, x_abs, fMagnitude, pDock->fFlatDockWidth, pDock->container.iWidth, pDock->container.iHeight, pDock->fAlign, pDock->fFoldingFactor, pDock->container.bDirectionUp);
+			pFormerPointedIcon = _former_calculate_wave_with_position_linear (pFormerDock->icons, x_abs, fMagnitude, pFormerDock->fFlatDockWidth, pFormerDock->container.iWidth, pFormerDock->container.iHeight, pFormerDock->fAlign, pFormerDock->fFoldingFactor, pFormerDock->container.bDirectionUp);
+			_check_same_icons (pDock, pFormerDock, pPointedIcon, pFormerPointedIcon, "wave of a list", iCase);
+		}
+
+		_free_dock (pDock);
+		_free_dock (pFormerDock);
+	}
+	g_rand_free (pRand);
+	printf ("%u random docks laid out identically\n", iNbCases);
+}
+
+  //////////////////
+ /// BENCHMARKS ///
+//////////////////
+
+static void _bench_dock (guint iNbIcons)
+{
+	GRand *pRand = g_rand_new_with_seed (iNbIcons);
+	myIconsParam.iIconGap = 4;
+	myIconsParam.fAmplitude = 1.;
+	myIconsParam.iSinusoidWidth = 250;
+	CairoDock *pDock = _new_random_dock (pRand, iNbIcons);
+	GList *ic;
+	Icon *icon;
+	for (ic = pDock->icons; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		icon->fWidth = icon->fHeight = 48;
+		icon->fInsertRemoveFactor = 0;
+	}
+	pDock->fFlatDockWidth = iNbIcons * (48 + myIconsParam.iIconGap);  // no wrapped icon
+	cairo_dock_calculate_icons_positions_at_rest_linear (pDock);
+	CairoDock *pFormerDock = _copy_dock (pDock);
+	gchar *cName;
+	double fMaxDockWidth = 0;
+
+	cName = g_strdup_printf ("max width (%u icons)", iNbIcons);
+	BENCH (cName, MAX (1, NB_MOTIONS / iNbIcons / iNbIcons),
+		fMaxDockWidth = cairo_dock_calculate_max_dock_width (pDock, pDock->fFlatDockWidth, 1., 0.));
+	g_free (cName);
+	cName = g_strdup_printf ("max width, former layout (%u icons)", iNbIcons);
+	BENCH (cName, MAX (1, NB_MOTIONS / iNbIcons / iNbIcons),
+		_former_calculate_max_dock_width (pFormerDock, pFormerDock->fFlatDockWidth, 1., 0.));
+	g_free (cName);
+
+	pDock->iActiveWidth = pFormerDock->iActiveWidth = fMaxDockWidth;
+	pDock->container.iWidth = pFormerDock->container.iWidth = fMaxDockWidth;
+	pDock->container.iHeight = pFormerDock->container.iHeight = 100;
+	pDock->iMagnitudeIndex = pFormerDock->iMagnitudeIndex = CAIRO_DOCK_NB_MAX_ITERATIONS;
+
+	// the cursor sweeps the dock by steps of 7 pixels.
+	cName = g_strdup_printf ("wave on a motion event (%u icons)", iNbIcons);
+	BENCH (cName, NB_MOTIONS,
+		pDock->container.iMouseX = (pDock->container.iMouseX + 7) % pDock->container.iWidth;
+		s_iBenchSink += GPOINTER_TO_SIZE (cairo_dock_apply_wave_effect_linear (pDock)));
+	g_free (cName);
+	cName = g_strdup_printf ("wave on a motion event, former layout (%u icons)", iNbIcons);
+	BENCH (cName, NB_MOTIONS,
+		pFormerDock->container.iMouseX = (pFormerDock->container.iMouseX + 7) % pFormerDock->container.iWidth;
+		s_iBenchSink += GPOINTER_TO_SIZE (_former_apply_wave_effect_linear (pFormerDock)));
+	g_free (cName);
+
+	_free_dock (pDock);
+	_free_dock (pFormerDock);
+	g_rand_free (pRand);
+}
+
+int main (int argc, char **argv)
+{
+	bench_init (argc, argv);
+
+	_test_golden_output ();
+
+	_bench_dock (10);
+	_bench_dock (60);
+	_bench_dock (200);
+
+	return 0;
+}